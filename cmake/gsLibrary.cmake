@@ -147,6 +147,10 @@ set_target_properties(${PROJECT_NAME} PROPERTIES
   #    endif()
   #endif()
 
+  if (GISMO_WITH_METIS)
+    target_link_libraries(${PROJECT_NAME} ${METIS_LIBRARIES})
+  endif()
+
   if (GISMO_WITH_SUPERLU)
     target_link_libraries(${PROJECT_NAME} ${SUPERLU_LIBRARIES})
   endif()
@@ -89,10 +89,10 @@ if  (${GISMO_WITH_ADIFF})
 message ("  GISMO_WITH_ADIFF        ${GISMO_WITH_ADIFF}")
 endif()
 
-#option(GISMO_WITH_METIS          "With METIS"                false )
-#if  (${GISMO_WITH_METIS})
-#message ("  GISMO_WITH_METIS        ${GISMO_WITH_METIS}")
-#endif()
+option(GISMO_WITH_METIS          "With METIS"                false )
+if  (${GISMO_WITH_METIS})
+message ("  GISMO_WITH_METIS        ${GISMO_WITH_METIS}")
+endif()
 
 option(GISMO_WITH_MPI            "With MPI"                  false  )
 if  (${GISMO_WITH_MPI})
@@ -0,0 +1,147 @@
+/** @file assemblyScaling_example.cpp
+
+    @brief Measures the parallel scaling of gsExprAssembler with
+    respect to the number of threads and the accumulation strategy
+    (including assembly into a precomputed sparsity pattern and
+    element coloring), and the effect of cached basis tables
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+int main(int argc, char *argv[])
+{
+    //! [Parse command line]
+    index_t numRefine  = 2;
+    index_t degree     = 2;
+    index_t dim        = 3;
+    index_t numPatches = 1;
+    index_t maxThreads = -1;
+    index_t repeat     = 1;
+
+    gsCmdLine cmd("Scaling of expression assembly over the number of threads.");
+    cmd.addInt( "r", "uniformRefine", "Number of uniform h-refinement steps", numRefine );
+    cmd.addInt( "p", "degree", "Polynomial degree of the discretization", degree );
+    cmd.addInt( "d", "dim", "Dimension of the domain (2 or 3)", dim );
+    cmd.addInt( "n", "patches", "Number of patches per direction", numPatches );
+    cmd.addInt( "t", "threads", "Maximum number of threads (-1: all available)", maxThreads );
+    cmd.addInt( "", "repeat", "Number of repetitions of each measurement", repeat );
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+    //! [Parse command line]
+
+    GISMO_ENSURE(2==dim || 3==dim, "Only 2D and 3D domains are supported");
+
+    gsMultiPatch<> mp = (2==dim ?
+                         gsNurbsCreator<>::BSplineSquareGrid(numPatches, numPatches, 1.0) :
+                         gsNurbsCreator<>::BSplineCubeGrid(numPatches, numPatches, numPatches, 1.0));
+
+    gsMultiBasis<> mb(mp, true);
+    mb.setDegree(degree);
+    for (index_t r = 0; r < numRefine; ++r)
+        mb.uniformRefine();
+
+    gsFunctionExpr<> f("1", dim);
+    gsBoundaryConditions<> bc;
+    gsConstantFunction<> zero(0.0, dim);
+    for (gsMultiPatch<>::const_biterator bit = mp.bBegin(); bit != mp.bEnd(); ++bit)
+        bc.addCondition(*bit, condition_type::dirichlet, &zero);
+    bc.setGeoMap(mp);
+
+    gsExprAssembler<> A(1,1);
+    A.setIntegrationElements(mb);
+    gsExprAssembler<>::geometryMap G = A.getMap(mp);
+    gsExprAssembler<>::space u = A.getSpace(mb);
+    auto ff = A.getCoeff(f, G);
+    u.setup(bc, dirichlet::homogeneous, 0);
+
+    A.initSystem();
+    gsInfo << "Patches: "<< mp.nPatches() <<", degree: "<< degree
+           <<", DoFs: "<< A.numDofs() <<"\n";
+
+#ifdef _OPENMP
+    if (-1 == maxThreads) maxThreads = omp_get_max_threads();
+#else
+    maxThreads = 1;
+#endif
+
+    std::vector<std::string> names;
+    names.push_back("critical");
+    names.push_back("threadLocal");
+    names.push_back("pattern");
+    names.push_back("colored");
+
+    gsSparseMatrix<> refMat;
+    gsMatrix<>       refRhs;
+    gsStopwatch timer;
+
+    gsInfo << "threads";
+    for (size_t m = 0; m != names.size(); ++m)
+        gsInfo << std::setw(14) << names[m];
+    gsInfo << "\n";
+
+    bool ok = true;
+    for (index_t nt = 1; nt <= maxThreads;
+         nt = (nt < maxThreads && 2*nt > maxThreads ? maxThreads : 2*nt) )
+    {
+#ifdef _OPENMP
+        omp_set_num_threads(nt);
+#endif
+        gsInfo << std::setw(7) << nt;
+        for (size_t m = 0; m != names.size(); ++m)
+        {
+            const bool pattern = ("pattern" == names[m]);
+            A.options().setInt("accumulation", pattern ? accumulation::critical
+                               : ( "colored" == names[m] ? accumulation::colored
+                                   : static_cast<index_t>(m) ));
+            A.options().setSwitch("exactPattern", pattern);
+            double time = math::limits::max();
+            for (index_t k = 0; k < repeat; ++k)
+            {
+                A.initSystem();
+                timer.restart();
+                A.assemble( igrad(u, G) * igrad(u, G).tr() * meas(G), u * ff * meas(G) );
+                time = math::min(time, timer.stop());
+            }
+            gsInfo << std::setw(14) << time << std::flush;
+
+            if (0 == refMat.size())
+            {
+                refMat = A.matrix();
+                refRhs = A.rhs();
+            }
+            else
+                ok = ok && (refMat - A.matrix()).norm() < 1e-10 * refMat.norm()
+                    && (refRhs - A.rhs()).norm() < 1e-10 * refRhs.norm();
+        }
+        gsInfo << "\n";
+    }
+
+    // Reuse of the basis tables on translation-equivalent elements
+    A.options().setInt("accumulation", accumulation::critical);
+    A.options().setSwitch("exactPattern", false);
+    A.options().setSwitch("cacheBasisTables", true);
+    double time = math::limits::max();
+    for (index_t k = 0; k < repeat; ++k)
+    {
+        A.initSystem();
+        timer.restart();
+        A.assemble( igrad(u, G) * igrad(u, G).tr() * meas(G), u * ff * meas(G) );
+        time = math::min(time, timer.stop());
+    }
+    gsInfo << "With cached basis tables ("<< maxThreads <<" threads): " << time << "\n";
+    ok = ok && (refMat - A.matrix()).norm() < 1e-10 * refMat.norm()
+        && (refRhs - A.rhs()).norm() < 1e-10 * refRhs.norm();
+
+    gsInfo << (ok ? "All strategies produced the same system.\n"
+                  : "Mismatch between the assembled systems!\n");
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,112 @@
+/** @file bSplineEvaluation_example.cpp
+
+    @brief Throughput of gsBSplineBasis::evalAllDers_into at the
+    quadrature nodes of all elements, evaluated in batches per
+    element versus point by point, for degrees 1 to 8
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+int main(int argc, char *argv[])
+{
+    //! [Parse command line]
+    index_t numElements = 64;
+    index_t maxDeg      = 8;
+    index_t numDers     = 2;
+    index_t repeat      = 20;
+
+    gsCmdLine cmd("Batched evaluation of B-spline basis functions and derivatives.");
+    cmd.addInt( "e", "elements", "Number of elements of the knot vector", numElements );
+    cmd.addInt( "p", "degree", "Maximum polynomial degree", maxDeg );
+    cmd.addInt( "n", "ders", "Number of derivatives", numDers );
+    cmd.addInt( "", "repeat", "Number of evaluations per measurement", repeat );
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+    //! [Parse command line]
+
+    GISMO_ENSURE(numDers >= 0 && numElements > 0, "Invalid arguments");
+
+    std::vector<gsMatrix<> > ders, single;
+    gsMatrix<> pts, uPts, ev;
+    gsStopwatch timer;
+    bool ok = true;
+
+    gsInfo << "Million points per second (values and " << numDers << " derivatives)\n";
+    gsInfo << "degree" << std::setw(14) << "pointwise" << std::setw(14)
+           << "batched" << std::setw(10) << "speedup\n";
+    for (index_t p = 1; p <= maxDeg; ++p)
+    {
+        gsKnotVector<> kv(0, 1, numElements - 1, p + 1);
+        gsBSplineBasis<> basis(kv);
+
+        // Gauss nodes on all elements, element after element
+        gsGaussRule<> rule(1, p + 1);
+        gsMatrix<> nodes;
+        gsVector<> weights;
+        pts.resize(1, numElements * (p + 1));
+        index_t c = 0;
+        for (gsBasis<>::domainIter domIt = basis.makeDomainIterator(); domIt->good(); domIt->next())
+        {
+            rule.mapTo(domIt->lowerCorner(), domIt->upperCorner(), nodes, weights);
+            pts.middleCols(c, nodes.cols()) = nodes;
+            c += nodes.cols();
+        }
+
+        timer.restart();
+        for (index_t r = 0; r < repeat; ++r)
+            for (index_t k = 0; k != pts.cols(); ++k)
+                basis.evalAllDers_into(pts.col(k), numDers, single);
+        const double tPoint = timer.stop();
+
+        timer.restart();
+        for (index_t r = 0; r < repeat; ++r)
+            for (index_t e = 0; e != numElements; ++e)
+                basis.evalAllDers_into(pts.middleCols(e * (p + 1), p + 1), numDers, ders);
+        const double tBatch = timer.stop();
+
+        // Check all points at once (including two points outside of
+        // the domain) against point-by-point evaluation and against
+        // eval_into, deriv_into and deriv2_into
+        uPts.resize(1, pts.cols() + 2);
+        uPts << -0.5, pts, 1.5;
+        basis.evalAllDers_into(uPts, numDers, ders);
+        bool eq = true;
+        for (index_t k = 0; k != uPts.cols(); ++k)
+        {
+            basis.evalAllDers_into(uPts.col(k), numDers, single);
+            for (index_t i = 0; i <= numDers; ++i)
+                eq = eq && (ders[i].col(k) - single[i]).norm()
+                    <= 1e-10 * (1 + single[i].norm());
+        }
+        for (index_t i = 0; i <= math::min<index_t>(numDers, 2); ++i)
+        {
+            switch (i)
+            {
+            case 0: basis.eval_into  (pts, ev); break;
+            case 1: basis.deriv_into (pts, ev); break;
+            case 2: basis.deriv2_into(pts, ev); break;
+            }
+            eq = eq && (ders[i].middleCols(1, pts.cols()) - ev).norm()
+                <= 1e-10 * (1 + ev.norm());
+        }
+        ok = ok && eq;
+
+        const real_t mPts = (real_t)(repeat * pts.cols()) / 1e6;
+        gsInfo << std::setw(6) << p << std::setw(14) << mPts / tPoint
+               << std::setw(14) << mPts / tBatch << std::setw(10) << tPoint / tBatch
+               << (eq ? "" : "  (mismatch)") << "\n";
+    }
+
+    gsInfo << (ok ? "Batched evaluation agrees with point-wise evaluation.\n"
+                  : "Mismatch in batched evaluation!\n");
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -8,6 +8,10 @@
     This class uses the expression assembler, for a use of the
     gsPoisson Assembler, see ieti2_example.cpp.
 
+    If G+Smo is compiled with MPI, the patches are distributed over the
+    processes, eg., for 4 processes:
+       mpirun -np 4 ./bin/ieti_example
+
     This file is part of the G+Smo library.
 
     This Source Code Form is subject to the terms of the Mozilla Public
@@ -57,6 +61,15 @@ int main(int argc, char *argv[])
 
     try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
 
+    // Initialize the MPI environment; without MPI, there is just one process
+    //! [Init MPI]
+    const gsMpi & mpi = gsMpi::init(argc, argv);
+    gsMpiComm comm = mpi.worldComm();
+    //! [Init MPI]
+
+    // Only the first process writes to the console
+    if (comm.rank() != 0)
+        gsInfo.setstate(std::ios::failbit);
 
     if ( ! gsFileManager::fileExists(geometry) )
     {
@@ -172,8 +185,22 @@ int main(int argc, char *argv[])
 
     gsInfo << "Setup assembler and assemble matrix... " << std::flush;
 
+    gsStopwatch timer;
     const index_t nPatches = mp.nPatches();
 
+    // Every process handles a set of neighboring patches, such that the
+    // estimated costs of the processes are about the same
+    //! [Distribute patches]
+    if (nPatches < comm.size())
+    {
+        gsInfo << "\nThere are less patches than processes; use --SplitPatches.\n";
+        return EXIT_FAILURE;
+    }
+    gsPatchPartitioner partitioner(mb);
+    const std::vector<index_t> patchRank = partitioner.partition(comm.size());
+    std::vector<index_t> myPatches = gsPatchPartitioner::patchesOf(patchRank, comm.rank());
+    //! [Distribute patches]
+
     //! [Define Ieti Mapper]
     gsIetiMapper<> ietiMapper;
     //! [Define Ieti Mapper]
@@ -228,22 +255,38 @@ int main(int argc, char *argv[])
     // The ieti system does not have a special treatment for the
     // primal dofs. They are just one more subdomain
     gsIetiSystem<> ieti;
-    ieti.reserve(nPatches+1);
+    ieti.reserve(myPatches.size()+1);
 
     // The scaled Dirichlet preconditioner is independent of the
     // primal dofs.
     gsScaledDirichletPrec<> prec;
-    prec.reserve(nPatches);
+    prec.reserve(myPatches.size());
 
     // Setup the primal system, which needs to know the number of primal dofs.
     gsPrimalSystem<> primal(ietiMapper.nPrimalDofs());
     if (eliminateCorners)
         primal.setEliminatePointwiseConstraints(true);
+
+    // Each process only holds its own patches
+    ieti.setComm(comm);
+    prec.setComm(comm);
+    primal.setComm(comm);
+
+    // The local systems of all patches, which are then processed in parallel
+    const size_t nMyPatches = myPatches.size();
+    std::vector< gsSparseMatrix<real_t, RowMajor> > jumpMatrices(nMyPatches);
+    std::vector< gsSparseMatrix<> >                 localMatrices(nMyPatches);
+    std::vector< gsMatrix<> >                       localRhs(nMyPatches);
+    std::vector< std::vector<index_t> >             skeletonDofs(nMyPatches);
+    std::vector< std::vector< gsSparseVector<> > >  primalConstraints(nMyPatches);
+    std::vector< std::vector<index_t> >             primalDofIndices(nMyPatches);
     //! [Setup]
 
     //! [Assemble]
-    for (index_t k=0; k<nPatches; ++k)
+    for (size_t l=0; l<nMyPatches; ++l)
     {
+        const index_t k = myPatches[l];
+
         // We use the local variants of everything
         gsBoundaryConditions<> bc_local;
         bc.getConditionsForPatch(k,bc_local);
@@ -294,49 +337,52 @@ int main(int argc, char *argv[])
         assembler.assembleBdr(bc_local.get("Neumann"),  u * g_N.val() * nv(G).norm() );
 
         // Fetch data
-        gsSparseMatrix<real_t, RowMajor> jumpMatrix  = ietiMapper.jumpMatrix(k);
-        gsSparseMatrix<>                 localMatrix = assembler.matrix();
-        gsMatrix<>                       localRhs    = assembler.rhs();
+        jumpMatrices[l]      = ietiMapper.jumpMatrix(k);
+        localMatrices[l]     = assembler.matrix();
+        localRhs[l]          = assembler.rhs();
+        skeletonDofs[l]      = ietiMapper.skeletonDofs(k);
+        primalConstraints[l] = ietiMapper.primalConstraints(k);
+        primalDofIndices[l]  = ietiMapper.primalDofIndices(k);
         //! [Assemble]
+    //! [End of assembling loop]
+    } // end for
+    //! [End of assembling loop]
 
-        // Add the patch to the scaled Dirichlet preconditioner
-        //! [Patch to preconditioner]
-        prec.addSubdomain(
-            gsScaledDirichletPrec<>::restrictToSkeleton(
-                jumpMatrix,
-                localMatrix,
-                ietiMapper.skeletonDofs(k)
-            )
-        );
-        //! [Patch to preconditioner]
-
-        // This function writes back to jumpMatrix, localMatrix, and localRhs,
-        // so it must be called after prec.addSubdomain().
-        //! [Patch to primals]
-        primal.handleConstraints(
-            ietiMapper.primalConstraints(k),
-            ietiMapper.primalDofIndices(k),
-            jumpMatrix,
-            localMatrix,
-            localRhs
-        );
-        //! [Patch to primals]
+    // Add the patches to the scaled Dirichlet preconditioner; this computes
+    // the local Schur complements for the patches in parallel
+    //! [Patch to preconditioner]
+    prec.addSubdomains( jumpMatrices, localMatrices, skeletonDofs );
+    //! [Patch to preconditioner]
+
+    // This function writes back to jumpMatrices, localMatrices, and localRhs,
+    // so it must be called after prec.addSubdomains().
+    //! [Patch to primals]
+    primal.handleConstraints(
+        primalConstraints,
+        primalDofIndices,
+        jumpMatrices,
+        localMatrices,
+        localRhs
+    );
+    //! [Patch to primals]
 
-        // Add the patch to the Ieti system
-        //! [Patch to system]
+    // Add the patches to the Ieti system
+    //! [Patch to system]
+    for (size_t l=0; l<nMyPatches; ++l)
+    {
         ieti.addSubdomain(
-            jumpMatrix.moveToPtr(),
-            makeMatrixOp(localMatrix.moveToPtr()),
-            give(localRhs)
+            jumpMatrices[l].moveToPtr(),
+            makeMatrixOp(localMatrices[l].moveToPtr()),
+            give(localRhs[l])
         );
-        //! [Patch to system]
-    //! [End of assembling loop]
-    } // end for
-    //! [End of assembling loop]
+    }
+    //! [Patch to system]
 
-    // Add the primal problem if there are primal constraints
+    // Add the primal problem if there are primal constraints; it is
+    // summed up over the processes and kept on the first one
     //! [Primal to system]
-    if (ietiMapper.nPrimalDofs()>0)
+    primal.sumContributions();
+    if (ietiMapper.nPrimalDofs()>0 && comm.rank()==0)
     {
         // It is not required to provide a local solver to .addSubdomain,
         // since a sparse LU solver would be set up on the fly if required.
@@ -354,12 +400,14 @@ int main(int argc, char *argv[])
     }
     //! [Primal to system]
 
+    const double setupTime = timer.stop();
     gsInfo << "done. " << ietiMapper.nPrimalDofs() << " primal dofs.\n";
 
     /**************** Setup solver and solve ****************/
 
     gsInfo << "Setup solver and solve... \n"
         "    Setup multiplicity scaling... " << std::flush;
+    timer.restart();
 
     // Tell the preconditioner to set up the scaling
     //! [Setup scaling]
@@ -377,6 +425,8 @@ int main(int argc, char *argv[])
     //! [Define initial guess]
     gsMatrix<> lambda;
     lambda.setRandom( ieti.nLagrangeMultipliers(), 1 );
+    // All processes hold the same Lagrange multipliers
+    comm.broadcast( lambda.data(), static_cast<int>(lambda.size()), 0 );
     //! [Define initial guess]
 
     gsMatrix<> errorHistory;
@@ -393,9 +443,12 @@ int main(int argc, char *argv[])
     gsMatrix<> uVec = ietiMapper.constructGlobalSolutionFromLocalSolutions(
         primal.distributePrimalSolution(
             ieti.constructSolutionFromLagrangeMultipliers(lambda)
-        )
+        ),
+        myPatches,
+        comm
     );
     //! [Recover]
+    const double solveTime = timer.stop();
     gsInfo << "done.\n\n";
 
     /******************** Print end Exit ********************/
@@ -415,6 +468,12 @@ int main(int argc, char *argv[])
     if (calcEigenvalues)
         gsInfo << "Estimated condition number: " << PCG.getConditionNumber() << "\n";
 
+    gsInfo << "Processes: " << comm.size() << ", assembling and setup: " << setupTime
+           << " s, solving: " << solveTime << " s.\n";
+
+    if (comm.rank() != 0)
+        return success ? EXIT_SUCCESS : EXIT_FAILURE;
+
     if (!out.empty())
     {
         gsFileData<> fd;
@@ -0,0 +1,123 @@
+/** @file krylovThreads_example.cpp
+
+    @brief Solves the Poisson problem of poisson2_example with the
+    Krylov solvers of G+Smo, using one thread and several threads
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+int main(int argc, char *argv[])
+{
+    //! [Parse command line]
+    index_t numRefine  = 4;
+    index_t numElevate = 1;
+    index_t numThreads = 0;
+    real_t  tol        = 1e-8;
+    std::string fn("pde/poisson2d_bvp.xml");
+
+    gsCmdLine cmd("Multithreaded Krylov solvers for a Poisson problem.");
+    cmd.addInt( "e", "degreeElevation", "Number of degree elevation steps", numElevate );
+    cmd.addInt( "r", "uniformRefine", "Number of uniform h-refinement steps", numRefine );
+    cmd.addInt( "t", "threads", "Number of threads of the parallel runs (0: OpenMP default)", numThreads );
+    cmd.addReal("", "tol", "Tolerance of the iterative solvers", tol );
+    cmd.addString( "f", "file", "Input XML file", fn );
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+    //! [Parse command line]
+
+    //! [Assemble]
+    gsFileData<> fd(fn);
+    gsMultiPatch<> mp;
+    fd.getId(0, mp);
+    gsFunctionExpr<> f;
+    fd.getId(1, f);
+    gsBoundaryConditions<> bc;
+    fd.getId(2, bc);
+    bc.setGeoMap(mp);
+
+    gsMultiBasis<> dbasis(mp, true);
+    dbasis.setDegree( dbasis.maxCwiseDegree() + numElevate);
+    for (index_t r = 0; r < numRefine; ++r)
+        dbasis.uniformRefine();
+
+    gsExprAssembler<> A(1,1);
+    A.setIntegrationElements(dbasis);
+    gsExprAssembler<>::geometryMap G = A.getMap(mp);
+    gsExprAssembler<>::space u = A.getSpace(dbasis);
+    auto ff = A.getCoeff(f, G);
+    u.setup(bc, dirichlet::l2Projection, 0);
+    A.initSystem();
+    A.assemble(igrad(u, G) * igrad(u, G).tr() * meas(G), u * ff * meas(G));
+    const gsSparseMatrix<> & K = A.matrix();
+    const gsMatrix<> rhs = A.rhs();
+    //! [Assemble]
+
+    const index_t maxThreads = (numThreads > 0 ? numThreads : omp_get_max_threads());
+    gsInfo << "DoFs: " << A.numDofs() << ", non-zeros: " << K.nonZeros()
+           << ", threads: " << maxThreads << "\n";
+
+    bool ok = true;
+
+    // Matrix-vector product
+    gsMatrix<> x, y, yRef;
+    x.setRandom(K.cols(), 1);
+    yRef = K * x;
+    gsLinearOperator<>::Ptr op = makeMatrixOp(K);
+    op->apply(x, y);
+    ok = ok && (y - yRef).norm() <= 1e-12 * yRef.norm();
+
+    //! [Solve]
+    gsLinearOperator<>::Ptr jacobi = makeJacobiOp(K);
+    gsConjugateGradient<> cg(K, jacobi);
+    gsGMRes<>             gmres(K, jacobi);
+    gsBiCgStab<>          bicgstab(K, jacobi);
+    gsMinimalResidual<>   minres(K, jacobi);
+    gsIterativeSolver<> * solvers[4] = { &cg, &gmres, &bicgstab, &minres };
+    const char * names[4] = { "CG", "GMRES", "BiCGStab", "MinRes" };
+
+    gsMatrix<> x1, xt;
+    gsInfo << std::setw(10) << "solver" << std::setw(8) << "iter" << std::setw(14)
+           << "1 thread" << std::setw(14) << maxThreads << " threads" << "\n";
+    for (index_t s = 0; s != 4; ++s)
+    {
+        gsIterativeSolver<> & solver = *solvers[s];
+        gsOptionList opt = gsIterativeSolver<>::defaultOptions();
+        opt.setReal("Tolerance", tol);
+        opt.setInt ("MaxIterations", 2 * K.rows());
+        opt.setInt ("NumThreads", 1);
+        solver.setOptions(opt);
+        x1.setZero(K.rows(), 1);
+        gsStopwatch timer;
+        solver.solve(rhs, x1);
+        const double t1 = timer.stop();
+        const index_t it1 = solver.iterations();
+
+        opt.setInt("NumThreads", maxThreads);
+        solver.setOptions(opt);
+        xt.setZero(K.rows(), 1);
+        timer.restart();
+        solver.solve(rhs, xt);
+        const double tt = timer.stop();
+
+        // Reductions are summed in different order, so the iterates
+        // differ by round-off only
+        const real_t res = (K * xt - rhs).norm() / rhs.norm();
+        const bool good = res <= 10 * tol && (xt - x1).norm() <= 1e-4 * x1.norm();
+        ok = ok && good;
+        gsInfo << std::setw(10) << names[s] << std::setw(8) << it1 << std::setw(14) << t1
+               << std::setw(14) << tt << (good ? "" : "  (failed)") << "\n";
+    }
+    //! [Solve]
+
+    gsInfo << (ok ? "All solvers converged.\n" : "Some solver failed!\n");
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
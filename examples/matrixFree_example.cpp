@@ -0,0 +1,171 @@
+/** @file matrixFree_example.cpp
+
+    @brief Solves a Poisson problem with a matrix-free operator
+    obtained from gsExprAssembler, using CG, GMRES and a two-grid
+    method with matrix-free Jacobi smoothing
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+int main(int argc, char *argv[])
+{
+    //! [Parse command line]
+    index_t numRefine = 2;
+    index_t degree    = 3;
+    index_t dim       = 3;
+    real_t  damping   = 0.6;
+    real_t  tol       = 1e-8;
+
+    gsCmdLine cmd("Matrix-free solution of a Poisson problem.");
+    cmd.addInt( "r", "uniformRefine", "Number of uniform h-refinement steps", numRefine );
+    cmd.addInt( "p", "degree", "Polynomial degree of the discretization", degree );
+    cmd.addInt( "d", "dim", "Dimension of the domain (2 or 3)", dim );
+    cmd.addReal("", "damping", "Damping of the Jacobi smoother", damping );
+    cmd.addReal("", "tol", "Tolerance of the iterative solvers", tol );
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+    //! [Parse command line]
+
+    GISMO_ENSURE(2==dim || 3==dim, "Only 2D and 3D domains are supported");
+    GISMO_ENSURE(numRefine >= 1, "At least one refinement is needed for the two-grid method");
+
+    //! [Problem setup]
+    gsMultiPatch<> mp;
+    if (2 == dim)
+        mp.addPatch(gsNurbsCreator<>::BSplineSquare());
+    else
+        mp.addPatch(gsNurbsCreator<>::BSplineCube());
+    mp.patch(0).degreeElevate(degree - 1);
+    gsMatrix<> & cf = mp.patch(0).coefs();
+    cf.col(0).array() += 0.25 * cf.col(1).array().square();
+
+    gsFunctionExpr<> f("1", dim);
+    gsConstantFunction<> zero(0.0, dim);
+    gsBoundaryConditions<> bc;
+    for (gsMultiPatch<>::const_biterator bit = mp.bBegin(); bit != mp.bEnd(); ++bit)
+        bc.addCondition(*bit, condition_type::dirichlet, &zero);
+    bc.setGeoMap(mp);
+
+    // Coarse and fine bases, and the transfer between them
+    gsMultiBasis<> mbCoarse(mp, true);
+    for (index_t r = 1; r < numRefine; ++r)
+        mbCoarse.uniformRefine();
+    gsMultiBasis<> mb = mbCoarse;
+    gsSparseMatrix<real_t, RowMajor> transfer;
+    mb.uniformRefine_withTransfer(transfer, bc, gsOptionList());
+    //! [Problem setup]
+
+    //! [Matrix-free operator]
+    gsExprAssembler<> A(1,1);
+    A.setIntegrationElements(mb);
+    gsExprAssembler<>::geometryMap G = A.getMap(mp);
+    gsExprAssembler<>::space u = A.getSpace(mb);
+    auto ff = A.getCoeff(f, G);
+    u.setup(bc, dirichlet::homogeneous, 0);
+    A.initSystem();
+
+    auto lapl = igrad(u, G) * igrad(u, G).tr() * meas(G);
+    gsLinearOperator<>::Ptr op       = A.getMatrixFreeOp(lapl);
+    gsLinearOperator<>::Ptr opCached = A.getMatrixFreeOp(lapl, true);
+    //! [Matrix-free operator]
+
+    // Assembled matrix, for comparison
+    gsStopwatch timer;
+    A.assemble(lapl, u * ff * meas(G));
+    const double tAssemble = timer.stop();
+    const gsMatrix<> rhs = A.rhs();
+    gsInfo << "Degree: " << degree << ", DoFs: " << A.numDofs()
+           << ", non-zeros: " << A.matrix().nonZeros() << "\n";
+
+    bool ok = true;
+    gsMatrix<> x, y, yRef;
+    x.setRandom(A.numDofs(), 2);
+    yRef = A.matrix() * x;
+    timer.restart();
+    op->apply(x, y);
+    const double tApply = timer.stop();
+    ok = ok && (y - yRef).norm() <= 1e-10 * yRef.norm();
+    opCached->apply(x, y); // fills the cache
+    timer.restart();
+    opCached->apply(x, y);
+    const double tApplyCached = timer.stop();
+    ok = ok && (y - yRef).norm() <= 1e-10 * yRef.norm();
+    gsInfo << "Assembly: " << tAssemble << "s, matrix-free apply: " << tApply
+           << "s, with cached geometry: " << tApplyCached << "s\n";
+
+    //! [Jacobi preconditioner]
+    gsMatrix<> diag;
+    A.getMatrixFreeOp(lapl)->diagonal_into(diag);
+    ok = ok && (diag - A.matrix().diagonal()).norm() <= 1e-10 * diag.norm();
+    gsSparseMatrix<> D(diag.rows(), diag.rows());
+    D.reserve(gsVector<index_t>::Ones(diag.rows()));
+    for (index_t i = 0; i != diag.rows(); ++i)
+        D.insert(i, i) = diag(i);
+    D.makeCompressed();
+    gsLinearOperator<>::Ptr jacobi = makeJacobiOp(D);
+    //! [Jacobi preconditioner]
+
+    //! [Solve]
+    gsMatrix<> sol, ref;
+    gsSparseSolver<>::SimplicialLDLT direct(A.matrix());
+    ref = direct.solve(rhs);
+
+    gsConjugateGradient<> cg(opCached, jacobi);
+    cg.setTolerance(tol);
+    sol.setZero(A.numDofs(), 1);
+    cg.solve(rhs, sol);
+    gsInfo << "CG (Jacobi):        " << cg.iterations() << " iterations, error "
+           << (sol - ref).norm() / ref.norm() << "\n";
+    ok = ok && (sol - ref).norm() <= 1e-5 * ref.norm();
+
+    gsGMRes<> gmres(opCached, jacobi);
+    gmres.setTolerance(tol);
+    sol.setZero(A.numDofs(), 1);
+    gmres.solve(rhs, sol);
+    gsInfo << "GMRES (Jacobi):     " << gmres.iterations() << " iterations, error "
+           << (sol - ref).norm() / ref.norm() << "\n";
+    ok = ok && (sol - ref).norm() <= 1e-5 * ref.norm();
+
+    // Two-grid method: assembled coarse level, matrix-free fine level
+    gsExprAssembler<> Ac(1,1);
+    Ac.setIntegrationElements(mbCoarse);
+    gsExprAssembler<>::geometryMap Gc = Ac.getMap(mp);
+    gsExprAssembler<>::space uc = Ac.getSpace(mbCoarse);
+    uc.setup(bc, dirichlet::homogeneous, 0);
+    Ac.initSystem();
+    Ac.assemble(igrad(uc, Gc) * igrad(uc, Gc).tr() * meas(Gc));
+    gsSparseMatrix<> coarseMat = Ac.matrix();
+
+    gsSparseMatrix<real_t, RowMajor> restriction = transfer.transpose();
+    std::vector<gsLinearOperator<>::Ptr> ops(2), prolong(1), restr(1);
+    ops[0] = makeMatrixOp(coarseMat);
+    ops[1] = opCached;
+    prolong[0] = makeMatrixOp(transfer);
+    restr[0]   = makeMatrixOp(restriction);
+    gsMultiGridOp<>::Ptr mg = gsMultiGridOp<>::make(ops, prolong, restr,
+                                                    makeSparseCholeskySolver(coarseMat));
+    mg->setSmoother(0, makeJacobiOp(coarseMat));
+    mg->setSmoother(1, gsPreconditionerFromOp<>::make(opCached, jacobi, damping));
+
+    gsConjugateGradient<> mgcg(opCached, mg);
+    mgcg.setTolerance(tol);
+    sol.setZero(A.numDofs(), 1);
+    mgcg.solve(rhs, sol);
+    gsInfo << "CG (two-grid):      " << mgcg.iterations() << " iterations, error "
+           << (sol - ref).norm() / ref.norm() << "\n";
+    ok = ok && (sol - ref).norm() <= 1e-5 * ref.norm();
+    //! [Solve]
+
+    gsInfo << (ok ? "The matrix-free operator agrees with the assembled matrix.\n"
+                  : "Mismatch between matrix-free and assembled results!\n");
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,117 @@
+/** @file mixedPrecisionMultiGrid_example.cpp
+
+    @brief Compares the time per V-cycle and the memory of a multigrid
+    preconditioner whose coarsest levels are stored in single precision
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+int main(int argc, char *argv[])
+{
+    //! [Parse command line]
+    index_t dim        = 3;
+    index_t degree     = 2;
+    index_t numRefine  = 4;
+    index_t levels     = 4;
+    index_t numCycles  = 10;
+    real_t  tol        = 1e-8;
+    std::string smoother("GaussSeidel");
+
+    gsCmdLine cmd("Multigrid with single precision levels for a Poisson problem on the unit square or cube.");
+    cmd.addInt   ( "d", "dim", "Spatial dimension (2 or 3)", dim );
+    cmd.addInt   ( "p", "degree", "Spline degree", degree );
+    cmd.addInt   ( "r", "uniformRefine", "Number of uniform h-refinement steps", numRefine );
+    cmd.addInt   ( "l", "levels", "Number of multigrid levels", levels );
+    cmd.addInt   ( "c", "cycles", "Number of V-cycles for the timing", numCycles );
+    cmd.addString( "s", "smoother", "Smoother, see gsMultiGridOp::setSmoothers", smoother );
+    cmd.addReal  ( "",  "tol", "Tolerance of the conjugate gradient solver", tol );
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+    //! [Parse command line]
+
+    //! [Assemble]
+    gsMultiPatch<> mp;
+    if (dim == 3)
+        mp.addPatch( *gsNurbsCreator<>::BSplineCube(degree) );
+    else
+        mp.addPatch( *gsNurbsCreator<>::BSplineSquareDeg(degree) );
+    mp.computeTopology();
+
+    gsMultiBasis<> mb(mp);
+    for (index_t r = 0; r < numRefine; ++r)
+        mb.uniformRefine();
+
+    gsConstantFunction<> zero(0, mp.geoDim()), one(1, mp.geoDim());
+    gsBoundaryConditions<> bc;
+    for (gsMultiPatch<>::const_biterator it = mp.bBegin(); it != mp.bEnd(); ++it)
+        bc.addCondition( *it, condition_type::dirichlet, &zero );
+
+    gsOptionList hierarchyOpt = gsGridHierarchy<>::defaultOptions();
+    hierarchyOpt.setInt( "Levels", levels );
+    gsPoissonAssembler<> assembler( mp, mb, bc, one,
+        (dirichlet::strategy) hierarchyOpt.getInt("DirichletStrategy"),
+        (iFace::strategy)     hierarchyOpt.getInt("InterfaceStrategy") );
+    assembler.assemble();
+    const gsSparseMatrix<> & K = assembler.matrix();
+    const gsMatrix<> & rhs = assembler.rhs();
+
+    std::vector< gsSparseMatrix<real_t,RowMajor> > transferMatrices;
+    gsGridHierarchy<>::buildByCoarsening(mb, bc, hierarchyOpt)
+        .moveTransferMatricesTo(transferMatrices);
+    //! [Assemble]
+
+    const index_t numLevels = transferMatrices.size() + 1;
+    gsInfo << "DoFs: " << K.rows() << ", non-zeros: " << K.nonZeros()
+           << ", levels: " << numLevels << ", threads: " << omp_get_max_threads() << "\n";
+
+    //! [Compare]
+    // The fine-grid matrix is needed by the conjugate gradient solver
+    // anyway, so its memory is not counted (but the one of its single
+    // precision copy is)
+    const size_t fine = K.nonZeros() * (sizeof(real_t) + sizeof(index_t)) + (K.cols() + 1) * sizeof(index_t);
+    gsInfo << std::setw(8) << "single" << std::setw(14) << "memory [MB]" << std::setw(16)
+           << "V-cycle [ms]" << std::setw(8) << "iter" << std::setw(14) << "CG [s]" << "\n";
+    bool ok = true;
+    gsMatrix<> x, sol;
+    for (index_t k = 0; k <= numLevels; ++k)
+    {
+        gsMultiGridOp<>::Ptr mg = gsMultiGridOp<>::make(K, transferMatrices);
+        gsOptionList mgOpt = gsMultiGridOp<>::defaultOptions();
+        mgOpt.setInt   ( "SinglePrecisionLevels", k );
+        mgOpt.setString( "Smoother", smoother );
+        mg->setOptions(mgOpt);
+        const double memory = (double)(mg->memoryUsage() - fine) / (1 << 20);
+
+        // One cycle for the coarse factorization, then the timing
+        mg->apply(rhs, x);
+        gsStopwatch timer;
+        for (index_t i = 0; i < numCycles; ++i)
+            mg->apply(rhs, x);
+        const double cycle = 1000 * timer.stop() / numCycles;
+
+        gsConjugateGradient<> cg(K, mg);
+        cg.setTolerance(tol);
+        cg.setMaxIterations(200);
+        sol.setZero(K.rows(), 1);
+        timer.restart();
+        cg.solve(rhs, sol);
+        const double solve = timer.stop();
+        ok = ok && cg.error() <= tol;
+
+        gsInfo << std::setw(8) << k << std::setw(14) << memory << std::setw(16) << cycle
+               << std::setw(8) << cg.iterations() << std::setw(14) << solve << "\n";
+    }
+    //! [Compare]
+
+    gsInfo << (ok ? "All solves converged.\n" : "Some solve failed!\n");
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,161 @@
+/** @file sumFactorization_example.cpp
+
+    @brief Throughput of element matrix computation by sum
+    factorization versus the standard quadrature loop, with respect
+    to the polynomial degree
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+// Element matrices by the standard loop over the quadrature nodes
+void denseElementMatrices(const gsBasis<> & basis, const gsMatrix<> & nodes,
+                          const gsMatrix<> & massCoefs, const gsMatrix<> & stiffCoefs,
+                          const gsMatrix<> & convCoefs,
+                          gsMatrix<> & mass, gsMatrix<> & stiff, gsMatrix<> & conv)
+{
+    std::vector<gsMatrix<> > ders;
+    basis.evalAllDers_into(nodes, 1, ders);
+    const index_t d = basis.dim(), N = ders[0].rows();
+    mass.setZero(N, N);
+    stiff.setZero(N, N);
+    conv.setZero(N, N);
+    for (index_t q = 0; q != nodes.cols(); ++q)
+    {
+        const gsAsConstMatrix<> grads(ders[1].col(q).data(), d, N);
+        const gsAsConstMatrix<> C(stiffCoefs.col(q).data(), d, d);
+        mass.noalias()  += massCoefs(0,q) * ders[0].col(q) * ders[0].col(q).transpose();
+        stiff.noalias() += grads.transpose() * C * grads;
+        conv.noalias()  += ders[0].col(q) * (convCoefs.col(q).transpose() * grads);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    //! [Parse command line]
+    index_t dim    = 3;
+    index_t maxDeg = 4;
+    index_t repeat = 10;
+
+    gsCmdLine cmd("Sum factorization of element matrices versus the polynomial degree.");
+    cmd.addInt( "d", "dim", "Dimension of the parameter domain (2 or 3)", dim );
+    cmd.addInt( "p", "degree", "Maximum polynomial degree", maxDeg );
+    cmd.addInt( "", "repeat", "Number of element matrices computed per measurement", repeat );
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+    //! [Parse command line]
+
+    GISMO_ENSURE(2==dim || 3==dim, "Only 2D and 3D domains are supported");
+
+    gsSumFactorization<real_t> sf;
+    gsMatrix<> massCoefs, stiffCoefs, convCoefs;
+    gsMatrix<> M, S, C, Msf, Ssf, Csf;
+    gsMatrix<> nodes;
+    gsVector<> weights;
+    gsStopwatch timer;
+    bool ok = true;
+
+    gsInfo << "Element matrices (mass+stiffness+convection) per second\n";
+    gsInfo << "degree" << std::setw(14) << "standard" << std::setw(14)
+           << "sumFact" << std::setw(10) << "speedup\n";
+    for (index_t p = 1; p <= maxDeg; ++p)
+    {
+        gsKnotVector<> kv(0, 1, 1, p + 1);
+        gsBasis<>::uPtr basis;
+        if (2 == dim)
+            basis = gsBasis<>::uPtr(new gsTensorBSplineBasis<2>(kv, kv));
+        else
+            basis = gsBasis<>::uPtr(new gsTensorBSplineBasis<3>(kv, kv, kv));
+
+        gsVector<index_t> numNodes = gsVector<index_t>::Constant(dim, p + 1);
+        gsGaussRule<> rule(numNodes);
+        gsBasis<>::domainIter domIt = basis->makeDomainIterator();
+        rule.mapTo(domIt->lowerCorner(), domIt->upperCorner(), nodes, weights);
+
+        // Coefficients of an SPD diffusion and of a velocity field
+        const index_t nq = nodes.cols();
+        massCoefs = weights.transpose();
+        stiffCoefs.resize(dim * dim, nq);
+        convCoefs.setRandom(dim, nq);
+        for (index_t q = 0; q != nq; ++q)
+        {
+            gsMatrix<> A;
+            A.setRandom(dim, dim);
+            A = A * A.transpose() + gsMatrix<>::Identity(dim, dim);
+            stiffCoefs.col(q) = weights[q] * gsAsConstMatrix<>(A.data(), dim * dim, 1);
+        }
+
+        timer.restart();
+        for (index_t r = 0; r < repeat; ++r)
+            denseElementMatrices(*basis, nodes, massCoefs, stiffCoefs, convCoefs, M, S, C);
+        const double tStd = timer.stop();
+
+        timer.restart();
+        for (index_t r = 0; r < repeat; ++r)
+        {
+            sf.compute(*basis, nodes, numNodes);
+            sf.mass_into(massCoefs, Msf);
+            sf.stiffness_into(stiffCoefs, Ssf);
+            sf.convection_into(convCoefs, Csf);
+        }
+        const double tSf = timer.stop();
+
+        const bool eq = (M - Msf).norm() <= 1e-10 * M.norm()
+            && (S - Ssf).norm() <= 1e-10 * S.norm()
+            && (C - Csf).norm() <= 1e-10 * C.norm();
+        ok = ok && eq;
+        gsInfo << std::setw(6) << p << std::setw(14) << repeat / tStd
+               << std::setw(14) << repeat / tSf << std::setw(10) << tStd / tSf
+               << (eq ? "" : "  (mismatch)") << "\n";
+    }
+
+    //! [Poisson assembly]
+    // Assembly on a curved domain through gsPoissonAssembler
+    gsMultiPatch<> mp;
+    if (2 == dim)
+        mp.addPatch(gsNurbsCreator<>::BSplineSquare());
+    else
+        mp.addPatch(gsNurbsCreator<>::BSplineCube());
+    mp.patch(0).degreeElevate(maxDeg - 1);
+    mp.patch(0).uniformRefine(1);
+    gsMatrix<> & cf = mp.patch(0).coefs();
+    cf.col(0).array() += 0.25 * cf.col(1).array().square();
+
+    gsMultiBasis<> mb(mp);
+    gsFunctionExpr<> f("1", dim);
+    gsConstantFunction<> zero(0.0, dim);
+    gsBoundaryConditions<> bc;
+    for (gsMultiPatch<>::const_biterator bit = mp.bBegin(); bit != mp.bEnd(); ++bit)
+        bc.addCondition(*bit, condition_type::dirichlet, &zero);
+
+    gsPoissonAssembler<> A(mp, mb, bc, f);
+    timer.restart();
+    A.assemble();
+    const double tStd = timer.stop();
+
+    gsPoissonAssembler<> Asf(mp, mb, bc, f);
+    Asf.options().setSwitch("sumFactorization", true);
+    timer.restart();
+    Asf.assemble();
+    const double tSf = timer.stop();
+
+    const bool eq = (A.matrix() - Asf.matrix()).norm() <= 1e-10 * A.matrix().norm()
+        && (A.rhs() - Asf.rhs()).norm() <= 1e-10 * A.rhs().norm();
+    ok = ok && eq;
+    gsInfo << "Poisson assembly, degree " << maxDeg << ", DoFs: " << A.numDofs()
+           << ", standard: " << tStd << "s, sumFact: " << tSf << "s"
+           << (eq ? "" : " (mismatch)") << "\n";
+    //! [Poisson assembly]
+
+    gsInfo << (ok ? "Sum factorization agrees with the standard assembly.\n"
+                  : "Mismatch between the element matrices!\n");
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
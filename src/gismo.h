@@ -151,10 +151,12 @@ namespace internal
 /* ----------- MultiGrid ----------- */
 #include <gsMultiGrid/gsMultiGrid.h>
 #include <gsMultiGrid/gsGridHierarchy.h>
+#include <gsMultiGrid/gsAlgebraicMultiGrid.h>
 
 /* ----------- Quadrature ----------- */
 #include <gsAssembler/gsQuadRule.h>
 #include <gsAssembler/gsQuadrature.h>
+#include <gsAssembler/gsSumFactorization.h>
 
 /* ----------- Assembler ----------- */
 #include <gsAssembler/gsAssembler.h>
@@ -173,10 +175,15 @@ namespace internal
 
 /* ----------- Solver ----------- */
 #include <gsSolver/gsLinearOperator.h>
+#include <gsSolver/gsKrylovKernels.h>
 #include <gsSolver/gsMinimalResidual.h>
 #include <gsSolver/gsGMRes.h>
+#include <gsSolver/gsBlockGMRes.h>
 #include <gsSolver/gsGradientMethod.h>
 #include <gsSolver/gsConjugateGradient.h>
+#include <gsSolver/gsPipelinedConjugateGradient.h>
+#include <gsSolver/gsSStepConjugateGradient.h>
+#include <gsSolver/gsBlockConjugateGradient.h>
 #include <gsSolver/gsBiCgStab.h>
 #include <gsSolver/gsPreconditioner.h>
 #include <gsSolver/gsAdditiveOp.h>
@@ -184,7 +191,10 @@ namespace internal
 #include <gsSolver/gsCompositePrecOp.h>
 #include <gsSolver/gsProductOp.h>
 #include <gsSolver/gsSimplePreconditioners.h>
+#include <gsSolver/gsIncompleteLUkOp.h>
 #include <gsSolver/gsSumOp.h>
+#include <gsSolver/gsMpiSumOp.h>
+#include <gsSolver/gsDistributedMatrixOp.h>
 #include <gsSolver/gsKroneckerOp.h>
 #include <gsSolver/gsPatchPreconditionersCreator.h>
 #include <gsSolver/gsLanczosMatrix.h>
@@ -204,12 +214,17 @@ namespace internal
 #include <gsIO/gsWriteParaview.h>
 #include <gsIO/gsParaviewCollection.h>
 #include <gsIO/gsParaviewDataSet.h>
+#include <gsIO/gsVtkDataArray.h>
 #include <gsIO/gsReadFile.h>
 #include <gsUtils/gsPointGrid.h>
 #include <gsIO/gsXmlUtils.h>
 
 /* ----------- Parallel ----------- */
 #include <gsParallel/gsMpi.h>
+#include <gsParallel/gsHaloExchange.h>
+#include <gsParallel/gsDistributedDofMapper.h>
+#include <gsParallel/gsDistributedSparseMatrix.h>
+#include <gsParallel/gsPatchPartitioner.h>
 
 /* ----------- Utilities ----------- */
 //#include <gsUtils/gsUtils.h> - in gsForwardDeclarations.h
@@ -673,6 +673,11 @@ void gsAssembler<T>::apply(ElementVisitor & visitor,
 
     const gsBasisRefs<T> bases(m_bases, patchIndex);
 
+    // Elements of the same color can be pushed without locking
+    const bool colored = boundary::none == side && m_system.hasPattern()
+        && accumulation::colored == m_options.askInt("accumulation", accumulation::critical);
+    const gsElementColoring<T> & coloring = m_system.coloring();
+
 #pragma omp parallel
 {
     gsQuadRule<T> quRule ; // Quadrature rule
@@ -694,28 +699,53 @@ void gsAssembler<T>::apply(ElementVisitor & visitor,
 
     const gsGeometry<T> & patch = m_pde_ptr->patches()[patchIndex];
 
-    // Initialize domain element iterator -- using unknown 0
-    typename gsBasis<T>::domainIter domIt = bases[0].makeDomainIterator(side);
+    if (colored)
+    {
+        typename gsElementColoring<T>::cursor cur;
+        for (index_t c = 0; c != coloring.numColors(); ++c)
+        {
+            const std::vector<typename gsElementColoring<T>::chunk> & chunks = coloring.chunks(c);
+            // Implicit barrier at the end of every color
+#           pragma omp for schedule(dynamic,1)
+            for (index_t k = 0; k < static_cast<index_t>(chunks.size()); ++k)
+            {
+                if (chunks[k].patch != static_cast<index_t>(patchIndex)) continue;
+                for (index_t e = chunks[k].begin; e != chunks[k].end; ++e)
+                {
+                    cur.moveTo(bases[0], patchIndex, coloring.element(e));
+                    quRule.mapTo( cur.it->lowerCorner(), cur.it->upperCorner(), quNodes, quWeights );
+                    visitor_.evaluate(bases, patch, quNodes);
+                    visitor_.assemble(*cur.it, quWeights);
+                    visitor_.localToGlobal(patchIndex, m_ddof, m_system);
+                }
+            }
+        }
+    }
+    else
+    {
+        // Initialize domain element iterator -- using unknown 0
+        typename gsBasis<T>::domainIter domIt = bases[0].makeDomainIterator(side);
 
-    // Start iteration over elements
+        // Start iteration over elements
 #ifdef _OPENMP
-    for ( domIt->next(tid); domIt->good(); domIt->next(nt) )
+        for ( domIt->next(tid); domIt->good(); domIt->next(nt) )
 #else
-    for (; domIt->good(); domIt->next() )
+        for (; domIt->good(); domIt->next() )
 #endif
-    {
-        // Map the Quadrature rule to the element
-        quRule.mapTo( domIt->lowerCorner(), domIt->upperCorner(), quNodes, quWeights );
+        {
+            // Map the Quadrature rule to the element
+            quRule.mapTo( domIt->lowerCorner(), domIt->upperCorner(), quNodes, quWeights );
 
-        // Perform required evaluations on the quadrature nodes
-        visitor_.evaluate(bases, patch, quNodes);
+            // Perform required evaluations on the quadrature nodes
+            visitor_.evaluate(bases, patch, quNodes);
 
-        // Assemble on element
-        visitor_.assemble(*domIt, quWeights);
+            // Assemble on element
+            visitor_.assemble(*domIt, quWeights);
 
-        // Push to global matrix and right-hand side vector
+            // Push to global matrix and right-hand side vector
 #pragma omp critical(localToGlobal)
-        visitor_.localToGlobal(patchIndex, m_ddof, m_system); // omp_locks inside
+            visitor_.localToGlobal(patchIndex, m_ddof, m_system); // omp_locks inside
+        }
     }
 }//omp parallel
 
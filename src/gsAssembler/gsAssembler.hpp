@@ -38,6 +38,9 @@ gsOptionList gsAssembler<T>::defaultOptions()
     opt.addReal("bdA", "Estimated nonzeros per column of the matrix: bdA*deg + bdB", 2.0  );
     opt.addInt ("bdB", "Estimated nonzeros per column of the matrix: bdA*deg + bdB", 1    );
     opt.addReal("bdO", "Overhead of sparse mem. allocation: (1+bdO)(bdA*deg + bdB) [0..1]", 0.333);
+    opt.addSwitch("exactPattern", "Compute the exact sparsity pattern once and keep it for repeated assemblies", false);
+    opt.addInt ("accumulation", "Accumulation of element contributions in parallel assembly: (0) critical sections; (2) element coloring, using the exact sparsity pattern", accumulation::critical);
+    opt.addSwitch("sumFactorization", "Compute element matrices of tensor-product bases by sum factorization, where supported by the visitor", false);
     return opt;
 }
 
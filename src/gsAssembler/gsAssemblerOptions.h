@@ -68,6 +68,27 @@ struct iFace
 
 };
 
+struct accumulation
+{
+    enum strategy
+    {
+        /// All threads write directly into the global system; every
+        /// update is guarded by a critical section.
+        critical    = 0,
+
+        /// Every thread accumulates its contributions into a private
+        /// triplet buffer and right-hand side, which are merged into
+        /// the global system once at the end of the assembly.
+        threadLocal = 1,
+
+        /// The elements are grouped in colors which share no DoFs
+        /// (see gsElementColoring). The colors are assembled one after
+        /// the other, the elements of each color concurrently and
+        /// without synchronization, into a precomputed sparsity pattern.
+        colored     = 2
+    };
+};
+
 /*
     enum iFaceTopology
     {
@@ -0,0 +1,256 @@
+/** @file gsBasisTableCache.h
+
+    @brief Reuses the values and derivatives of B-spline bases at the
+    quadrature nodes of translation-equivalent elements
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsNurbs/gsTensorBSplineBasis.h>
+
+namespace gismo
+{
+
+/**
+   @brief Cache of basis tables (values and derivatives of the active
+   functions at the evaluation points) of tensor-product B-spline bases
+
+   Two elements are translation-equivalent if, in every direction, the
+   knots which determine the active functions of the element (p knots
+   on either side of the knot span) have the same distances from the
+   left end of the span, and the evaluation points have the same
+   offsets from it. The active functions of such elements are
+   translates of each other, therefore their tables at the points are
+   identical; only the indices of the active functions differ. On a
+   uniform knot vector all interior elements are equivalent, together
+   with a few classes of elements near the boundary.
+
+   compute() evaluates a basis on a new class of elements and stores
+   the tables. For every further element of the same class the tables
+   are copied, and the active functions are obtained from the knot
+   span. Functions other than (non-periodic) tensor-product B-spline
+   bases, and points which do not lie in a single element, are not
+   handled, and the caller evaluates them as usual.
+
+   The cache is used by gsExprAssembler when the option
+   "cacheBasisTables" is set. One cache is needed per thread.
+
+   \ingroup Assembler
+*/
+template<class T>
+class gsBasisTableCache
+{
+public:
+
+    /// Constructs a cache which stores the tables of at most \a
+    /// maxEntries classes of elements, and distinguishes at most \a
+    /// maxShapes univariate element classes. Beyond these limits the
+    /// functions are evaluated without caching.
+    explicit gsBasisTableCache(const size_t maxEntries = 512,
+                               const size_t maxShapes  = 64)
+    : m_maxEntries(maxEntries), m_maxShapes(maxShapes), m_hits(0), m_misses(0)
+    { }
+
+    /// Removes all entries
+    void clear()
+    {
+        m_tables.clear();
+        m_shapes.clear();
+        m_hits = m_misses = 0;
+    }
+
+    /// Number of evaluations served from the cache
+    size_t hits() const { return m_hits; }
+
+    /// Number of evaluations which created a new entry
+    size_t misses() const { return m_misses; }
+
+    /**
+       @brief Computes the data \a out of \a func at \a points, as
+       gsFunctionSet::compute does, using the stored tables if
+       possible
+
+       @return false if the cache does not apply, in which case \a out
+       is not touched
+     */
+    bool compute(const gsFunctionSet<T> & func, const gsMatrix<T> & points,
+                 gsFuncData<T> & out)
+    {
+        const unsigned flags = out.flags;
+        const int md = out.maxDeriv();
+        if ( md < 0 || 0 == points.cols() ||
+             ( (flags & NEED_ACTIVE) && !(flags & SAME_ELEMENT) ) )
+            return false;
+
+        // Univariate components
+        const short_t d = static_cast<short_t>(points.rows());
+        const gsTensorBSplineBasis<1,T> * comp[4];
+        switch (d)
+        {
+        case 1: comp[0] = dynamic_cast<const gsTensorBSplineBasis<1,T>*>(&func); break;
+        case 2: if (!getComponents<2>(func, comp)) return false; break;
+        case 3: if (!getComponents<3>(func, comp)) return false; break;
+        case 4: if (!getComponents<4>(func, comp)) return false; break;
+        default: return false;
+        }
+        if (NULL == comp[0]) return false;
+
+        // Key: derivatives, laplacians and class of every direction
+        m_key.resize(2 + d);
+        m_key[0] = md;
+        m_key[1] = (flags & NEED_LAPLACIAN) ? 1 : 0;
+        index_t first[4];
+        for (short_t k = 0; k != d; ++k)
+        {
+            const index_t s = shape(*comp[k], points, k, first[k]);
+            if (-1 == s) return false;
+            m_key[2+k] = s;
+        }
+
+        typename TableMap::iterator it = m_tables.find(m_key);
+        if (m_tables.end() == it)
+        {
+            func.compute(points, out);
+            ++m_misses;
+            if (m_tables.size() < m_maxEntries)
+            {
+                entry & e = m_tables[m_key];
+                e.values.assign(out.values.begin(), out.values.begin() + md + 1);
+                if (flags & NEED_LAPLACIAN)
+                    e.laplacians = out.laplacians;
+            }
+            return true;
+        }
+        ++m_hits;
+
+        out.dim = func.dimensions();
+        out.values.resize(md + 1);
+        for (int i = 0; i <= md; ++i)
+            out.values[i] = it->second.values[i];
+        if (flags & NEED_LAPLACIAN)
+            out.laplacians = it->second.laplacians;
+
+        if (flags & NEED_ACTIVE)
+        {
+            // Tensor indices first[k]+i_k, with i_0 running fastest
+            index_t na = 1;
+            for (short_t k = 0; k != d; ++k)
+                na *= comp[k]->degree() + 1;
+            out.actives.resize(na, 1);
+            index_t base = 0, stride = 1;
+            for (short_t k = 0; k != d; ++k)
+            {
+                base   += first[k] * stride;
+                stride *= comp[k]->size();
+            }
+            index_t r = 0;
+            activeIndices(comp, d - 1, base, out.actives, r);
+        }
+        return true;
+    }
+
+private:
+
+    template<short_t d>
+    static bool getComponents(const gsFunctionSet<T> & func,
+                              const gsTensorBSplineBasis<1,T> * comp[])
+    {
+        const gsTensorBSplineBasis<d,T> * tb =
+            dynamic_cast<const gsTensorBSplineBasis<d,T>*>(&func);
+        if (NULL == tb) return false;
+        for (short_t k = 0; k != d; ++k)
+            comp[k] = &tb->component(k);
+        return true;
+    }
+
+    // Writes the indices of the active functions recursively, last
+    // direction outermost
+    static void activeIndices(const gsTensorBSplineBasis<1,T> * const comp[],
+                              const short_t k, const index_t base,
+                              gsMatrix<index_t> & actives, index_t & r)
+    {
+        index_t stride = 1;
+        for (short_t j = 0; j != k; ++j)
+            stride *= comp[j]->size();
+        for (index_t i = 0; i <= comp[k]->degree(); ++i)
+        {
+            if (0 == k)
+                actives(r++, 0) = base + i;
+            else
+                activeIndices(comp, k - 1, base + i * stride, actives, r);
+        }
+    }
+
+    // Returns the class of the univariate element containing the
+    // coordinates \a k of the points \a u, and the index of its first
+    // active function, or -1 if they do not lie in a single element
+    index_t shape(const gsTensorBSplineBasis<1,T> & basis,
+                  const gsMatrix<T> & u, const short_t k, index_t & first)
+    {
+        if (basis.isPeriodic()) return -1;
+
+        const gsKnotVector<T> & kv = basis.knots();
+        const index_t p = basis.degree();
+        if ( u(k,0) < *(kv.begin() + p) || u(k,0) > *(kv.end() - p - 1) )
+            return -1;
+        const typename gsKnotVector<T>::iterator span = kv.iFind( u(k,0) );
+        first = (span - kv.begin()) - p;
+        if ( first < 0 || span + p + 1 >= kv.end() ) return -1;
+
+        const T a = *span, h = *(span+1) - a;
+        for (index_t q = 1; q < u.cols(); ++q)
+            if ( u(k,q) < a || u(k,q) > a + h ) return -1;
+
+        // Relative knots and points
+        m_shape.resize(2 * p + 2 + u.cols());
+        for (index_t j = 0; j != 2 * p + 2; ++j)
+            m_shape[j] = *(span - p + j) - a;
+        for (index_t q = 0; q != u.cols(); ++q)
+            m_shape[2 * p + 2 + q] = u(k,q) - a;
+
+        const T tol = 1000 * std::numeric_limits<T>::epsilon() * (math::abs(a) + h);
+        for (size_t s = 0; s != m_shapes.size(); ++s)
+        {
+            const std::vector<T> & c = m_shapes[s];
+            if (c.size() != m_shape.size()) continue;
+            size_t j = 0;
+            while (j != c.size() && math::abs(c[j] - m_shape[j]) <= tol) ++j;
+            if (j == c.size()) return static_cast<index_t>(s);
+        }
+        if (m_shapes.size() == m_maxShapes) return -1;
+        m_shapes.push_back(m_shape);
+        return static_cast<index_t>(m_shapes.size() - 1);
+    }
+
+private:
+
+    struct entry
+    {
+        std::vector<gsMatrix<T> > values;
+        gsMatrix<T> laplacians;
+    };
+    typedef std::map<std::vector<index_t>, entry> TableMap;
+
+    size_t m_maxEntries, m_maxShapes;
+    size_t m_hits, m_misses;
+
+    // Tables of every class of elements
+    TableMap m_tables;
+
+    // Relative knots and points of the univariate element classes
+    std::vector<std::vector<T> > m_shapes;
+
+    // Workspace
+    std::vector<index_t> m_key;
+    std::vector<T> m_shape;
+};
+
+} // namespace gismo
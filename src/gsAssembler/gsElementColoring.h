@@ -0,0 +1,212 @@
+/** @file gsElementColoring.h
+
+    @brief Coloring of the elements of a multi-patch mesh for
+    race-free parallel assembly
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsAssembler/gsElementScheduler.h>
+
+namespace gismo
+{
+
+/**
+   @brief Groups the elements of a (multi-patch) mesh into colors,
+   such that no two elements of the same color share a degree of
+   freedom.
+
+   The elements are added one by one, in the order of the domain
+   iterator of each patch, together with the global indices of the
+   DoFs they write to (typically the free test functions which are
+   active on the element). A greedy first-fit coloring is applied on
+   the fly. The elements of one color can be assembled concurrently
+   without any synchronization, provided that the global matrix does
+   not change its structure (see gsSparsityPattern).
+
+   Every color is split into chunks of consecutive elements of the
+   same patch, which are the work items of a dynamically scheduled
+   parallel loop. This balances uneven (e.g. hierarchical) meshes.
+
+   \ingroup Assembler
+*/
+template<class T>
+class gsElementColoring
+{
+public:
+
+    typedef typename gsBasis<T>::domainIter domainIter;
+
+    /// A range [begin,end) of elements of one color, all belonging to \a patch
+    struct chunk
+    {
+        chunk(index_t _patch, index_t _begin, index_t _end)
+        : patch(_patch), begin(_begin), end(_end) { }
+        index_t patch, begin, end;
+    };
+
+    /// Helper which positions a (thread-private) domain iterator on
+    /// a given element of a patch
+    typedef typename gsElementScheduler<T>::cursor cursor;
+
+public:
+
+    gsElementColoring() { }
+
+    /// Removes all elements and colors
+    void clear()
+    {
+        m_color.clear();
+        m_start.clear();
+        m_dofColors.clear();
+        m_mark.clear();
+        m_elements.clear();
+        m_chunks.clear();
+    }
+
+    /// Returns true if no coloring is stored
+    bool empty() const { return m_chunks.empty(); }
+
+    /// Number of colors
+    index_t numColors() const { return static_cast<index_t>(m_chunks.size()); }
+
+    /// Number of elements of color \a c
+    index_t numElements(const index_t c) const
+    {
+        return m_chunks[c].empty() ? 0 :
+            m_chunks[c].back().end - m_chunks[c].front().begin;
+    }
+
+    /// Returns the chunks of color \a c
+    const std::vector<chunk> & chunks(const index_t c) const
+    { return m_chunks[c]; }
+
+    /// Returns the position (in iteration order of its patch) of the
+    /// \a k-th element in the chunk lists
+    index_t element(const index_t k) const { return m_elements[k]; }
+
+    /**
+       @brief Colors the next element of patch \a patch
+
+       The elements of each patch must be added in iteration order,
+       and the patches in increasing order.
+       @param patch index of the patch of the element
+       @param dofs global indices of the DoFs written by the element;
+       negative values are ignored
+     */
+    template<class Container>
+    void add(const index_t patch, const Container & dofs)
+    {
+        if (static_cast<index_t>(m_start.size()) <= patch)
+            m_start.resize(patch + 1, static_cast<index_t>(m_color.size()));
+        const index_t e = static_cast<index_t>(m_color.size());
+
+        // Mark the colors of all elements sharing a DoF
+        for (index_t i = 0; i != static_cast<index_t>(dofs.size()); ++i)
+        {
+            const index_t d = dofs[i];
+            if (d < 0) continue;
+            if (static_cast<index_t>(m_dofColors.size()) <= d)
+                m_dofColors.resize(d + 1);
+            const std::vector<index_t> & used = m_dofColors[d];
+            for (size_t k = 0; k != used.size(); ++k)
+                m_mark[used[k]] = e;
+        }
+
+        // First-fit
+        index_t c = 0;
+        while (c != static_cast<index_t>(m_mark.size()) && e == m_mark[c]) ++c;
+        if (c == static_cast<index_t>(m_mark.size()))
+            m_mark.push_back(-1);
+        m_color.push_back(c);
+
+        for (index_t i = 0; i != static_cast<index_t>(dofs.size()); ++i)
+            if (dofs[i] >= 0)
+                m_dofColors[dofs[i]].push_back(c);
+    }
+
+    /**
+       @brief Finishes the coloring and splits the colors into chunks
+
+       @param chunkSize maximum number of elements in a chunk; if zero,
+       it is chosen such that every thread gets several chunks of
+       each color
+     */
+    void finalize(index_t chunkSize = 0)
+    {
+        const index_t nc = static_cast<index_t>(m_mark.size());
+        const index_t ne = static_cast<index_t>(m_color.size());
+        m_start.push_back(ne);
+
+        // Counting sort by color, keeping the iteration order
+        std::vector<index_t> offset(nc + 1, 0);
+        for (index_t e = 0; e != ne; ++e)
+            ++offset[m_color[e] + 1];
+        for (index_t c = 0; c != nc; ++c)
+            offset[c + 1] += offset[c];
+
+        std::vector<index_t> pos(offset.begin(), offset.end() - 1);
+        std::vector<index_t> patchOf(ne);
+        m_elements.resize(ne);
+        for (index_t p = 0; p + 1 < static_cast<index_t>(m_start.size()); ++p)
+            for (index_t e = m_start[p]; e != m_start[p + 1]; ++e)
+            {
+                const index_t k = pos[m_color[e]]++;
+                m_elements[k] = e - m_start[p];
+                patchOf[k]    = p;
+            }
+
+#       ifdef _OPENMP
+        const index_t nt = omp_get_max_threads();
+#       else
+        const index_t nt = 1;
+#       endif
+
+        m_chunks.clear();
+        m_chunks.resize(nc);
+        for (index_t c = 0; c != nc; ++c)
+        {
+            const index_t cs = ( chunkSize > 0 ? chunkSize : math::max<index_t>(1,
+                                 math::min<index_t>(64, (offset[c + 1] - offset[c]) / (4 * nt))) );
+            for (index_t k = offset[c]; k != offset[c + 1];)
+            {
+                index_t l = k + 1;
+                while (l != offset[c + 1] && l - k < cs && patchOf[l] == patchOf[k]) ++l;
+                m_chunks[c].push_back(chunk(patchOf[k], k, l));
+                k = l;
+            }
+        }
+
+        // Release the coloring workspace
+        std::vector<index_t>().swap(m_color);
+        std::vector<index_t>().swap(m_start);
+        std::vector<std::vector<index_t> >().swap(m_dofColors);
+        std::vector<index_t>().swap(m_mark);
+    }
+
+private:
+
+    // Workspace of the coloring: color of every element, first
+    // element of every patch, colors touching every DoF, and marks
+    // of the forbidden colors
+    std::vector<index_t> m_color;
+    std::vector<index_t> m_start;
+    std::vector<std::vector<index_t> > m_dofColors;
+    std::vector<index_t> m_mark;
+
+    // Patch-local element positions, grouped by color and patch
+    std::vector<index_t> m_elements;
+
+    // Chunks of every color
+    std::vector<std::vector<chunk> > m_chunks;
+};
+
+} // namespace gismo
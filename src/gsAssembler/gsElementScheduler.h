@@ -0,0 +1,227 @@
+/** @file gsElementScheduler.h
+
+    @brief Splits the elements of several domains (patches, sides or
+    interfaces) into balanced work items for parallel loops
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsAssembler/gsQuadrature.h>
+
+namespace gismo
+{
+
+/**
+   @brief Work distribution over the elements of a list of domains
+
+   Every domain (a patch, a boundary side or an interface) is
+   registered with its number of elements and the estimated cost of
+   one element. The elements are then split into work items of
+   consecutive elements of one domain, of roughly equal cost, such
+   that every thread receives several items. The items are ordered by
+   decreasing cost, so that a dynamically scheduled loop over them
+   balances many small patches as well as a few large ones.
+
+   Example of usage:
+   \code
+   gsElementScheduler<T> sched;
+   for (size_t p = 0; p != mb.nBases(); ++p)
+       sched.addDomain(mb.basis(p).numElements(),
+                       gsElementScheduler<T>::elementCost(mb.basis(p), opt));
+   sched.finalize();
+   #pragma omp parallel
+   {
+       typename gsElementScheduler<T>::cursor cur;
+       #pragma omp for schedule(dynamic,1)
+       for (index_t k = 0; k < sched.size(); ++k)
+           for (index_t e = sched[k].begin; e != sched[k].end; ++e)
+           {
+               cur.moveTo(mb.basis(sched[k].domain), sched[k].domain, e);
+               // work on element *cur.it
+           }
+   }
+   \endcode
+
+   \ingroup Assembler
+*/
+template<class T>
+class gsElementScheduler
+{
+public:
+
+    typedef typename gsBasis<T>::domainIter domainIter;
+
+    /// The elements [begin,end) of domain \a domain, in iteration order
+    struct workItem
+    {
+        workItem(index_t _domain, index_t _begin, index_t _end)
+        : domain(_domain), begin(_begin), end(_end) { }
+        index_t domain, begin, end;
+    };
+
+    /// Helper which positions a (thread-private) domain iterator on
+    /// a given element of a domain
+    struct cursor
+    {
+        cursor() : domain(-1), pos(0) { }
+
+        /// Moves to the element with position \a target (in iteration
+        /// order) of \a basis, restricted to \a side, which is the
+        /// basis of domain \a _domain. The iterator is re-created if
+        /// needed, in which case true is returned and the caller must
+        /// re-bind it.
+        bool moveTo(const gsBasis<T> & basis, const index_t _domain,
+                    const index_t target, const boxSide side = boundary::none)
+        {
+            const bool fresh = (_domain != domain || target < pos);
+            if (fresh)
+            {
+                it     = ( boundary::none == side ? basis.makeDomainIterator()
+                           : basis.makeDomainIterator(side) );
+                domain = _domain;
+                pos    = 0;
+            }
+            if (target != pos)
+            {
+                it->next(target - pos);
+                pos = target;
+            }
+            return fresh;
+        }
+
+        domainIter it;
+        index_t domain, pos;
+    };
+
+public:
+
+    gsElementScheduler() { m_offset.push_back(0); }
+
+    /// Registers a domain with \a numEl elements of cost \a cost each
+    void addDomain(const index_t numEl, const T cost = 1)
+    {
+        m_offset.push_back(m_offset.back() + numEl);
+        m_cost.push_back(cost);
+    }
+
+    /**
+       @brief Splits the domains into work items
+
+       @param nThreads number of threads sharing the work; if
+       negative, the maximum number of OpenMP threads is used
+       @param itemsPerThread targeted number of items per thread
+     */
+    void finalize(index_t nThreads = -1, const index_t itemsPerThread = 4)
+    {
+        if (nThreads < 1)
+        {
+#           ifdef _OPENMP
+            nThreads = omp_get_max_threads();
+#           else
+            nThreads = 1;
+#           endif
+        }
+
+        T total = 0;
+        for (index_t d = 0; d != numDomains(); ++d)
+            total += m_cost[d] * static_cast<T>(numElements(d));
+        const T target = total / static_cast<T>(nThreads * itemsPerThread);
+
+        m_items.clear();
+        std::vector<T> itemCost;
+        for (index_t d = 0; d != numDomains(); ++d)
+        {
+            const index_t ne = numElements(d);
+            if (0 == ne) continue;
+            // A single thread works on the whole domain if it is cheap
+            const index_t nItems = ( 1 == nThreads ? 1 : math::max<index_t>(1,
+                cast<T,index_t>(m_cost[d] * static_cast<T>(ne) / target + 0.5)) );
+            const index_t chunk  = (ne + nItems - 1) / nItems;
+            for (index_t b = 0; b < ne; b += chunk)
+            {
+                m_items.push_back(workItem(d, b, math::min<index_t>(ne, b + chunk)));
+                itemCost.push_back(m_cost[d] * static_cast<T>(m_items.back().end - b));
+            }
+        }
+
+        // Largest items first, for the dynamic scheduler
+        if (1 == nThreads) return;
+        std::vector<index_t> order(m_items.size());
+        for (size_t k = 0; k != order.size(); ++k)
+            order[k] = static_cast<index_t>(k);
+        std::stable_sort(order.begin(), order.end(), costGreater(itemCost));
+        std::vector<workItem> sorted;
+        sorted.reserve(m_items.size());
+        for (size_t k = 0; k != order.size(); ++k)
+            sorted.push_back(m_items[order[k]]);
+        m_items.swap(sorted);
+    }
+
+    /// Number of work items
+    index_t size() const { return static_cast<index_t>(m_items.size()); }
+
+    /// Returns the \a k-th work item
+    const workItem & operator[](const index_t k) const { return m_items[k]; }
+
+    /// Number of registered domains
+    index_t numDomains() const { return static_cast<index_t>(m_cost.size()); }
+
+    /// Number of elements of domain \a d
+    index_t numElements(const index_t d) const { return m_offset[d+1] - m_offset[d]; }
+
+    /// Global index of the first element of domain \a d (the
+    /// elements are numbered consecutively over all domains)
+    index_t offset(const index_t d) const { return m_offset[d]; }
+
+    /// Number of elements of \a basis, or of its side \a side
+    static index_t countElements(const gsBasis<T> & basis,
+                                 const boxSide side = boundary::none)
+    {
+        return static_cast<index_t>( boundary::none == side ? basis.numElements()
+                                     : basis.makeDomainIterator(side)->numElements() );
+    }
+
+    /// Estimates the cost of one element of \a basis (possibly on the
+    /// side direction \a fixDir) as the number of quadrature nodes
+    /// times the number of active functions
+    static T elementCost(const gsBasis<T> & basis, const gsOptionList & opt,
+                         const short_t fixDir = -1)
+    {
+        const index_t nq = gsQuadrature::numNodes(basis,
+                                                  opt.askReal("quA", 1.0),
+                                                  opt.askInt("quB", 1), fixDir).prod();
+        index_t na = 1;
+        for (short_t i = 0; i != basis.dim(); ++i)
+            na *= basis.degree(i) + 1;
+        return static_cast<T>(nq * na);
+    }
+
+private:
+
+    struct costGreater
+    {
+        explicit costGreater(const std::vector<T> & c) : cost(c) { }
+        bool operator()(const index_t a, const index_t b) const
+        { return cost[a] > cost[b]; }
+        const std::vector<T> & cost;
+    };
+
+private:
+
+    // Element offsets and cost per element of every domain
+    std::vector<index_t> m_offset;
+    std::vector<T>       m_cost;
+
+    // Work items, in order of decreasing cost
+    std::vector<workItem> m_items;
+};
+
+} // namespace gismo
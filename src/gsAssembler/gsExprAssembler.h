@@ -16,9 +16,14 @@
 #include <gsUtils/gsPointGrid.h>
 #include <gsAssembler/gsQuadrature.h>
 #include <gsAssembler/gsExprHelper.h>
+#include <gsAssembler/gsSparsityPattern.h>
+#include <gsAssembler/gsElementColoring.h>
+#include <gsAssembler/gsElementScheduler.h>
 
 #include <gsAssembler/gsCPPInterface.h>
 
+#include <gsSolver/gsLinearOperator.h>
+
 namespace gismo
 {
 
@@ -38,6 +43,12 @@ private:
     gsSparseMatrix<T> m_matrix;
     gsMatrix<T>       m_rhs;
 
+    // True if m_matrix holds the exact sparsity pattern of the system
+    bool m_hasPattern;
+
+    // Coloring of the integration elements w.r.t. the test DoFs
+    gsElementColoring<T> m_coloring;
+
     std::list<gsFeSpaceData<T> > m_sdata;
     std::vector<gsFeSpaceData<T>*> m_vrow;
     std::vector<gsFeSpaceData<T>*> m_vcol;
@@ -72,7 +83,7 @@ public:
     /// \param _cBlocks Number of spaces for solution variables
     gsExprAssembler(index_t _rBlocks = 1, index_t _cBlocks = 1)
     : m_exprdata(gsExprHelper<T>::make()), m_gmap(nullptr), m_options(defaultOptions()),
-      m_vrow(_rBlocks,nullptr), m_vcol(_cBlocks,nullptr)
+      m_hasPattern(false), m_vrow(_rBlocks,nullptr), m_vcol(_cBlocks,nullptr)
     { }
 
     // The copy constructor replicates the same environent but does
@@ -116,10 +127,12 @@ public:
     const gsSparseMatrix<T> & matrix() const { return m_matrix; }
 
     /// @brief Writes the resulting matrix in \a out. The internal matrix is moved.
-    void matrix_into(gsSparseMatrix<T> & out) { out = give(m_matrix); }
+    void matrix_into(gsSparseMatrix<T> & out)
+    { out = give(m_matrix); m_hasPattern = false; }
 
     EIGEN_STRONG_INLINE gsSparseMatrix<T> giveMatrix()
     {
+         m_hasPattern = false;
          gsSparseMatrix<T> rvo;
          rvo.swap(m_matrix);
          return rvo;
@@ -319,9 +332,14 @@ public:
         else
         {
             m_matrix = gsSparseMatrix<T>(numTestDofs(), numDofs());
+            m_hasPattern = false;
 
             if (0 == m_matrix.rows() || 0 == m_matrix.cols())
                 gsWarn << " No internal DOFs, zero sized system.\n";
+            else if (m_options.askSwitch("exactPattern", false) ||
+                     accumulation::colored ==
+                     m_options.askInt("accumulation", accumulation::critical))
+                computePattern();
             else {
                 // Pick up values from options
                 const T bdA = m_options.getReal("bdA");
@@ -340,6 +358,21 @@ public:
         }
     }
 
+    /**
+     * @brief Computes the exact sparsity pattern of the system
+     * matrix (symbolic assembly)
+     *
+     * Every test space is coupled with every trial space on each
+     * integration element. The matrix is then stored in compressed
+     * form with explicit zeros, and the numeric assembly only updates
+     * the existing entries (lock-free in parallel). The elements are
+     * also colored, for accumulation::colored.
+     */
+    void computePattern();
+
+    /// Returns true if the matrix holds a precomputed sparsity pattern
+    bool hasPattern() const { return m_hasPattern; }
+
     /// \brief Initializes the right-hand side vector only
     void initVector(const index_t numRhs = 1)
     {
@@ -401,8 +434,43 @@ public:
     template<class expr> void assembleJacobianIfc(const ifContainer & iFaces,
                                                   const expr residual, solution  u);
 
+    /// Matrix-free linear operator of a bilinear expression (see getMatrixFreeOp)
+    template<class E> class matrixFreeOp;
+
+    /**
+       \brief Returns a linear operator which applies the matrix of the
+       bilinear expression \a a without assembling it
+
+       Every application recomputes the element matrices on the fly,
+       therefore only vectors are stored. The operator acts on the
+       free DoFs, as the matrix assembled by assemble(a) does. It can
+       be used with the iterative solvers (gsConjugateGradient,
+       gsGMRes, ...) and as underlying operator of gsMultiGridOp. The
+       assembler (and the spaces and functions of \a a) must outlive
+       the operator.
+
+       \param cacheGeometry if true, the evaluated geometry maps
+       (Jacobians, measures, ...) at the quadrature nodes of every
+       element are stored at the first application and reused
+       afterwards
+    */
+    template<class E>
+    memory::unique_ptr<matrixFreeOp<E> > getMatrixFreeOp(const expr::_expr<E> & a,
+                                                         const bool cacheGeometry = false)
+    {
+        return memory::unique_ptr<matrixFreeOp<E> >(
+            new matrixFreeOp<E>(*this, static_cast<const E&>(a), cacheGeometry) );
+    }
+
 private:
 
+    // Applies the matrix of \a a to \a x and adds the result to \a
+    // y, or adds the diagonal of the matrix to \a y if x is null. If
+    // \a geoData is given, it holds the map data of every element
+    template<class E>
+    void _matrixFree(const E & a, const gsMatrix<T> * x, gsMatrix<T> & y,
+                     std::vector<std::vector<gsMapData<T> > > * geoData);
+
     void _blockDims(gsVector<index_t> & rowSizes,
                     gsVector<index_t> & colSizes)
     {
@@ -430,6 +498,29 @@ private:
     /// Called internally by the init* functions
     void resetDimensions();
 
+    // Writes the global indices of the basis functions of space \a s
+    // which are active at \a pt of \a patch; eliminated DoFs are
+    // marked by -1
+    void _freeActives(const gsFeSpaceData<T> & s, const index_t patch,
+                      const gsMatrix<T> & pt, gsMatrix<index_t> & act,
+                      std::vector<index_t> & result) const;
+
+    // Writes the global indices of the basis functions of space \a u
+    // which are active on the current element (in the order of the
+    // local matrices); eliminated DoFs are marked by -1
+    void _freeActives(const expr::gsFeSpace<T> & u, std::vector<index_t> & result) const
+    {
+        const gsMatrix<index_t> & act = u.data().actives;
+        const gsDofMapper & map = u.mapper();
+        result.resize(u.dim() * act.rows());
+        for (index_t c = 0; c != u.dim(); ++c)
+            for (index_t i = 0; i != act.rows(); ++i)
+            {
+                const index_t ii = map.index(act.at(i), u.data().patchId, c);
+                result[c * act.rows() + i] = ( map.is_free_index(ii) ? ii : -1 );
+            }
+    }
+
     // Prints the expression to a text stream
     struct __printExpr
     {
@@ -464,15 +555,160 @@ private:
         gsMatrix<T>         localMat;
         gsMatrix<T>         aux;
 
+        // Thread-private storage (used if accumulation::threadLocal)
+        gsSparseEntries<T> * m_entries;
+        gsMatrix<T>        * m_lrhs;
+
+        // Entries outside a precomputed sparsity pattern
+        gsSparseEntries<T> * m_overflow;
+
+        // No other thread writes to the same entries (colored assembly)
+        bool m_exclusive;
+
         _eval(gsSparseMatrix<T> & _matrix,
               gsMatrix<T>       & _rhs,
               const gsVector<>  & _quWeights)
         : m_matrix(_matrix), m_rhs(_rhs),
-          m_quWeights(_quWeights), m_elim(true)
+          m_quWeights(_quWeights), m_elim(true),
+          m_entries(nullptr), m_lrhs(nullptr), m_overflow(nullptr),
+          m_exclusive(false)
         { }
 
         void setElim(bool elim) {m_elim = elim;}
 
+        /// Redirects all contributions to the thread-private buffers
+        ///  entries and  rhs, which must be merged by the caller
+        void setLocalStorage(gsSparseEntries<T> & entries, gsMatrix<T> & rhs)
+        {
+            m_entries = &entries;
+            m_lrhs    = &rhs;
+        }
+
+        /// Writes matrix contributions in place, assuming that \a
+        /// m_matrix is compressed and holds the sparsity
+        /// pattern. Entries outside the pattern go to \a overflow
+        void setFixedPattern(gsSparseEntries<T> & overflow)
+        {
+            m_overflow = &overflow;
+        }
+
+        /// As setFixedPattern, but the caller guarantees that
+        /// concurrent elements share no test DoFs, therefore the
+        /// global matrix and right-hand side are updated directly
+        void setExclusive(gsSparseEntries<T> & overflow)
+        {
+            m_overflow  = &overflow;
+            m_lrhs      = &m_rhs;
+            m_exclusive = true;
+        }
+
+        /// Selects the accumulation of the calling thread according to
+        /// \a mode (see accumulation::strategy), using \a entries and
+        /// \a rhs as private storage
+        void setAccumulation(const index_t mode, const bool fixedPattern,
+                             gsSparseEntries<T> & entries, gsMatrix<T> & rhs)
+        {
+            if (accumulation::threadLocal == mode)
+            {
+                rhs.setZero(m_rhs.rows(), m_rhs.cols());
+                setLocalStorage(entries, rhs);
+            }
+            else if (fixedPattern)
+            {
+                if (accumulation::colored == mode)
+                    setExclusive(entries);
+                else
+                    setFixedPattern(entries);
+            }
+        }
+
+        /// Adds the private contributions of the calling thread to the
+        /// global system. Must be called by all threads of the team.
+        void mergeLocal(const bool failed)
+        {
+            if (m_entries)
+            {
+                if (failed) return;
+                // Each thread compresses its own triplets, then the partial
+                // systems are added to the global one
+                gsSparseMatrix<T> lMat(m_matrix.rows(), m_matrix.cols());
+                lMat.setFrom(*m_entries);
+                gsSparseEntries<T>().swap(*m_entries);
+#               pragma omp critical (acc_m_matrix)
+                {
+                    m_matrix += lMat;
+                    m_rhs    += *m_lrhs;
+                }
+            }
+            else if (m_overflow)
+            {
+                // All threads must be done writing into the pattern before
+                // it is extended by the entries that did not fit
+#               pragma omp barrier
+                if (0 != m_overflow->size() && !failed)
+                {
+                    gsSparseMatrix<T> lMat(m_matrix.rows(), m_matrix.cols());
+                    lMat.setFrom(*m_overflow);
+#                   pragma omp critical (acc_m_matrix)
+                    m_matrix += lMat;
+                }
+            }
+        }
+
+        inline void addToMatrix(const index_t ii, const index_t jj, const T val)
+        {
+            if (m_entries)
+                m_entries->add(ii, jj, val);
+            else if (m_overflow)
+            {
+                const index_t * inner = m_matrix.innerIndexPtr();
+                const index_t * last  = inner + m_matrix.outerIndexPtr()[jj+1];
+                const index_t * pos   =
+                    std::lower_bound(inner + m_matrix.outerIndexPtr()[jj], last, ii);
+                if (pos != last && *pos == ii)
+                {
+                    T & entry = m_matrix.valuePtr()[pos - inner];
+                    if (m_exclusive)
+                        entry += val;
+                    else
+                    {
+#                       pragma omp atomic
+                        entry += val;
+                    }
+                }
+                else
+                    m_overflow->add(ii, jj, val);
+            }
+            else
+            {
+#               pragma omp critical (acc_m_matrix)
+                m_matrix.coeffRef(ii, jj) += val;
+            }
+        }
+
+        inline void addToRhs(const index_t ii, const T val)
+        {
+            if (m_lrhs)
+                m_lrhs->at(ii) += val;
+            else
+            {
+#               pragma omp critical (acc_m_rhs)
+                m_rhs.at(ii) += val;
+            }
+        }
+
+        template <typename Derived>
+        inline void addToRhsRow(const index_t ii, const gsEigen::MatrixBase<Derived> & row)
+        {
+            if (m_lrhs)
+                m_lrhs->row(ii) += row;
+            else
+            {
+#               pragma omp critical (acc_m_rhs)
+                m_rhs.row(ii) += row;
+            }
+        }
+
         template <typename E> void operator() (const gismo::expr::_expr<E> & ee)
         {
             // ------- Compute  -------
@@ -604,16 +840,14 @@ private:
                                         // If matrix is symmetric, we could
                                         // store only lower triangular part
                                         //if ( (!symm) || jj <= ii )
-#                                       pragma omp critical (acc_m_matrix)
-                                        m_matrix.coeffRef(ii, jj) += localMat(rls+i,cls+j);
+                                        addToMatrix(ii, jj, localMat(rls+i,cls+j));
                                     }
                                     else if (elim) // colMap.is_boundary_index(jj) )
                                     {
                                         // Symmetric treatment of eliminated BCs
                                         // GISMO_ASSERT(1==m_rhs.cols(), "-");
-#                                       pragma omp critical (acc_m_rhs)
-                                        m_rhs.at(ii) -= localMat(rls+i,cls+j) *
-                                            fixedDofs.at(colMap.global_to_bindex(jj));
+                                        addToRhs(ii, - localMat(rls+i,cls+j) *
+                                                 fixedDofs.at(colMap.global_to_bindex(jj)) );
                                     }
                                 }
                             }
@@ -621,8 +855,7 @@ private:
                         else
                         {
                             //The right-hand side can have more than one columns
-#                           pragma omp critical (acc_m_rhs)
-                            m_rhs.row(ii) += localMat.row(rls+i);
+                            addToRhsRow(ii, localMat.row(rls+i));
                         }
                     }
                 }
@@ -633,6 +866,63 @@ private:
 
 }; // gsExprAssembler
 
+/**
+   \brief Linear operator applying the matrix of a bilinear expression
+   of a gsExprAssembler element by element, without assembling it
+
+   Created by gsExprAssembler::getMatrixFreeOp.
+*/
+template<class T>
+template<class E>
+class gsExprAssembler<T>::matrixFreeOp : public gsLinearOperator<T>
+{
+public:
+
+    /// Shared pointer for matrixFreeOp
+    typedef memory::shared_ptr<matrixFreeOp> Ptr;
+
+    /// Unique pointer for matrixFreeOp
+    typedef memory::unique_ptr<matrixFreeOp> uPtr;
+
+    matrixFreeOp(gsExprAssembler & assembler, const E & a, const bool cacheGeometry)
+    : m_assembler(assembler), m_expr(a), m_cacheGeometry(cacheGeometry)
+    {
+        GISMO_ENSURE(E::isMatrix(), "Expecting a bilinear expression");
+    }
+
+    void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
+    {
+        GISMO_ASSERT(input.rows() == cols(), "Wrong input size");
+        x.setZero(rows(), input.cols());
+        m_assembler._matrixFree(m_expr, &input, x, m_cacheGeometry ? &m_geoData : nullptr);
+    }
+
+    index_t rows() const { return m_assembler.numTestDofs(); }
+
+    index_t cols() const { return m_assembler.numDofs(); }
+
+    /// Computes the diagonal of the (square) operator, e.g. for a
+    /// Jacobi preconditioner or smoother
+    void diagonal_into(gsMatrix<T> & result) const
+    {
+        GISMO_ASSERT(rows() == cols(), "The operator is not square");
+        result.setZero(rows(), 1);
+        m_assembler._matrixFree(m_expr, nullptr, result, m_cacheGeometry ? &m_geoData : nullptr);
+    }
+
+    /// Discards the cached geometry data, e.g. after a change of
+    /// the geometry map or of the integration elements
+    void clearCache() { m_geoData.clear(); }
+
+private:
+    gsExprAssembler & m_assembler;
+    E m_expr;
+    bool m_cacheGeometry;
+
+    // Geometry map data at the quadrature nodes of every element
+    mutable std::vector<std::vector<gsMapData<T> > > m_geoData;
+};
+
 template<class T>
 gsOptionList gsExprAssembler<T>::defaultOptions()
 {
@@ -648,6 +938,9 @@ gsOptionList gsExprAssembler<T>::defaultOptions()
     opt.addSwitch("overInt", "Apply over-integration on boundary elements or not?", false);
     opt.addSwitch("flipSide", "Flip side of interface where integration is performed.", false);
     opt.addSwitch("movingInterface", "Used in interface assembly when interface is not stationary.", false);
+    opt.addInt ("accumulation", "Accumulation of element contributions in parallel assembly: (0) critical sections; (1) thread-local buffers, merged at the end; (2) element coloring, using the exact sparsity pattern", accumulation::critical);
+    opt.addSwitch("exactPattern", "Compute the exact sparsity pattern in initSystem() and keep it for repeated assemblies", false);
+    opt.addSwitch("cacheBasisTables", "Reuse the basis values at the quadrature nodes of translation-equivalent elements of tensor B-spline bases", false);
     return opt;
 
     /// dirichlet treatment? elimination ????
@@ -739,6 +1032,60 @@ template<class T> void gsExprAssembler<T>::resetDimensions()
     }
 }
 
+template<class T> void gsExprAssembler<T>::computePattern()
+{
+    const gsMultiBasis<T> & mesh = m_exprdata->multiBasis();
+    gsSparsityPattern sp(numTestDofs(), numDofs());
+
+    gsMatrix<T> center;
+    gsMatrix<index_t> act;
+    std::vector<std::vector<index_t> > rInd(m_vrow.size()), cInd(m_vcol.size());
+    std::vector<index_t> rAll;
+    m_coloring.clear();
+
+    for (size_t p = 0; p != mesh.nBases(); ++p)
+    {
+        typename gsBasis<T>::domainIter domIt = mesh.basis(p).makeDomainIterator();
+        for (; domIt->good(); domIt->next() )
+        {
+            center = domIt->centerPoint();
+            // Global indices of the actives on the element, -1 if not free
+            for (size_t r = 0; r != m_vrow.size(); ++r)
+                _freeActives(*m_vrow[r], p, center, act, rInd[r]);
+            for (size_t c = 0; c != m_vcol.size(); ++c)
+                _freeActives(*m_vcol[c], p, center, act, cInd[c]);
+
+            rAll.clear();
+            for (size_t r = 0; r != m_vrow.size(); ++r)
+            {
+                for (size_t c = 0; c != m_vcol.size(); ++c)
+                    sp.add(rInd[r], cInd[c]);
+                rAll.insert(rAll.end(), rInd[r].begin(), rInd[r].end());
+            }
+            m_coloring.add(p, rAll);
+        }
+    }
+
+    sp.into(m_matrix);
+    m_coloring.finalize();
+    m_hasPattern = true;
+}
+
+template<class T> void
+gsExprAssembler<T>::_freeActives(const gsFeSpaceData<T> & s, const index_t patch,
+                                 const gsMatrix<T> & pt, gsMatrix<index_t> & act,
+                                 std::vector<index_t> & result) const
+{
+    s.fs->piece(patch).active_into(pt, act);
+    result.resize(s.dim * act.rows());
+    for (index_t d = 0; d != s.dim; ++d)
+        for (index_t i = 0; i != act.rows(); ++i)
+        {
+            const index_t ii = s.mapper.index(act.at(i), patch, d);
+            result[d * act.rows() + i] = (s.mapper.is_free_index(ii) ? ii : -1);
+        }
+}
+
 template<size_t I, class op, typename... Ts>
 void op_tuple_impl (op & _op, const std::tuple<Ts...> &tuple)
 {
@@ -757,13 +1104,34 @@ void gsExprAssembler<T>::assemble(const expr &... args)
 {
     GISMO_ASSERT(matrix().cols()==numDofs(), "System not initialized, matrix().cols() = "<<matrix().cols()<<"!="<<numDofs()<<" = numDofs()");
 
+    const index_t accMode = m_options.askInt("accumulation", accumulation::critical);
+    const bool colored = (accumulation::colored == accMode);
+    if (colored && !m_hasPattern)
+    {
+        // Switch to the exact pattern, keeping the current values
+        gsSparseMatrix<T> cur;
+        cur.swap(m_matrix);
+        computePattern();
+        if (0 != cur.nonZeros())
+            m_matrix += cur;
+    }
+
+    // Work items of (patch, element range), balanced by their cost
+    const gsMultiBasis<T> & mesh = m_exprdata->multiBasis();
+    gsElementScheduler<T> sched;
+    if (!colored)
+    {
+        for (size_t p = 0; p != mesh.nBases(); ++p)
+            sched.addDomain(gsElementScheduler<T>::countElements(mesh.basis(p)),
+                            gsElementScheduler<T>::elementCost(mesh.basis(p), m_options));
+        sched.finalize();
+    }
+
     bool failed = false;
+    m_exprdata->setBasisTableCache(m_options.askSwitch("cacheBasisTables", false));
+
 #pragma omp parallel shared(failed)
 {
-#   ifdef _OPENMP
-    const int tid = omp_get_thread_num();
-    const int nt  = omp_get_num_threads();
-#   endif
     auto arg_tpl = std::make_tuple(args...);
 
     m_exprdata->parse(arg_tpl);
@@ -777,61 +1145,204 @@ void gsExprAssembler<T>::assemble(const expr &... args)
     const index_t elim = m_options.getInt("DirichletStrategy");
     ee.setElim(dirichlet::elimination==elim);
 
-    // Note: omp thread will loop over all patches and will work on Ep/nt
-    // elements, where Ep is the elements on the patch.
-    for (unsigned patchInd = 0; patchInd < m_exprdata->multiBasis().nBases() && (!failed); ++patchInd) //todo: distribute in parallel somehow?
+    // Thread-private buffers, merged into the global system at the end
+    gsSparseEntries<T> lEntries;
+    gsMatrix<T>        lRhs;
+    ee.setAccumulation(accMode, m_hasPattern, lEntries, lRhs);
+
+    // Assembles the contributions of the element pointed at by domIt,
+    // returns false if the evaluation failed
+    auto elementContribution = [&](const index_t patchInd,
+                                   const gsDomainIterator<T> & domIt) -> bool
     {
-        QuRule = gsQuadrature::getPtr(m_exprdata->multiBasis().basis(patchInd), m_options);
+        // Map the Quadrature rule to the element
+        QuRule->mapTo( domIt.lowerCorner(), domIt.upperCorner(),
+                       m_exprdata->points(), quWeights);
 
-        // Initialize domain element iterator for current patch
-        typename gsBasis<T>::domainIter domIt =  // add patchInd to domainiter ?
-            m_exprdata->multiBasis().basis(patchInd).makeDomainIterator();
-        m_exprdata->getElement().set(*domIt,quWeights);
+        if (m_exprdata->points().cols()==0)
+            return true;
 
-        // Start iteration over elements of patchInd
-#       ifdef _OPENMP
-        for ( domIt->next(tid); domIt->good() && (!failed); domIt->next(nt) )
-#       else
-        for (; domIt->good(); domIt->next() )
-#       endif
+// Activate the try-catch only if G+Smo is not in DEBUG
+#ifdef NDEBUG
+        // Perform required pre-computations on the quadrature nodes
+        try
         {
-            // Map the Quadrature rule to the element
-            QuRule->mapTo( domIt->lowerCorner(), domIt->upperCorner(),
-                           m_exprdata->points(), quWeights);
+        m_exprdata->precompute(patchInd);
+        //m_exprdata->precompute(patchInd, QuRule, *domIt); // todo
+        }
+        catch (...)
+        {
+            // #pragma omp single copyprivate(failed) // broadcasting "failed". Does not work
+            #pragma omp atomic write
+            failed = true;
+            return false;
+        }
+#else
+        m_exprdata->precompute(patchInd);
+#endif
 
-            if (m_exprdata->points().cols()==0)
-                continue;
+        // Assemble contributions of the element
+        op_tuple(ee, arg_tpl);
+        return true;
+    };
 
-// Activate the try-catch only if G+Smo is not in DEBUG
-#ifdef NDEBUG
-            // Perform required pre-computations on the quadrature nodes
-            try
+    typename gsElementScheduler<T>::cursor cur;
+    if (colored)
+    {
+        // The elements of a color share no test DoFs; the colors are
+        // separated by the implicit barrier of the worksharing loop
+        for (index_t c = 0; c != m_coloring.numColors(); ++c)
+        {
+            const std::vector<typename gsElementColoring<T>::chunk> & chunks = m_coloring.chunks(c);
+#           pragma omp for schedule(dynamic,1)
+            for (index_t k = 0; k < static_cast<index_t>(chunks.size()); ++k)
             {
-            m_exprdata->precompute(patchInd);
-            //m_exprdata->precompute(patchInd, QuRule, *domIt); // todo
+                const index_t patchInd = chunks[k].patch;
+                const gsBasis<T> & basis = mesh.basis(patchInd);
+                for (index_t e = chunks[k].begin; e != chunks[k].end && (!failed); ++e)
+                {
+                    if ( cur.moveTo(basis, patchInd, m_coloring.element(e)) )
+                    {
+                        QuRule = gsQuadrature::getPtr(basis, m_options);
+                        m_exprdata->getElement().set(*cur.it,quWeights);
+                    }
+                    if ( !elementContribution(patchInd, *cur.it) ) break;
+                }
             }
-            catch (...)
+        }
+    }
+    else
+    {
+        // Every thread picks (patch, element range) items dynamically
+#       pragma omp for schedule(dynamic,1) nowait
+        for (index_t k = 0; k < sched.size(); ++k)
+        {
+            const index_t patchInd = sched[k].domain;
+            const gsBasis<T> & basis = mesh.basis(patchInd);
+            for (index_t e = sched[k].begin; e != sched[k].end && (!failed); ++e)
             {
-                // #pragma omp single copyprivate(failed) // broadcasting "failed". Does not work
-                #pragma omp atomic write
-                failed = true;
-                break;
+                if ( cur.moveTo(basis, patchInd, e) )
+                {
+                    QuRule = gsQuadrature::getPtr(basis, m_options);
+                    m_exprdata->getElement().set(*cur.it,quWeights);
+                }
+                if ( !elementContribution(patchInd, *cur.it) ) break;
             }
-#else
-            m_exprdata->precompute(patchInd);
-#endif
-
-
-            // Assemble contributions of the element
-            op_tuple(ee, arg_tpl);
         }
     }
+
+    ee.mergeLocal(failed);
 }//omp parallel
     // Throw something else?? (floating point exception?)
     GISMO_ENSURE(!failed,"Assembly failed due to an error");
     m_matrix.makeCompressed();
 }
 
+template<class T>
+template<class E>
+void gsExprAssembler<T>::_matrixFree(const E & a, const gsMatrix<T> * x, gsMatrix<T> & y,
+                                     std::vector<std::vector<gsMapData<T> > > * geoData)
+{
+    const gsMultiBasis<T> & mesh = m_exprdata->multiBasis();
+    gsElementScheduler<T> sched;
+    for (size_t p = 0; p != mesh.nBases(); ++p)
+        sched.addDomain(gsElementScheduler<T>::countElements(mesh.basis(p)),
+                        gsElementScheduler<T>::elementCost(mesh.basis(p), m_options));
+    sched.finalize();
+
+    // One slot per element, filled at the first visit
+    const index_t numEl = sched.offset(sched.numDomains());
+    if (geoData && static_cast<index_t>(geoData->size()) != numEl)
+    {
+        geoData->clear();
+        geoData->resize(numEl);
+    }
+
+    m_exprdata->setBasisTableCache(m_options.askSwitch("cacheBasisTables", false));
+
+#pragma omp parallel
+{
+    E ea(a);
+    m_exprdata->parse(ea);
+    m_exprdata->activateFlags(SAME_ELEMENT);
+
+    typename gsQuadRule<T>::uPtr QuRule;
+    gsVector<T> quWeights;
+    gsSparseMatrix<T> dummyMat;
+    gsMatrix<T>       dummyRhs;
+    _eval ee(dummyMat, dummyRhs, quWeights);
+
+    // Thread-private result, global indices and local vectors
+    gsMatrix<T> ly, xl, yl;
+    ly.setZero(y.rows(), y.cols());
+    std::vector<index_t> rInd, cInd;
+
+    typename gsElementScheduler<T>::cursor cur;
+#   pragma omp for schedule(dynamic,1) nowait
+    for (index_t k = 0; k < sched.size(); ++k)
+    {
+        const index_t patchInd = sched[k].domain;
+        const gsBasis<T> & basis = mesh.basis(patchInd);
+        for (index_t e = sched[k].begin; e != sched[k].end; ++e)
+        {
+            if ( cur.moveTo(basis, patchInd, e) )
+            {
+                QuRule = gsQuadrature::getPtr(basis, m_options);
+                m_exprdata->getElement().set(*cur.it,quWeights);
+            }
+            QuRule->mapTo( cur.it->lowerCorner(), cur.it->upperCorner(),
+                           m_exprdata->points(), quWeights);
+            if (m_exprdata->points().cols()==0)
+                continue;
+
+            if (geoData)
+            {
+                std::vector<gsMapData<T> > & md = (*geoData)[sched.offset(patchInd) + e];
+                if (md.empty())
+                {
+                    m_exprdata->precompute(patchInd);
+                    m_exprdata->mapData_into(md);
+                }
+                else
+                    m_exprdata->precompute(md, patchInd);
+            }
+            else
+                m_exprdata->precompute(patchInd);
+
+            ee.quadrature(ea, ee.localMat);
+            _freeActives(ea.rowVar(), rInd);
+            _freeActives(ea.colVar(), cInd);
+
+            if (x)
+            {
+                // Gather, multiply, scatter
+                xl.resize(cInd.size(), x->cols());
+                for (size_t j = 0; j != cInd.size(); ++j)
+                    if (cInd[j] < 0)
+                        xl.row(j).setZero();
+                    else
+                        xl.row(j) = x->row(cInd[j]);
+                yl.noalias() = ee.localMat * xl;
+                for (size_t i = 0; i != rInd.size(); ++i)
+                    if (rInd[i] >= 0)
+                        ly.row(rInd[i]) += yl.row(i);
+            }
+            else
+            {
+                for (size_t i = 0; i != rInd.size(); ++i)
+                    if (rInd[i] >= 0)
+                        for (size_t j = 0; j != cInd.size(); ++j)
+                            if (rInd[i] == cInd[j])
+                                ly.at(rInd[i]) += ee.localMat(i,j);
+            }
+        }
+    }
+
+#   pragma omp critical (acc_matrixFree)
+    y += ly;
+}//omp parallel
+}
+
 template<class T>
 template<class... expr>
 void gsExprAssembler<T>::assembleBdr(const bcRefList & BCs, expr&... args)
@@ -841,12 +1352,28 @@ void gsExprAssembler<T>::assembleBdr(const bcRefList & BCs, expr&... args)
     if ( BCs.empty() || 0==numDofs() ) return;
     m_exprdata->setMutSource(*BCs.front().get().function()); //initialize once
 
-// #pragma omp parallel
-// {
-// #   ifdef _OPENMP
-//     const int tid = omp_get_thread_num();
-//     const int nt  = omp_get_num_threads();
-// #   endif
+    // Work items of (boundary condition, element range)
+    const gsMultiBasis<T> & mesh = m_exprdata->multiBasis();
+    std::vector<const boundary_condition<T> *> bcs;
+    gsElementScheduler<T> sched;
+    for (typename bcRefList::const_iterator iit = BCs.begin(); iit!= BCs.end(); ++iit)
+    {
+        bcs.push_back(&iit->get());
+        const gsBasis<T> & basis = mesh.basis(bcs.back()->patch());
+        sched.addDomain(gsElementScheduler<T>::countElements(basis, bcs.back()->side()),
+                        gsElementScheduler<T>::elementCost(basis, m_options,
+                                                           bcs.back()->side().direction()));
+    }
+    sched.finalize();
+
+    // Element coloring does not apply to boundary elements
+    index_t accMode = m_options.askInt("accumulation", accumulation::critical);
+    if (accumulation::colored == accMode) accMode = accumulation::critical;
+
+    m_exprdata->setBasisTableCache(m_options.askSwitch("cacheBasisTables", false));
+
+#pragma omp parallel
+{
     auto arg_tpl = std::make_tuple(args...);
     m_exprdata->parse(arg_tpl);
     m_exprdata->activateFlags(SAME_ELEMENT);
@@ -855,41 +1382,52 @@ void gsExprAssembler<T>::assembleBdr(const bcRefList & BCs, expr&... args)
     gsVector<T> quWeights;               // quadrature weights
 
     _eval ee(m_matrix, m_rhs, quWeights);
-
-//#   pragma omp parallel for
-    for (typename bcRefList::const_iterator iit = BCs.begin(); iit!= BCs.end(); ++iit)
+    gsSparseEntries<T> lEntries;
+    gsMatrix<T>        lRhs;
+    ee.setAccumulation(accMode, m_hasPattern, lEntries, lRhs);
+
+    typename gsElementScheduler<T>::cursor cur;
+    // The boundary function source is shared, therefore the boundary
+    // conditions are treated one after the other
+    for (index_t b = 0; b != sched.numDomains(); ++b)
     {
-        const boundary_condition<T> * it = &iit->get();
-
-        QuRule = gsQuadrature::getPtr(m_exprdata->multiBasis().basis(it->patch()), m_options, it->side().direction());
+        const boundary_condition<T> * it = bcs[b];
+        const gsBasis<T> & basis = mesh.basis(it->patch());
 
         // Update boundary function source
+#       pragma omp single
         m_exprdata->setMutSource(*it->function());
 
-        typename gsBasis<T>::domainIter domIt =
-            m_exprdata->multiBasis().basis(it->patch()).
-            makeDomainIterator(it->side());
-        m_exprdata->getElement().set(*domIt,quWeights);
-
-        // Start iteration over elements
-        for (; domIt->good(); domIt->next() )
+#       pragma omp for schedule(dynamic,1)
+        for (index_t k = 0; k < sched.size(); ++k)
         {
-            // Map the Quadrature rule to the element
-            QuRule->mapTo( domIt->lowerCorner(), domIt->upperCorner(),
-                           m_exprdata->points(), quWeights);
+            if (sched[k].domain != b) continue;
+            for (index_t e = sched[k].begin; e != sched[k].end; ++e)
+            {
+                if ( cur.moveTo(basis, b, e, it->side()) )
+                {
+                    QuRule = gsQuadrature::getPtr(basis, m_options, it->side().direction());
+                    m_exprdata->getElement().set(*cur.it,quWeights);
+                }
 
-            if (m_exprdata->points().cols()==0)
-                continue;
+                // Map the Quadrature rule to the element
+                QuRule->mapTo( cur.it->lowerCorner(), cur.it->upperCorner(),
+                               m_exprdata->points(), quWeights);
 
-            // Perform required pre-computations on the quadrature nodes
-            m_exprdata->precompute(it->patch(), it->side());
+                if (m_exprdata->points().cols()==0)
+                    continue;
 
-            // Assemble contributions of the element
-            op_tuple(ee, arg_tpl);
+                // Perform required pre-computations on the quadrature nodes
+                m_exprdata->precompute(it->patch(), it->side());
+
+                // Assemble contributions of the element
+                op_tuple(ee, arg_tpl);
+            }
         }
     }
 
-//}//omp parallel
+    ee.mergeLocal(false);
+}//omp parallel
 
     m_matrix.makeCompressed();
 }
@@ -903,6 +1441,23 @@ void gsExprAssembler<T>::assembleBdr(const bContainer & bnd, expr&... args)
 
     if ( bnd.size()==0 || 0==numDofs() ) return;
 
+    // Work items of (side, element range)
+    const gsMultiBasis<T> & mesh = m_exprdata->multiBasis();
+    gsElementScheduler<T> sched;
+    for (gsBoxTopology::const_biterator it = bnd.begin(); it != bnd.end(); ++it )
+        sched.addDomain(gsElementScheduler<T>::countElements(mesh.basis(it->patch), it->side()),
+                        gsElementScheduler<T>::elementCost(mesh.basis(it->patch), m_options,
+                                                           it->side().direction()));
+    sched.finalize();
+
+    // Element coloring does not apply to boundary elements
+    index_t accMode = m_options.askInt("accumulation", accumulation::critical);
+    if (accumulation::colored == accMode) accMode = accumulation::critical;
+
+    m_exprdata->setBasisTableCache(m_options.askSwitch("cacheBasisTables", false));
+
+#pragma omp parallel
+{
     auto arg_tpl = std::make_tuple(args...);
     m_exprdata->parse(arg_tpl);
 
@@ -910,39 +1465,42 @@ void gsExprAssembler<T>::assembleBdr(const bContainer & bnd, expr&... args)
     gsVector<T> quWeights;               // quadrature weights
 
     _eval ee(m_matrix, m_rhs, quWeights);
+    gsSparseEntries<T> lEntries;
+    gsMatrix<T>        lRhs;
+    ee.setAccumulation(accMode, m_hasPattern, lEntries, lRhs);
 
-//#   pragma omp parallel for
-
-    for (gsBoxTopology::const_biterator it = bnd.begin();
-         it != bnd.end(); ++it )
+    typename gsElementScheduler<T>::cursor cur;
+#   pragma omp for schedule(dynamic,1) nowait
+    for (index_t k = 0; k < sched.size(); ++k)
     {
-        QuRule = gsQuadrature::getPtr(m_exprdata->multiBasis().basis(it->patch),
-                                    m_options, it->side().direction());
-
-        typename gsBasis<T>::domainIter domIt =
-            m_exprdata->multiBasis().basis(it->patch).
-            makeDomainIterator(it->side());
-        m_exprdata->getElement().set(*domIt,quWeights);
+        const patchSide & ps = bnd[sched[k].domain];
+        const gsBasis<T> & basis = mesh.basis(ps.patch);
 
-        // Start iteration over elements
-        for (; domIt->good(); domIt->next() )
+        for (index_t e = sched[k].begin; e != sched[k].end; ++e)
         {
+            if ( cur.moveTo(basis, sched[k].domain, e, ps.side()) )
+            {
+                QuRule = gsQuadrature::getPtr(basis, m_options, ps.side().direction());
+                m_exprdata->getElement().set(*cur.it,quWeights);
+            }
+
             // Map the Quadrature rule to the element
-            QuRule->mapTo( domIt->lowerCorner(), domIt->upperCorner(),
+            QuRule->mapTo( cur.it->lowerCorner(), cur.it->upperCorner(),
                            m_exprdata->points(), quWeights);
 
             if (m_exprdata->points().cols()==0)
                 continue;
 
             // Perform required pre-computations on the quadrature nodes
-            m_exprdata->precompute(it->patch, it->side());
+            m_exprdata->precompute(ps.patch, ps.side());
 
             // Assemble contributions of the element
             op_tuple(ee, arg_tpl);
         }
     }
 
-//}//omp parallel
+    ee.mergeLocal(false);
+}//omp parallel
 
     m_matrix.makeCompressed();
 }
@@ -952,10 +1510,39 @@ void gsExprAssembler<T>::assembleIfc(const ifContainer & iFaces, expr... args)
 {
     GISMO_ASSERT(matrix().cols()==numDofs(), "System not initialized");
 
-// #pragma omp parallel
-// {
     typedef typename gsFunction<T>::uPtr ifacemap;
 
+    // If flipSide switch is enabled, then the integration will be
+    // performed on the opposite side of the interface
+    const bool flipSide = m_options.askSwitch("flipSide", false);
+
+    // Work items of (interface, element range)
+    const gsMultiBasis<T> & mesh = m_exprdata->multiBasis();
+    std::vector<boundaryInterface> ifaces;
+    gsElementScheduler<T> sched;
+    for (gsBoxTopology::const_iiterator it = iFaces.begin();
+         it != iFaces.end(); ++it )
+    {
+        ifaces.push_back( flipSide ? it->getInverse() : *it );
+        const patchSide & ps = ifaces.back().first();
+        sched.addDomain(gsElementScheduler<T>::countElements(mesh.basis(ps.patch), ps.side()),
+                        gsElementScheduler<T>::elementCost(mesh.basis(ps.patch), m_options,
+                                                           ps.side().direction()));
+    }
+    sched.finalize();
+
+    // Element coloring does not apply to interface elements
+    index_t accMode = m_options.askInt("accumulation", accumulation::critical);
+    if (accumulation::colored == accMode) accMode = accumulation::critical;
+
+    // The data of the mirrored side is created on first access; make
+    // sure this happens before the threads are started
+    m_exprdata->pointsIfc();
+
+    m_exprdata->setBasisTableCache(m_options.askSwitch("cacheBasisTables", false));
+
+#pragma omp parallel
+{
     auto arg_tpl = std::make_tuple(args...);
 
     m_exprdata->parse(arg_tpl);
@@ -964,40 +1551,37 @@ void gsExprAssembler<T>::assembleIfc(const ifContainer & iFaces, expr... args)
     typename gsQuadRule<T>::uPtr QuRule;
     gsVector<T> quWeights;// quadrature weights
     _eval ee(m_matrix, m_rhs, quWeights);
-
-    const bool flipSide = m_options.askSwitch("flipSide", false);
+    gsSparseEntries<T> lEntries;
+    gsMatrix<T>        lRhs;
+    ee.setAccumulation(accMode, m_hasPattern, lEntries, lRhs);
 
     ifacemap interfaceMap;
-// #   pragma omp for
-    for (gsBoxTopology::const_iiterator it = iFaces.begin();
-         it != iFaces.end(); ++it )
+    typename gsElementScheduler<T>::cursor cur;
+#   pragma omp for schedule(dynamic,1) nowait
+    for (index_t k = 0; k < sched.size(); ++k)
     {
-        // If flipSide switch is enabled, then the integration will be
-        // performed on the opposite side of the interface
-        const boundaryInterface & iFace =  flipSide ? it->getInverse() : *it;
+        const boundaryInterface & iFace = ifaces[sched[k].domain];
         const index_t patch1 = iFace.first() .patch;
         const index_t patch2 = iFace.second().patch;
 
-        if (iFace.type() == interaction::conforming)
-            interfaceMap = gsAffineFunction<T>::make( iFace.dirMap(), iFace.dirOrientation(),
-                                                      m_exprdata->multiBasis().basis(patch1).support(),
-                                                      m_exprdata->multiBasis().basis(patch2).support() );
-        else
-            interfaceMap = gsCPPInterface<T>::make(getGeometryMap(), m_exprdata->multiBasis(), iFace);
-
-        QuRule = gsQuadrature::getPtr(m_exprdata->multiBasis().basis(patch1),
-                                   m_options, iFace.first().side().direction());
-
-        typename gsBasis<T>::domainIter domIt =
-            m_exprdata->multiBasis().basis(patch1)
-            .makeDomainIterator(iFace.first().side());
-        m_exprdata->getElement().set(*domIt, quWeights);
-
-        // Start iteration over elements
-        for (; domIt->good(); domIt->next() )
+        for (index_t e = sched[k].begin; e != sched[k].end; ++e)
         {
+            if ( cur.moveTo(mesh.basis(patch1), sched[k].domain, e, iFace.first().side()) )
+            {
+                if (iFace.type() == interaction::conforming)
+                    interfaceMap = gsAffineFunction<T>::make( iFace.dirMap(), iFace.dirOrientation(),
+                                                              mesh.basis(patch1).support(),
+                                                              mesh.basis(patch2).support() );
+                else
+                    interfaceMap = gsCPPInterface<T>::make(getGeometryMap(), mesh, iFace);
+
+                QuRule = gsQuadrature::getPtr(mesh.basis(patch1),
+                                              m_options, iFace.first().side().direction());
+                m_exprdata->getElement().set(*cur.it, quWeights);
+            }
+
             // Map the Quadrature rule to the element
-            QuRule->mapTo( domIt->lowerCorner(), domIt->upperCorner(),
+            QuRule->mapTo( cur.it->lowerCorner(), cur.it->upperCorner(),
                            m_exprdata->points(), quWeights);
             interfaceMap->eval_into(m_exprdata->points(), m_exprdata->pointsIfc());
 
@@ -1016,7 +1600,9 @@ void gsExprAssembler<T>::assembleIfc(const ifContainer & iFaces, expr... args)
         }
     }
 
-// }//omp parallel
+    ee.mergeLocal(false);
+}//omp parallel
+
     m_matrix.makeCompressed();
 }
 
@@ -1029,6 +1615,8 @@ void gsExprAssembler<T>::assembleJacobian(const expr residual, solution & u)
     clearMatrix();
     clearRhs();
 
+    m_exprdata->setBasisTableCache(m_options.askSwitch("cacheBasisTables", false));
+
 #pragma omp parallel
 {
 #   ifdef _OPENMP
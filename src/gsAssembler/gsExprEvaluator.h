@@ -16,6 +16,7 @@
 // #include<gsIO/gsParaviewCollection.h>
 #include <fstream>
 #include <gsAssembler/gsQuadrature.h>
+#include <gsAssembler/gsElementScheduler.h>
 #include <gsAssembler/gsRemapInterface.h>
 #include <gsAssembler/gsCPPInterface.h>
 //#include <gsIO/gsWriteParaview.h>
@@ -383,51 +384,45 @@ T gsExprEvaluator<T>::compute_impl(const expr::_expr<E> & expr)
 {
     m_value = _op::init();
     m_elWise.clear();
+
+    // Work items of (patch, element range), balanced by their cost
+    const gsMultiBasis<T> & mesh = m_exprdata->multiBasis();
+    gsElementScheduler<T> sched;
+    for (size_t p = 0; p != mesh.nBases(); ++p)
+        sched.addDomain(gsElementScheduler<T>::countElements(mesh.basis(p)),
+                        gsElementScheduler<T>::elementCost(mesh.basis(p), m_options));
+    sched.finalize();
+
     if ( storeElWise )
-        m_elWise.resize(m_exprdata->multiBasis().totalElements());
+        m_elWise.resize(sched.offset(sched.numDomains()));
 
 #pragma omp parallel
 {
-#   ifdef _OPENMP
-    const int tid = omp_get_thread_num();
-    const int nt  = omp_get_num_threads();
-    index_t patch_cnt = 0;
-#   endif
-
     gsQuadRule<T> QuRule;  // Quadrature rule
     gsVector<T> quWeights; // quadrature weights
 
     auto _arg = expr.val();
     m_exprdata->parse(_arg);
     m_exprdata->activateFlags(SAME_ELEMENT);
-    
-    // Computed value on element
-    T elVal;
-    index_t c = 0;
-    for (unsigned patchInd=0; patchInd < m_exprdata->multiBasis().nBases(); ++patchInd)
-    {
-        // Quadrature rule
-        QuRule =  gsQuadrature::get(m_exprdata->multiBasis().basis(patchInd), m_options);
 
-        // Initialize domain element iterator
-        typename gsBasis<T>::domainIter domIt =
-            m_exprdata->multiBasis().piece(patchInd).makeDomainIterator();
-        m_exprdata->getElement().set(*domIt,quWeights);
-
-        // Start iteration over elements of patchInd
-#       ifdef _OPENMP
-        if ( storeElWise )
-        {
-            c = patch_cnt + tid;
-            patch_cnt += domIt->numElements();// a bit costy
-        }
-        for ( domIt->next(tid); domIt->good(); domIt->next(nt) )
-#       else
-        for (; domIt->good(); domIt->next() )
-#       endif
+    // Computed value on element, and accumulated value of the thread
+    T elVal, thVal = _op::init();
+    typename gsElementScheduler<T>::cursor cur;
+#   pragma omp for schedule(dynamic,1) nowait
+    for (index_t k = 0; k < sched.size(); ++k)
+    {
+        const index_t patchInd = sched[k].domain;
+        for (index_t e = sched[k].begin; e != sched[k].end; ++e)
         {
+            if ( cur.moveTo(mesh.basis(patchInd), patchInd, e) )
+            {
+                // Quadrature rule
+                QuRule = gsQuadrature::get(mesh.basis(patchInd), m_options);
+                m_exprdata->getElement().set(*cur.it,quWeights);
+            }
+
             // Map the Quadrature rule to the element
-            QuRule.mapTo( domIt->lowerCorner(), domIt->upperCorner(),
+            QuRule.mapTo( cur.it->lowerCorner(), cur.it->upperCorner(),
                           m_exprdata->points(), quWeights);
 
             // Perform required pre-computations on the quadrature nodes
@@ -435,24 +430,18 @@ T gsExprEvaluator<T>::compute_impl(const expr::_expr<E> & expr)
 
             // Compute on element
             elVal = _op::init();
-            for (index_t k = 0; k != quWeights.rows(); ++k) // loop over quad. nodes
-                _op::acc(_arg.eval(k), quWeights[k], elVal);
+            for (index_t q = 0; q != quWeights.rows(); ++q) // loop over quad. nodes
+                _op::acc(_arg.eval(q), quWeights[q], elVal);
 
             if ( storeElWise )
-            {
-#               ifdef _OPENMP
-                m_elWise[c] = elVal;
-                c += nt;
-#               else
-                m_elWise[c++] = elVal;
-#               endif
-            }
+                m_elWise[sched.offset(patchInd) + e] = elVal;
 
-#           pragma omp critical (_op_acc)
-            _op::acc(elVal, 1, m_value);
+            _op::acc(elVal, 1, thVal);
         }
     }
 
+#   pragma omp critical (_op_acc)
+    _op::acc(thVal, 1, m_value);
 }//omp parallel
     return m_value;
 }
@@ -15,6 +15,7 @@
 
 #include <gsAssembler/gsExpressions.h>
 #include <gsUtils/gsThreaded.h>
+#include <gsAssembler/gsBasisTableCache.h>
 
 namespace gismo
 {
@@ -29,12 +30,13 @@ private:
     gsExprHelper(const gsExprHelper &);
 
     gsExprHelper() : m_mirror(nullptr), mesh_ptr(nullptr),
-                     mutSrc(nullptr), mutMap(nullptr)
+                     mutSrc(nullptr), mutMap(nullptr), m_useTableCache(false)
     { }
 
     explicit gsExprHelper(gsExprHelper * m)
     : m_mirror(memory::make_shared_not_owned(m)),
-      mesh_ptr(m->mesh_ptr), mutSrc(nullptr), mutMap(nullptr)
+      mesh_ptr(m->mesh_ptr), mutSrc(nullptr), mutMap(nullptr),
+      m_useTableCache(false)
     { }
 
 private:
@@ -67,6 +69,10 @@ private:
     // Represents the current element
     expr::gsFeElement<T> m_element;
 
+    // Basis tables of translation-equivalent elements
+    bool m_useTableCache;
+    util::gsThreaded<gsBasisTableCache<T> > m_tableCache;
+
 public:
     typedef memory::unique_ptr<gsExprHelper> uPtr;
     typedef memory::shared_ptr<gsExprHelper>  Ptr;
@@ -119,6 +125,10 @@ public:
 
     void setMultiBasis(const gsMultiBasis<T> & mesh) { mesh_ptr = &mesh; }
 
+    /// Enables the reuse of basis tables on translation-equivalent
+    /// elements of tensor B-spline bases (see gsBasisTableCache)
+    void setBasisTableCache(bool on) { m_useTableCache = on; }
+
     bool multiBasisSet() { return NULL!=mesh_ptr;}
 
     const gsMultiBasis<T> & multiBasis()
@@ -400,11 +410,45 @@ public:
             it->second.mine().points.swap(m_points.mine());
         }
 
+        precomputeFunctions(patchIndex);
+    }
+
+    /// Precomputes the data of the current element as precompute()
+    /// does, except that the geometry maps are not evaluated, but
+    /// taken from \a mapData (see mapData_into)
+    void precompute(const std::vector<gsMapData<T> > & mapData,
+                    const index_t patchIndex = 0)
+    {
+        GISMO_ASSERT(mapData.size() == m_mdata.size(), "Invalid map data");
+        typename std::vector<gsMapData<T> >::const_iterator md = mapData.begin();
+        for (MapDataIt it = m_mdata.begin(); it != m_mdata.end(); ++it, ++md)
+            it->second.mine() = *md;
+
+        precomputeFunctions(patchIndex);
+    }
+
+    /// Copies the data of all geometry maps on the current element to
+    /// \a result, e.g. to be reused by precompute(mapData,patchIndex)
+    void mapData_into(std::vector<gsMapData<T> > & result)
+    {
+        result.resize(m_mdata.size());
+        typename std::vector<gsMapData<T> >::iterator md = result.begin();
+        for (MapDataIt it = m_mdata.begin(); it != m_mdata.end(); ++it, ++md)
+            *md = it->second.mine();
+    }
+
+private:
+
+    // Evaluates all functions and compositions, after the maps
+    void precomputeFunctions(const index_t patchIndex)
+    {
         for (FuncDataIt it = m_fdata.begin(); it != m_fdata.end(); ++it)
         {
             it->second.mine().patchId = patchIndex;
-            it->first->piece(patchIndex)
-                .compute(m_points, it->second.mine());
+            const gsFunctionSet<T> & piece = it->first->piece(patchIndex);
+            if ( !m_useTableCache ||
+                 !m_tableCache.mine().compute(piece, m_points, it->second.mine()) )
+                piece.compute(m_points, it->second.mine());
         }
 
         for (CFuncDataIt it = m_cdata.begin(); it != m_cdata.end(); ++it)
@@ -423,6 +467,8 @@ public:
         }
     }
 
+public:
+
     void precompute(const boundaryInterface & iFace)
     {
         this->precompute( iFace.first ().patch, iFace.first().side() );
@@ -15,6 +15,8 @@
 #pragma once
 
 #include <gsCore/gsStdVectorRef.h>
+#include <gsAssembler/gsSparsityPattern.h>
+#include <gsAssembler/gsElementColoring.h>
 
 namespace gismo
 {
@@ -78,9 +80,17 @@ protected:
 
     gsVector<index_t> m_dims;
 
+    /// @brief true if the matrix holds a precomputed (symbolic)
+    /// sparsity pattern, which is kept when the system is reset
+    bool m_hasPattern;
+
+    /// @brief Coloring of the elements with respect to the row DoFs,
+    /// computed together with the sparsity pattern
+    gsElementColoring<T> m_coloring;
+
 public:
 
-    gsSparseSystem()
+    gsSparseSystem() : m_hasPattern(false)
     { }
 
     /**
@@ -95,7 +105,8 @@ public:
           m_rstr   (1),
           m_cstr   (1),
           m_cvar   (1),
-          m_dims   (1)
+          m_dims   (1),
+          m_hasPattern(false)
     {
         m_row [0] =  m_col [0] =
                 m_rstr[0] =  m_cstr[0] =
@@ -142,7 +153,8 @@ public:
           m_col(dims.sum()),
           m_rstr(dims.sum()),
           m_cstr(dims.sum()),
-          m_dims(dims.cast<index_t>())
+          m_dims(dims.cast<index_t>()),
+          m_hasPattern(false)
     {
         const index_t d = dims.size();
         const index_t s = dims.sum();
@@ -209,7 +221,8 @@ public:
           m_col (gsVector<index_t>::LinSpaced(cols,0,cols-1)),
           m_rstr(rows),
           m_cstr(cols),
-          m_dims(cols)
+          m_dims(cols),
+          m_hasPattern(false)
     {
         GISMO_ASSERT( rows > 0 && cols > 0, "Block dimensions must be positive");
 
@@ -280,7 +293,8 @@ public:
           m_col (colInd),
           m_rstr((index_t)rowInd.size()),
           m_cstr((index_t)colInd.size()),
-          m_dims(colInd.size())
+          m_dims(colInd.size()),
+          m_hasPattern(false)
         // ,m_cvar(colvar) //<< Bug
     {
         m_dims.setOnes();
@@ -317,6 +331,8 @@ public:
         m_cstr   .swap(other.m_cstr   );
         m_cvar   .swap(other.m_cvar   );
         m_dims   .swap(other.m_dims   );
+        std::swap(m_hasPattern, other.m_hasPattern);
+        std::swap(m_coloring, other.m_coloring);
     }
 
     /**
@@ -327,7 +343,13 @@ public:
     void reserve(const index_t nz, const index_t numRhs)
     {
         GISMO_ASSERT( 0 != m_mappers.size(), "Sparse system was not initialized");
-        if ( 0 != m_matrix.cols() )
+        if ( m_hasPattern ) // numeric-only refill
+        {
+            setZero();
+            if ( 0 != numRhs && numRhs != m_rhs.cols() )
+                m_rhs.setZero(m_matrix.cols(), numRhs);
+        }
+        else if ( 0 != m_matrix.cols() )
         {
             m_matrix.reservePerColumn(nz);
             if ( 0 != numRhs )
@@ -343,6 +365,11 @@ public:
      * At each column approximately bdA * deg + dbB non-zero entries
      * are expected. An extra amount of memory of bdO percent is
      * allocated, in order to speedup the process.
+     *
+     * If the switch "exactPattern" is set in \a opt, or the
+     * accumulation strategy is accumulation::colored, the exact
+     * sparsity pattern is computed instead (only at the first call,
+     * see computePattern).
      * @param mb
      * @param opt
      * @param [in] numRhs number of columns
@@ -350,9 +377,58 @@ public:
     void reserve(const gsMultiBasis<T> & mb, const gsOptionList & opt,
                  const index_t numRhs)
     {
-        reserve(numColNz(mb,opt), numRhs);
+        if ( !m_hasPattern && ( opt.askSwitch("exactPattern", false) ||
+                                accumulation::colored ==
+                                opt.askInt("accumulation", accumulation::critical) ) )
+            computePattern(mb, numRhs);
+        else
+            reserve(numColNz(mb,opt), numRhs);
     }
 
+    /**
+     * @brief Computes the exact sparsity pattern of the matrix
+     * (symbolic phase) and allocates it with explicit zeros.
+     *
+     * Two free degrees of freedom are coupled if their basis
+     * functions are active on a common element of \a mb, which is
+     * used for all row and column blocks. Afterwards, setZero() and
+     * reserve() only reset the values, so that repeated assemblies
+     * write into the existing entries without any insertion.
+     * @param mb the discretization basis
+     * @param [in] numRhs number of columns of the right-hand side
+     */
+    void computePattern(const gsMultiBasis<T> & mb, const index_t numRhs)
+    {
+        std::vector<const gsMultiBasis<T>*> rb(m_row.size(), &mb), cb(m_col.size(), &mb);
+        _computePattern(rb, cb, numRhs);
+    }
+
+    /**
+     * @brief Computes the exact sparsity pattern of the matrix
+     * (symbolic phase), where column block c is discretized by
+     * bases[colBasis(c)]. The row blocks use the same bases as the
+     * corresponding column blocks.
+     * @param bases the discretization bases (as in gsAssembler)
+     * @param [in] numRhs number of columns of the right-hand side
+     */
+    void computePattern(const std::vector<gsMultiBasis<T> > & bases, const index_t numRhs)
+    {
+        std::vector<const gsMultiBasis<T>*> rb(m_row.size()), cb(m_col.size());
+        for (size_t c = 0; c != cb.size(); ++c)
+            cb[c] = &bases[ m_cvar[ math::min<index_t>(c, m_cvar.size()-1) ] ];
+        for (size_t r = 0; r != rb.size(); ++r)
+            rb[r] = cb[ math::min<size_t>(r, cb.size()-1) ];
+        _computePattern(rb, cb, numRhs);
+    }
+
+    /// @brief Returns true if the matrix holds a precomputed sparsity pattern
+    bool hasPattern() const { return m_hasPattern; }
+
+    /// @brief Returns the coloring of the elements of the first
+    /// row basis, such that elements of the same color share no row
+    /// DoF. Available after computePattern()
+    const gsElementColoring<T> & coloring() const { return m_coloring; }
+
     /// @brief Provides an estimation of the number of non-zero matrix
     /// entries per column. This value can be used for sparse matrix
     /// memory allocation
@@ -369,10 +445,15 @@ public:
         return cast<T,short_t>(nz*(1.0+bdO));
     }
 
-    /// @brief set everything to zero
+    /// @brief set everything to zero. A precomputed sparsity pattern
+    /// is kept, only the values are reset
     void setZero()
     {
-        m_matrix.setZero();
+        if ( m_hasPattern )
+            std::fill(m_matrix.valuePtr(),
+                      m_matrix.valuePtr() + m_matrix.data().size(), T(0));
+        else
+            m_matrix.setZero();
         m_rhs   .setZero();
     }
 
@@ -1404,6 +1485,65 @@ public: /* Add local contributions to system matrix and right-hand side */
     }
 
 
+private:
+
+    void _computePattern(const std::vector<const gsMultiBasis<T>*> & rb,
+                         const std::vector<const gsMultiBasis<T>*> & cb,
+                         const index_t numRhs)
+    {
+        GISMO_ASSERT( 0 != m_mappers.size(), "Sparse system was not initialized");
+        gsSparsityPattern sp(m_matrix.rows(), m_matrix.cols(), symm);
+        gsMatrix<index_t> act;
+        std::vector<gsVector<index_t> > rInd(rb.size()), cInd(cb.size());
+        std::vector<index_t> rAll;
+        m_coloring.clear();
+
+        // The elements of the first row basis are used (as in gsAssembler::apply)
+        for (size_t k = 0; k != rb.front()->nBases(); ++k) // for all patches
+        {
+            typename gsBasis<T>::domainIter domIt = rb.front()->basis(k).makeDomainIterator();
+            for (; domIt->good(); domIt->next() )
+            {
+                rAll.clear();
+                for (size_t r = 0; r != rb.size(); ++r) // for all row-blocks
+                {
+                    rb[r]->basis(k).active_into(domIt->centerPoint(), act);
+                    _mapFree(act, k, rowMapper(r), m_rstr[r], rInd[r]);
+                    rAll.insert(rAll.end(), rInd[r].data(), rInd[r].data() + rInd[r].size());
+                }
+                for (size_t c = 0; c != cb.size(); ++c) // for all col-blocks
+                {
+                    cb[c]->basis(k).active_into(domIt->centerPoint(), act);
+                    _mapFree(act, k, colMapper(c), m_cstr[c], cInd[c]);
+                }
+
+                for (size_t r = 0; r != rb.size(); ++r)
+                    for (size_t c = 0; c != cb.size(); ++c)
+                        sp.add(rInd[r], cInd[c]);
+                m_coloring.add(k, rAll);
+            }
+        }
+
+        sp.into(m_matrix);
+        m_coloring.finalize();
+        m_hasPattern = true;
+        if ( 0 != numRhs )
+            m_rhs.setZero(m_matrix.cols(), numRhs);
+    }
+
+    // Maps patch-local indices to shifted global ones, -1 for eliminated dofs
+    static void _mapFree(const gsMatrix<index_t> & act, const index_t patch,
+                         const gsDofMapper & mapper, const index_t shift,
+                         gsVector<index_t> & result)
+    {
+        result.resize(act.rows());
+        for (index_t i = 0; i != act.rows(); ++i)
+        {
+            const index_t ii = mapper.index(act.at(i), patch);
+            result[i] = mapper.is_free_index(ii) ? ii + shift : -1;
+        }
+    }
+
 public:
     void pushSparse(const gsSparseMatrix<T> & localMat,
                     const gsMatrix<T> & localRhs,
@@ -0,0 +1,122 @@
+/** @file gsSparsityPattern.h
+
+    @brief Symbolic sparsity pattern of an assembled sparse matrix
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+namespace gismo
+{
+
+/**
+   @brief Collects the non-zero positions of a sparse matrix before
+   any value is computed (symbolic assembly phase).
+
+   Couplings are added element by element, as sets of global row and
+   column indices; negative indices mark eliminated degrees of freedom
+   and are skipped. The pattern is finally transferred to a compressed
+   column-major gsSparseMatrix holding explicit zeros, so that a
+   subsequent (numeric) assembly only writes into existing entries.
+
+   \ingroup Assembler
+*/
+class gsSparsityPattern
+{
+public:
+
+    /// Constructor for a \a rows x \a cols pattern. If \a lower is
+    /// true, only the lower triangular part is kept.
+    gsSparsityPattern(const index_t rows, const index_t cols,
+                      const bool lower = false)
+    : m_rows(rows), m_lower(lower), m_outer(cols), m_sorted(cols, 0)
+    { }
+
+    index_t rows() const { return m_rows; }
+
+    index_t cols() const { return static_cast<index_t>(m_outer.size()); }
+
+    /// Couples every row index in \a rowInd with every column index
+    /// in \a colInd
+    template<class Container>
+    void add(const Container & rowInd, const Container & colInd)
+    {
+        for (index_t j = 0; j != static_cast<index_t>(colInd.size()); ++j)
+        {
+            const index_t c = colInd[j];
+            if (c < 0) continue;
+            std::vector<index_t> & col = m_outer[c];
+            for (index_t i = 0; i != static_cast<index_t>(rowInd.size()); ++i)
+            {
+                const index_t r = rowInd[i];
+                if (r >= 0 && (!m_lower || r >= c))
+                    col.push_back(r);
+            }
+            // Keep the memory bounded by removing duplicates from time to time
+            if (col.size() > 2 * m_sorted[c] + 64)
+                compact(c);
+        }
+    }
+
+    /// Returns the number of (structurally) non-zero entries
+    index_t nonZeros()
+    {
+        index_t nz = 0;
+        for (size_t c = 0; c != m_outer.size(); ++c)
+        {
+            compact(c);
+            nz += static_cast<index_t>(m_outer[c].size());
+        }
+        return nz;
+    }
+
+    /// Writes the pattern to \a mat, which becomes a compressed
+    /// matrix with explicit zeros at all the positions of the pattern
+    template<class T, int _Options, typename _Index>
+    void into(gsSparseMatrix<T,_Options,_Index> & mat)
+    {
+        typedef gsSparseMatrix<T,_Options,_Index> MatrixT;
+        GISMO_ASSERT(!MatrixT::IsRowMajor, "Expecting a column-major matrix");
+        const index_t nz = nonZeros();
+        mat.resize(m_rows, cols());
+        mat.resizeNonZeros(nz);
+        _Index * outer = mat.outerIndexPtr();
+        _Index * inner = mat.innerIndexPtr();
+        outer[0] = 0;
+        for (size_t c = 0; c != m_outer.size(); ++c)
+        {
+            inner = std::copy(m_outer[c].begin(), m_outer[c].end(), inner);
+            outer[c+1] = outer[c] + static_cast<_Index>(m_outer[c].size());
+        }
+        std::fill(mat.valuePtr(), mat.valuePtr() + nz, T(0));
+    }
+
+private:
+
+    void compact(const size_t c)
+    {
+        std::vector<index_t> & col = m_outer[c];
+        std::sort(col.begin(), col.end());
+        col.erase(std::unique(col.begin(), col.end()), col.end());
+        m_sorted[c] = col.size();
+    }
+
+private:
+    index_t m_rows;
+    bool    m_lower;
+
+    // Row indices of every column
+    std::vector<std::vector<index_t> > m_outer;
+
+    // Size of each column after the last removal of duplicates
+    std::vector<size_t> m_sorted;
+};
+
+} // namespace gismo
@@ -0,0 +1,301 @@
+/** @file gsSumFactorization.h
+
+    @brief Sum-factorized computation of element matrices of
+    tensor-product bases
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsTensor/gsTensorBasis.h>
+#include <gsAssembler/gsQuadrature.h>
+
+namespace gismo
+{
+
+/**
+   @brief Element matrices of tensor-product bases by sum factorization
+
+   On an element of a tensor-product basis, integrated with a
+   tensor-product quadrature rule, every basis function and its
+   parametric derivatives are products of univariate factors. The
+   element integrals
+   \f[ \sum_q c(q)\, \partial_a B_i(q)\, \partial_b B_j(q) \f]
+   are then computed by contracting the coefficients \f$c\f$ at the
+   quadrature nodes with the univariate basis tables, one direction
+   after the other (last direction first). Each contraction is a
+   dense matrix product, and for degree \f$p\f$ in \f$d\f$
+   dimensions the cost of an element matrix drops from
+   \f$O(p^{3d})\f$ to \f$O(p^{2d+1})\f$ operations.
+
+   The coefficients contain the quadrature weights as well as all
+   geometry factors (e.g. the measure and the inverse Jacobian), and
+   are given in the order of the tensor quadrature nodes (first
+   direction running fastest, as produced by gsQuadRule::mapTo). The
+   rows and columns of the results follow the order of
+   gsBasis::active_into.
+
+   Example of usage, for a mass matrix:
+   \code
+   sf.compute(basis, quNodes, numNodes);
+   coefs = quWeights.transpose().array() * md.measures.array();
+   sf.mass_into(coefs, localMat);
+   \endcode
+
+   \ingroup Assembler
+*/
+template<class T>
+class gsSumFactorization
+{
+public:
+
+    gsSumFactorization() : m_dim(0) { }
+
+    /// Returns true if \a basis is a (non-rational) tensor-product
+    /// basis, for which sum factorization applies
+    static bool isTensor(const gsBasis<T> & basis)
+    {
+        switch (basis.dim())
+        {
+        case 1: return NULL != dynamic_cast<const gsTensorBasis<1,T>*>(&basis);
+        case 2: return NULL != dynamic_cast<const gsTensorBasis<2,T>*>(&basis);
+        case 3: return NULL != dynamic_cast<const gsTensorBasis<3,T>*>(&basis);
+        case 4: return NULL != dynamic_cast<const gsTensorBasis<4,T>*>(&basis);
+        default: return false;
+        }
+    }
+
+    /// Returns true if sum factorization applies to \a basis with
+    /// the quadrature rule selected by \a options, i.e., a
+    /// Gauss-Legendre or Gauss-Lobatto rule without
+    /// over-integration, whose nodes form a tensor grid on every
+    /// element. Otherwise the standard quadrature loop has to be used
+    static bool applies(const gsBasis<T> & basis, const gsOptionList & options)
+    {
+        const index_t qu = options.askInt("quRule", gsQuadrature::GaussLegendre);
+        return isTensor(basis)
+            && (gsQuadrature::GaussLegendre == qu || gsQuadrature::GaussLobatto == qu)
+            && !options.askSwitch("overInt", false);
+    }
+
+    /**
+       @brief Evaluates the univariate factors of \a basis on an element
+
+       @param basis a tensor-product basis (see isTensor)
+       @param nodes the tensor grid of quadrature nodes of the element,
+       as produced by gsQuadRule::mapTo
+       @param numNodes number of nodes in every direction
+     */
+    void compute(const gsBasis<T> & basis, const gsMatrix<T> & nodes,
+                 const gsVector<index_t> & numNodes)
+    {
+        GISMO_ASSERT(numNodes.size() == basis.dim() && nodes.rows() == basis.dim()
+                     && nodes.cols() == numNodes.prod(),
+                     "Nodes do not form a tensor grid of the given size");
+
+        const short_t d = basis.dim();
+        bool sameSize = (d == m_dim);
+        m_dim = d;
+        m_val.resize(d);
+        m_der.resize(d);
+        m_nq = numNodes;
+        m_n.resize(d);
+
+        gsMatrix<T> pts;
+        index_t stride = 1;
+        for (short_t k = 0; k != d; ++k)
+        {
+            // The nodes of direction k are found with stride equal to
+            // the number of nodes of the previous directions
+            pts.resize(1, numNodes[k]);
+            for (index_t q = 0; q != numNodes[k]; ++q)
+                pts(0,q) = nodes(k, q * stride);
+            stride *= numNodes[k];
+
+            basis.component(k).evalAllDers_into(pts, 1, m_ders);
+            m_val[k].swap(m_ders[0]);
+            m_der[k].swap(m_ders[1]);
+            sameSize = sameSize && m_n[k] == m_val[k].rows();
+            m_n[k] = m_val[k].rows();
+        }
+
+        if (!sameSize || m_perm.empty())
+            computePermutation();
+    }
+
+    /// Number of active basis functions on the element
+    index_t numActive() const { return m_n.prod(); }
+
+    /// Number of quadrature nodes on the element
+    index_t numNodes() const { return m_nq.prod(); }
+
+    /**
+       @brief Mass-type matrix \f$ \sum_q c(q) B_i(q) B_j(q) \f$
+
+       @param coefs 1 x numNodes() coefficients
+       @param result numActive() x numActive() element matrix
+     */
+    void mass_into(const gsMatrix<T> & coefs, gsMatrix<T> & result)
+    {
+        GISMO_ASSERT(coefs.size() == numNodes(), "Wrong number of coefficients");
+        result.setZero(numActive(), numActive());
+        m_coef = coefs.transpose();
+        contract(-1, -1, true, result.data());
+    }
+
+    /**
+       @brief Stiffness-type matrix \f$ \sum_q \nabla B_i(q)^T C(q)
+       \nabla B_j(q) \f$ with parametric gradients
+
+       For the Laplace operator on a geometry with Jacobian \f$J\f$,
+       \f$C = w\,|\det J|\, J^{-1}J^{-T}\f$.
+       @param coefs d*d x numNodes() coefficients, column \a q holding
+       the entries of \f$C(q)\f$ (column-wise)
+       @param result numActive() x numActive() element matrix
+     */
+    void stiffness_into(const gsMatrix<T> & coefs, gsMatrix<T> & result)
+    {
+        GISMO_ASSERT(coefs.rows() == m_dim * m_dim && coefs.cols() == numNodes(),
+                     "Wrong number of coefficients");
+        result.setZero(numActive(), numActive());
+        for (short_t b = 0; b != m_dim; ++b)
+            for (short_t a = 0; a != m_dim; ++a)
+            {
+                m_coef = coefs.row(a + m_dim * b).transpose();
+                contract(a, b, true, result.data());
+            }
+    }
+
+    /**
+       @brief Convection-type matrix \f$ \sum_q B_i(q)\, c(q)^T
+       \nabla B_j(q) \f$ with parametric gradients
+
+       For a physical velocity \f$\beta\f$, \f$c = w\,|\det J|\,
+       J^{-1}\beta\f$.
+       @param coefs d x numNodes() coefficients
+       @param result numActive() x numActive() element matrix, with
+       rows corresponding to the test functions \f$B_i\f$
+     */
+    void convection_into(const gsMatrix<T> & coefs, gsMatrix<T> & result)
+    {
+        GISMO_ASSERT(coefs.rows() == m_dim && coefs.cols() == numNodes(),
+                     "Wrong number of coefficients");
+        result.setZero(numActive(), numActive());
+        for (short_t b = 0; b != m_dim; ++b)
+        {
+            m_coef = coefs.row(b).transpose();
+            contract(-1, b, true, result.data());
+        }
+    }
+
+    /**
+       @brief Load vectors \f$ \sum_q f(q) B_i(q) \f$
+
+       @param coefs m x numNodes() coefficients, one row per
+       right-hand side
+       @param result numActive() x m element vectors
+     */
+    void moments_into(const gsMatrix<T> & coefs, gsMatrix<T> & result)
+    {
+        GISMO_ASSERT(coefs.cols() == numNodes(), "Wrong number of coefficients");
+        result.setZero(numActive(), coefs.rows());
+        for (index_t r = 0; r != coefs.rows(); ++r)
+        {
+            m_coef = coefs.row(r).transpose();
+            contract(-1, -1, false, result.col(r).data());
+        }
+    }
+
+private:
+
+    // Adds to \a out the contraction of m_coef with the derivative
+    // in direction a (resp. b) of the test (resp. trial) functions;
+    // -1 stands for the values. If bilinear is false, only the test
+    // functions are used and out has numActive() entries.
+    void contract(const short_t a, const short_t b, const bool bilinear, T * out)
+    {
+        index_t rows = numNodes(), cols = 1;
+        const T * cur = m_coef.data();
+        index_t s = 0;
+        for (short_t k = m_dim - 1; k >= 0; --k)
+        {
+            const gsMatrix<T> & L = (k == a ? m_der[k] : m_val[k]);
+            const gsMatrix<T> & R = (k == b ? m_der[k] : m_val[k]);
+            const index_t nq = m_nq[k], n = m_n[k], nn = (bilinear ? n * n : n);
+
+            // Univariate table of products, nq x nn
+            m_W.resize(nq, nn);
+            if (bilinear)
+                for (index_t j = 0; j != n; ++j)
+                    for (index_t i = 0; i != n; ++i)
+                        m_W.col(i + n * j) = L.row(i).transpose().cwiseProduct(R.row(j).transpose());
+            else
+                m_W = L.transpose();
+
+            // cur is a (rows x nq x cols) array; contract its middle index
+            rows /= nq;
+            gsMatrix<T> & next = m_buf[s];
+            next.resize(rows * nn * cols, 1);
+            for (index_t c = 0; c != cols; ++c)
+                gsAsMatrix<T>(next.data() + c * rows * nn, rows, nn).noalias() =
+                    gsAsConstMatrix<T>(cur + c * rows * nq, rows, nq) * m_W;
+            cur   = next.data();
+            cols *= nn;
+            s     = 1 - s;
+        }
+
+        // cur is now indexed by the pairs (i_0,j_0),...,(i_{d-1},j_{d-1})
+        if (bilinear)
+            for (size_t t = 0; t != m_perm.size(); ++t)
+                out[m_perm[t]] += cur[t];
+        else
+            for (index_t t = 0; t != cols; ++t)
+                out[t] += cur[t];
+    }
+
+    // Position in the element matrix of every entry of the contracted
+    // array of index pairs
+    void computePermutation()
+    {
+        const index_t N = m_n.prod();
+        m_perm.resize(N * N);
+        for (index_t t = 0; t != N * N; ++t)
+        {
+            index_t rem = t, i = 0, j = 0, stride = 1;
+            for (short_t k = 0; k != m_dim; ++k)
+            {
+                const index_t n = m_n[k];
+                const index_t ij = rem % (n * n);
+                rem /= n * n;
+                i += (ij % n) * stride;
+                j += (ij / n) * stride;
+                stride *= n;
+            }
+            m_perm[t] = i + N * j;
+        }
+    }
+
+private:
+    short_t m_dim;
+
+    // Number of quadrature nodes and of active functions per direction
+    gsVector<index_t> m_nq, m_n;
+
+    // Univariate values and derivatives, n_k x nq_k
+    std::vector<gsMatrix<T> > m_val, m_der;
+
+    std::vector<index_t> m_perm;
+
+    // Workspace
+    std::vector<gsMatrix<T> > m_ders;
+    gsMatrix<T> m_coef, m_W, m_buf[2];
+};
+
+} // namespace gismo
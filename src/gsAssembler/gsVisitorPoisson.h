@@ -14,6 +14,7 @@
 #pragma once
 
 #include <gsAssembler/gsQuadrature.h>
+#include <gsAssembler/gsSumFactorization.h>
 
 namespace gismo
 {
@@ -27,6 +28,11 @@ namespace gismo
      *  where \f$u\f$  is the trial function, \f$v\f$ is the test function and
      *  \f$f\f$ is the right-hand-side function.
      *
+     *  If the option "sumFactorization" is set, the basis is a
+     *  tensor-product basis and the quadrature rule is a Gauss or
+     *  Lobatto rule without over-integration, the element matrices
+     *  are computed by sum factorization (see gsSumFactorization).
+     *
      *  @ingroup Assembler
      */
 
@@ -39,7 +45,8 @@ public:
     ///
     /// @param pde     Reference to \a gsPoissonPde object
     gsVisitorPoisson(const gsPde<T> & pde)
-    : pde_ptr(static_cast<const gsPoissonPde<T>*>(&pde))
+    : pde_ptr(static_cast<const gsPoissonPde<T>*>(&pde)),
+      sumFact(false), useSumFact(false)
     {}
 
     /// Initialize
@@ -54,6 +61,12 @@ public:
         // Setup Quadrature
         rule = gsQuadrature::get(basis, options); // harmless slicing occurs here
 
+        sumFact = options.askSwitch("sumFactorization", false)
+            && gsSumFactorization<T>::applies(basis, options);
+        if (sumFact)
+            numNodes = gsQuadrature::numNodes(basis, options.getReal("quA"),
+                                              options.getInt("quB"));
+
         // Set Geometry evaluation flags
         md.flags = NEED_VALUE | NEED_MEASURE | NEED_GRAD_TRANSFORM;
     }
@@ -69,8 +82,13 @@ public:
         basis.active_into(md.points.col(0), actives);
         numActive = actives.rows();
 
-        // Evaluate basis functions on element
-        basis.evalAllDers_into( md.points, 1, basisData);
+        // Evaluate basis functions on element, or only their
+        // univariate factors for sum factorization
+        useSumFact = sumFact && geo.targetDim() == basis.dim();
+        if (useSumFact)
+            sfKernel.compute(basis, md.points, numNodes);
+        else
+            basis.evalAllDers_into( md.points, 1, basisData);
 
         // Compute image of Gauss nodes under geometry mapping as well as Jacobians
         geo.computeMap(md);
@@ -89,6 +107,12 @@ public:
     inline void assemble(gsDomainIterator<T>    & ,
                          gsVector<T> const      & quWeights)
     {
+        if (useSumFact)
+        {
+            assembleSumFact(quWeights);
+            return;
+        }
+
         gsMatrix<T> & bVals  = basisData[0];
         gsMatrix<T> & bGrads = basisData[1];
 
@@ -117,6 +141,28 @@ public:
         system.push(localMat, localRhs, actives, eliminatedDofs.front(), 0, 0);
     }
 
+protected:
+
+    // Assembles the element matrix and right-hand side by sum
+    // factorization, using the metric J^{-1}J^{-T} of the geometry
+    void assembleSumFact(gsVector<T> const & quWeights)
+    {
+        const index_t d  = md.dim.first;
+        const index_t nq = quWeights.rows();
+        coefs.resize(d * d, nq);
+        rhsCoefs.resize(rhsVals.rows(), nq);
+        for (index_t k = 0; k < nq; ++k)
+        {
+            const T weight = quWeights[k] * md.measure(k);
+            const gsAsConstMatrix<T> jacInvTr(md.jacInvTr.col(k).data(), d, d);
+            gsAsMatrix<T>(coefs.col(k).data(), d, d).noalias() =
+                weight * (jacInvTr.transpose() * jacInvTr);
+            rhsCoefs.col(k) = weight * rhsVals.col(k);
+        }
+        sfKernel.stiffness_into(coefs, localMat);
+        sfKernel.moments_into(rhsCoefs, localRhs);
+    }
+
 protected:
     // Pointer to the pde data
     const gsPoissonPde<T> * pde_ptr;
@@ -128,6 +174,13 @@ protected:
     gsMatrix<index_t> actives;
     index_t numActive;
 
+protected:
+    // Sum factorization data
+    bool sumFact, useSumFact;
+    gsVector<index_t> numNodes;
+    gsSumFactorization<T> sfKernel;
+    gsMatrix<T> coefs, rhsCoefs;
+
 protected:
     // Right hand side ptr for current patch
     const gsFunction<T> * rhs_ptr;
@@ -288,6 +288,7 @@ template <class T=real_t>                class gsIdentityOp;
 
 template <class T=real_t>                class gsPreconditionerOp;
 template <class T=real_t>                class gsPreconditionerFromOp;
+template <class T=real_t>                class gsIncompleteLUkOp;
 
 template <class T=real_t>                class gsAdditiveOp;
 template <class T=real_t>                class gsSumOp;
@@ -301,6 +302,7 @@ template <class T=real_t>                class gsPatchPreconditionersCreator;
 
 template <class T=real_t>                class gsMultiGridOp;
 template <class T=real_t>                class gsGridHierarchy;
+template <class T=real_t>                class gsAlgebraicMultiGrid;
 
 // gsIeti
 
@@ -330,7 +332,8 @@ void gsWriteParaviewTPgrid(gsMatrix<T> const& points,
                            std::string const & fn);
 
 template <class T>
-void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd = true);
+void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd = true,
+                     int encoding = -1);
 
 
 
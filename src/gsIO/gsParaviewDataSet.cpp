@@ -32,6 +32,7 @@ namespace gismo
 
         // QUESTION: Can I be certain that the ids are consecutive?
         initFilenames();
+        m_writers.assign(m_geometry->nPieces(), gsVtkDataArray(m_options.askInt("encoding",-1)));
         for ( index_t k=0; k!=m_geometry->nPieces(); k++) // For every patch.
         {
             gsMatrix<real_t> activeBases = m_geometry->piece(k).support();
@@ -43,11 +44,11 @@ namespace gismo
 
             // initializes individual .vts files
             // for every patch
-            std::ofstream file(m_filenames[k].c_str());
+            std::ofstream file(m_filenames[k].c_str(), std::ios_base::binary);
             file << std::fixed; // no exponents
             file << std::setprecision(5); // PLOT_PRECISION
             file <<"<?xml version=\"1.0\"?>\n";
-            file <<"<VTKFile type=\"StructuredGrid\" version=\"0.1\">\n";
+            file <<"<VTKFile type=\"StructuredGrid\" version=\"0.1\""<< m_writers[k].fileAttributes() <<">\n";
             file <<"<StructuredGrid WholeExtent=\"0 "<< np(0)-1<<" 0 "<< np1 <<" 0 "
                 << np2 <<"\">\n";
             file <<"<Piece Extent=\"0 "<< np(0)-1<<" 0 "<<np1<<" 0 "
@@ -81,14 +82,19 @@ namespace gismo
             for ( index_t k=0; k!=m_geometry->nPieces(); k++) // For every patch.
             {
                 std::ofstream file;
-                file.open(m_filenames[k].c_str(), std::ios_base::app); // Append to file 
+                file.open(m_filenames[k].c_str(), std::ios_base::app | std::ios_base::binary); // Append to file 
                 file <<"</PointData>\n\n\n<!-- GEOMETRY -->\n<Points>\n";
                 file << points[k];
-                file << "</Points>\n</Piece>\n</StructuredGrid>\n</VTKFile>";
+                file << "</Points>\n</Piece>\n</StructuredGrid>\n";
+                m_writers[k].appendedData(file);
+                file << "</VTKFile>";
                 file.close();
+
+                // The control net and the mesh use the encoding of the data set
+                const int encoding = m_writers[k].encoding();
                 if (plotControlNet)
                 {
-                    writeSingleControlNet( m_geometry->piece(k), m_basename + "_cnet" + std::to_string(k));
+                    writeSingleControlNet( m_geometry->piece(k), m_basename + "_cnet" + std::to_string(k), encoding);
                     m_filenames.push_back( m_basename + "_cnet" + std::to_string(k)+".vtp");
                 } 
                 if ( plotElements)
@@ -105,7 +111,7 @@ namespace gismo
                     }
                     gsMesh<real_t> msh( gsMultiBasis<real_t>(*m_geometry).basis(k), numPoints);
                     static_cast<const gsGeometry<real_t>&>(m_geometry->piece(k)).evaluateMesh(msh);
-                    gsWriteParaview(msh, m_basename + "_mesh" + std::to_string(k), false);
+                    gsWriteParaview(msh, m_basename + "_mesh" + std::to_string(k), false, encoding);
                     m_filenames.push_back( m_basename + "_mesh" + std::to_string(k)+".vtp");
                 }
             }
@@ -18,6 +18,7 @@
 #include <gsCore/gsDofMapper.h>         // Only to make linker happy
 #include <gsAssembler/gsExprHelper.h>  
 #include <gsAssembler/gsExprEvaluator.h>
+#include <gsIO/gsVtkDataArray.h>
 
 #include<fstream>
 
@@ -41,6 +42,7 @@ private:
     gsExprEvaluator<real_t> * m_evaltr;
     gsOptionList m_options;
     bool m_isSaved;
+    std::vector<gsVtkDataArray> m_writers; // One per file
     
 public:
     /// @brief Basic constructor
@@ -83,7 +85,7 @@ public:
         for ( index_t k=0; k!=m_geometry->nPieces(); k++) // For every patch.
         {
             std::ofstream file;
-            file.open( fnames[k].c_str(), std::ios_base::app); // Append to file
+            file.open( fnames[k].c_str(), std::ios_base::app | std::ios_base::binary); // Append to file
             file << tags[k];
             file.close(); 
         }
@@ -134,7 +136,7 @@ public:
         for ( index_t k=0; k!=m_geometry->nPieces(); k++) // For every patch.
         {
             std::ofstream file;
-            file.open( fnames[k].c_str(), std::ios_base::app); // Append to file
+            file.open( fnames[k].c_str(), std::ios_base::app | std::ios_base::binary); // Append to file
             file << tags[k];
             file.close(); 
         }
@@ -171,6 +173,7 @@ public:
         gsOptionList opt;
         opt.addInt("numPoints", "Number of points per-patch.", 1000);
         opt.addInt("precision", "Number of decimal digits.", 5);
+        opt.addInt("encoding", "Encoding of the data arrays: (-1) global default, see gsVtkDataArray::setDefaultEncoding; (0) ascii; (1) base64; (2) zlib-compressed base64; (3) raw appended binary.", -1);
         opt.addInt("plotElements.resolution", "Drawing resolution for element mesh.", -1);
         opt.addSwitch("makeSubfolder", "Export vtk files to subfolder ( below the .pvd file ).", true);
         opt.addString("subfolder","Name of subfolder where the vtk files will be stored.", "");
@@ -189,7 +192,7 @@ private:
     /// @param precision Number of decimal points in xml output
     /// @return Vector of strings of all <DataArrays>
     template< class T>
-    static std::vector<std::string> toVTK(const gsFunctionSet<T> & funSet, unsigned nPts=1000, unsigned precision=5, std::string label="")
+    std::vector<std::string> toVTK(const gsFunctionSet<T> & funSet, unsigned nPts=1000, unsigned precision=5, std::string label="")
     {   
         std::vector<std::string> out;
         gsMatrix<T> evalPoint, xyzPoints;
@@ -209,13 +212,13 @@ private:
                 col++;
             }
 
-            out.push_back( toDataArray(xyzPoints, label, precision)  );
+            out.push_back( toDataArray(xyzPoints, label, precision, m_writers[i])  );
         }
         return out; 
     }
 
     template< class T>
-    static std::vector<std::string> toVTK(const gsField<T> & field, unsigned nPts=1000, unsigned precision=5, std::string label="")
+    std::vector<std::string> toVTK(const gsField<T> & field, unsigned nPts=1000, unsigned precision=5, std::string label="")
     {   
         std::vector<std::string> out;
         gsMatrix<T> evalPoint, xyzPoints;
@@ -235,7 +238,7 @@ private:
                 col++;
             }
 
-            out.push_back( toDataArray(xyzPoints, label, precision)  );
+            out.push_back( toDataArray(xyzPoints, label, precision, m_writers[i])  );
         }
         return out; 
     }
@@ -270,21 +273,8 @@ private:
             
             vals = m_evaltr->allValues(m_evaltr->elementwise().size()/pt.numPoints(), pt.numPoints());
 
-            dataArray <<"<DataArray type=\"Float32\" Name=\""<< label <<"\" format=\"ascii\" NumberOfComponents=\""<< ( vals.rows()==1 ? 1 : 3) <<"\">\n";
-            if ( vals.rows()==1 )
-                for ( index_t j=0; j<vals.cols(); ++j)
-                    dataArray<< vals.at(j) <<" ";
-            else
-            {
-                for ( index_t j=0; j<vals.cols(); ++j)
-                {
-                    for ( index_t k=0; k!=vals.rows(); ++k)
-                        dataArray<< vals(k,j) <<" ";
-                    for ( index_t k=vals.rows(); k<3; ++k)
-                        dataArray<<"0 ";
-                }
-            }
-            dataArray <<"\n</DataArray>\n";
+            m_writers[i].writeFloat32(dataArray, vals, "Name=\"" + label + "\" ",
+                                      vals.rows()==1 ? 1 : 3);
             out.push_back( dataArray.str() );
             dataArray.str(std::string()); // Clear the dataArray stringstream
         }
@@ -297,28 +287,17 @@ private:
     /// @param points A gsMatrix<T> with the coordinates of the points, stored column-wise. Its size is (numDims, numPoints)
     /// @param label A string with the label of the data
     /// @param precision Number of decimal points in xml output
+    /// @param writer The writer of the file, which determines the encoding
     /// @return The raw xml string 
     template<class T>
-    static std::string toDataArray(const gsMatrix<T> & points, const std::string label, unsigned precision)
+    static std::string toDataArray(const gsMatrix<T> & points, const std::string label, unsigned precision,
+                                   gsVtkDataArray & writer)
     {
         std::stringstream stream;
         stream.setf( std::ios::fixed ); // write floating point values in fixed-point notation.
         stream.precision(precision); 
         // Format as vtk xml string
-        stream <<"<DataArray type=\"Float32\" format=\"ascii\" ";
-        if ( "" != label )
-            stream << "Name=\"" << label <<"\" ";
-        stream << "NumberOfComponents=\"3\">\n";
-        // For every point
-        for ( index_t j=0; j<points.cols(); ++j)
-        {
-            for ( index_t i=0; i!=points.rows(); ++i)
-                stream<< points(i,j) <<" ";
-            for ( index_t i=points.rows(); i<3; ++i)
-                stream<<"0 ";
-        }
-        stream <<"\n</DataArray>\n";
-
+        writer.writeFloat32(stream, points, "" != label ? "Name=\"" + label + "\" " : "", 3);
         return stream.str();
     }
 
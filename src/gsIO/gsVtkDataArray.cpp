@@ -0,0 +1,178 @@
+/** @file gsVtkDataArray.cpp
+
+    @brief Writes the data arrays of VTK XML (Paraview) files, as text
+    or in binary encodings
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#include <gsIO/gsVtkDataArray.h>
+
+#ifdef GISMO_ZLIB_STATIC
+#define Z_PREFIX
+#endif
+#include <zlib/zlib.h> // G+Smo
+
+#include <cstring>
+
+namespace gismo
+{
+
+namespace
+{
+
+vtkEncoding::type s_defaultEncoding = vtkEncoding::ascii;
+
+// Size of the blocks compressed by vtkZLibDataCompressor
+const size_t zlibBlockSize = 32768;
+
+bool isLittleEndian()
+{
+    const uint32_t one = 1;
+    return 1 == *reinterpret_cast<const unsigned char*>(&one);
+}
+
+// Appends the base64 encoding of \a n bytes to \a out
+void base64Encode(const unsigned char * data, size_t n, std::string & out)
+{
+    static const char table[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    out.reserve(out.size() + 4 * ((n + 2) / 3));
+    size_t i = 0;
+    for (; i + 2 < n; i += 3)
+    {
+        const uint32_t b = (uint32_t(data[i]) << 16) |
+            (uint32_t(data[i+1]) << 8) | uint32_t(data[i+2]);
+        out.push_back(table[(b >> 18) & 63]);
+        out.push_back(table[(b >> 12) & 63]);
+        out.push_back(table[(b >>  6) & 63]);
+        out.push_back(table[ b        & 63]);
+    }
+    if (i < n)
+    {
+        const bool two = (i + 1 < n);
+        const uint32_t b = (uint32_t(data[i]) << 16) |
+            (two ? uint32_t(data[i+1]) << 8 : 0);
+        out.push_back(table[(b >> 18) & 63]);
+        out.push_back(table[(b >> 12) & 63]);
+        out.push_back(two ? table[(b >> 6) & 63] : '=');
+        out.push_back('=');
+    }
+}
+
+void checkSize(size_t nbytes)
+{
+    GISMO_ENSURE(nbytes <= std::numeric_limits<uint32_t>::max(),
+                 "Data array of "<<nbytes<<" bytes too large for the UInt32 headers of VTK.");
+}
+
+} // anonymous namespace
+
+gsVtkDataArray::gsVtkDataArray(int enc)
+: m_enc(enc < 0 ? s_defaultEncoding : static_cast<vtkEncoding::type>(enc))
+{
+    GISMO_ENSURE(m_enc <= vtkEncoding::appended, "Unknown VTK encoding "<<enc);
+}
+
+vtkEncoding::type gsVtkDataArray::defaultEncoding()
+{
+    return s_defaultEncoding;
+}
+
+void gsVtkDataArray::setDefaultEncoding(vtkEncoding::type enc)
+{
+    s_defaultEncoding = enc;
+}
+
+std::string gsVtkDataArray::fileAttributes() const
+{
+    std::string res(isLittleEndian() ? " byte_order=\"LittleEndian\""
+                                     : " byte_order=\"BigEndian\"");
+    if (vtkEncoding::zlib == m_enc)
+        res.append(" compressor=\"vtkZLibDataCompressor\"");
+    return res;
+}
+
+void gsVtkDataArray::writeBinary(std::ostream & os, const char * type,
+                                 const std::string & attributes, index_t numComp,
+                                 const void * data, size_t nbytes)
+{
+    checkSize(nbytes);
+    const unsigned char * bytes = static_cast<const unsigned char*>(data);
+    os << "<DataArray type=\"" << type << "\" " << attributes
+       << "NumberOfComponents=\"" << numComp << "\" ";
+
+    const uint32_t size = static_cast<uint32_t>(nbytes);
+    std::string encoded;
+    switch (m_enc)
+    {
+    case vtkEncoding::base64:
+    {
+        // The size header and the data are encoded together
+        std::vector<unsigned char> buf(sizeof(uint32_t) + nbytes);
+        std::memcpy(buf.data(), &size, sizeof(uint32_t));
+        if (nbytes) std::memcpy(buf.data() + sizeof(uint32_t), bytes, nbytes);
+        base64Encode(buf.data(), buf.size(), encoded);
+        os << "format=\"binary\">\n" << encoded << "\n</DataArray>\n";
+        break;
+    }
+    case vtkEncoding::zlib:
+    {
+        // Header: number of blocks, block size, size of the last
+        // block, compressed size of every block
+        const size_t nblocks = (nbytes + zlibBlockSize - 1) / zlibBlockSize;
+        std::vector<uint32_t> header(3 + nblocks);
+        header[0] = static_cast<uint32_t>(nblocks);
+        header[1] = static_cast<uint32_t>(zlibBlockSize);
+        header[2] = static_cast<uint32_t>(nbytes % zlibBlockSize);
+
+        std::vector<unsigned char> comp(nblocks * compressBound(zlibBlockSize));
+        size_t pos = 0;
+        for (size_t b = 0; b != nblocks; ++b)
+        {
+            const size_t len = math::min(zlibBlockSize, nbytes - b * zlibBlockSize);
+            uLongf clen = static_cast<uLongf>(comp.size() - pos);
+            const int err = compress2(comp.data() + pos, &clen,
+                                      bytes + b * zlibBlockSize,
+                                      static_cast<uLong>(len), Z_DEFAULT_COMPRESSION);
+            GISMO_ENSURE(Z_OK == err, "zlib compression failed with error "<<err);
+            header[3 + b] = static_cast<uint32_t>(clen);
+            pos += clen;
+        }
+
+        // Header and data are encoded separately
+        base64Encode(reinterpret_cast<const unsigned char*>(header.data()),
+                     header.size() * sizeof(uint32_t), encoded);
+        base64Encode(comp.data(), pos, encoded);
+        os << "format=\"binary\">\n" << encoded << "\n</DataArray>\n";
+        break;
+    }
+    case vtkEncoding::appended:
+    {
+        checkSize(m_appended.size());
+        os << "format=\"appended\" offset=\"" << m_appended.size() << "\"/>\n";
+        m_appended.append(reinterpret_cast<const char*>(&size), sizeof(uint32_t));
+        m_appended.append(reinterpret_cast<const char*>(bytes), nbytes);
+        break;
+    }
+    default:
+        GISMO_ERROR("writeBinary called in ascii mode");
+    }
+}
+
+void gsVtkDataArray::appendedData(std::ostream & os)
+{
+    if (vtkEncoding::appended != m_enc || m_appended.empty()) return;
+    os << "<AppendedData encoding=\"raw\">\n_";
+    os.write(m_appended.data(), static_cast<std::streamsize>(m_appended.size()));
+    os << "\n</AppendedData>\n";
+    m_appended.clear();
+}
+
+} // namespace gismo
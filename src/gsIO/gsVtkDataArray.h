@@ -0,0 +1,178 @@
+/** @file gsVtkDataArray.h
+
+    @brief Writes the data arrays of VTK XML (Paraview) files, as text
+    or in binary encodings
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsCore/gsLinearAlgebra.h>
+
+namespace gismo
+{
+
+/// @brief Encodings of the data arrays of VTK XML files
+/// \ingroup IO
+struct vtkEncoding
+{
+    enum type
+    {
+        ascii    = 0, ///< Text, one value after the other
+        base64   = 1, ///< Binary, base64-encoded inside the DataArray tag
+        zlib     = 2, ///< Binary, zlib-compressed and base64-encoded inside the DataArray tag
+        appended = 3  ///< Raw binary, appended at the end of the file
+    };
+};
+
+/**
+    @brief Writes <DataArray> tags of a VTK XML file
+
+    The values are converted to the VTK type of the array (Float32,
+    Int32 or Int64) and, unless the encoding is vtkEncoding::ascii,
+    written as one block of bytes, without formatting of the
+    individual values. In vtkEncoding::appended mode, the tags only
+    refer to an offset, and the data are collected in the object; they
+    are written by appendedData(), which must be called after the
+    closing tag of the dataset and before "</VTKFile>".
+
+    The attributes returned by fileAttributes() must be added to the
+    <VTKFile> tag. One object is used per file.
+
+    Example of usage:
+    \code
+    gsVtkDataArray vtk; // uses defaultEncoding()
+    file << "<VTKFile type=\"StructuredGrid\" version=\"0.1\"" << vtk.fileAttributes() << ">\n";
+    ...
+    vtk.writeFloat32(file, points, "", 3);
+    ...
+    file << "</StructuredGrid>\n";
+    vtk.appendedData(file);
+    file << "</VTKFile>\n";
+    \endcode
+
+    \ingroup IO
+*/
+class GISMO_EXPORT gsVtkDataArray
+{
+public:
+
+    /// Constructs a writer with encoding \a enc; a negative value
+    /// stands for defaultEncoding()
+    explicit gsVtkDataArray(int enc = -1);
+
+    /// The encoding used by default by all writers of VTK files
+    static vtkEncoding::type defaultEncoding();
+
+    /// Sets the encoding used by default by all writers of VTK files
+    static void setDefaultEncoding(vtkEncoding::type enc);
+
+    /// The encoding of this writer
+    vtkEncoding::type encoding() const { return m_enc; }
+
+    /// Attributes of the <VTKFile> tag (byte order and compressor),
+    /// starting with a space
+    std::string fileAttributes() const;
+
+    /**
+       @brief Writes the columns of \a data as a Float32 data array
+
+       @param os output stream
+       @param data values, one column per point
+       @param attributes additional attributes of the tag, e.g.
+       "Name=\"SolutionField\" ", or empty
+       @param numComp number of components; the columns are padded
+       with zeros if it exceeds data.rows(), -1 uses data.rows()
+     */
+    template<class T>
+    void writeFloat32(std::ostream & os, const gsMatrix<T> & data,
+                      const std::string & attributes, index_t numComp = -1)
+    {
+        if (-1 == numComp) numComp = data.rows();
+        const index_t nr = math::min(data.rows(), numComp);
+        if (vtkEncoding::ascii == m_enc)
+        {
+            os << "<DataArray type=\"Float32\" " << attributes
+               << "NumberOfComponents=\"" << numComp << "\" format=\"ascii\">\n";
+            for (index_t j = 0; j != data.cols(); ++j)
+            {
+                for (index_t i = 0; i != nr; ++i)
+                    os << data(i,j) << " ";
+                for (index_t i = nr; i < numComp; ++i)
+                    os << "0 ";
+            }
+            os << "\n</DataArray>\n";
+            return;
+        }
+
+        m_float.assign(numComp * data.cols(), 0.0f);
+        for (index_t j = 0; j != data.cols(); ++j)
+            for (index_t i = 0; i != nr; ++i)
+                m_float[j * numComp + i] = cast<T,float>(data(i,j));
+        writeBinary(os, "Float32", attributes, numComp,
+                    m_float.data(), m_float.size() * sizeof(float));
+    }
+
+    /// Writes the entries of \a data as an Int32 (or Int64, if \a
+    /// int64 is true) data array with one component
+    template<class Z>
+    void writeInt(std::ostream & os, const std::vector<Z> & data,
+                  const std::string & attributes, bool int64 = false)
+    {
+        const char * type = (int64 ? "Int64" : "Int32");
+        if (vtkEncoding::ascii == m_enc)
+        {
+            os << "<DataArray type=\"" << type << "\" " << attributes
+               << "NumberOfComponents=\"1\" format=\"ascii\">\n";
+            for (size_t j = 0; j != data.size(); ++j)
+                os << data[j] << " ";
+            os << "\n</DataArray>\n";
+            return;
+        }
+
+        if (int64)
+        {
+            m_int64.assign(data.begin(), data.end());
+            writeBinary(os, type, attributes, 1, m_int64.data(),
+                        m_int64.size() * sizeof(int64_t));
+        }
+        else
+        {
+            m_int32.assign(data.begin(), data.end());
+            writeBinary(os, type, attributes, 1, m_int32.data(),
+                        m_int32.size() * sizeof(int32_t));
+        }
+    }
+
+    /// Writes the <AppendedData> section with the data of all arrays
+    /// written in vtkEncoding::appended mode, and clears it. Nothing
+    /// is written in the other modes, or if there are no such arrays.
+    void appendedData(std::ostream & os);
+
+private:
+
+    // Writes a binary data array of \a nbytes bytes
+    void writeBinary(std::ostream & os, const char * type,
+                     const std::string & attributes, index_t numComp,
+                     const void * data, size_t nbytes);
+
+private:
+    vtkEncoding::type m_enc;
+
+    // Raw data of the appended arrays
+    std::string m_appended;
+
+    // Conversion buffers
+    std::vector<float>   m_float;
+    std::vector<int32_t> m_int32;
+    std::vector<int64_t> m_int64;
+};
+
+} // namespace gismo
@@ -2,6 +2,10 @@
 
     @brief Provides declaration of functions writing Paraview files.
 
+    The data arrays of the structured grids and of the meshes are
+    written in the encoding set by gsVtkDataArray::setDefaultEncoding
+    (ascii by default).
+
     This file is part of the G+Smo library. 
 
     This Source Code Form is subject to the terms of the Mozilla Public
@@ -89,8 +93,11 @@ void gsWriteParaview(gsFunctionSet<T> const& geom,
 /// \param sl a gsMesh object
 /// \param fn filename where paraview file is written
 /// \param pvd if true, a .pvd file is generated (for compatibility)
+/// \param encoding the vtkEncoding of the data arrays; -1 uses
+/// gsVtkDataArray::defaultEncoding()
 //template <class T>
-//void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd = true);
+//void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd = true,
+//                     int encoding = -1);
 
 /// \brief Exports a parametrized mesh.
 template <class T>
@@ -408,10 +415,11 @@ void writeSingleCompMesh(const gsBasis<T> & basis, const gsGeometry<T> & Geo,
 template<class T>
 void writeSingleHBox(gsHBox<2,T> & box, std::string const & fn);
 
-/// Export a control net
+/// Export a control net, with the data arrays in the vtkEncoding
+/// \a encoding (-1: gsVtkDataArray::defaultEncoding())
 template<class T>
 void writeSingleControlNet(const gsGeometry<T> & Geo,
-                           std::string const & fn);
+                           std::string const & fn, int encoding = -1);
 
 // Please document
 template <class T>
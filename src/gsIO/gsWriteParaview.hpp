@@ -16,6 +16,7 @@
 
 #include <gsIO/gsParaviewCollection.h>
 #include <gsIO/gsIOUtils.h>
+#include <gsIO/gsVtkDataArray.h>
 
 #include <gsCore/gsGeometry.h>
 #include <gsCore/gsGeometrySlice.h>
@@ -246,7 +247,7 @@ void writeSingleCompMesh(const gsBasis<T> & basis, const gsGeometry<T> & Geo,
 /// Export a control net
 template<class T>
 void writeSingleControlNet(const gsGeometry<T> & Geo,
-                           std::string const & fn)
+                           std::string const & fn, int encoding)
 {
     const int d = Geo.parDim();
     gsMesh<T> msh;
@@ -270,7 +271,7 @@ void writeSingleControlNet(const gsGeometry<T> & Geo,
         return;
     }
 
-    gsWriteParaview(msh, fn, false);
+    gsWriteParaview(msh, fn, false, encoding);
 }
 
 template<class T>
@@ -286,49 +287,29 @@ void gsWriteParaviewTPgrid(const gsMatrix<T> & eval_geo  ,
 
     std::string mfn(fn);
     mfn.append(".vts");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios_base::binary);
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
 
     index_t np1 = (np.size()>1 ? np(1)-1 : 0);
     index_t np2 = (np.size()>2 ? np(2)-1 : 0);
     
+    gsVtkDataArray vtk;
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"StructuredGrid\" version=\"0.1\">\n";
+    file <<"<VTKFile type=\"StructuredGrid\" version=\"0.1\""<< vtk.fileAttributes() <<">\n";
     file <<"<StructuredGrid WholeExtent=\"0 "<< np(0)-1<<" 0 "<< np1 <<" 0 "
          << np2 <<"\">\n";
     file <<"<Piece Extent=\"0 "<< np(0)-1<<" 0 "<<np1<<" 0 "
          << np2 <<"\">\n";
     file <<"<PointData "<< ( eval_field.rows()==1 ?"Scalars":"Vectors")<<"=\"SolutionField\">\n";
-    file <<"<DataArray type=\"Float32\" Name=\"SolutionField\" format=\"ascii\" NumberOfComponents=\""<< ( eval_field.rows()==1 ? 1 : 3) <<"\">\n";
-    if ( eval_field.rows()==1 )
-        for ( index_t j=0; j<eval_field.cols(); ++j)
-            file<< eval_field.at(j) <<" ";
-    else
-    {
-        for ( index_t j=0; j<eval_field.cols(); ++j)
-        {
-            for ( index_t i=0; i!=eval_field.rows(); ++i)
-                file<< eval_field(i,j) <<" ";
-            for ( index_t i=eval_field.rows(); i<3; ++i)
-                file<<"0 ";
-        }
-    }
-    file <<"</DataArray>\n";
+    vtk.writeFloat32(file, eval_field, "Name=\"SolutionField\" ", eval_field.rows()==1 ? 1 : 3);
     file <<"</PointData>\n";
     file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" NumberOfComponents=\"3\">\n";
-    for ( index_t j=0; j<eval_geo.cols(); ++j)
-    {
-        for ( index_t i=0; i!=n; ++i)
-            file<< eval_geo(i,j) <<" ";
-        for ( index_t i=n; i<3; ++i)
-            file<<"0 ";
-    }
-    file <<"</DataArray>\n";
+    vtk.writeFloat32(file, eval_geo, "", 3);
     file <<"</Points>\n";
     file <<"</Piece>\n";
     file <<"</StructuredGrid>\n";
+    vtk.appendedData(file);
     file <<"</VTKFile>\n";
 
     file.close();
@@ -507,13 +488,14 @@ void writeSingleGeometry(gsFunction<T> const& func,
 
     std::string mfn(fn);
     mfn.append(".vts");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios_base::binary);
     if ( ! file.is_open() )
         gsWarn<<"writeSingleGeometry: Problem opening file \""<<fn<<"\""<<std::endl;
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
+    gsVtkDataArray vtk;
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"StructuredGrid\" version=\"0.1\">\n";
+    file <<"<VTKFile type=\"StructuredGrid\" version=\"0.1\""<< vtk.fileAttributes() <<">\n";
     file <<"<StructuredGrid WholeExtent=\"0 "<<np(0)-1<<" 0 "<<np(1)-1<<" 0 "<<np(2)-1<<"\">\n";
     file <<"<Piece Extent=\"0 "<< np(0)-1<<" 0 "<<np(1)-1<<" 0 "<<np(2)-1<<"\">\n";
     // Add norm of the point as data
@@ -530,23 +512,18 @@ void writeSingleGeometry(gsFunction<T> const& func,
     {
         //gsWarn<< "4th dimension as scalar data.\n";
         file <<"<PointData "<< "Scalars=\"Coordinate4\">\n";
-        file <<"<DataArray type=\"Float32\" Name=\"Coordinate4\" format=\"ascii\" NumberOfComponents=\"1\">\n";
-        for ( index_t j=0; j!=eval_func.cols(); ++j)
-            file<< eval_func(3,j) <<" ";
-        file <<"</DataArray>\n";
+        const gsMatrix<T> coord4 = eval_func.row(3);
+        vtk.writeFloat32(file, coord4, "Name=\"Coordinate4\" ");
         file <<"</PointData>\n";
     }
     //---------
 
     file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" NumberOfComponents=\"3\">\n";
-    for ( index_t j=0; j<eval_func.cols(); ++j)
-        for ( index_t i=0; i!=3; ++i)
-            file<< eval_func(i,j) <<" ";
-    file <<"</DataArray>\n";
+    vtk.writeFloat32(file, eval_func, "", 3);
     file <<"</Points>\n";
     file <<"</Piece>\n";
     file <<"</StructuredGrid>\n";
+    vtk.appendedData(file);
     file <<"</VTKFile>\n";
     file.close();
 }
@@ -1687,18 +1664,20 @@ void gsWriteParaviewSolid(gsSolid<T> const& sl,
 
 /// Visualizing a mesh
 template <class T>
-void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd)
+void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd,
+                     int encoding)
 {
     std::string mfn(fn);
     mfn.append(".vtp");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios_base::binary);
     if ( ! file.is_open() )
         gsWarn<<"gsWriteParaview: Problem opening file \""<<fn<<"\""<<std::endl;
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
 
+    gsVtkDataArray vtk(encoding);
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"PolyData\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+    file <<"<VTKFile type=\"PolyData\" version=\"0.1\""<< vtk.fileAttributes() <<">\n";
     file <<"<PolyData>\n";
 
     /// Number of vertices and number of faces
@@ -1707,92 +1686,46 @@ void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd)
 
     /// Coordinates of vertices
     file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"ascii\">\n";
-    for (typename std::vector< gsVertex<T>* >::const_iterator it=sl.vertices().begin(); it!=sl.vertices().end(); ++it)
-    {
-        const gsVertex<T>& vertex = **it;
-        file << vertex[0] << " ";
-        file << vertex[1] << " ";
-        file << vertex[2] << " \n";
-    }
-
-    file << "\n";
-    file <<"</DataArray>\n";
+    gsMatrix<T> coords(3, sl.numVertices());
+    index_t c = 0;
+    for (typename std::vector< gsVertex<T>* >::const_iterator it=sl.vertices().begin(); it!=sl.vertices().end(); ++it, ++c)
+        coords.col(c) = (*it)->topRows(3);
+    vtk.writeFloat32(file, coords, "", 3);
     file <<"</Points>\n";
 
-    // Scalar field attached to each face
-    // file << "<PointData Scalars=\"point_scalars\">\n";
-    // file << "<DataArray type=\"Int32\" Name=\"point_scalars\" format=\"ascii\">\n";
-    // for (typename std::vector< gsVertex<T>* >::const_iterator it=sl.vertex.begin();
-    //      it!=sl.vertex.end(); ++it)
-    // {
-    //     file << 0 << " ";
-    // }
-    // file << "\n";
-    // file << "</DataArray>\n";
-    // file << "</PointData>\n";
-
     // Write out edges
+    std::vector<index_t> conn, offsets;
     file << "<Lines>\n";
-    file << "<DataArray type=\"Int32\" Name=\"connectivity\" format=\"ascii\">\n";
-    for (typename std::vector< gsEdge<T> >::const_iterator it=sl.edges().begin();
-         it!=sl.edges().end(); ++it)
-    {
-            file << it->source->getId() << " " << it->target->getId() << "\n";
-    }
-    file << "</DataArray>\n";
-    file << "<DataArray type=\"Int32\" Name=\"offsets\" format=\"ascii\">\n";
-    int count=0;
     for (typename std::vector< gsEdge<T> >::const_iterator it=sl.edges().begin();
          it!=sl.edges().end(); ++it)
     {
-        count+=2;
-        file << count << " ";
+        conn.push_back(it->source->getId());
+        conn.push_back(it->target->getId());
+        offsets.push_back(conn.size());
     }
-    file << "\n";
-    file << "</DataArray>\n";
+    vtk.writeInt(file, conn, "Name=\"connectivity\" ");
+    vtk.writeInt(file, offsets, "Name=\"offsets\" ");
     file << "</Lines>\n";
 
-    // Scalar field attached to each face (* if edges exists, this has a problem)
-    // file << "<CellData Scalars=\"cell_scalars\">\n";
-    // file << "<DataArray type=\"Int32\" Name=\"cell_scalars\" format=\"ascii\">\n";
-    // for (typename std::vector< gsFace<T>* >::const_iterator it=sl.face.begin();
-    //      it!=sl.face.end(); ++it)
-    // {
-    //     file << 1 << " ";
-    // }
-    // file << "\n";
-    // file << "</DataArray>\n";
-    // file << "</CellData>\n";
-
     /// Which vertices belong to which faces
+    conn.clear();
+    offsets.clear();
     file << "<Polys>\n";
-    file << "<DataArray type=\"Int32\" Name=\"connectivity\" format=\"ascii\">\n";
     for (typename std::vector< gsFace<T>* >::const_iterator it=sl.faces().begin();
          it!=sl.faces().end(); ++it)
     {
         for (typename std::vector< gsVertex<T>* >::const_iterator vit= (*it)->vertices.begin();
              vit!=(*it)->vertices.end(); ++vit)
-        {
-            file << (*vit)->getId() << " ";
-        }
-        file << "\n";
+            conn.push_back((*vit)->getId());
+        offsets.push_back(conn.size());
     }
-    file << "</DataArray>\n";
-    file << "<DataArray type=\"Int32\" Name=\"offsets\" format=\"ascii\">\n";
-    count=0;
-    for (typename std::vector< gsFace<T>* >::const_iterator it=sl.faces().begin();
-         it!=sl.faces().end(); ++it)
-    {
-        count += (*it)->vertices.size();
-        file << count << " ";
-    }
-    file << "\n";
-    file << "</DataArray>\n";
+    vtk.writeInt(file, conn, "Name=\"connectivity\" ");
+    vtk.writeInt(file, offsets, "Name=\"offsets\" ");
     file << "</Polys>\n";
 
     file << "</Piece>\n";
     file <<"</PolyData>\n";
+    vtk.appendedData(file);
     file <<"</VTKFile>\n";
     file.close();
 
@@ -91,7 +91,8 @@ void gsWriteParaviewSolid(gsSolid<T> const  & sl,
                      unsigned numSamples );
 
 TEMPLATE_INST
-void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd);
+void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd,
+                     int encoding);
 
 TEMPLATE_INST
 void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, const gsMatrix<T>& params);
@@ -152,7 +153,7 @@ TEMPLATE_INST
 void writeSingleHBox(gsHBox<2,T> & box, std::string const & fn);
 
 TEMPLATE_INST
-void writeSingleControlNet(const gsGeometry<T> & Geo, std::string const & fn);
+void writeSingleControlNet(const gsGeometry<T> & Geo, std::string const & fn, int encoding);
 
 ///////////////////////////////////////////////////////////////////////
 
@@ -15,6 +15,7 @@
 
 #include <gsCore/gsMultiBasis.h>
 #include <gsAssembler/gsExprAssembler.h>
+#include <gsParallel/gsMpi.h>
 
 namespace gismo
 {
@@ -140,6 +141,18 @@ public:
     /// @brief Construct the global solution from a vector of patch-local ones
     Matrix constructGlobalSolutionFromLocalSolutions( const std::vector<Matrix>& localContribs );
 
+    /// @brief Construct the global solution from the patch-local ones, if the
+    /// patches are distributed over the processes of \a comm
+    ///
+    /// @param localContribs  The solutions for the patches of this process
+    /// @param patches        The indices of these patches
+    /// @param comm           The communicator
+    ///
+    /// Every process obtains the global solution. On dofs shared by the
+    /// patches of several processes, the values of the processes are averaged.
+    Matrix constructGlobalSolutionFromLocalSolutions( const std::vector<Matrix>& localContribs,
+        const std::vector<index_t>& patches, const gsMpiComm& comm );
+
 public:
 
     /// @brief Returns the number of Lagrange multipliers.
@@ -111,6 +111,45 @@ gsIetiMapper<T>::constructGlobalSolutionFromLocalSolutions( const std::vector<Ma
     return result;
 }
 
+template <class T>
+gsMatrix<T>
+gsIetiMapper<T>::constructGlobalSolutionFromLocalSolutions( const std::vector<Matrix>& localContribs,
+    const std::vector<index_t>& patches, const gsMpiComm& comm )
+{
+    GISMO_ASSERT( m_status&1, "gsIetiMapper: The class has not been initialized." );
+    GISMO_ASSERT( patches.size() == localContribs.size() && !patches.empty(),
+        "gsIetiMapper::constructGlobalSolutionFromLocalSolutions; The number of local contributions does "
+        "not argee with the number of patches." );
+
+    Matrix result;
+    result.setZero( m_dofMapperGlobal.freeSize(), localContribs[0].cols() );
+    gsVector<T> count;
+    count.setZero( m_dofMapperGlobal.freeSize() );
+
+    const index_t nPatches = patches.size();
+    for (index_t l=0; l<nPatches; ++l)
+    {
+        const index_t k = patches[l];
+        const index_t sz=m_dofMapperLocal[k].size();
+        for (index_t i=0; i<sz; ++i)
+        {
+            if (m_dofMapperLocal[k].is_free(i,0) && m_dofMapperGlobal.is_free(i,k))
+            {
+                const index_t j = m_dofMapperGlobal.index(i,k);
+                result.row(j) = localContribs[l].row(m_dofMapperLocal[k].index(i,0));
+                count[j] = 1;
+            }
+        }
+    }
+
+    comm.sum( result.data(), static_cast<int>(result.size()) );
+    comm.sum( count.data(), static_cast<int>(count.size()) );
+    for (index_t j=0; j<count.size(); ++j)
+        if (count[j] > 1)
+            result.row(j) /= count[j];
+    return result;
+}
+
 namespace {
 struct dof_helper {
     index_t globalIndex;
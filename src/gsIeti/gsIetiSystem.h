@@ -14,6 +14,7 @@
 #pragma once
 
 #include <gsSolver/gsMatrixOp.h>
+#include <gsParallel/gsMpi.h>
 
 namespace gismo
 {
@@ -62,6 +63,20 @@ namespace gismo
  *
  *  The right-hand sides are stored in a vector accessible via \ref localRhs.
  *
+ *  The subdomains are independent of each other. So, the local solvers are
+ *  set up and applied for the subdomains in parallel by the OpenMP threads,
+ *  where each thread sums up its contributions to the vectors of Lagrange
+ *  multipliers in its own buffer (see \a gsAdditiveOp).
+ *
+ *  If a communicator is set (see \ref setComm), the subdomains are
+ *  distributed over its processes: every process only adds its own
+ *  subdomains (and the primal problem is added on one process only).
+ *  The local solvers are set up and applied for the local subdomains,
+ *  while the vectors of Lagrange multipliers are held by every process.
+ *  The contributions to the Schur complement and to its right-hand side
+ *  are summed up over the processes (see \a gsMpiSumOp). Every process
+ *  has to own at least one subdomain.
+ *
  *  @ingroup Solver
 **/
 
@@ -77,6 +92,9 @@ class gsIetiSystem
     typedef gsMatrix<T>                       Matrix;          ///< Matrix type
 public:
 
+    /// @brief Default constructor
+    gsIetiSystem() : m_distributed(false) {}
+
     /// @brief Reserves the memory required to store the number of subdomains
     /// @param n Number of subdomains
     void reserve(index_t n);
@@ -110,6 +128,11 @@ public:
     OpPtr&               localSolverOp(index_t k)        { return m_localSolverOps[k]; }
     const OpPtr&         localSolverOp(index_t k) const  { return m_localSolverOps[k]; }
 
+    /// @brief Distributes the subdomains over the processes of \a comm
+    ///
+    /// Afterwards, only the subdomains owned by this process are to be added.
+    void setComm( const gsMpiComm & comm )           { m_comm = comm; m_distributed = true; }
+
     /// @brief Returns the number of Lagrange multipliers
     ///
     /// This requires that at least one jump matrix has been set.
@@ -139,12 +162,16 @@ public:
     /// @param multipliers  The Lagrange multipliers previously computed
     ///                     (based on the Schur complement form)
     ///
+    /// If a communicator is set, the solutions are computed for the
+    /// subdomains of this process.
     /// If the local solvers have not been provided, this function will generate
     /// them from the \ref localMatrixOp if they are \a gsMatrixOp<gsSparseMatrix<T>>
     std::vector<Matrix> constructSolutionFromLagrangeMultipliers(const Matrix& multipliers) const;
 
     /// @brief Returns \a gsLinearOperator that represents the IETI problem as
     ///        saddle point problem
+    ///
+    /// This is not available if the subdomains are distributed.
     OpPtr saddlePointProblem() const;
 
     /// @brief Returns the right-hand-side that is required for the saddle point
@@ -164,6 +191,8 @@ private:
     std::vector<OpPtr>          m_localMatrixOps;     ///< Stores the local matrix ops \f$ \tilde A_k \f$
     std::vector<Matrix>         m_localRhs;           ///< Stores the local right-hand sides
     mutable std::vector<OpPtr>  m_localSolverOps;     ///< Stores the local solvers
+    gsMpiComm                   m_comm;               ///< The communicator, if the subdomains are distributed
+    bool                        m_distributed;        ///< True iff the subdomains are distributed
 };
 
 } // namespace gismo
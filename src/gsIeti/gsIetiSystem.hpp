@@ -15,6 +15,8 @@
 
 #include <gsSolver/gsBlockOp.h>
 #include <gsSolver/gsAdditiveOp.h>
+#include <gsSolver/gsMpiSumOp.h>
+#include <gsSolver/gsKrylovKernels.h>
 
 namespace gismo
 {
@@ -49,24 +51,32 @@ void gsIetiSystem<T>::addSubdomain(JumpMatrixPtr jumpMatrix, OpPtr localMatrixOp
 template<class T>
 void gsIetiSystem<T>::setupSparseLUSolvers() const
 {
-    const size_t sz = this->m_localSolverOps.size();
-    for (size_t i=0; i<sz; ++i)
+    const index_t sz = this->m_localSolverOps.size();
+    std::vector<const SparseMatrixOp*> matops(sz, NULL);
+    for (index_t i=0; i<sz; ++i)
     {
         if (!m_localSolverOps[i]) // If not yet provided...
         {
-            SparseMatrixOp* matop = dynamic_cast<SparseMatrixOp*>(this->m_localMatrixOps[i].get());
-            GISMO_ENSURE( matop, "gsIetiSystem::setupSparseLUSolvers The local solvers can only "
+            matops[i] = dynamic_cast<const SparseMatrixOp*>(this->m_localMatrixOps[i].get());
+            GISMO_ENSURE( matops[i], "gsIetiSystem::setupSparseLUSolvers The local solvers can only "
               "be computed on the fly if the local systems in localMatrixOps are of type "
               "gsMatrixOp<gsSparseMatrix<T>>. Please provide solvers via members .addSubdomain "
               "or .solverOp" );
-            this->m_localSolverOps[i] = makeSparseLUSolver(SparseMatrix(matop->matrix()));
         }
     }
+
+    // The factorizations are independent of each other
+#   pragma omp parallel for schedule(dynamic,1)
+    for (index_t i=0; i<sz; ++i)
+        if (matops[i])
+            this->m_localSolverOps[i] = makeSparseLUSolver(SparseMatrix(matops[i]->matrix()));
 }
 
 template<class T>
 typename gsIetiSystem<T>::OpPtr gsIetiSystem<T>::saddlePointProblem() const
 {
+    GISMO_ENSURE( !m_distributed, "gsIetiSystem::saddlePointProblem is not available "
+        "if the subdomains are distributed over several processes." );
     const size_t sz = this->m_localMatrixOps.size();
     typename gsBlockOp<T>::Ptr result = gsBlockOp<T>::make( sz+1, sz+1 );
     for (size_t i=0; i<sz; ++i)
@@ -83,7 +93,10 @@ template<class T>
 typename gsIetiSystem<T>::OpPtr gsIetiSystem<T>::schurComplement() const
 {
     setupSparseLUSolvers();
-    return gsAdditiveOp<T>::make( this->m_jumpMatrices, this->m_localSolverOps );
+    OpPtr result = gsAdditiveOp<T>::make( this->m_jumpMatrices, this->m_localSolverOps );
+    if (m_distributed)
+        return gsMpiSumOp<T>::make( give(result), m_comm );
+    return result;
 }
 
 
@@ -92,14 +105,16 @@ gsMatrix<T> gsIetiSystem<T>::rhsForSchurComplement() const
 {
     setupSparseLUSolvers();
     Matrix result;
-    result.setZero( this->nLagrangeMultipliers(), this->m_localRhs[0].cols());
-    const index_t numPatches = this->m_jumpMatrices.size();
-    for (index_t i=0; i<numPatches; ++i)
-    {
-        Matrix tmp;
-        this->m_localSolverOps[i]->apply( this->m_localRhs[i], tmp );
-        result += *(this->m_jumpMatrices[i]) * tmp;
-    }
+    gsKrylovKernels<T>::sumTasks( this->m_jumpMatrices.size(), this->nLagrangeMultipliers(),
+        this->m_localRhs[0].cols(),
+        [&](index_t i, Matrix & y)
+        {
+            Matrix tmp;
+            this->m_localSolverOps[i]->apply( this->m_localRhs[i], tmp );
+            y += *(this->m_jumpMatrices[i]) * tmp;
+        }, result );
+    if (m_distributed)
+        m_comm.sum( result.data(), static_cast<int>(result.size()) );
     return result;
 }
 
@@ -111,6 +126,7 @@ std::vector< gsMatrix<T> > gsIetiSystem<T>::constructSolutionFromLagrangeMultipl
     const index_t numPatches = this->m_jumpMatrices.size();
     std::vector<Matrix> result;
     result.resize(numPatches);
+#   pragma omp parallel for schedule(dynamic,1)
     for (index_t i=0; i<numPatches; ++i)
     {
         this->m_localSolverOps[i]->apply( this->m_localRhs[i]-this->m_jumpMatrices[i]->transpose()*multipliers, result[i] );
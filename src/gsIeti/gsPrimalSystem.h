@@ -15,6 +15,7 @@
 
 #include <gsSolver/gsMatrixOp.h>
 #include <gsMatrix/gsVector.h>
+#include <gsParallel/gsMpi.h>
 
 namespace gismo
 {
@@ -79,6 +80,13 @@ namespace gismo
  *  After solving, the member \ref distributePrimalSolution distributes the
  *  solution obtained for the primal problem back to the individual patches.
  *
+ *  If the patches are distributed over the processes of a communicator
+ *  (see \ref setComm), every process handles the constraints of its own
+ *  patches. Then, \ref sumContributions sums up the primal problem over
+ *  the processes, such that every process holds the full primal problem.
+ *  It is handed over to \a gsIetiSystem on process 0 only, and
+ *  \ref distributePrimalSolution broadcasts its solution from there.
+ *
  *  @ingroup Solver
 **/
 
@@ -255,6 +263,31 @@ public:
         Matrix& localRhs
     );
 
+    /// @brief Handles the primal constraints for several patches
+    ///
+    /// This is equivalent to calling \ref handleConstraints for each of the
+    /// patches, in the given order. The constraints are incorporated and the
+    /// primal bases are computed (including the sparse LU factorizations of
+    /// the local systems) for the patches in parallel by the OpenMP threads.
+    void handleConstraints(
+        const std::vector< std::vector<SparseVector> >& primalConstraints,
+        const std::vector< std::vector<index_t> >& primalDofIndices,
+        std::vector<JumpMatrix>& jumpMatrices,
+        std::vector<SparseMatrix>& localMatrices,
+        std::vector<Matrix>& localRhs
+    );
+
+    /// @brief Distributes the patches over the processes of \a comm
+    ///
+    /// Afterwards, only the patches owned by this process are to be handled.
+    void setComm( const gsMpiComm & comm )                    { m_comm = comm; m_distributed = true;    }
+
+    /// @brief Sums up the contributions of all processes to the primal problem
+    ///
+    /// This is to be called after the constraints of all local patches have
+    /// been handled; it does nothing if no communicator is set.
+    void sumContributions();
+
     /// @brief  Distributes the given solution for K+1 subdomains to the K patches
     ///
     /// @param    sol   The solution, first for the K patches, followed by the
@@ -262,6 +295,8 @@ public:
     ///                 patches is expected to have first the values for all patch-local
     ///                 degrees of freedom, possibly followed by degrees of freedom
     ///                 from Lagrange-mutlipliers used for enforcing primal constraints.
+    ///                 If a communicator is set, these are the patches of this
+    ///                 process, and only process 0 provides the primal solution.
     /// @returns        The solution for the K patches
     std::vector<Matrix> distributePrimalSolution( std::vector<Matrix> sol );
 
@@ -293,6 +328,8 @@ private:
     std::vector<SparseMatrix>   m_primalBases;  ///< The bases for the primal dofs on the patches
     std::vector<OpPtr>          m_embeddings;   ///< For each patch, the map \f$ \tilde u_k \f$ to \f$ u_k \f$
     bool                        m_eliminatePointwiseConstraints; ///< \ref handleConstraints will eliminate pointwise constraints
+    gsMpiComm                   m_comm;         ///< The communicator, if the patches are distributed
+    bool                        m_distributed;  ///< True iff the patches are distributed
 };
 
 } // namespace gismo
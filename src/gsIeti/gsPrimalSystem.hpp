@@ -18,7 +18,8 @@ namespace gismo
 
 template <class T>
 gsPrimalSystem<T>::gsPrimalSystem(index_t nPrimalDofs)
-    : m_localMatrix(nPrimalDofs,nPrimalDofs), m_eliminatePointwiseConstraints(false)
+    : m_localMatrix(nPrimalDofs,nPrimalDofs), m_eliminatePointwiseConstraints(false),
+      m_distributed(false)
 {
     this->m_localRhs.setZero(nPrimalDofs,1);
 }
@@ -227,12 +228,146 @@ void gsPrimalSystem<T>::handleConstraints(
     jumpMatrix   = jumpMatrix * localEmbedding.transpose();
 }
 
+template <class T>
+void gsPrimalSystem<T>::handleConstraints(
+        const std::vector< std::vector<SparseVector> >& primalConstraints,
+        const std::vector< std::vector<index_t> >& primalDofIndices,
+        std::vector<JumpMatrix>& jumpMatrices,
+        std::vector<SparseMatrix>& localMatrices,
+        std::vector<Matrix>& localRhs
+    )
+{
+    const index_t sz = localMatrices.size();
+    GISMO_ASSERT( static_cast<index_t>(primalConstraints.size()) == sz
+        && static_cast<index_t>(primalDofIndices.size()) == sz
+        && static_cast<index_t>(jumpMatrices.size()) == sz
+        && static_cast<index_t>(localRhs.size()) == sz,
+        "gsPrimalSystem::handleConstraints: The number of patches does not agree." );
+
+    std::vector<SparseMatrix> bases(sz), modifiedLocalMatrices(sz), localEmbeddings(sz);
+
+    // The expensive part: factorizations and solves for the primal bases
+#   pragma omp parallel for schedule(dynamic,1)
+    for (index_t k=0; k<sz; ++k)
+    {
+        SparseMatrix embeddingForBasis;
+        Matrix rhsForBasis;
+
+        incorporateConstraints(primalConstraints[k],eliminatePointwiseConstraints(),
+            localMatrices[k],
+            modifiedLocalMatrices[k],localEmbeddings[k],embeddingForBasis,rhsForBasis);
+
+        bases[k] = primalBasis(
+            makeSparseLUSolver(modifiedLocalMatrices[k]),
+            embeddingForBasis, rhsForBasis, primalDofIndices[k], nPrimalDofs()
+        );
+    }
+
+    // The contributions are added in the order of the patches
+    for (index_t k=0; k<sz; ++k)
+        addContribution( jumpMatrices[k], localMatrices[k], localRhs[k], give(bases[k]) );
+
+#   pragma omp parallel for schedule(dynamic,1)
+    for (index_t k=0; k<sz; ++k)
+    {
+        localMatrices[k] = give(modifiedLocalMatrices[k]);
+        localRhs[k]      = localEmbeddings[k] * localRhs[k];
+        jumpMatrices[k]  = jumpMatrices[k] * localEmbeddings[k].transpose();
+    }
+}
+
+namespace internal {
+
+/// Sums up a sparse matrix over the processes of \a comm, by gathering
+/// the non-zero entries of all processes
+template <class SpMatrix>
+void sumSparseMatrix( const gsMpiComm & comm, SpMatrix & mat )
+{
+    typedef typename SpMatrix::Scalar T;
+    const int np = comm.size();
+    if (np == 1) return;
+
+    int nnz = mat.nonZeros();
+    std::vector<index_t> rows, cols;
+    std::vector<T> vals;
+    rows.reserve(nnz); cols.reserve(nnz); vals.reserve(nnz);
+    for (index_t i=0; i<mat.outerSize(); ++i)
+        for (typename SpMatrix::InnerIterator it(mat, i); it; ++it)
+        {
+            rows.push_back(it.row());
+            cols.push_back(it.col());
+            vals.push_back(it.value());
+        }
+
+    std::vector<int> counts(np), displ(np+1, 0);
+    comm.allgather(&nnz, 1, counts.data());
+    for (int p=0; p<np; ++p)
+        displ[p+1] = displ[p] + counts[p];
+
+    std::vector<index_t> allRows(displ[np]), allCols(displ[np]);
+    std::vector<T> allVals(displ[np]);
+    comm.allgatherv(rows.data(), nnz, allRows.data(), counts.data(), displ.data());
+    comm.allgatherv(cols.data(), nnz, allCols.data(), counts.data(), displ.data());
+    comm.allgatherv(vals.data(), nnz, allVals.data(), counts.data(), displ.data());
+
+    // Duplicate entries are summed up by setFrom
+    gsSparseEntries<T> se;
+    se.reserve(displ[np]);
+    for (int k=0; k<displ[np]; ++k)
+        se.add(allRows[k], allCols[k], allVals[k]);
+    mat.setFrom(se);
+    mat.makeCompressed();
+}
+
+} // namespace internal
+
+template <class T>
+void gsPrimalSystem<T>::sumContributions()
+{
+    if (!m_distributed) return;
+
+    // Processes without primal contributions have not set up the jump matrix
+    index_t nLagrangeMultipliers = m_jumpMatrix.rows();
+    m_comm.max(&nLagrangeMultipliers, 1);
+    if (m_jumpMatrix.rows()==0)
+        m_jumpMatrix.resize(nLagrangeMultipliers, nPrimalDofs());
+
+    internal::sumSparseMatrix(m_comm, m_localMatrix);
+    internal::sumSparseMatrix(m_comm, m_jumpMatrix);
+    m_comm.sum( m_localRhs.data(), static_cast<int>(m_localRhs.size()) );
+}
+
 template <class T>
 std::vector<typename gsPrimalSystem<T>::Matrix>
 gsPrimalSystem<T>::distributePrimalSolution( std::vector<Matrix> sol )
 {
     const index_t sz = this->m_primalBases.size();
 
+    // The primal problem is solved on process 0, which broadcasts its solution.
+    // The size is taken from the bases since the matrix might have been moved away.
+    const index_t nPrimal = this->m_primalBases.empty() ? 0 : this->m_primalBases[0].cols();
+    if (m_distributed && nPrimal>0)
+    {
+        Matrix primalSol;
+        index_t nCols = 0;
+        if (m_comm.rank()==0)
+        {
+            GISMO_ASSERT(static_cast<index_t>(sol.size())==sz+1, "gsPrimalSystem::distributePrimalSolution "
+                "expects that process 0 holds the primal subdomain as last one.");
+            nCols = sol.back().cols();
+        }
+        m_comm.broadcast(&nCols, 1, 0);
+        if (m_comm.rank()==0)
+            primalSol.swap(sol.back());
+        else
+            primalSol.resize(nPrimal, nCols);
+        m_comm.broadcast(primalSol.data(), static_cast<int>(primalSol.size()), 0);
+        if (m_comm.rank()==0)
+            sol.back().swap(primalSol);
+        else
+            sol.push_back(give(primalSol));
+    }
+
     // If the primal problem is empty, there might just not be any primal subdomain
     if (static_cast<index_t>(sol.size())==sz && this->m_jumpMatrix.cols()==0)
         return sol;
@@ -15,6 +15,7 @@
 
 #include <gsSolver/gsMatrixOp.h>
 #include <gsUtils/gsSortedVector.h>
+#include <gsParallel/gsMpi.h>
 
 namespace gismo
 {
@@ -71,6 +72,11 @@ namespace gismo
  *  \ref scalingMatrix. They can be provided by the caller or generated by
  *  calling \ref setupMultiplicityScaling.
  *
+ *  As for \a gsIetiSystem, the subdomains can be distributed over the
+ *  processes of a communicator (see \ref setComm). Then, every process
+ *  adds its own subdomains and the contributions of the processes are
+ *  summed up in the preconditioner.
+ *
  *  @ingroup Solver
 **/
 
@@ -85,6 +91,9 @@ class gsScaledDirichletPrec
     typedef gsMatrix<T>                       Matrix;          ///< Matrix type
 public:
 
+    /// @brief Default constructor
+    gsScaledDirichletPrec() : m_distributed(false) {}
+
     /// @brief Reserves the memory required to store the given number of subdomain
     /// @param n Number of subdomains
     void reserve( index_t n )
@@ -116,6 +125,22 @@ public:
     void addSubdomain( std::pair<JumpMatrix,OpPtr> data )
     { addSubdomain(data.first.moveToPtr(), give(data.second)); }
 
+    /// @brief Adds several subdomains, which are restricted to the skeleton
+    ///
+    /// @param jumpMatrices   The jump matrices
+    /// @param localMatrices  The local stiffness matrices
+    /// @param dofs           For each subdomain, the degrees of freedom on the skeleton
+    ///
+    /// This is equivalent to calling \ref addSubdomain with the result of
+    /// \ref restrictToSkeleton for each of the subdomains, in the given order.
+    /// The subdomains (including the sparse Cholesky factorizations for the
+    /// Schur complements) are processed in parallel by the OpenMP threads.
+    void addSubdomains(
+        const std::vector<JumpMatrix>& jumpMatrices,
+        const std::vector<SparseMatrix>& localMatrices,
+        const std::vector< std::vector<index_t> >& dofs
+    );
+
     /// Access the jump matrix
     JumpMatrixPtr&       jumpMatrix(index_t k)           { return m_jumpMatrices[k];  }
     const JumpMatrixPtr& jumpMatrix(index_t k) const     { return m_jumpMatrices[k];  }
@@ -209,6 +234,11 @@ public:
         return m_jumpMatrices[0]->rows();
     }
 
+    /// @brief Distributes the subdomains over the processes of \a comm
+    ///
+    /// Afterwards, only the subdomains owned by this process are to be added.
+    void setComm( const gsMpiComm & comm )           { m_comm = comm; m_distributed = true; }
+
     /// @brief This sets up the member vector \a localScaling based on
     ///        multiplicity scaling
     ///
@@ -224,6 +254,10 @@ public:
     std::vector<JumpMatrixPtr>  m_jumpMatrices;     ///< The jump matrices \f$ \hat B_k \f$
     std::vector<OpPtr>          m_localSchurOps;    ///< The local Schur complements \f$ S_k \f$
     std::vector<Matrix>         m_localScaling;     ///< The diagonal entries of \f$ D_k \f$ as vectors
+
+private:
+    gsMpiComm                   m_comm;             ///< The communicator, if the subdomains are distributed
+    bool                        m_distributed;      ///< True iff the subdomains are distributed
 };
 
 } // namespace gismo
@@ -16,6 +16,7 @@
 #include <gsSolver/gsProductOp.h>
 #include <gsSolver/gsSumOp.h>
 #include <gsSolver/gsAdditiveOp.h>
+#include <gsSolver/gsMpiSumOp.h>
 
 namespace gismo
 {
@@ -145,11 +146,34 @@ gsScaledDirichletPrec<T>::schurComplement( Blocks matrixBlocks, OpPtr solver )
     );
 }
 
+template <class T>
+void gsScaledDirichletPrec<T>::addSubdomains(
+        const std::vector<JumpMatrix>& jumpMatrices,
+        const std::vector<SparseMatrix>& localMatrices,
+        const std::vector< std::vector<index_t> >& dofs
+    )
+{
+    const index_t sz = localMatrices.size();
+    GISMO_ASSERT( static_cast<index_t>(jumpMatrices.size()) == sz
+        && static_cast<index_t>(dofs.size()) == sz,
+        "gsScaledDirichletPrec::addSubdomains: The number of subdomains does not agree." );
+
+    std::vector< std::pair<JumpMatrix,OpPtr> > data(sz);
+#   pragma omp parallel for schedule(dynamic,1)
+    for (index_t k=0; k<sz; ++k)
+        data[k] = restrictToSkeleton(jumpMatrices[k], localMatrices[k], dofs[k]);
+
+    reserve(m_jumpMatrices.size() + sz);
+    for (index_t k=0; k<sz; ++k)
+        addSubdomain(give(data[k]));
+}
+
 template <class T>
 void gsScaledDirichletPrec<T>::setupMultiplicityScaling()
 {
     const index_t pnr = m_jumpMatrices.size();
 
+#   pragma omp parallel for schedule(dynamic,1)
     for (index_t k=0; k<pnr; ++k)
     {
         const index_t sz = m_localSchurOps[k]->rows();
@@ -207,6 +231,8 @@ gsScaledDirichletPrec<T>::preconditioner() const
         result->addOperator(m_jumpMatrices[i],local);
     }
 
+    if (m_distributed)
+        return gsMpiSumOp<T>::make( give(result), m_comm );
     return result;
 }
 
@@ -35,6 +35,8 @@ template<typename T> class gsEigenMINRES;
 template<typename T> class gsEigenGMRES;
 template<typename T> class gsEigenDGMRES;
 
+template<typename T, class LowSolver> class gsMixedPrecisionSolver;
+
 /** @brief Abstract class for solvers.
     The solver interface is base on 3 methods:
     -compute set the system matrix (possibly compute the factorization or preconditioners)
@@ -87,7 +89,11 @@ public:
     typedef gsEigenMINRES<T>               MINRES;
     typedef gsEigenGMRES<T>                GMRES;
     typedef gsEigenDGMRES<T>               DGMRES;
-    
+
+    // factorization in single precision, see gsMixedPrecisionSolver
+    typedef gsMixedPrecisionSolver<T, typename gsEigenAdaptor<float>::SparseLU>       MixedPrecisionLU;
+    typedef gsMixedPrecisionSolver<T, typename gsEigenAdaptor<float>::SimplicialLDLT> MixedPrecisionLDLT;
+
 public:
     typedef gsSparseMatrix<T> MatrixT;
     typedef gsMatrix<T>       VectorT;
@@ -135,6 +141,8 @@ public:
         if (slv=="BiCGSTABDiagonal") return uPtr(new BiCGSTABDiagonal());
         if (slv=="QR")               return uPtr(new QR());
         if (slv=="LU")               return uPtr(new LU());
+        if (slv=="MixedPrecisionLU")   return uPtr(new MixedPrecisionLU());
+        if (slv=="MixedPrecisionLDLT") return uPtr(new MixedPrecisionLDLT());
         if (slv=="CGIdentity")       return uPtr(new CGIdentity());
         if (slv=="BiCGSTABIdentity") return uPtr(new BiCGSTABIdentity());
         // if (slv=="MINRES") return uPtr(new MINRES());
@@ -216,4 +224,258 @@ GISMO_EIGEN_SPARSE_SOLVER (gsEigenSimplicialLLT, SimplicialLLT)
 
 #undef GISMO_EIGEN_SPARSE_SOLVER
 
+/** @brief Sparse direct solver with factorization in single precision
+
+    The matrix is factorized in single precision by \a LowSolver (an
+    Eigen solver for float matrices, like
+    gsEigenAdaptor<float>::SparseLU), which halves the memory and the
+    memory traffic of the factors. The accuracy of \a T is recovered by
+    iterative refinement,
+    \f$ x \leftarrow x + \tilde{A}^{-1} (b - A x) \f$, where the residual
+    is computed in the precision \a T. If the refinement does not
+    reduce the error by at least a factor 2 per step (for
+    ill-conditioned matrices), the solver continues with restarted
+    GMRES, preconditioned by the single precision factorization.
+
+    The iteration stops if the normwise backward error
+    \f$ \|b - A x\|_\infty / (\|A\|_\infty \|x\|_\infty + \|b\|_\infty) \f$
+    is below the tolerance, which is by default
+    \f$ \sqrt{n} \f$ times the machine precision (as in LAPACK's
+    dsgesv). This is the accuracy of a direct solver in the precision
+    \a T.
+
+    The matrix is scaled before the conversion to single precision, and
+    a copy of it is kept for the computation of the residuals.
+
+    Example of usage:
+    \code
+    gsSparseSolver<>::MixedPrecisionLU solver(A);
+    gsMatrix<> x = solver.solve(b);
+    \endcode
+
+    \ingroup Matrix
+*/
+template<typename T, class LowSolver>
+class gsMixedPrecisionSolver : public gsSparseSolver<T>
+{
+public:
+    typedef typename gsSparseSolver<T>::MatrixT MatrixT;
+    typedef typename gsSparseSolver<T>::VectorT VectorT;
+    typedef typename LowSolver::Scalar          LowT;
+
+    typedef T       Scalar;
+    typedef MatrixT MatrixType;
+
+public:
+    gsMixedPrecisionSolver()
+    : m_scale(1), m_norm(0), m_tol(0), m_maxIter(100), m_restart(30),
+      m_iter(0), m_error(0), m_info(gsEigen::Success)
+    { }
+
+    gsMixedPrecisionSolver(const MatrixT &matrix)
+    : m_scale(1), m_norm(0), m_tol(0), m_maxIter(100), m_restart(30),
+      m_iter(0), m_error(0), m_info(gsEigen::Success)
+    { compute(matrix); }
+
+    gsMixedPrecisionSolver& compute(const MatrixT &matrix)
+    {
+        m_mat = matrix;
+        m_mat.makeCompressed();
+
+        gsVector<T> rowSum;
+        rowSum.setZero(m_mat.rows());
+        for (index_t j = 0; j < m_mat.outerSize(); ++j)
+            for (typename MatrixT::InnerIterator it(m_mat, j); it; ++it)
+                rowSum[it.row()] += math::abs(it.value());
+        m_norm  = rowSum.size() ? rowSum.maxCoeff() : T(0);
+        m_scale = m_norm > 0 ? 1 / m_norm : T(1);
+
+        const gsEigen::SparseMatrix<LowT,0,index_t> low = (m_scale * m_mat).template cast<LowT>();
+        m_solver.compute(low);
+        m_info = m_solver.info();
+        return *this;
+    }
+
+    VectorT solve(const VectorT &rhs) const
+    {
+        GISMO_ASSERT(rhs.rows() == m_mat.rows(), "gsMixedPrecisionSolver: Dimensions do not match.");
+        VectorT x(rhs.rows(), rhs.cols());
+        m_iter  = 0;
+        m_error = 0;
+        if (m_info == gsEigen::NumericalIssue || m_info == gsEigen::InvalidInput)
+        {
+            x.setZero();
+            return x;
+        }
+        m_info = gsEigen::Success;
+        const T tol = tolerance();
+
+        VectorT b, r, d;
+        for (index_t c = 0; c < rhs.cols(); ++c)
+        {
+            b = rhs.col(c);
+            const T bnorm = b.cwiseAbs().maxCoeff();
+            if (bnorm == 0) { x.col(c).setZero(); continue; }
+
+            // Iterative refinement
+            VectorT xc;
+            xc.setZero(b.rows(), 1);
+            r = b;
+            T err = 1, prev;
+            index_t it = 0;
+            while (it < m_maxIter)
+            {
+                ++it;
+                lowSolve(r, d);
+                xc += d;
+                r.noalias() = b - m_mat * xc;
+                prev = err;
+                err  = backwardError(r, xc, bnorm);
+                if (err <= tol || err > prev / 2)
+                    break;
+            }
+
+            // GMRES, if the refinement stagnates
+            if (err > tol && it < m_maxIter)
+                it += gmres(b, bnorm, xc, r, err, m_maxIter - it);
+
+            x.col(c) = xc;
+            m_iter   = math::max(m_iter, it);
+            m_error  = math::max(m_error, err);
+        }
+        if (m_error > tol)
+            m_info = gsEigen::NoConvergence;
+        return x;
+    }
+
+    /// True if the factorization succeeded and the last solve reached the tolerance
+    bool succeed() const { return m_info == gsEigen::Success; }
+
+    int info() const { return m_info; }
+
+    /// Sets the tolerance for the backward error, 0 for the default
+    gsMixedPrecisionSolver& setTolerance(T tol) { m_tol = tol; return *this; }
+
+    /// Sets the maximum number of refinement and GMRES steps (default: 100)
+    gsMixedPrecisionSolver& setMaxIterations(index_t maxIter) { m_maxIter = maxIter; return *this; }
+
+    /// Sets the restart length of the GMRES method (default: 30)
+    gsMixedPrecisionSolver& setRestart(index_t restart) { m_restart = restart; return *this; }
+
+    /// The tolerance for the backward error
+    T tolerance() const
+    {
+        return m_tol > 0 ? m_tol
+            : math::sqrt((T)math::max(m_mat.rows(), (index_t)1)) * std::numeric_limits<T>::epsilon();
+    }
+
+    /// The number of steps of the last solve (maximum over the columns)
+    index_t iterations() const { return m_iter; }
+
+    /// The backward error of the last solve (maximum over the columns)
+    T error() const { return m_error; }
+
+    index_t rows() const {return m_mat.rows();}
+    index_t cols() const {return m_mat.cols();}
+
+    std::ostream &print(std::ostream &os) const
+    {
+        os << "gsMixedPrecisionSolver";
+        return os;
+    }
+
+private:
+    T backwardError(const VectorT & r, const VectorT & x, const T bnorm) const
+    { return r.cwiseAbs().maxCoeff() / (m_norm * x.cwiseAbs().maxCoeff() + bnorm); }
+
+    /// Solves approximately A d = r in single precision
+    void lowSolve(const VectorT & r, VectorT & d) const
+    {
+        // Scaling avoids overflow and underflow in single precision
+        const T rmax = r.cwiseAbs().maxCoeff();
+        if (rmax == 0) { d.setZero(r.rows(), 1); return; }
+        const gsEigen::Matrix<LowT,Dynamic,1> rl = (r / rmax).template cast<LowT>();
+        const gsEigen::Matrix<LowT,Dynamic,1> dl = m_solver.solve(rl);
+        d = (m_scale * rmax) * dl.template cast<T>();
+    }
+
+    /// Restarted GMRES, right-preconditioned by the single precision
+    /// factorization, starting from x with residual r; returns the
+    /// number of steps
+    index_t gmres(const VectorT & b, const T bnorm, VectorT & x, VectorT & r,
+                  T & err, const index_t maxIter) const
+    {
+        const index_t n = b.rows(), m = math::min(m_restart, maxIter);
+        const T tol = tolerance();
+        gsMatrix<T> V(n, m + 1), Z(n, m), H;
+        gsVector<T> g, cs(m), sn(m), w;
+        VectorT z;
+        index_t it = 0;
+        while (it < maxIter && err > tol)
+        {
+            // Target for the Euclidean norm of the residual
+            const T target = tol * (m_norm * x.cwiseAbs().maxCoeff() + bnorm);
+            const T rnorm  = r.norm();
+            V.col(0) = r / rnorm;
+            H.setZero(m + 1, m);
+            g.setZero(m + 1);
+            g[0] = rnorm;
+            index_t k = 0;
+            while (k < m && it < maxIter)
+            {
+                lowSolve(V.col(k), z);
+                Z.col(k) = z;
+                w.noalias() = m_mat * Z.col(k);
+                for (index_t j = 0; j <= k; ++j)
+                {
+                    H(j,k) = V.col(j).dot(w);
+                    w -= H(j,k) * V.col(j);
+                }
+                H(k+1,k) = w.norm();
+                if (H(k+1,k) != 0)
+                    V.col(k+1) = w / H(k+1,k);
+
+                // Givens rotations
+                for (index_t j = 0; j < k; ++j)
+                {
+                    const T t = cs[j] * H(j,k) + sn[j] * H(j+1,k);
+                    H(j+1,k)  = -sn[j] * H(j,k) + cs[j] * H(j+1,k);
+                    H(j,k)    = t;
+                }
+                const T h = math::sqrt(H(k,k) * H(k,k) + H(k+1,k) * H(k+1,k));
+                cs[k] = H(k,k) / h;
+                sn[k] = H(k+1,k) / h;
+                H(k,k)   = h;
+                H(k+1,k) = 0;
+                g[k+1] = -sn[k] * g[k];
+                g[k]   =  cs[k] * g[k];
+                ++k;
+                ++it;
+                if (math::abs(g[k]) <= target)
+                    break;
+            }
+
+            const gsVector<T> y = H.topLeftCorner(k, k).template triangularView<gsEigen::Upper>().solve(g.head(k));
+            x.noalias() += Z.leftCols(k) * y;
+            r.noalias() = b - m_mat * x;
+            err = backwardError(r, x, bnorm);
+        }
+        return it;
+    }
+
+private:
+    gsSparseMatrix<T> m_mat;    ///< Copy of the matrix for the residuals
+    T                 m_scale;  ///< Scaling of the matrix for the factorization
+    T                 m_norm;   ///< Infinity norm of the matrix
+    LowSolver         m_solver; ///< Factorization in single precision
+
+    T       m_tol;
+    index_t m_maxIter;
+    index_t m_restart;
+
+    mutable index_t m_iter;
+    mutable T       m_error;
+    mutable int     m_info;
+};
+
 }
@@ -0,0 +1,154 @@
+/** @file gsAlgebraicMultiGrid.h
+
+    @brief Smoothed aggregation algebraic multigrid hierarchies
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsMultiGrid/gsMultiGrid.h>
+#include <gsIO/gsOptionList.h>
+
+namespace gismo
+{
+
+/** @brief
+ *  Smoothed aggregation algebraic multigrid
+ *
+ *  This class constructs a multigrid hierarchy from an assembled sparse
+ *  matrix only, without knowledge of the underlying bases. It can hence
+ *  be used where \a gsGridHierarchy is not available, like for
+ *  gsMappedBasis, for multi-patch objects with non-matching interfaces
+ *  or for matrices from external assemblers. The hierarchy is set up
+ *  by \a build and turned into a \a gsMultiGridOp by \a makeMultiGridOp,
+ *  which takes care of the cycles, the smoothers and the coarse solver.
+ *
+ *  On every level, the unknowns are grouped into aggregates of strongly
+ *  connected unknowns (Vanek, Mandel and Brezina, Computing 56, 1996);
+ *  \f$ a_{ij} \f$ is strong if
+ *  \f$ |a_{ij}| \ge \theta \sqrt{|a_{ii} a_{jj}|} \f$, where \f$ \theta \f$
+ *  is the option "StrengthThreshold". The tentative prolongation
+ *  interpolates the constants piecewise on the aggregates, and is
+ *  smoothed by one damped Jacobi step,
+ *  \f$ P = (I - \omega D^{-1} A) P_0 \f$ with
+ *  \f$ \omega = \frac{4}{3 \rho(D^{-1}A)} \f$. The coarse matrices are the
+ *  Galerkin products \f$ P^T A P \f$, which are computed by a
+ *  multithreaded sparse matrix product (see \a multiply).
+ *
+ *  Unknowns without strong connections (like eliminated Dirichlet
+ *  values) belong to no aggregate and are treated by the smoother only.
+ *  The matrix is expected to be symmetric, or at least structurally
+ *  symmetric, and to have a kernel close to the constants, as for
+ *  scalar diffusion problems.
+ *
+ *  @ingroup Solver
+**/
+template<class T>
+class gsAlgebraicMultiGrid
+{
+
+public:
+
+    /// Sparse matrix type
+    typedef gsSparseMatrix<T> SpMatrix;
+
+    /// Smart pointer to sparse matrix type
+    typedef memory::shared_ptr<SpMatrix> SpMatrixPtr;
+
+    /// @brief This function sets up an algebraic multigrid hierarchy
+    ///
+    /// @param mat                       The matrix on the finest level (copied)
+    /// @param options                   A gsOptionList, see \a defaultOptions
+    ///
+    /// The algorithm terminates if the number of levels is reached, if
+    /// the number of unknowns is below "CoarseSize", or if the coarsening
+    /// stagnates.
+    static gsAlgebraicMultiGrid build(
+        const SpMatrix& mat,
+        const gsOptionList& options = defaultOptions()
+    );
+
+    /// Get the default options
+    static gsOptionList defaultOptions()
+    {
+        gsOptionList opt;
+        opt.addInt   ( "Levels", "Maximum number of levels to be constructed", 10 );
+        opt.addInt   ( "CoarseSize", "Number of unknowns below which a level is not coarsened further", 100 );
+        opt.addReal  ( "StrengthThreshold", "Threshold theta for strong connections", (gsOptionList::Real)0.08 );
+        opt.addReal  ( "ProlongationDamping", "Damping of the prolongation smoother, relative to 4/3 over the spectral radius", (gsOptionList::Real)1 );
+        opt.addString( "Smoother", "Smoother of gsMultiGridOp, see gsMultiGridOp::setSmoothers", "GaussSeidel" );
+        opt.addReal  ( "JacobiDamping", "Damping of the Jacobi smoother", (gsOptionList::Real)0.6 );
+        return opt;
+    }
+
+    /// @brief Constructs the multigrid preconditioner on the hierarchy
+    ///
+    /// The matrices and transfers are shared with this object. The
+    /// smoothers are set on all levels, as given by the options
+    /// "Smoother" and "JacobiDamping" of \a build; the coarse solver is
+    /// the default one of \a gsMultiGridOp. Further options, like the
+    /// number of smoothing steps or cycles, are set on the returned
+    /// object by \a gsMultiGridOp::setOptions.
+    typename gsMultiGridOp<T>::uPtr makeMultiGridOp() const;
+
+    /// Number of levels, including the finest one
+    index_t numLevels() const                          { return m_matrices.size(); }
+
+    /// The matrix on level \a lvl (0 is the coarsest level)
+    const SpMatrix& matrix(index_t lvl) const          { return *m_matrices[lvl]; }
+
+    /// The prolongation from level \a lvl to level \a lvl+1
+    const SpMatrix& prolongation(index_t lvl) const    { return *m_prolong[lvl]; }
+
+    /// The ratio of the numbers of non-zeros of all levels and of the finest level
+    T operatorComplexity() const;
+
+    /// Reset the object (to save memory)
+    void clear()
+    {
+        m_matrices.clear();
+        m_prolong.clear();
+        m_restrict.clear();
+    }
+
+    /// @brief Groups the unknowns into aggregates
+    ///
+    /// @param[in]  mat      The matrix
+    /// @param[in]  theta    The threshold for strong connections
+    /// @param[out] agg      The aggregate of each unknown, -1 if it has
+    ///                      no strong connections
+    /// @return              The number of aggregates
+    static index_t aggregate(const SpMatrix& mat, T theta, gsVector<index_t>& agg);
+
+    /// @brief Computes the sparse matrix product \f$ C = A B \f$
+    ///
+    /// The columns of the product are computed in parallel by the
+    /// OpenMP threads, in two passes: one for the sparsity pattern and
+    /// one for the values, which are written directly to the compressed
+    /// storage of \a C.
+    static void multiply(const SpMatrix& A, const SpMatrix& B, SpMatrix& C);
+
+private:
+    T m_jacobiDamping;
+    std::string m_smoother;
+
+    /// Matrices, from the coarsest to the finest level
+    std::vector<SpMatrixPtr> m_matrices;
+
+    /// Prolongation and restriction for each grid transition
+    std::vector<SpMatrixPtr> m_prolong;
+    std::vector<SpMatrixPtr> m_restrict;
+};
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsAlgebraicMultiGrid.hpp)
+#endif
@@ -0,0 +1,269 @@
+/** @file gsAlgebraicMultiGrid.hpp
+
+    @brief Smoothed aggregation algebraic multigrid hierarchies
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#include <gsSolver/gsMatrixOp.h>
+#include <gsSolver/gsSimplePreconditioners.h>
+#include <gsParallel/gsOpenMP.h>
+
+namespace gismo
+{
+
+template<class T>
+gsAlgebraicMultiGrid<T> gsAlgebraicMultiGrid<T>::build(
+    const SpMatrix& mat,
+    const gsOptionList& options
+)
+{
+    GISMO_ASSERT (mat.rows() == mat.cols(), "gsAlgebraicMultiGrid needs quadratic matrices.");
+
+    const index_t levels     = options.askInt ( "Levels", 10 );
+    const index_t coarseSize = options.askInt ( "CoarseSize", 100 );
+    const T theta            = options.askReal( "StrengthThreshold", (T)0.08 );
+    const T damping          = options.askReal( "ProlongationDamping", 1 );
+
+    gsAlgebraicMultiGrid result;
+    result.m_smoother      = options.askString( "Smoother", "GaussSeidel" );
+    result.m_jacobiDamping = options.askReal  ( "JacobiDamping", (T)0.6 );
+
+    // The hierarchy is built from the finest level on
+    std::vector<SpMatrixPtr> matrices, prolong, restriction;
+    SpMatrixPtr A(new SpMatrix(mat));
+    A->makeCompressed();
+    matrices.push_back(A);
+
+    gsVector<index_t> agg;
+    while ( (index_t)matrices.size() < levels && A->rows() > coarseSize )
+    {
+        const index_t n = A->rows();
+        const index_t nc = aggregate(*A, theta, agg);
+        if ( nc == 0 || nc == n )
+            break;
+
+        // Tentative prolongation, normalized columns
+        gsVector<index_t> size;
+        size.setZero(nc);
+        for (index_t i = 0; i < n; ++i)
+            if (agg[i] >= 0) ++size[agg[i]];
+
+        SpMatrix P0(n, nc);
+        P0.reserve(size);
+        for (index_t i = 0; i < n; ++i)
+            if (agg[i] >= 0)
+                P0.insert(i, agg[i]) = 1 / math::sqrt((T)size[agg[i]]);
+        P0.makeCompressed();
+
+        // Smoothed prolongation
+        gsVector<T> invDiag = A->diagonal();
+        for (index_t i = 0; i < n; ++i)
+        {
+            GISMO_ENSURE( invDiag[i] != 0, "gsAlgebraicMultiGrid: Zero on the diagonal." );
+            invDiag[i] = 1 / invDiag[i];
+        }
+        const T omega = damping * 4 / ( 3 * internal::jacobiSpectralRadius<T>(*A, 20) );
+
+        SpMatrix AP0;
+        multiply(*A, P0, AP0);
+        SpMatrixPtr P(new SpMatrix( P0 - omega * invDiag.asDiagonal() * AP0 ));
+        P->prune((T)0);
+        P->makeCompressed();
+        SpMatrixPtr R(new SpMatrix( P->transpose() ));
+
+        // Galerkin product
+        SpMatrix AP;
+        multiply(*A, *P, AP);
+        A = SpMatrixPtr(new SpMatrix);
+        multiply(*R, AP, *A);
+
+        matrices.push_back(A);
+        prolong.push_back(P);
+        restriction.push_back(R);
+    }
+
+    // Storage from the coarsest level on, as in gsMultiGridOp
+    result.m_matrices.assign(matrices.rbegin(), matrices.rend());
+    result.m_prolong.assign(prolong.rbegin(), prolong.rend());
+    result.m_restrict.assign(restriction.rbegin(), restriction.rend());
+    return result;
+}
+
+template<class T>
+typename gsMultiGridOp<T>::uPtr gsAlgebraicMultiGrid<T>::makeMultiGridOp() const
+{
+    typedef typename gsLinearOperator<T>::Ptr OpPtr;
+    const index_t nLevels = numLevels();
+    GISMO_ASSERT( nLevels > 0, "gsAlgebraicMultiGrid: The hierarchy has not been built." );
+
+    std::vector<OpPtr> ops(nLevels), prolong(nLevels-1), restriction(nLevels-1);
+    for (index_t i = 0; i < nLevels; ++i)
+        ops[i] = makeMatrixOp(m_matrices[i]);
+    for (index_t i = 0; i < nLevels-1; ++i)
+    {
+        prolong[i]     = makeMatrixOp(m_prolong[i]);
+        restriction[i] = makeMatrixOp(m_restrict[i]);
+    }
+
+    typename gsMultiGridOp<T>::uPtr mg = gsMultiGridOp<T>::make(ops, prolong, restriction);
+    gsOptionList opt;
+    opt.addReal( "Damping", "Damping of the Jacobi smoother", m_jacobiDamping );
+    mg->setSmoothers(m_smoother, opt);
+    return mg;
+}
+
+template<class T>
+T gsAlgebraicMultiGrid<T>::operatorComplexity() const
+{
+    GISMO_ASSERT( numLevels() > 0, "gsAlgebraicMultiGrid: The hierarchy has not been built." );
+    index_t nnz = 0;
+    for (size_t i = 0; i < m_matrices.size(); ++i)
+        nnz += m_matrices[i]->nonZeros();
+    return (T)nnz / m_matrices.back()->nonZeros();
+}
+
+template<class T>
+index_t gsAlgebraicMultiGrid<T>::aggregate(const SpMatrix& mat, T theta, gsVector<index_t>& agg)
+{
+    const index_t n = mat.cols();
+    const gsVector<T> diag = mat.diagonal().cwiseAbs();
+
+    // Strong connections, stored column by column
+    std::vector<index_t> start(n+1), strong;
+    strong.reserve(mat.nonZeros());
+    start[0] = 0;
+    for (index_t j = 0; j < n; ++j)
+    {
+        for (typename SpMatrix::InnerIterator it(mat, j); it; ++it)
+            if ( it.index() != j
+                 && math::abs(it.value()) >= theta * math::sqrt(diag[it.index()] * diag[j]) )
+                strong.push_back(it.index());
+        start[j+1] = strong.size();
+    }
+
+    agg.setConstant(n, -1);
+    index_t nc = 0;
+
+    // 1st pass: unknowns whose strong neighbours are all free, together
+    // with their neighbours
+    for (index_t i = 0; i < n; ++i)
+    {
+        if ( agg[i] != -1 || start[i] == start[i+1] )
+            continue;
+        bool free = true;
+        for (index_t k = start[i]; k < start[i+1] && free; ++k)
+            free = ( agg[strong[k]] == -1 );
+        if (!free)
+            continue;
+        agg[i] = nc;
+        for (index_t k = start[i]; k < start[i+1]; ++k)
+            agg[strong[k]] = nc;
+        ++nc;
+    }
+
+    // 2nd pass: the remaining unknowns join a neighbouring aggregate
+    // of the 1st pass
+    const gsVector<index_t> agg1 = agg;
+    for (index_t i = 0; i < n; ++i)
+    {
+        if ( agg[i] != -1 )
+            continue;
+        for (index_t k = start[i]; k < start[i+1]; ++k)
+            if ( agg1[strong[k]] != -1 )
+            {
+                agg[i] = agg1[strong[k]];
+                break;
+            }
+    }
+
+    // 3rd pass: new aggregates from what is left over
+    for (index_t i = 0; i < n; ++i)
+    {
+        if ( agg[i] != -1 || start[i] == start[i+1] )
+            continue;
+        agg[i] = nc;
+        for (index_t k = start[i]; k < start[i+1]; ++k)
+            if ( agg[strong[k]] == -1 )
+                agg[strong[k]] = nc;
+        ++nc;
+    }
+
+    return nc;
+}
+
+template<class T>
+void gsAlgebraicMultiGrid<T>::multiply(const SpMatrix& A, const SpMatrix& B, SpMatrix& C)
+{
+    GISMO_ASSERT( A.cols() == B.rows(), "gsAlgebraicMultiGrid::multiply: Dimensions do not match." );
+    GISMO_ASSERT( A.isCompressed() && B.isCompressed(),
+                  "gsAlgebraicMultiGrid::multiply: The matrices must be compressed." );
+
+    typedef typename SpMatrix::InnerIterator Iterator;
+    const index_t m = A.rows(), n = B.cols();
+
+    // Sparsity pattern: number of non-zeros per column
+    std::vector<index_t> start(n+1, 0);
+#   pragma omp parallel
+    {
+        std::vector<index_t> mark(m, -1);
+#       pragma omp for schedule(dynamic,64)
+        for (index_t j = 0; j < n; ++j)
+        {
+            index_t count = 0;
+            for (Iterator b(B, j); b; ++b)
+                for (Iterator a(A, b.index()); a; ++a)
+                    if ( mark[a.index()] != j )
+                    {
+                        mark[a.index()] = j;
+                        ++count;
+                    }
+            start[j+1] = count;
+        }
+    }
+    for (index_t j = 0; j < n; ++j)
+        start[j+1] += start[j];
+
+    C.resize(m, n);
+    C.resizeNonZeros(start[n]);
+    std::copy(start.begin(), start.end(), C.outerIndexPtr());
+
+    // Values, accumulated in a dense column
+#   pragma omp parallel
+    {
+        std::vector<index_t> mark(m, -1);
+        gsVector<T> acc;
+        acc.setZero(m);
+#       pragma omp for schedule(dynamic,64)
+        for (index_t j = 0; j < n; ++j)
+        {
+            index_t * ind = C.innerIndexPtr() + start[j];
+            index_t count = 0;
+            for (Iterator b(B, j); b; ++b)
+                for (Iterator a(A, b.index()); a; ++a)
+                {
+                    if ( mark[a.index()] != j )
+                    {
+                        mark[a.index()] = j;
+                        ind[count++] = a.index();
+                    }
+                    acc[a.index()] += a.value() * b.value();
+                }
+            std::sort(ind, ind + count);
+            T * val = C.valuePtr() + start[j];
+            for (index_t k = 0; k < count; ++k)
+            {
+                val[k] = acc[ind[k]];
+                acc[ind[k]] = 0;
+            }
+        }
+    }
+}
+
+} // namespace gismo
@@ -0,0 +1,9 @@
+#include <gsMultiGrid/gsAlgebraicMultiGrid.h>
+#include <gsMultiGrid/gsAlgebraicMultiGrid.hpp>
+
+namespace gismo
+{
+
+CLASS_TEMPLATE_INST gsAlgebraicMultiGrid<real_t>;
+
+} // namespace gismo
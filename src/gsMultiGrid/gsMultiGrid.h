@@ -38,7 +38,9 @@ namespace gismo
  *  matrix, the matrices for the coarser levels are computed automatically based
  *  on the Galerkin principle.
  *
- *  For all levels, a smoother has to be provided by defining setSmoother().
+ *  For all levels, a smoother has to be provided by defining setSmoother(),
+ *  or, for sparse matrices, be chosen by setSmoothers() or the option
+ *  "Smoother".
  *
  *  The solver for the coarsest grid level is created automatically if not
  *  provided by the caller.
@@ -50,6 +52,15 @@ namespace gismo
  *  Also full multigrid and cascadic multigrid algorithms for computing an
  *  initial guess are provided.
  *
+ *  The matrices, the transfers and the smoothers of the coarsest levels can
+ *  be stored and applied in single precision (float) by
+ *  setSinglePrecisionLevels() or the option "SinglePrecisionLevels", while
+ *  the caller, e.g., an outer Krylov iteration, works in \a T. This halves
+ *  the memory traffic of the smoothers and of the residual computations on
+ *  these levels. The vectors are converted where the cycle enters the
+ *  coarsest level in \a T, i.e., after restrictVector and before
+ *  prolongVector.
+ *
  *  @ingroup Solver
 **/
 
@@ -89,6 +100,15 @@ public:
     /// Smart pointer to matrix type for transfers
     typedef memory::shared_ptr<SpMatrixRowMajor> SpMatrixRowMajorPtr;
 
+    /// Matrix type on single precision levels
+    typedef gsMatrix<float> MatrixSingle;
+
+    /// Smart pointer to sparse matrix type on single precision levels
+    typedef memory::shared_ptr< gsSparseMatrix<float> > SpMatrixSinglePtr;
+
+    /// Smart pointer to matrix type for transfers on single precision levels
+    typedef memory::shared_ptr< gsSparseMatrix<float, RowMajor> > SpMatrixRowMajorSinglePtr;
+
     /// @brief Constructor
     ///
     /// @param fineMatrix                Stiffness matrix on the finest grid
@@ -173,6 +193,14 @@ private:
     void init(SpMatrixPtr fineMatrix, std::vector<SpMatrixRowMajorPtr> transferMatrices);
     /// Init solver on coarsest grid level
     void initCoarseSolver() const;
+    /// Creates a smoother of the given type, see setSmoothers
+    template<class S>
+    static typename gsPreconditionerOp<S>::Ptr makeSmoother(const std::string& type,
+        const memory::shared_ptr< gsSparseMatrix<S> >& mat, const gsOptionList& opt);
+    /// Multigrid cycle on a single precision level
+    void multiGridStepSingle(index_t level, const MatrixSingle& rhs, MatrixSingle& x) const;
+    /// Coarse solver on a single precision coarsest level
+    void solveCoarseSingle(const MatrixSingle& rhs, MatrixSingle& result) const;
 public:
 
     /// @brief Apply smoothing steps on the corresponding level
@@ -246,11 +274,7 @@ public:
     void prolongVector(index_t lc, const Matrix& coarse, Matrix& fine) const;
 
     /// Solve the problem with direct solver on coarsest level
-    void solveCoarse(const Matrix& rhs, Matrix& result) const
-    {
-        if (!m_coarseSolver) initCoarseSolver();
-        m_coarseSolver->apply(rhs, result);
-    }
+    void solveCoarse(const Matrix& rhs, Matrix& result) const;
 
     /// Number of levels in the multigrid construction
     index_t numLevels() const                         { return m_nLevels;                 }
@@ -271,9 +295,20 @@ public:
     /// Underlying operator (=stiffness matrix) for finest level
     OpPtr underlyingOp() const override               { return m_ops[finestLevel()];     }
 
-    /// Stiffness matrix for given level
+    /// @brief Stiffness matrix for given level
+    ///
+    /// On single precision levels, the stiffness matrix in \a T is only
+    /// kept on the finest level; on the others, see matrixSingle.
     const SpMatrix& matrix(index_t lvl) const;
 
+    /// Stiffness matrix in single precision for given level, see
+    /// setSinglePrecisionLevels
+    const gsSparseMatrix<float>& matrixSingle(index_t lvl) const
+    {
+        GISMO_ASSERT ( lvl < m_singleLevels, "gsMultiGridOp: Level "<<lvl<<" is not stored in single precision." );
+        return *m_opsSingle[lvl];
+    }
+
     /// Stiffness matrix for finest level
     const SpMatrix& matrix() const                    { return matrix(finestLevel());     }
 
@@ -294,10 +329,47 @@ public:
     /// @param sm   The smoother
     void setSmoother(index_t lvl, const PrecondPtr& sm);
 
-    /// Get the smoother
+    /// @brief Set the smoothers on all levels
+    ///
+    /// @param type The smoother: "Jacobi", "GaussSeidel", "SymmetricGaussSeidel",
+    ///             "MultiColorGaussSeidel", "MultiColorSSOR" or "Chebyshev"
+    /// @param opt  Options passed to the smoothers, like "Damping",
+    ///             "Relaxation" or "Degree"
+    ///
+    /// This requires the stiffness matrices to be sparse matrices, see \a matrix.
+    void setSmoothers(const std::string& type, const gsOptionList& opt = gsOptionList());
+
+    /// Get the smoother (null on single precision levels)
     /// @param lvl  The corresponding level
     PrecondPtr smoother(index_t lvl) const            { return m_smoother[lvl];           }
 
+    /// @brief Store and apply the coarsest levels in single precision
+    ///
+    /// @param n    Number of levels, starting from the coarsest one (level 0),
+    ///             whose matrices, transfers and smoothers are stored in float
+    ///
+    /// The matrices and transfers in \a T of these levels are released,
+    /// except for the matrix of the finest level, which is usually shared
+    /// with the caller. The operators returned by underlyingOp and used by
+    /// restrictVector and prolongVector apply the float matrices to vectors
+    /// converted on demand. The smoothers on
+    /// these levels are the ones chosen by setSmoothers (also if it is called
+    /// afterwards). A coarse solver given by setCoarseSolver is applied in
+    /// \a T; otherwise, a sparse LU solver in float is used. This requires
+    /// the stiffness matrices and the transfers to be sparse matrices. Levels
+    /// can not be turned back to \a T.
+    void setSinglePrecisionLevels(index_t n);
+
+    /// Number of levels stored in single precision, see setSinglePrecisionLevels
+    index_t singlePrecisionLevels() const             { return m_singleLevels;            }
+
+    /// @brief Number of bytes of the stiffness matrices and of the transfers
+    ///
+    /// All matrices stored by the multigrid solver are taken into account,
+    /// both in \a T and in float. Operators not stored as sparse matrices
+    /// are not.
+    size_t memoryUsage() const;
+
     /// Set the solver for the coarsest problem (level 0)
     void setCoarseSolver(const OpPtr& sol)            { m_coarseSolver = sol;             }
 
@@ -392,6 +464,29 @@ private:
     /// Damping for the coarse-grid correction
     T m_damping;
 
+    /// Number of levels stored in single precision
+    index_t m_singleLevels;
+
+    /// Stiffness matrices on the single precision levels
+    std::vector<SpMatrixSinglePtr> m_opsSingle;
+
+    /// Smoothers on the single precision levels
+    std::vector<typename gsPreconditionerOp<float>::Ptr> m_smootherSingle;
+
+    /// Prolongation matrices between single precision levels
+    std::vector<SpMatrixRowMajorSinglePtr> m_prolongSingle;
+
+    /// Restriction matrices between single precision levels (null if they
+    /// are the transposed prolongation matrices)
+    std::vector<SpMatrixRowMajorSinglePtr> m_restrictSingle;
+
+    /// Solver for the coarsest-grid problem in single precision
+    mutable typename gsLinearOperator<float>::Ptr m_coarseSolverSingle;
+
+    /// Smoother type and options given to setSmoothers
+    std::string m_smootherType;
+    gsOptionList m_smootherOpt;
+
 }; // class gsMultiGridOp
 
 }  // namespace gismo
@@ -12,6 +12,9 @@
 */
 
 #include <gsSolver/gsMatrixOp.h>
+#include <gsSolver/gsSimplePreconditioners.h>
+// The smoothers on single precision levels need the sweeps for float
+#include <gsSolver/gsSimplePreconditioners.hpp>
 
 namespace gismo
 {
@@ -24,7 +27,7 @@ gsMultiGridOp<T>::gsMultiGridOp(
 )
     : m_nLevels(transferMatrices.size()+1), m_ops(m_nLevels), m_smoother(m_nLevels),
       m_prolong(m_nLevels-1), m_restrict(m_nLevels-1), m_coarseSolver(coarseSolver),
-      m_numPreSmooth(1), m_numPostSmooth(1), m_symmSmooth(true), m_damping(1)
+      m_numPreSmooth(1), m_numPostSmooth(1), m_symmSmooth(true), m_damping(1), m_singleLevels(0)
 {
     m_numCycles.setConstant(m_nLevels-1,1);
     std::vector<SpMatrixRowMajorPtr> transferMatrixPtrs(m_nLevels-1);
@@ -42,7 +45,7 @@ gsMultiGridOp<T>::gsMultiGridOp(
 )
     : m_nLevels(transferMatrices.size()+1), m_ops(m_nLevels), m_smoother(m_nLevels),
       m_prolong(m_nLevels-1), m_restrict(m_nLevels-1), m_coarseSolver(coarseSolver),
-      m_numPreSmooth(1), m_numPostSmooth(1), m_symmSmooth(true), m_damping(1)
+      m_numPreSmooth(1), m_numPostSmooth(1), m_symmSmooth(true), m_damping(1), m_singleLevels(0)
 {
     m_numCycles.setConstant(m_nLevels-1,1);
     init(give(fineMatrix),give(transferMatrices));
@@ -57,7 +60,7 @@ gsMultiGridOp<T>::gsMultiGridOp(
 )
     : m_nLevels(ops.size()), m_ops(ops), m_smoother(m_nLevels),
       m_prolong(prolongation), m_restrict(restriction), m_coarseSolver(coarseSolver),
-      m_numPreSmooth(1), m_numPostSmooth(1), m_symmSmooth(true), m_damping(1)
+      m_numPreSmooth(1), m_numPostSmooth(1), m_symmSmooth(true), m_damping(1), m_singleLevels(0)
 {
     m_numCycles.setConstant(m_nLevels-1,1);
     GISMO_ASSERT (prolongation.size() == restriction.size(),
@@ -121,9 +124,55 @@ void gsMultiGridOp<T>::initCoarseSolver() const
     }
 }
 
+template<class T>
+void gsMultiGridOp<T>::solveCoarse(const Matrix& rhs, Matrix& result) const
+{
+    if (m_singleLevels > 0 && !m_coarseSolver)
+    {
+        MatrixSingle resultSingle;
+        solveCoarseSingle(rhs.template cast<float>(), resultSingle);
+        result = resultSingle.template cast<T>();
+        return;
+    }
+    if (!m_coarseSolver) initCoarseSolver();
+    m_coarseSolver->apply(rhs, result);
+}
+
+template<class T>
+void gsMultiGridOp<T>::solveCoarseSingle(const MatrixSingle& rhs, MatrixSingle& result) const
+{
+    if (m_coarseSolver)
+    {
+        Matrix resultT;
+        m_coarseSolver->apply(rhs.template cast<T>(), resultT);
+        result = resultT.template cast<float>();
+        return;
+    }
+    if (!m_coarseSolverSingle)
+        m_coarseSolverSingle = makeSparseLUSolver(*m_opsSingle[0]);
+    m_coarseSolverSingle->apply(rhs, result);
+}
+
 template<class T>
 void gsMultiGridOp<T>::smoothingStep(index_t level, const Matrix& rhs, Matrix& x) const
 {
+    if (level < m_singleLevels)
+    {
+        MatrixSingle xSingle = x.template cast<float>();
+        const MatrixSingle rhsSingle = rhs.template cast<float>();
+        for (index_t i = 0; i < m_numPreSmooth; ++i)
+            m_smootherSingle[level]->step( rhsSingle, xSingle );
+        for (index_t i = 0; i < m_numPostSmooth; ++i)
+        {
+            if (m_symmSmooth)
+                m_smootherSingle[level]->stepT( rhsSingle, xSingle );
+            else
+                m_smootherSingle[level]->step( rhsSingle, xSingle );
+        }
+        x = xSingle.template cast<T>();
+        return;
+    }
+
     GISMO_ASSERT (m_smoother[level], "gsMultiGridOp::smoothingStep: "
         "Smoother is not defined for level "<<level<<". Define it using setSmoother.");
 
@@ -149,7 +198,14 @@ void gsMultiGridOp<T>::multiGridStep(index_t level, const Matrix& rhs, Matrix& x
 {
     GISMO_ASSERT ( 0 <= level && level < m_nLevels, "TgsMultiGridOp: the given level is not feasible." );
 
-    if (level == 0)
+    if (level < m_singleLevels)
+    {
+        // The cycle continues in single precision
+        MatrixSingle xSingle = x.template cast<float>();
+        multiGridStepSingle(level, rhs.template cast<float>(), xSingle);
+        x = xSingle.template cast<T>();
+    }
+    else if (level == 0)
     {
         solveCoarse(rhs, x);
     }
@@ -200,6 +256,62 @@ void gsMultiGridOp<T>::multiGridStep(index_t level, const Matrix& rhs, Matrix& x
     }
 }
 
+template<class T>
+void gsMultiGridOp<T>::multiGridStepSingle(index_t level, const MatrixSingle& rhs, MatrixSingle& x) const
+{
+    if (level == 0)
+    {
+        solveCoarseSingle(rhs, x);
+        return;
+    }
+
+    const index_t lf = level;
+    const index_t lc = lf - 1;
+
+    GISMO_ASSERT (m_smootherSingle[lf], "gsMultiGridOp::multiGridStep: "
+        "Smoother is not defined for level "<<lf<<". Define it using setSmoothers.");
+
+    MatrixSingle fineRes, fineCorr, coarseRes, coarseCorr;
+
+    // pre-smooth
+    for (index_t i = 0; i < m_numPreSmooth; ++i)
+    {
+        m_smootherSingle[lf]->step( rhs, x );
+    }
+
+    // compute fine residual
+    gsKrylovKernels<float>::product( *m_opsSingle[lf], x, fineRes );
+    fineRes -= rhs;
+
+    // restrict residual to coarse grid
+    if (m_restrictSingle[lc])
+        gsKrylovKernels<float>::product( *m_restrictSingle[lc], fineRes, coarseRes );
+    else
+        gsKrylovKernels<float>::product( m_prolongSingle[lc]->transpose(), fineRes, coarseRes );
+
+    // obtain coarse-grid correction by recursing
+    coarseCorr.setZero( nDofs(lc), coarseRes.cols() );
+    for (index_t i = 0; i < m_numCycles[lc]; ++i)
+    {
+        multiGridStepSingle( lc, coarseRes, coarseCorr );
+    }
+
+    // prolong correction
+    gsKrylovKernels<float>::product( *m_prolongSingle[lc], coarseCorr, fineCorr );
+
+    // apply correction
+    x -= static_cast<float>(m_damping) * fineCorr;
+
+    // post-smooth
+    for (index_t i = 0; i < m_numPostSmooth; ++i)
+    {
+        if (m_symmSmooth)
+            m_smootherSingle[lf]->stepT( rhs, x );
+        else
+            m_smootherSingle[lf]->step( rhs, x );
+    }
+}
+
 template<class T>
 void gsMultiGridOp<T>::fullMultiGrid(
     const std::vector<Matrix>& rhs,
@@ -284,18 +396,212 @@ template<class T>
 void gsMultiGridOp<T>::setSmoother(index_t lvl, const PrecondPtr& sm)
 {
     GISMO_ASSERT ( 0 <= lvl && lvl < m_nLevels, "gsMultiGrid: The given level is not feasible." );
+    GISMO_ENSURE ( lvl >= m_singleLevels, "gsMultiGridOp::setSmoother: The smoothers on single precision "
+                   "levels are set by setSmoothers." );
     m_smoother[lvl] = sm;
 }
 
+template<class T>
+template<class S>
+typename gsPreconditionerOp<S>::Ptr gsMultiGridOp<T>::makeSmoother(const std::string& type,
+    const memory::shared_ptr< gsSparseMatrix<S> >& mat, const gsOptionList& opt)
+{
+    typename gsPreconditionerOp<S>::Ptr sm;
+    if ( type == "Jacobi" )
+        sm = makeJacobiOp(mat);
+    else if ( type == "GaussSeidel" )
+        sm = makeGaussSeidelOp(mat);
+    else if ( type == "SymmetricGaussSeidel" )
+        sm = makeSymmetricGaussSeidelOp(mat);
+    else if ( type == "MultiColorGaussSeidel" )
+        sm = makeMultiColorGaussSeidelOp(mat);
+    else if ( type == "MultiColorSSOR" )
+        sm = makeMultiColorSSOROp(mat);
+    else if ( type == "Chebyshev" )
+        sm = makeChebyshevOp(mat);
+    else
+        GISMO_ERROR( "gsMultiGridOp::setSmoothers: Unknown smoother \"" << type << "\"." );
+
+    sm->setOptions(opt);
+    return sm;
+}
+
+template<class T>
+void gsMultiGridOp<T>::setSmoothers(const std::string& type, const gsOptionList& opt)
+{
+    for (index_t lvl = 0; lvl < m_nLevels; ++lvl)
+    {
+        if (lvl < m_singleLevels)
+        {
+            m_smootherSingle[lvl] = makeSmoother<float>(type, m_opsSingle[lvl], opt);
+            continue;
+        }
+        const gsMatrixOp<SpMatrix>* matrOp = dynamic_cast< const gsMatrixOp<SpMatrix>* >( m_ops[lvl].get() );
+        GISMO_ENSURE ( matrOp, "gsMultiGridOp::setSmoothers: Matrices are not available for matrix-free multigrid solvers." );
+        m_smoother[lvl] = makeSmoother<T>(type, matrOp->matrixPtr(), opt);
+    }
+    m_smootherType = type;
+    m_smootherOpt  = opt;
+}
+
+namespace internal
+{
+
+// Number of bytes of a compressed sparse matrix
+template<class SparseMatrixType>
+size_t sparseBytes(const SparseMatrixType& mat)
+{
+    return mat.nonZeros() * ( sizeof(typename SparseMatrixType::Scalar) + sizeof(typename SparseMatrixType::StorageIndex) )
+        + ( mat.outerSize() + 1 ) * sizeof(typename SparseMatrixType::StorageIndex);
+}
+
+// Copies the sparse matrix of a transfer operator to single
+// precision, returns false if it is no sparse matrix
+template<class T>
+bool transferToSingle(const gsLinearOperator<T>& op, gsSparseMatrix<float, RowMajor>& result)
+{
+    typedef gsSparseMatrix<T> SpMatrix;
+    typedef gsSparseMatrix<T, RowMajor> SpMatrixRowMajor;
+    if (const gsMatrixOp<SpMatrixRowMajor>* matrOp = dynamic_cast< const gsMatrixOp<SpMatrixRowMajor>* >( &op ))
+        result = matrOp->matrix().template cast<float>();
+    else if (const gsMatrixOp<SpMatrix>* matrOp = dynamic_cast< const gsMatrixOp<SpMatrix>* >( &op ))
+        result = matrOp->matrix().template cast<float>();
+    else
+        return false;
+    return true;
+}
+
+// Applies a matrix stored in single precision to vectors in T, which
+// are converted on every application; no copy of the matrix is kept
+template<class T, class MatrixType>
+class gsSinglePrecisionMatrixOp : public gsLinearOperator<T>
+{
+public:
+    gsSinglePrecisionMatrixOp(const memory::shared_ptr<MatrixType>& mat, bool transposed = false)
+    : m_mat(mat), m_transposed(transposed) { }
+
+    void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const override
+    {
+        if (m_transposed)
+            x = ( m_mat->transpose() * input.template cast<float>() ).template cast<T>();
+        else
+            x = ( *m_mat * input.template cast<float>() ).template cast<T>();
+    }
+
+    index_t rows() const override { return m_transposed ? m_mat->cols() : m_mat->rows(); }
+
+    index_t cols() const override { return m_transposed ? m_mat->rows() : m_mat->cols(); }
+
+private:
+    memory::shared_ptr<MatrixType> m_mat;
+    bool m_transposed;
+};
+
+} // namespace internal
+
+template<class T>
+void gsMultiGridOp<T>::setSinglePrecisionLevels(index_t n)
+{
+    GISMO_ENSURE ( 0 <= n && n <= m_nLevels, "gsMultiGridOp::setSinglePrecisionLevels: "
+                   "The number of levels "<<n<<" is not feasible." );
+    GISMO_ENSURE ( n >= m_singleLevels, "gsMultiGridOp::setSinglePrecisionLevels: "
+                   "Single precision levels can not be turned back." );
+    if (n == m_singleLevels)
+        return;
+
+    m_opsSingle.resize(m_nLevels);
+    m_smootherSingle.resize(m_nLevels);
+    m_prolongSingle.resize(m_nLevels-1);
+    m_restrictSingle.resize(m_nLevels-1);
+
+    for (index_t lvl = m_singleLevels; lvl < n; ++lvl)
+    {
+        const gsMatrixOp<SpMatrix>* matrOp = dynamic_cast< const gsMatrixOp<SpMatrix>* >( m_ops[lvl].get() );
+        GISMO_ENSURE ( matrOp, "gsMultiGridOp::setSinglePrecisionLevels: Matrices are not available for "
+                       "matrix-free multigrid solvers." );
+        m_opsSingle[lvl] = memory::make_shared( new gsSparseMatrix<float>( matrOp->matrix().template cast<float>() ) );
+        // The matrix on the finest level is usually needed by the caller
+        if (lvl < finestLevel())
+            m_ops[lvl] = memory::make_shared( new internal::gsSinglePrecisionMatrixOp<T, gsSparseMatrix<float> >( m_opsSingle[lvl] ) );
+        m_smoother[lvl].reset();
+        if (!m_smootherType.empty())
+            m_smootherSingle[lvl] = makeSmoother<float>(m_smootherType, m_opsSingle[lvl], m_smootherOpt);
+    }
+
+    // Transfers between two single precision levels
+    for (index_t lc = math::max(m_singleLevels-1, (index_t)0); lc < n-1; ++lc)
+    {
+        m_prolongSingle[lc] = memory::make_shared( new gsSparseMatrix<float, RowMajor> );
+        GISMO_ENSURE ( internal::transferToSingle(*m_prolong[lc], *m_prolongSingle[lc]),
+                       "gsMultiGridOp::setSinglePrecisionLevels: The prolongation is no sparse matrix." );
+
+        // The restriction is either a sparse matrix or, as set up by the
+        // constructors taking transfer matrices, the transposed prolongation
+        m_restrictSingle[lc] = memory::make_shared( new gsSparseMatrix<float, RowMajor> );
+        // The operators in T, used by restrictVector and prolongVector, are
+        // applied to the single precision matrices
+        typedef internal::gsSinglePrecisionMatrixOp<T, gsSparseMatrix<float, RowMajor> > TransferOp;
+        if ( internal::transferToSingle(*m_restrict[lc], *m_restrictSingle[lc]) )
+            m_restrict[lc] = memory::make_shared( new TransferOp( m_restrictSingle[lc] ) );
+        else
+        {
+            GISMO_ENSURE ( dynamic_cast< const gsMatrixOp< gsEigen::Transpose<typename SpMatrixRowMajor::Base> >* >
+                           ( m_restrict[lc].get() ), "gsMultiGridOp::setSinglePrecisionLevels: "
+                           "The restriction is no sparse matrix." );
+            m_restrictSingle[lc].reset();
+            m_restrict[lc] = memory::make_shared( new TransferOp( m_prolongSingle[lc], true ) );
+        }
+        m_prolong[lc] = memory::make_shared( new TransferOp( m_prolongSingle[lc] ) );
+    }
+
+    m_coarseSolverSingle.reset();
+    m_singleLevels = n;
+}
+
 template<class T>
 const typename gsMultiGridOp<T>::SpMatrix& gsMultiGridOp<T>::matrix(index_t lvl) const
 {
     const gsMatrixOp<SpMatrix>* matrOp = dynamic_cast< const gsMatrixOp<SpMatrix>* >( m_ops[lvl].get() );
+    GISMO_ENSURE ( matrOp || lvl >= m_singleLevels, "gsMultiGridOp::matrix: The matrix of level "<<lvl<<" is "
+                   "only stored in single precision, see matrixSingle." );
     GISMO_ASSERT ( matrOp, "Matrices are not available for matrix-free multigrid solvers." );
     //return matrOp->matrix(); does not work because we must not return a temporary
     return *(matrOp->matrixPtr());
 }
 
+template<class T>
+size_t gsMultiGridOp<T>::memoryUsage() const
+{
+    size_t result = 0;
+    for (index_t lvl = 0; lvl < m_nLevels; ++lvl)
+    {
+        if (lvl < m_singleLevels)
+            result += internal::sparseBytes(*m_opsSingle[lvl]);
+        if (const gsMatrixOp<SpMatrix>* matrOp = dynamic_cast< const gsMatrixOp<SpMatrix>* >( m_ops[lvl].get() ))
+            result += internal::sparseBytes(matrOp->matrix());
+    }
+    for (index_t lc = 0; lc < m_nLevels-1; ++lc)
+    {
+        if (lc < m_singleLevels-1)
+        {
+            result += internal::sparseBytes(*m_prolongSingle[lc]);
+            if (m_restrictSingle[lc])
+                result += internal::sparseBytes(*m_restrictSingle[lc]);
+        }
+        // The transposed prolongation shares its storage, the operators
+        // of the single precision levels store no matrices in T
+        const gsLinearOperator<T>* transfers[2] = { m_prolong[lc].get(), m_restrict[lc].get() };
+        for (index_t k = 0; k < 2; ++k)
+        {
+            if (const gsMatrixOp<SpMatrixRowMajor>* matrOp = dynamic_cast< const gsMatrixOp<SpMatrixRowMajor>* >( transfers[k] ))
+                result += internal::sparseBytes(matrOp->matrix());
+            else if (const gsMatrixOp<SpMatrix>* matrOp = dynamic_cast< const gsMatrixOp<SpMatrix>* >( transfers[k] ))
+                result += internal::sparseBytes(matrOp->matrix());
+        }
+    }
+    return result;
+}
+
 template<class T>
 gsOptionList gsMultiGridOp<T>::defaultOptions()
 {
@@ -305,6 +611,11 @@ gsOptionList gsMultiGridOp<T>::defaultOptions()
     opt.addInt   ("NumCycles"                   , "Number of cycles (usually 1 for V-cycle or 2 for W-cycle)",             1 );
     opt.addReal  ("CoarseGridCorrectionDamping" , "Damping of the coarse-grid correction (usually 1)", (gsOptionList::Real)1 );
     opt.addSwitch("SymmSmooth"                  , "Iff true, stepT is called for post-smoothing",           true );
+    opt.addString("Smoother"                    , "Smoother on all levels (Jacobi, GaussSeidel, SymmetricGaussSeidel, "
+                                                  "MultiColorGaussSeidel, MultiColorSSOR or Chebyshev), "
+                                                  "empty to keep the ones given by setSmoother",            "" );
+    opt.addInt   ("SinglePrecisionLevels"       , "Number of coarsest levels which are stored and smoothed in single "
+                                                  "precision (float), see setSinglePrecisionLevels",       0 );
 
     return opt;
 }
@@ -325,6 +636,14 @@ void gsMultiGridOp<T>::setOptions(const gsOptionList & opt)
         // The direct solver on coarsest level is only invoked once
         m_numCycles[0] = 1;
     }
+
+    const index_t sl   = opt.askInt   ("SinglePrecisionLevels"       , m_singleLevels    );
+    if (sl != m_singleLevels)
+        setSinglePrecisionLevels(sl);
+
+    const std::string smoother = opt.askString("Smoother", "");
+    if (!smoother.empty())
+        setSmoothers(smoother, opt);
 }
 
 }
@@ -610,6 +610,16 @@ protected:
     /// @brief Adjusts endknots so that the knot vector can be made periodic.
     void _stretchEndKnots();
 
+    /// @brief Evaluates the basis functions which are active on the
+    /// knot span \a span and their derivatives up to order \a n at
+    /// the \a nb points u(0,v0), ..., u(0,v0+nb-1), which all lie in
+    /// this span. The values are written to the columns v0, ...,
+    /// v0+nb-1 of \a result, the k-th derivatives without the factor
+    /// p!/(p-k)!. Used by evalAllDers_into.
+    void _evalAllDersSpan(const typename KnotVectorType::iterator & span,
+                          const gsMatrix<T> & u, const index_t v0, const index_t nb,
+                          const int n, std::vector<gsMatrix<T> >& result) const;
+
 public:
 
     /// @brief Helper function for evaluation with periodic basis.
@@ -891,167 +891,162 @@ void gsTensorBSplineBasis<1,T>::
 evalAllDers_into(const gsMatrix<T> & u, int n,
                  std::vector<gsMatrix<T> >& result) const
 {
-    // TO DO : Use less memory proportionally to n
-    // Only last n+1 columns and last n rows of ndu are needed
-    // Also a's size is proportional to n
     GISMO_ASSERT( u.rows() == 1 , "gsBSplineBasis accepts points with one coordinate.");
 
-    const int p1 = m_p + 1;       // degree plus one
-
-    STACK_ARRAY(T, ndu,  p1 * p1 );
-    STACK_ARRAY(T, left, p1);
-    STACK_ARRAY(T, right, p1);
-    STACK_ARRAY(T, a, 2 * p1);
-
     result.resize(n+1);
     for(int k=0; k<=n; k++)
         result[k].resize(m_p + 1, u.cols());
 
-#if FALSE
-
-    const int pn = m_p - n;
-
-    for (index_t v = 0; v < u.cols(); ++v) // for all columns of u
+    // Consecutive points of the same knot span (e.g. the quadrature
+    // nodes of an element) are evaluated together, in blocks
+    const index_t maxBlock = 16;
+    for (index_t v = 0; v < u.cols(); ) // for all columns of u
     {
         // Check if the point is in the domain
         if ( ! inDomain( u(0,v) ) )
         {
-            // gsWarn<< "Point "<< u(0,v) <<" not in the BSpline domain.\n";
+            //gsDebug<< "Point "<< u(0,v) <<" not in the BSpline domain ["
+            //      << *(m_knots.begin()+m_p)<< ", "<<*(m_knots.end()-m_p-1)<<"].\n";
             for(int k=0; k<=n; k++)
                 result[k].col(v).setZero();
+            ++v;
             continue;
         }
 
-        // Run evaluation algorithm and keep the function values triangle & the knot differences
-        unsigned span = m_knots.findspan( u(0,v) ) ;     // Get span of absissae
-
-        for(int j=1; j<= m_p; j++) // For all degrees ( ndu column)
-        {
-            // Compute knot splits
-            left[j]  = u(0,v) - m_knots[span+1-j];
-            right[j] = m_knots[span+j] - u(0,v);
-        }
+        typename KnotVectorType::iterator span = m_knots.iFind( u(0,v) );
+        index_t nb = 1;
+        while ( nb < maxBlock && v + nb < u.cols() && inDomain( u(0,v+nb) )
+                && ( ( *span <= u(0,v+nb) && u(0,v+nb) < *(span+1) )
+                     || span == m_knots.iFind( u(0,v+nb) ) ) )
+            ++nb;
+
+        _evalAllDersSpan(span, u, v, nb, n, result);
+        v += nb;
+    }
 
-        ndu[0] = (T)(1) ; // 0-th degree function value
-        T saved = (T)(0) ;
-        // Compute Basis functions of degree m_p-n ( ndu[] )
-        for(int r=0; r<pn ; r++) // For all (except the last) basis functions of degree m_p-n
-        {
-            const T temp = ndu[r*p1 + pn -1] / ( right[r+1] + left[pn-r] ) ;
-            ndu[r*p1 + pn] = saved + right[r+1] * temp ;// r-th function value of degree j
-            saved = left[pn-r] * temp ;
-        }
-        ndu[pn*p1 + pn] = saved ;
+    // Multiply through by the factor factorial(m_p)/factorial(m_p-k)
+    int r = m_p ;
+    for(int k=1; k<=n; k++)
+    {
+        result[k].array() *= (T)(r) ;
+        r *= m_p - k ;
+    }
+}
 
-        // Compute n-th derivative and continue to n-1 ... 0
+template <class T>
+void gsTensorBSplineBasis<1,T>::
+_evalAllDersSpan(const typename KnotVectorType::iterator & span,
+                 const gsMatrix<T> & u, const index_t v0, const index_t nb,
+                 const int n, std::vector<gsMatrix<T> >& result) const
+{
+    const int p1 = m_p + 1;       // degree plus one
 
-        for(int r=0; r<pn ; r++) // For all (except the last)  basis functions of degree j ( ndu row)
-        {
-            // Strictly lower triangular part: Knot differences of distance j
-            ndu[j*p1 + r] = right[r+1]+left[j-r] ;
-            const T temp = ndu[r*p1 + j-1] / ndu[j*p1 + r] ;
-            // Upper triangular part: Basis functions of degree j
-            ndu[r*p1 + j] = saved + right[r+1] * temp ;// r-th function value of degree j
-            saved = left[j-r] * temp ;
-        }
-        // Diagonal: j-th (last) function value of degree j
-        ndu[j*p1 + j] = saved ;
-    }
+    // Point-dependent quantities are stored with the nb points
+    // contiguous, so that the loops over the points vectorize:
+    // ndu[(r*p1+j)*nb + b] is the r-th function of degree j at point b
+    STACK_ARRAY(T, ndu,   p1 * p1 * nb);
+    STACK_ARRAY(T, left,  p1 * nb);
+    STACK_ARRAY(T, right, p1 * nb);
+    STACK_ARRAY(T, saved, nb);
+    STACK_ARRAY(T, d,     nb);
+    // Knot differences (same for all points of the span) and
+    // derivative coefficients
+    STACK_ARRAY(T, kd, p1 * p1);
+    STACK_ARRAY(T, a, 2 * p1);
 
-#endif
+    const T * x = u.data() + v0;
 
-    for (index_t v = 0; v < u.cols(); ++v) // for all columns of u
+    for (index_t b = 0; b != nb; ++b)
+        ndu[b] = (T)(1) ; // 0-th degree function value
+    for(int j=1; j<= m_p; j++) // For all degrees ( ndu column)
     {
-        // Check if the point is in the domain
-        if ( ! inDomain( u(0,v) ) )
+        // Compute knot splits
+        const T kl = *(span+1-j), kr = *(span+j);
+        T * lj = left + j*nb, * rj = right + j*nb;
+        for (index_t b = 0; b != nb; ++b)
         {
-            //gsDebug<< "Point "<< u(0,v) <<" not in the BSpline domain ["
-            //      << *(m_knots.begin()+m_p)<< ", "<<*(m_knots.end()-m_p-1)<<"].\n";
-            for(int k=0; k<=n; k++)
-                result[k].col(v).setZero();
-            continue;
+            lj[b] = x[b] - kl;
+            rj[b] = kr - x[b];
         }
 
-        // Run evaluation algorithm and keep the function values triangle & the knot differences
-        typename KnotVectorType::iterator span = m_knots.iFind( u(0,v) );
-
-        ndu[0] = (T)(1) ; // 0-th degree function value
-        for(int j=1; j<= m_p; j++) // For all degrees ( ndu column)
+        std::fill(saved, saved + nb, (T)(0));
+        for(int r=0; r<j ; r++) // For all (except the last)  basis functions of degree j ( ndu row)
         {
-            // Compute knot splits
-            left[j] = u(0,v) - *(span+1-j);
-            right[j] = *(span+j) - u(0,v);
-
-            T saved = (T)(0) ;
-
-            for(int r=0; r<j ; r++) // For all (except the last)  basis functions of degree j ( ndu row)
+            // Knot differences of distance j
+            kd[j*p1 + r] = *(span+r+1) - *(span+1-j+r) ;
+            const T inv = (T)(1) / kd[j*p1 + r];
+            const T * prev = ndu + (r*p1 + j-1)*nb;
+            T * cur = ndu + (r*p1 + j)*nb;
+            const T * rr = right + (r+1)*nb, * ll = left + (j-r)*nb;
+            for (index_t b = 0; b != nb; ++b)
             {
-                // Strictly lower triangular part: Knot differences of distance j
-                ndu[j*p1 + r] = right[r+1]+left[j-r] ;
-                const T temp = ndu[r*p1 + j-1] / ndu[j*p1 + r] ;
-                // Upper triangular part: Basis functions of degree j
-                ndu[r*p1 + j] = saved + right[r+1] * temp ;// r-th function value of degree j
-                saved = left[j-r] * temp ;
+                const T temp = prev[b] * inv ;
+                // Basis functions of degree j
+                cur[b]   = saved[b] + rr[b] * temp ;// r-th function value of degree j
+                saved[b] = ll[b] * temp ;
             }
-            // Diagonal: j-th (last) function value of degree j
-            ndu[j*p1 + j] = saved ;
         }
+        // j-th (last) function value of degree j
+        std::copy(saved, saved + nb, ndu + (j*p1 + j)*nb);
+    }
 
-        // Assign 0-derivative equal to function values
-        //result.front().block(0,v, p1,1) = ndu.col(m_p);
-        for (int j=0; j <= m_p ; ++j )
-            result.front()(j,v) = ndu[j*p1 + m_p];
+    // Assign 0-derivative equal to function values
+    for (int j=0; j <= m_p ; ++j )
+    {
+        const T * val = ndu + (j*p1 + m_p)*nb;
+        for (index_t b = 0; b != nb; ++b)
+            result.front()(j,v0+b) = val[b];
+    }
 
-        // Compute the derivatives
-        for(int r = 0; r <= m_p; r++)
-        {
-            // alternate rows in array a
-            T* a1 = &a[0];
-            T* a2 = &a[p1];
+    // Compute the derivatives; the coefficients a depend only on the
+    // knots, therefore they are computed once for all points
+    for(int r = 0; r <= m_p; r++)
+    {
+        // alternate rows in array a
+        T* a1 = &a[0];
+        T* a2 = &a[p1];
 
-            a1[0] = (T)(1) ;
+        a1[0] = (T)(1) ;
 
-            // Compute the k-th derivative of the r-th basis function
-            for(int k=1; k<=n; k++)
-            {
-                int rk,pk,j1,j2 ;
-                T d(0) ;
-                rk = r-k ; pk = m_p-k ;
+        // Compute the k-th derivative of the r-th basis function
+        for(int k=1; k<=n; k++)
+        {
+            int rk,pk,j1,j2 ;
+            rk = r-k ; pk = m_p-k ;
+            std::fill(d, d + nb, (T)(0));
 
-                if(r >= k)
-                {
-                    a2[0] = a1[0] / ndu[ (pk+1)*p1 + rk] ;
-                    d = a2[0] * ndu[rk*p1 + pk] ;
-                }
+            if(r >= k)
+            {
+                a2[0] = a1[0] / kd[ (pk+1)*p1 + rk] ;
+                const T * N = ndu + (rk*p1 + pk)*nb;
+                for (index_t b = 0; b != nb; ++b)
+                    d[b] = a2[0] * N[b] ;
+            }
 
-                j1 = ( rk >= -1  ? 1   : -rk     );
-                j2 = ( r-1 <= pk ? k-1 : m_p - r );
+            j1 = ( rk >= -1  ? 1   : -rk     );
+            j2 = ( r-1 <= pk ? k-1 : m_p - r );
 
-                for(int j = j1; j <= j2; j++)
-                {
-                    a2[j] = (a1[j] - a1[j-1]) / ndu[(pk+1)*p1 + rk+j] ;
-                    d += a2[j] * ndu[(rk+j)*p1 + pk] ;
-                }
+            for(int j = j1; j <= j2; j++)
+            {
+                a2[j] = (a1[j] - a1[j-1]) / kd[(pk+1)*p1 + rk+j] ;
+                const T * N = ndu + ((rk+j)*p1 + pk)*nb;
+                for (index_t b = 0; b != nb; ++b)
+                    d[b] += a2[j] * N[b] ;
+            }
 
-                if(r <= pk)
-                {
-                    a2[k] = -a1[k-1] / ndu[(pk+1)*p1 + r] ;
-                    d += a2[k] * ndu[r*p1 + pk] ;
-                }
+            if(r <= pk)
+            {
+                a2[k] = -a1[k-1] / kd[(pk+1)*p1 + r] ;
+                const T * N = ndu + (r*p1 + pk)*nb;
+                for (index_t b = 0; b != nb; ++b)
+                    d[b] += a2[k] * N[b] ;
+            }
 
-                result[k](r, v) = d;
+            for (index_t b = 0; b != nb; ++b)
+                result[k](r, v0+b) = d[b];
 
-                std::swap(a1, a2);              // Switch rows
-            }
+            std::swap(a1, a2);              // Switch rows
         }
-    }// end for all columns v
-
-    // Multiply through by the factor factorial(m_p)/factorial(m_p-k)
-    int r = m_p ;
-    for(int k=1; k<=n; k++)
-    {
-        result[k].array() *= (T)(r) ;
-        r *= m_p - k ;
     }
 }
 
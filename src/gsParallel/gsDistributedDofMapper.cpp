@@ -0,0 +1,88 @@
+/** @file gsDistributedDofMapper.cpp
+
+    @brief Distribution of the degrees of freedom of a gsDofMapper over
+    the processes, based on an assignment of the patches
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#include <gsParallel/gsDistributedDofMapper.h>
+
+namespace gismo
+{
+
+void gsDistributedDofMapper::init(const gsDofMapper & mapper,
+                                  const std::vector<index_t> & patchRank,
+                                  const gsMpiComm & comm)
+{
+    GISMO_ASSERT(mapper.isFinalized(), "finalize() was not called on gsDofMapper");
+    GISMO_ASSERT(patchRank.size() == mapper.numPatches(),
+                 "The number of patches does not match: "
+                 << patchRank.size() << "!=" << mapper.numPatches());
+
+    m_mapper    = mapper;
+    m_comm      = comm;
+    m_rank      = comm.rank();
+    m_patchRank = patchRank;
+
+    const index_t np = comm.size(), nPatches = static_cast<index_t>(patchRank.size());
+    const index_t nDofs = mapper.freeSize(), nComp = static_cast<index_t>(mapper.componentsSize());
+
+    m_localPatches.clear();
+    for (index_t k = 0; k < nPatches; ++k)
+    {
+        GISMO_ENSURE(0 <= patchRank[k] && patchRank[k] < np,
+                     "Invalid rank "<<patchRank[k]<<" for patch "<<k);
+        if (patchRank[k] == m_rank)
+            m_localPatches.push_back(k);
+    }
+
+    // The owner of a dof is the smallest rank among its patches
+    std::vector<index_t> owner(nDofs, np);
+    std::vector<bool> onLocalPatch(nDofs, false);
+    for (index_t k = 0; k < nPatches; ++k)
+        for (index_t c = 0; c < nComp; ++c)
+        {
+            const index_t sz = static_cast<index_t>(mapper.patchSize(k, c));
+            for (index_t i = 0; i < sz; ++i)
+                if (mapper.is_free(i, k, c))
+                {
+                    const index_t gl = mapper.freeIndex(i, k, c);
+                    owner[gl] = math::min(owner[gl], patchRank[k]);
+                    if (patchRank[k] == m_rank)
+                        onLocalPatch[gl] = true;
+                }
+        }
+
+    // Renumbering by owner, in the order of the serial numbering
+    m_offsets.assign(np + 1, 0);
+    for (index_t gl = 0; gl < nDofs; ++gl)
+    {
+        GISMO_ASSERT(owner[gl] < np, "The dof "<<gl<<" does not belong to any patch.");
+        ++m_offsets[owner[gl] + 1];
+    }
+    for (index_t p = 0; p < np; ++p)
+        m_offsets[p+1] += m_offsets[p];
+
+    std::vector<index_t> next(m_offsets.begin(), m_offsets.end() - 1);
+    m_toDistributed.resize(nDofs);
+    m_toSerial.resize(nDofs);
+    m_ghosts.clear();
+    for (index_t gl = 0; gl < nDofs; ++gl)
+    {
+        const index_t d = next[owner[gl]]++;
+        m_toDistributed[gl] = d;
+        m_toSerial[d] = gl;
+        if (onLocalPatch[gl] && owner[gl] != m_rank)
+            m_ghosts.push_back(d);
+    }
+    std::sort(m_ghosts.begin(), m_ghosts.end());
+}
+
+} // namespace gismo
@@ -0,0 +1,258 @@
+/** @file gsDistributedDofMapper.h
+
+    @brief Distribution of the degrees of freedom of a gsDofMapper over
+    the processes, based on an assignment of the patches
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsCore/gsDofMapper.h>
+#include <gsParallel/gsMpi.h>
+
+namespace gismo
+{
+
+/**
+   @brief Distributes the free degrees of freedom of a (finalized)
+   gsDofMapper over the processes of a communicator
+
+   Every patch is assigned to one process. A dof is owned by the process
+   with the smallest rank among the processes of the patches it belongs
+   to, so the dofs on an interface between patches of different
+   processes have exactly one owner.
+
+   The dofs are renumbered such that every process owns a contiguous
+   range of the new (distributed) global numbering: the dofs owned by
+   process p are the indices offsets()[p], ..., offsets()[p+1]-1, in the
+   order of the serial numbering. These are the rows of the
+   gsDistributedSparseMatrix and the entries of the distributed vectors,
+   which are gsMatrix objects holding the owned entries only.
+
+   The ghosts of a process are the dofs on its patches which are owned
+   by other processes. The local numbering of a process consists of its
+   owned dofs followed by its ghosts.
+
+   The assignment is replicated on every process, no communication is
+   needed for the setup.
+
+   @ingroup Mpi
+*/
+class GISMO_EXPORT gsDistributedDofMapper
+{
+public:
+
+    /// Default empty constructor
+    gsDistributedDofMapper() : m_rank(0) { }
+
+    /// @brief Distributes the dofs of \a mapper
+    ///
+    /// @param mapper    the serial dof mapper, must be finalized
+    /// @param patchRank the rank of the process of every patch
+    /// @param comm      the communicator
+    gsDistributedDofMapper(const gsDofMapper & mapper,
+                           const std::vector<index_t> & patchRank,
+                           const gsMpiComm & comm)
+    { init(mapper, patchRank, comm); }
+
+    /// @copydoc gsDistributedDofMapper(const gsDofMapper&,const std::vector<index_t>&,const gsMpiComm&)
+    void init(const gsDofMapper & mapper,
+              const std::vector<index_t> & patchRank,
+              const gsMpiComm & comm);
+
+    /// The serial dof mapper
+    const gsDofMapper & serialMapper() const { return m_mapper; }
+
+    /// The communicator
+    const gsMpiComm & comm() const { return m_comm; }
+
+    /// The total number of (free) dofs
+    index_t globalSize() const { return m_offsets.back(); }
+
+    /// The number of dofs owned by this process
+    index_t ownedSize() const { return m_offsets[m_rank+1] - m_offsets[m_rank]; }
+
+    /// The global index of the first dof owned by this process
+    index_t firstOwned() const { return m_offsets[m_rank]; }
+
+    /// The first global index owned by every process, followed by the global size
+    const std::vector<index_t> & offsets() const { return m_offsets; }
+
+    /// The number of ghosts of this process
+    index_t ghostSize() const { return static_cast<index_t>(m_ghosts.size()); }
+
+    /// The sorted global indices of the ghosts of this process
+    const std::vector<index_t> & ghosts() const { return m_ghosts; }
+
+    /// The number of owned dofs and ghosts
+    index_t localSize() const { return ownedSize() + ghostSize(); }
+
+    /// The patches assigned to this process
+    const std::vector<index_t> & localPatches() const { return m_localPatches; }
+
+    /// The rank of the process of patch \a k
+    index_t patchOwner(index_t k) const { return m_patchRank[k]; }
+
+    /// The rank of the process owning global dof \a gl
+    index_t owner(index_t gl) const
+    {
+        GISMO_ASSERT(0 <= gl && gl < globalSize(), "Invalid index "<<gl);
+        return static_cast<index_t>( std::upper_bound(m_offsets.begin(), m_offsets.end(), gl)
+                                     - m_offsets.begin() ) - 1;
+    }
+
+    /// Returns true if local dof \a i of patch \a k is not eliminated
+    bool is_free(index_t i, index_t k = 0, index_t c = 0) const
+    { return m_mapper.is_free(i, k, c); }
+
+    /// The global index of the free local dof \a i of patch \a k
+    index_t index(index_t i, index_t k = 0, index_t c = 0) const
+    {
+        GISMO_ASSERT(m_mapper.is_free(i, k, c), "The dof is eliminated.");
+        return m_toDistributed[m_mapper.freeIndex(i, k, c)];
+    }
+
+    /// The global index of the free dof with index \a gl of the serial mapper
+    /// (not shifted)
+    index_t fromSerial(index_t gl) const { return m_toDistributed[gl]; }
+
+    /// The index of the serial mapper (not shifted) of global dof \a gl
+    index_t toSerial(index_t gl) const { return m_toSerial[gl]; }
+
+    /// @brief The local index of global dof \a gl
+    ///
+    /// Returns -1 if the dof is neither owned by this process nor a ghost
+    index_t localIndex(index_t gl) const
+    {
+        const index_t first = firstOwned();
+        if (first <= gl && gl < m_offsets[m_rank+1])
+            return gl - first;
+        std::vector<index_t>::const_iterator it =
+            std::lower_bound(m_ghosts.begin(), m_ghosts.end(), gl);
+        return (it != m_ghosts.end() && *it == gl)
+            ? ownedSize() + static_cast<index_t>(it - m_ghosts.begin()) : -1;
+    }
+
+    /// The global index of local dof \a loc
+    index_t globalIndex(index_t loc) const
+    { return loc < ownedSize() ? firstOwned() + loc : m_ghosts[loc - ownedSize()]; }
+
+    /// @brief Extracts the rows owned by this process of \a serial,
+    /// given in the serial numbering
+    template<class T>
+    void restrict(const gsMatrix<T> & serial, gsMatrix<T> & owned) const
+    {
+        GISMO_ASSERT(serial.rows() == globalSize(), "Sizes do not match");
+        const index_t n = ownedSize(), first = firstOwned();
+        owned.resize(n, serial.cols());
+        for (index_t i = 0; i < n; ++i)
+            owned.row(i) = serial.row(m_toSerial[first+i]);
+    }
+
+    /// @brief Gathers the rows \a owned by the processes into \a serial,
+    /// in the serial numbering, on every process
+    template<class T>
+    void gather(const gsMatrix<T> & owned, gsMatrix<T> & serial) const
+    {
+        GISMO_ASSERT(owned.rows() == ownedSize(), "Sizes do not match");
+        const int np = m_comm.size();
+        const index_t nc = owned.cols();
+        std::vector<int> counts(np), displ(np);
+        for (int p = 0; p < np; ++p)
+        {
+            counts[p] = static_cast<int>( (m_offsets[p+1] - m_offsets[p]) * nc );
+            displ [p] = static_cast<int>( m_offsets[p] * nc );
+        }
+        // Transposed, such that the block of every process is contiguous
+        gsMatrix<T> local = owned.transpose(), all(nc, globalSize());
+        m_comm.allgatherv(local.data(), counts[m_rank], all.data(), counts.data(), displ.data());
+        serial.resize(globalSize(), nc);
+        for (index_t gl = 0; gl < globalSize(); ++gl)
+            serial.row(m_toSerial[gl]) = all.col(gl).transpose();
+    }
+
+    /// @brief Sums the contributions of all processes to the rows owned
+    /// by this process
+    ///
+    /// \a contributions is given in the (distributed) global numbering.
+    /// Its non-zero entries in rows owned by other processes are sent to
+    /// their owners.
+    template<class T>
+    void accumulate(const gsMatrix<T> & contributions, gsMatrix<T> & owned) const;
+
+private:
+    gsDofMapper m_mapper;
+    gsMpiComm m_comm;
+    index_t m_rank;
+
+    std::vector<index_t> m_patchRank;
+    std::vector<index_t> m_localPatches;
+    std::vector<index_t> m_offsets;
+    std::vector<index_t> m_ghosts;
+    std::vector<index_t> m_toDistributed;   // serial -> distributed numbering
+    std::vector<index_t> m_toSerial;        // distributed -> serial numbering
+};
+
+template<class T>
+void gsDistributedDofMapper::accumulate(const gsMatrix<T> & contributions, gsMatrix<T> & owned) const
+{
+    GISMO_ASSERT(contributions.rows() == globalSize(), "Sizes do not match");
+    const int np = m_comm.size();
+    const index_t nc = contributions.cols(), first = firstOwned();
+    owned = contributions.middleRows(first, ownedSize());
+    if (np == 1) return;
+
+    // Pairs (row, column) and values of the non-zeros owned by others
+    std::vector<int> sendCount(np, 0), recvCount(np), sendDispl(np+1, 0), recvDispl(np+1, 0);
+    std::vector<index_t> idx;
+    std::vector<T> val;
+    for (int p = 0; p < np; ++p)
+    {
+        if (p != m_rank)
+            for (index_t i = m_offsets[p]; i < m_offsets[p+1]; ++i)
+                for (index_t j = 0; j < nc; ++j)
+                    if (contributions(i,j) != T(0))
+                    {
+                        idx.push_back(i - m_offsets[p]);
+                        idx.push_back(j);
+                        val.push_back(contributions(i,j));
+                    }
+        sendDispl[p+1] = static_cast<int>(val.size());
+        sendCount[p]   = sendDispl[p+1] - sendDispl[p];
+    }
+
+    m_comm.alltoall(sendCount.data(), recvCount.data(), 1, 1);
+    for (int p = 0; p < np; ++p)
+        recvDispl[p+1] = recvDispl[p] + recvCount[p];
+
+    std::vector<T> recvVal(recvDispl[np]);
+    m_comm.alltoallv(val.data(), sendCount.data(), sendDispl.data(),
+                     recvVal.data(), recvCount.data(), recvDispl.data());
+
+    // Two indices per value
+    for (int p = 0; p <= np; ++p)
+    {
+        if (p < np)
+        {
+            sendCount[p] *= 2;
+            recvCount[p] *= 2;
+        }
+        sendDispl[p] *= 2;
+        recvDispl[p] *= 2;
+    }
+    std::vector<index_t> recvIdx(recvDispl[np]);
+    m_comm.alltoallv(idx.data(), sendCount.data(), sendDispl.data(),
+                     recvIdx.data(), recvCount.data(), recvDispl.data());
+
+    for (size_t k = 0; k != recvVal.size(); ++k)
+        owned(recvIdx[2*k], recvIdx[2*k+1]) += recvVal[k];
+}
+
+} // namespace gismo
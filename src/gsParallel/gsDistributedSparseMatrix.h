@@ -0,0 +1,145 @@
+/** @file gsDistributedSparseMatrix.h
+
+    @brief Sparse matrix whose rows are distributed over the processes
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsCore/gsLinearAlgebra.h>
+#include <gsParallel/gsHaloExchange.h>
+
+namespace gismo
+{
+
+/**
+   @brief A square sparse matrix whose rows are distributed over the
+   processes of a communicator
+
+   Every process owns a contiguous range of the rows (given by the
+   offsets, as in gsDistributedDofMapper), and the same range of the
+   entries of the distributed vectors. The distributed vectors are
+   gsMatrix objects holding the owned entries only.
+
+   The owned rows are stored in two row-major blocks: the diagonal block
+   of the columns owned by this process, and the off-diagonal block of
+   the other columns, the ghosts. The product with a distributed vector
+   starts the exchange of the ghost values (see gsHaloExchange), then
+   multiplies the diagonal block, and the off-diagonal block as soon as
+   the ghost values have arrived. By default the exchange uses
+   persistent requests, which are initialized in the first product and
+   restarted in the following ones (see gsHaloExchange::mode).
+
+   The diagonal block can be used to set up local preconditioners, like
+   a block Jacobi method with one block per process.
+
+   \ingroup Mpi
+*/
+template<class T = real_t>
+class gsDistributedSparseMatrix
+{
+public:
+    typedef memory::shared_ptr<gsDistributedSparseMatrix> Ptr;
+    typedef memory::unique_ptr<gsDistributedSparseMatrix> uPtr;
+
+    typedef gsSparseMatrix<T,RowMajor> LocalMatrix;
+
+    /// Empty matrix
+    gsDistributedSparseMatrix() { }
+
+    /// @brief Sets up the matrix from the contributions of the processes
+    ///
+    /// @param contributions the contributions of this process, in the
+    ///                      (distributed) global numbering. The entries
+    ///                      in rows owned by other processes are sent to
+    ///                      their owners, and all contributions are summed.
+    /// @param offsets       the first row owned by every process, followed
+    ///                      by the global size
+    /// @param comm          the communicator
+    gsDistributedSparseMatrix(const gsSparseMatrix<T> & contributions,
+                              const std::vector<index_t> & offsets,
+                              const gsMpiComm & comm)
+    { init(contributions, offsets, comm); }
+
+    /// @copydoc gsDistributedSparseMatrix(const gsSparseMatrix<T>&,const std::vector<index_t>&,const gsMpiComm&)
+    void init(const gsSparseMatrix<T> & contributions,
+              const std::vector<index_t> & offsets,
+              const gsMpiComm & comm);
+
+    /// @brief \f$ y = A x \f$ for the owned rows \a x and \a y of
+    /// distributed vectors
+    void multiply(const gsMatrix<T> & x, gsMatrix<T> & y) const;
+
+    /// The number of rows owned by this process
+    index_t rows() const { return m_diag.rows(); }
+
+    /// The number of rows (and columns) of the whole matrix
+    index_t globalSize() const { return m_offsets.back(); }
+
+    /// The first row owned by this process
+    index_t firstRow() const { return m_offsets[m_comm.rank()]; }
+
+    /// The first row owned by every process, followed by the global size
+    const std::vector<index_t> & offsets() const { return m_offsets; }
+
+    /// The owned rows and the owned columns
+    const LocalMatrix & diagonalBlock() const { return m_diag; }
+
+    /// The owned rows and the ghost columns
+    const LocalMatrix & offDiagonalBlock() const { return m_offd; }
+
+    /// The sorted global indices of the ghost columns
+    const std::vector<index_t> & ghosts() const { return m_ghosts; }
+
+    /// The communication pattern of the ghost values
+    const gsHaloExchange & halo() const { return m_halo; }
+
+    /// @brief Sets the communication mode of the exchange of the ghost
+    /// values (collective)
+    void setHaloMode(gsHaloExchange::mode m) { m_halo.setMode(m); }
+
+    /// The communicator
+    const gsMpiComm & comm() const { return m_comm; }
+
+    /// Prints the object as a string
+    std::ostream & print(std::ostream & os) const
+    {
+        os << "gsDistributedSparseMatrix: " << rows() << " of " << globalSize()
+           << " rows, " << m_diag.nonZeros() + m_offd.nonZeros() << " non-zeros, "
+           << m_ghosts.size() << " ghosts from " << m_halo.recvRanks().size()
+           << " processes\n";
+        return os;
+    }
+
+private:
+    gsMpiComm m_comm;
+    std::vector<index_t> m_offsets;
+
+    LocalMatrix m_diag, m_offd;
+    std::vector<index_t> m_ghosts;
+    gsHaloExchange m_halo;
+
+    // Workspaces of multiply, one column at a time, such that the
+    // persistent requests stay bound to the same buffers
+    mutable gsVector<T> m_ghostValues;
+    mutable std::vector<T> m_sendBuffer;
+};
+
+/// \brief Print (as string) operator for distributed sparse matrices
+/// \relates gsDistributedSparseMatrix
+template<class T>
+std::ostream & operator<<(std::ostream & os, const gsDistributedSparseMatrix<T> & A)
+{ return A.print(os); }
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsDistributedSparseMatrix.hpp)
+#endif
@@ -0,0 +1,142 @@
+/** @file gsDistributedSparseMatrix.hpp
+
+    @brief Sparse matrix whose rows are distributed over the processes
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+namespace gismo
+{
+
+template<class T>
+void gsDistributedSparseMatrix<T>::init(const gsSparseMatrix<T> & contributions,
+                                        const std::vector<index_t> & offsets,
+                                        const gsMpiComm & comm)
+{
+    const int np = comm.size(), me = comm.rank();
+    GISMO_ASSERT(static_cast<int>(offsets.size()) == np+1, "Invalid offsets.");
+    GISMO_ASSERT(contributions.rows() == offsets.back() && contributions.cols() == offsets.back(),
+                 "The contributions do not match the global size.");
+
+    m_comm    = comm;
+    m_offsets = offsets;
+    const index_t first = offsets[me], last = offsets[me+1];
+
+    // Sort the non-zeros by the owners of their rows
+    std::vector<std::vector<index_t> > idx(np);
+    std::vector<std::vector<T> >       val(np);
+    std::vector<index_t>::const_iterator ob = offsets.begin(), oe = offsets.end();
+    for (index_t j = 0; j < contributions.outerSize(); ++j)
+        for (typename gsSparseMatrix<T>::InnerIterator it(contributions, j); it; ++it)
+        {
+            const int p = static_cast<int>(std::upper_bound(ob, oe, it.row()) - ob) - 1;
+            idx[p].push_back(it.row());
+            idx[p].push_back(it.col());
+            val[p].push_back(it.value());
+        }
+
+    // Send the contributions to the rows owned by other processes
+    std::vector<int> sendCount(np), recvCount(np), sendDispl(np+1, 0), recvDispl(np+1, 0);
+    for (int p = 0; p < np; ++p)
+        sendCount[p] = (p == me ? 0 : static_cast<int>(val[p].size()));
+    comm.alltoall(sendCount.data(), recvCount.data(), 1, 1);
+    for (int p = 0; p < np; ++p)
+    {
+        sendDispl[p+1] = sendDispl[p] + sendCount[p];
+        recvDispl[p+1] = recvDispl[p] + recvCount[p];
+    }
+
+    std::vector<T> sendVal, recvVal(recvDispl[np]);
+    std::vector<index_t> sendIdx, recvIdx(2*recvDispl[np]);
+    sendVal.reserve(sendDispl[np]);
+    sendIdx.reserve(2*sendDispl[np]);
+    for (int p = 0; p < np; ++p)
+        if (p != me)
+        {
+            sendVal.insert(sendVal.end(), val[p].begin(), val[p].end());
+            sendIdx.insert(sendIdx.end(), idx[p].begin(), idx[p].end());
+        }
+    comm.alltoallv(sendVal.data(), sendCount.data(), sendDispl.data(),
+                   recvVal.data(), recvCount.data(), recvDispl.data());
+
+    // Two indices per value
+    for (int p = 0; p <= np; ++p)
+    {
+        if (p < np)
+        {
+            sendCount[p] *= 2;
+            recvCount[p] *= 2;
+        }
+        sendDispl[p] *= 2;
+        recvDispl[p] *= 2;
+    }
+    comm.alltoallv(sendIdx.data(), sendCount.data(), sendDispl.data(),
+                   recvIdx.data(), recvCount.data(), recvDispl.data());
+
+    // Own and received entries
+    idx[me].insert(idx[me].end(), recvIdx.begin(), recvIdx.end());
+    val[me].insert(val[me].end(), recvVal.begin(), recvVal.end());
+    const std::vector<index_t> & ownIdx = idx[me];
+    const std::vector<T>       & ownVal = val[me];
+    const size_t nnz = ownVal.size();
+
+    // The ghosts are the columns owned by other processes
+    m_ghosts.clear();
+    for (size_t k = 0; k != nnz; ++k)
+    {
+        const index_t c = ownIdx[2*k+1];
+        if (c < first || c >= last)
+            m_ghosts.push_back(c);
+    }
+    std::sort(m_ghosts.begin(), m_ghosts.end());
+    m_ghosts.erase(std::unique(m_ghosts.begin(), m_ghosts.end()), m_ghosts.end());
+
+    // Split into the diagonal and the off-diagonal block; duplicates are summed
+    gsSparseEntries<T> diag, offd;
+    diag.reserve(nnz);
+    for (size_t k = 0; k != nnz; ++k)
+    {
+        const index_t r = ownIdx[2*k] - first, c = ownIdx[2*k+1];
+        if (c >= first && c < last)
+            diag.add(r, c - first, ownVal[k]);
+        else
+            offd.add(r, static_cast<index_t>(std::lower_bound(m_ghosts.begin(), m_ghosts.end(), c)
+                                             - m_ghosts.begin()), ownVal[k]);
+    }
+    m_diag.resize(last - first, last - first);
+    m_diag.setFrom(diag);
+    m_diag.makeCompressed();
+    m_offd.resize(last - first, static_cast<index_t>(m_ghosts.size()));
+    m_offd.setFrom(offd);
+    m_offd.makeCompressed();
+
+    m_halo.init(m_ghosts, m_offsets, m_comm);
+    m_halo.setMode(gsHaloExchange::persistent);
+}
+
+template<class T>
+void gsDistributedSparseMatrix<T>::multiply(const gsMatrix<T> & x, gsMatrix<T> & y) const
+{
+    GISMO_ASSERT(x.rows() == rows(), "The vector does not match the matrix: "
+                 << x.rows() << "!=" << rows());
+    GISMO_ASSERT(&x != &y, "The input and the output must be different.");
+
+    y.resize(rows(), x.cols());
+    m_ghostValues.resize(m_halo.numGhosts());
+    for (index_t j = 0; j < x.cols(); ++j)
+    {
+        m_halo.begin(x.col(j).data(), m_ghostValues.data(), m_sendBuffer);
+        y.col(j).noalias() = m_diag * x.col(j);           // overlapped with the exchange
+        m_halo.end();
+        if (m_offd.nonZeros() > 0)
+            y.col(j).noalias() += m_offd * m_ghostValues;
+    }
+}
+
+} // namespace gismo
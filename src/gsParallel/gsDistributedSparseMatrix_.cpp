@@ -0,0 +1,9 @@
+#include <gsParallel/gsDistributedSparseMatrix.h>
+#include <gsParallel/gsDistributedSparseMatrix.hpp>
+
+namespace gismo
+{
+
+CLASS_TEMPLATE_INST gsDistributedSparseMatrix<real_t>;
+
+} // namespace gismo
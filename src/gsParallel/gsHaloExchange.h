@@ -0,0 +1,349 @@
+/** @file gsHaloExchange.h
+
+    @brief Exchange of ghost values of row-distributed vectors
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsParallel/gsMpi.h>
+#include <typeinfo>
+
+namespace gismo
+{
+
+/**
+   @brief Communication pattern for the ghost values of a row-distributed
+   vector
+
+   The global indices are split into contiguous ranges, one per process
+   (the offsets, with offsets[p] the first index owned by process p).
+   Every process stores the values of its owned range, and needs some
+   values owned by other processes, its ghosts.
+
+   The ghosts are given as a sorted list of global indices. Then the
+   ghosts owned by one process are contiguous in the list, and they are
+   received in place by one non-blocking receive per neighbor. The
+   owned values requested by the neighbors are packed into a send buffer
+   and sent by one non-blocking send per neighbor.
+
+   The pattern is set up once (by one alltoall and one alltoallv); the
+   exchange can then be overlapped with local work, see begin() and
+   end(). It is carried out in one of the following modes (see setMode):
+
+   - pointToPoint: new non-blocking sends and receives in every exchange;
+   - persistent: the sends and receives are initialized once, for the
+     buffers of the first exchange, and restarted in every following
+     exchange with the same buffers;
+   - neighborhood: one non-blocking neighborhood alltoallv on a graph
+     topology communicator, whose sources are the recvRanks() and whose
+     destinations are the sendRanks().
+
+   @ingroup Mpi
+*/
+class gsHaloExchange
+{
+public:
+
+    /// The communication modes of the exchange
+    enum mode
+    {
+        pointToPoint = 0, ///< non-blocking sends and receives
+        persistent   = 1, ///< persistent sends and receives
+        neighborhood = 2  ///< neighborhood collective on a graph communicator
+    };
+
+    /// Empty pattern, no ghosts
+    gsHaloExchange()
+    : m_nOwned(0), m_nGhosts(0), m_mode(pointToPoint), m_active(0), m_bound(NULL)
+    { }
+
+    /// @brief Sets up the pattern
+    ///
+    /// @param ghosts  sorted global indices of the ghosts of this process
+    /// @param offsets the first global index owned by every process,
+    ///                followed by the global size (size: comm.size()+1)
+    /// @param comm    the communicator
+    gsHaloExchange(const std::vector<index_t> & ghosts,
+                   const std::vector<index_t> & offsets,
+                   const gsMpiComm & comm)
+    : m_mode(pointToPoint), m_active(0), m_bound(NULL)
+    { init(ghosts, offsets, comm); }
+
+    /// Copies the pattern and the mode. The persistent requests are
+    /// initialized again by the copy, the graph communicator is shared.
+    gsHaloExchange(const gsHaloExchange & other)
+    : m_active(0), m_bound(NULL)
+    { *this = other; }
+
+    gsHaloExchange & operator=(const gsHaloExchange & other)
+    {
+        if (this != &other)
+        {
+            freeRequests();
+            m_comm       = other.m_comm;
+            m_nOwned     = other.m_nOwned;
+            m_nGhosts    = other.m_nGhosts;
+            m_mode       = other.m_mode;
+            m_recvRank   = other.m_recvRank;
+            m_recvOffset = other.m_recvOffset;
+            m_sendRank   = other.m_sendRank;
+            m_sendOffset = other.m_sendOffset;
+            m_sendIdx    = other.m_sendIdx;
+            m_recvCount  = other.m_recvCount;
+            m_sendCount  = other.m_sendCount;
+            m_graph      = other.m_graph;
+            m_requests.resize(other.m_requests.size());
+        }
+        return *this;
+    }
+
+    ~gsHaloExchange() { freeRequests(); }
+
+    /// @copydoc gsHaloExchange(const std::vector<index_t>&,const std::vector<index_t>&,const gsMpiComm&)
+    void init(const std::vector<index_t> & ghosts,
+              const std::vector<index_t> & offsets,
+              const gsMpiComm & comm)
+    {
+        const int np = comm.size(), me = comm.rank();
+        GISMO_ASSERT(static_cast<int>(offsets.size()) == np+1, "Invalid offsets.");
+        freeRequests();
+        m_graph.reset();
+        m_comm   = comm;
+        m_nOwned = offsets[me+1] - offsets[me];
+        m_nGhosts = static_cast<index_t>(ghosts.size());
+
+        // Ghosts per owner, as contiguous segments of the ghost list
+        std::vector<int> recvCount(np, 0), sendCount(np, 0);
+        for (std::vector<index_t>::const_iterator it = ghosts.begin(); it != ghosts.end(); ++it)
+        {
+            GISMO_ASSERT(it == ghosts.begin() || *(it-1) < *it, "The ghosts are not sorted.");
+            const int p = static_cast<int>( std::upper_bound(offsets.begin(), offsets.end(), *it)
+                                            - offsets.begin() ) - 1;
+            GISMO_ASSERT(p != me && p >= 0 && p < np, "Invalid ghost index "<<*it);
+            ++recvCount[p];
+        }
+
+        comm.alltoall(recvCount.data(), sendCount.data(), 1, 1);
+
+        std::vector<int> recvDispl(np+1, 0), sendDispl(np+1, 0);
+        for (int p = 0; p < np; ++p)
+        {
+            recvDispl[p+1] = recvDispl[p] + recvCount[p];
+            sendDispl[p+1] = sendDispl[p] + sendCount[p];
+        }
+
+        // Tell every owner which of its values are needed here
+        std::vector<index_t> request(ghosts);
+        m_sendIdx.resize(sendDispl[np]);
+        comm.alltoallv(request.data(), recvCount.data(), recvDispl.data(),
+                       m_sendIdx.data(), sendCount.data(), sendDispl.data());
+        for (std::vector<index_t>::iterator it = m_sendIdx.begin(); it != m_sendIdx.end(); ++it)
+            *it -= offsets[me];
+
+        m_recvRank.clear(); m_recvOffset.assign(1, 0);
+        m_sendRank.clear(); m_sendOffset.assign(1, 0);
+        for (int p = 0; p < np; ++p)
+        {
+            if (recvCount[p] > 0)
+            {
+                m_recvRank.push_back(p);
+                m_recvOffset.push_back(recvDispl[p+1]);
+            }
+            if (sendCount[p] > 0)
+            {
+                m_sendRank.push_back(p);
+                m_sendOffset.push_back(sendDispl[p+1]);
+            }
+        }
+        m_recvCount.resize(m_recvRank.size());
+        for (size_t k = 0; k != m_recvRank.size(); ++k)
+            m_recvCount[k] = m_recvOffset[k+1] - m_recvOffset[k];
+        m_sendCount.resize(m_sendRank.size());
+        for (size_t k = 0; k != m_sendRank.size(); ++k)
+            m_sendCount[k] = m_sendOffset[k+1] - m_sendOffset[k];
+
+        m_requests.resize(m_recvRank.size() + m_sendRank.size());
+        setMode(static_cast<mode>(m_mode));
+    }
+
+    /// @brief Sets the communication mode of the exchange
+    ///
+    /// Collective over the communicator: switching to the neighborhood
+    /// mode creates the graph topology communicator.
+    void setMode(mode m)
+    {
+        freeRequests();
+        m_mode = m;
+        if (neighborhood == m && !m_graph)
+            m_graph = memory::shared_ptr<gsMpiComm>(
+                new gsMpiComm(m_comm.graph(m_recvRank, m_sendRank)), freeComm());
+    }
+
+    /// The communication mode of the exchange
+    mode getMode() const { return static_cast<mode>(m_mode); }
+
+    /// @brief Starts the exchange
+    ///
+    /// Posts the receives into \a ghostValues (of size numGhosts()) and
+    /// the sends of the requested entries of \a ownedValues (of size
+    /// numOwned()). The values are packed into \a sendBuffer, which must
+    /// not be touched until end() has been called.
+    ///
+    /// In the persistent mode the requests are initialized again
+    /// whenever \a ghostValues or the data of \a sendBuffer differ from
+    /// the ones of the previous exchange, so the buffers should be kept.
+    template<class T>
+    void begin(const T * ownedValues, T * ghostValues, std::vector<T> & sendBuffer) const
+    {
+        const size_t nr = m_recvRank.size(), ns = m_sendRank.size();
+        sendBuffer.resize(m_sendIdx.size());
+
+        switch (m_mode)
+        {
+        case neighborhood:
+            pack(ownedValues, sendBuffer);
+            m_graph->ineighborAlltoallv(sendBuffer.data(), m_sendCount.data(), m_sendOffset.data(),
+                                        ghostValues, m_recvCount.data(), m_recvOffset.data(),
+                                        &m_graphRequest);
+            m_active = 1;
+            break;
+        case persistent:
+            if (m_bound != &typeid(T) || m_boundGhosts != ghostValues
+                || m_boundSend != sendBuffer.data())
+            {
+                freeRequests();
+                for (size_t k = 0; k != nr; ++k)
+                    m_comm.recvInit(ghostValues + m_recvOffset[k], m_recvCount[k],
+                                    m_recvRank[k], &m_requests[k], tag);
+                for (size_t k = 0; k != ns; ++k)
+                    m_comm.sendInit(sendBuffer.data() + m_sendOffset[k], m_sendCount[k],
+                                    m_sendRank[k], &m_requests[nr+k], tag);
+                m_bound       = &typeid(T);
+                m_boundGhosts = ghostValues;
+                m_boundSend   = sendBuffer.data();
+            }
+            if (nr) gsMpiRequest::startAll(static_cast<int>(nr), m_requests.data());
+            pack(ownedValues, sendBuffer);
+            if (ns) gsMpiRequest::startAll(static_cast<int>(ns), m_requests.data() + nr);
+            m_active = static_cast<int>(nr + ns);
+            break;
+        default:
+            for (size_t k = 0; k != nr; ++k)
+                m_comm.irecv(ghostValues + m_recvOffset[k], m_recvCount[k],
+                             m_recvRank[k], &m_requests[k], tag);
+            pack(ownedValues, sendBuffer);
+            for (size_t k = 0; k != ns; ++k)
+                m_comm.isend(sendBuffer.data() + m_sendOffset[k], m_sendCount[k],
+                             m_sendRank[k], &m_requests[nr+k], tag);
+            m_active = static_cast<int>(nr + ns);
+        }
+    }
+
+    /// Waits for the completion of the exchange started by begin()
+    void end() const
+    {
+        if (m_active > 0)
+        {
+            if (neighborhood == m_mode)
+                m_graphRequest.wait();
+            else
+                gsMpiRequest::waitAll(m_active, m_requests.data());
+        }
+        m_active = 0;
+    }
+
+    /// Updates \a ghostValues from the \a ownedValues of the neighbors (blocking)
+    template<class T>
+    void exchange(const T * ownedValues, T * ghostValues, std::vector<T> & sendBuffer) const
+    {
+        begin(ownedValues, ghostValues, sendBuffer);
+        end();
+    }
+
+    /// The number of values owned by this process
+    index_t numOwned() const { return m_nOwned; }
+
+    /// The number of ghosts of this process
+    index_t numGhosts() const { return m_nGhosts; }
+
+    /// The ranks of the processes sending ghost values to this process
+    const std::vector<int> & recvRanks() const { return m_recvRank; }
+
+    /// The ranks of the processes receiving values from this process
+    const std::vector<int> & sendRanks() const { return m_sendRank; }
+
+    /// The communicator
+    const gsMpiComm & comm() const { return m_comm; }
+
+private:
+
+    template<class T>
+    void pack(const T * ownedValues, std::vector<T> & sendBuffer) const
+    {
+        for (size_t i = 0; i != m_sendIdx.size(); ++i)
+            sendBuffer[i] = ownedValues[m_sendIdx[i]];
+    }
+
+    // Frees the persistent requests, if any
+    void freeRequests() const
+    {
+        if (NULL != m_bound && !finalized())
+            for (size_t k = 0; k != m_requests.size(); ++k)
+                m_requests[k].free();
+        m_bound  = NULL;
+        m_active = 0;
+    }
+
+    static bool finalized()
+    {
+#ifdef GISMO_WITH_MPI
+        int fin = 0;
+        MPI_Finalized(&fin);
+        return 0 != fin;
+#else
+        return false;
+#endif
+    }
+
+    struct freeComm
+    {
+        void operator()(gsMpiComm * c) const
+        {
+            if (!finalized()) c->free();
+            delete c;
+        }
+    };
+
+private:
+    static const int tag = 2718;
+
+    gsMpiComm m_comm;
+    index_t m_nOwned, m_nGhosts;
+
+    std::vector<int> m_recvRank, m_recvOffset;  // neighbors and their segments of the ghosts
+    std::vector<int> m_sendRank, m_sendOffset;  // neighbors and their segments of m_sendIdx
+    std::vector<index_t> m_sendIdx;             // owned (local) indices to send
+
+    std::vector<int> m_recvCount, m_sendCount;  // segment sizes
+
+    int m_mode;
+    memory::shared_ptr<gsMpiComm> m_graph;      // neighborhood mode
+
+    mutable std::vector<gsMpiRequest> m_requests;
+    mutable gsMpiRequest m_graphRequest;
+    mutable int m_active;                       // requests started by begin()
+
+    // Buffers of the persistent requests
+    mutable const std::type_info * m_bound;
+    mutable const void * m_boundGhosts, * m_boundSend;
+};
+
+} // namespace gismo
@@ -1,6 +1,7 @@
 
 
 #include <gsParallel/gsMpi.h>
+#include <gsCore/gsBoxTopology.h>
 
 namespace gismo
 {
@@ -17,4 +18,33 @@ gsMpi & gsMpiSingleton(const int& argc, char** argv)
 MPI_Errhandler gsMpiComm::ErrHandler = MPI_ERRORS_ARE_FATAL;
 #endif
 
+#ifdef GISMO_WITH_MPI
+MPI_Comm gsMpiComm::graph(const gsBoxTopology & topology,
+                          const std::vector<index_t> & patchRank,
+                          bool reorder) const
+{
+    GISMO_ASSERT(static_cast<index_t>(patchRank.size()) == topology.nBoxes(),
+                 "The number of patches does not match: "
+                 << patchRank.size() << "!=" << topology.nBoxes());
+
+    // The ranks of the patches sharing an interface with our patches
+    std::vector<int> nb;
+    const std::vector<boundaryInterface> & ifaces = topology.interfaces();
+    for (std::vector<boundaryInterface>::const_iterator it = ifaces.begin();
+         it != ifaces.end(); ++it)
+    {
+        const int p1 = static_cast<int>(patchRank[it->first ().patch]);
+        const int p2 = static_cast<int>(patchRank[it->second().patch]);
+        if (p1 == p2) continue;
+        if (p1 == rank_) nb.push_back(p2);
+        if (p2 == rank_) nb.push_back(p1);
+    }
+    std::sort(nb.begin(), nb.end());
+    nb.erase(std::unique(nb.begin(), nb.end()), nb.end());
+
+    // The interfaces are symmetric, so are the neighborhoods
+    return graph(nb, nb, reorder);
+}
+#endif
+
 };
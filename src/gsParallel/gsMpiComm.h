@@ -243,6 +243,38 @@ public:
         return gsSerialStatus();
     }
 
+    /**
+        @brief Waits for all communication requests
+    */
+    static int waitAll (int, gsSerialRequest[])
+    {
+        return 0;
+    }
+
+    /**
+        @brief Starts a persistent communication request
+    */
+    static int start ()
+    {
+        return 0;
+    }
+
+    /**
+        @brief Starts all persistent communication requests
+    */
+    static int startAll (int, gsSerialRequest[])
+    {
+        return 0;
+    }
+
+    /**
+        @brief Frees the communication request
+    */
+    static int free ()
+    {
+        return 0;
+    }
+
     static gsSerialRequest getNullRequest()
     {
         gsSerialRequest request;
@@ -258,6 +290,15 @@ public:
         return &req;
     }
 
+    /**
+       @brief Returns a pointer to the internal request object
+    */
+    MPI_Request* operator& ()
+    {
+        static MPI_Request req(0);
+        return &req;
+    }
+
     /**
        @brief Prints the request object as a string
     */
@@ -334,6 +375,51 @@ public:
         return gsSerialComm(*this);
     }
 
+    /** @brief Creates a distributed graph topology communicator.
+     *
+     * The process receives data from the processes \a sources and sends
+     * data to the processes \a destinations in the neighborhood
+     * collectives, like neighborAlltoallv. If \a reorder is true, the
+     * processes may be renumbered in the new communicator.
+     */
+    gsSerialComm graph (const std::vector<int> &,
+                        const std::vector<int> &,
+                        bool = false) const
+    {
+        return gsSerialComm(*this);
+    }
+
+    /** @brief Creates a distributed graph topology communicator of the
+     * patches of a multi-patch domain.
+     *
+     * Patch k is assigned to the process \a patchRank[k]. The neighbors
+     * of a process are the processes of the patches which share an
+     * interface with one of its patches.
+     */
+    gsSerialComm graph (const gsBoxTopology &,
+                        const std::vector<index_t> &,
+                        bool = false) const
+    {
+        return gsSerialComm(*this);
+    }
+
+    /** @brief Returns the neighbors of the process in a graph topology
+     * communicator (none for the serial communicator).
+     */
+    static int neighbors (std::vector<int> & sources, std::vector<int> & destinations)
+    {
+        sources.clear();
+        destinations.clear();
+        return 0;
+    }
+
+    /** @brief Frees a communicator created by duplicate, split or graph.
+     */
+    static int free ()
+    {
+        return 0;
+    }
+
 #ifdef GISMO_WITH_MPI
     operator MPI_Comm () const  { return MPI_COMM_SELF;}
 #else
@@ -364,6 +450,15 @@ public:
         return 0;
     }
 
+    /** @brief Non-blocking version of sum(T*,int); the request
+        is completed immediately
+    */
+    template<typename T>
+    static int isum (T*, int, MPI_Request*)
+    {
+        return 0;
+    }
+
     /** @brief Compute the product of the argument over all processes
         and return the result in every process. Assumes that T has an
         operator*
@@ -485,7 +580,7 @@ public:
      * @param[in] tag Specifies the message ID
      */
     template<typename T>
-    static int isend (T* in, int len, int dest, MPI_Request request, int tag = 0)
+    static int isend (T*, int, int, MPI_Request*, int = 0)
     {
         return 0;
     }
@@ -516,7 +611,76 @@ public:
      * @param[in] tag Specifies the message ID
      */
     template<typename T>
-    static int irecv (T* out, int len, int source, MPI_Request request, int tag = 0)
+    static int irecv (T*, int, int, MPI_Request*, int = 0)
+    {
+        return 0;
+    }
+
+    /** @brief Creates a persistent request for sending data to a
+     * destination process with a defined tag
+     *
+     * The request is started by gsMpiRequest::start or
+     * gsMpiRequest::startAll, completed like a non-blocking send, and
+     * can then be started again, sending the current content of the
+     * buffer \a in. It must be freed by gsMpiRequest::free.
+     */
+    template<typename T>
+    static int sendInit (T*, int, int, MPI_Request*, int = 0)
+    {
+        return 0;
+    }
+
+    /** @brief Creates a persistent request for receiving data from a
+     * source process with a defined tag
+     *
+     * @see sendInit
+     */
+    template<typename T>
+    static int recvInit (T*, int, int, MPI_Request*, int = 0)
+    {
+        return 0;
+    }
+
+    /** @brief Sends a block of \a count elements to each destination and
+     * receives a block of \a count elements from each source of a graph
+     * topology communicator (blocks in the order of the neighbors).
+     */
+    template<typename T>
+    static int neighborAlltoall (T*, T*, int)
+    {
+        return 0;
+    }
+
+    /** @brief Sends blocks of variable length to the destinations and
+     * receives blocks of variable length from the sources of a graph
+     * topology communicator.
+     *
+     * The block of length sendcount[k] starting at send+senddispl[k] is
+     * sent to destination k, the block received from source k is stored
+     * starting at recv+recvdispl[k].
+     */
+    template<typename T>
+    static int neighborAlltoallv (T*, const int*, const int*,
+                                  T*, const int*, const int*)
+    {
+        return 0;
+    }
+
+    /** @brief Non-blocking version of neighborAlltoallv
+     */
+    template<typename T>
+    static int ineighborAlltoallv (T*, const int*, const int*,
+                                   T*, const int*, const int*,
+                                   MPI_Request*)
+    {
+        return 0;
+    }
+
+    /** @brief Gathers a block of \a count elements from each source of a
+     * graph topology communicator.
+     */
+    template<typename T>
+    static int neighborAllgather (T*, int, T*)
     {
         return 0;
     }
@@ -627,6 +791,35 @@ public:
         return 0;
     }
 
+    /** @brief Sends a block of \a sendcount elements to each process and
+     * receives a block of \a recvcount elements from each process.
+     *
+     * The block k of the send buffer is sent to process k, which stores
+     * it in the block with the rank of the sender of its receive buffer.
+     */
+    template<typename T>
+    static int alltoall (T* send, T* recv, int sendcount, int)
+    {
+        for (int i=0; i<sendcount; i++)
+            recv[i] = send[i];
+        return 0;
+    }
+
+    /** @brief Sends blocks of variable length to each process and receives
+     * blocks of variable length from each process.
+     *
+     * The block of length sendcount[k] starting at send+senddispl[k] is
+     * sent to process k, the block received from process k is stored
+     * starting at recv+recvdispl[k].
+     */
+    template<typename T>
+    static int alltoallv (T* send, int* sendcount, int* senddispl, T* recv, int*, int* recvdispl)
+    {
+        for (int i=0; i<*sendcount; i++)
+            recv[*recvdispl+i] = send[*senddispl+i];
+        return 0;
+    }
+
     /**
      * @brief Gathers data from all tasks and distribute it to all.
      *
@@ -944,6 +1137,12 @@ public:
         return MPI_Request_free(&m_request);
     }
 
+    /// @copydoc gsSerialRequest::start
+    int start ()
+    {
+        return MPI_Start(&m_request);
+    }
+
     /**
         @brief Returns the status of the communication request
     */
@@ -1014,6 +1213,32 @@ public:
         return status;
     }
 
+    /// @copydoc gsSerialRequest::waitAll
+    static int waitAll (int numberRequests, gsMpiRequest requests[])
+    {
+        std::vector<MPI_Request> mpiRequests(numberRequests);
+        for(int i = 0; i < numberRequests; i++)
+            mpiRequests[i] = requests[i].m_request;
+
+        const int ret = MPI_Waitall(numberRequests, mpiRequests.data(), MPI_STATUSES_IGNORE);
+        for(int i = 0; i < numberRequests; i++)
+            requests[i].m_request = mpiRequests[i];
+        return ret;
+    }
+
+    /// @copydoc gsSerialRequest::startAll
+    static int startAll (int numberRequests, gsMpiRequest requests[])
+    {
+        std::vector<MPI_Request> mpiRequests(numberRequests);
+        for(int i = 0; i < numberRequests; i++)
+            mpiRequests[i] = requests[i].m_request;
+
+        const int ret = MPI_Startall(numberRequests, mpiRequests.data());
+        for(int i = 0; i < numberRequests; i++)
+            requests[i].m_request = mpiRequests[i];
+        return ret;
+    }
+
     static gsMpiRequest getNullRequest()
     {
         gsMpiRequest request;
@@ -1070,7 +1295,7 @@ public:
         }
     }
 
-    gsMpiComm(const gsSerialComm &) : m_comm(MPI_COMM_SELF) { }
+    gsMpiComm(const gsSerialComm &) : rank_(0), size_(1), m_comm(MPI_COMM_SELF) { }
 
     /**
      * @brief The type of the mpi communicator.
@@ -1128,6 +1353,48 @@ public:
         return comm;
     }
 
+    /// @copydoc gsSerialComm::graph(const std::vector<int>&,const std::vector<int>&,bool) const
+    MPI_Comm graph (const std::vector<int> & sources,
+                    const std::vector<int> & destinations,
+                    bool reorder = false) const
+    {
+        MPI_Comm comm;
+        // Avoid passing null pointers for empty neighborhoods
+        int dummy = 0;
+        MPI_Dist_graph_create_adjacent(m_comm,
+            static_cast<int>(sources.size()), sources.empty() ? &dummy : sources.data(), MPI_UNWEIGHTED,
+            static_cast<int>(destinations.size()), destinations.empty() ? &dummy : destinations.data(), MPI_UNWEIGHTED,
+            MPI_INFO_NULL, reorder ? 1 : 0, &comm);
+        return comm;
+    }
+
+    /// @copydoc gsSerialComm::graph(const gsBoxTopology&,const std::vector<index_t>&,bool) const
+    MPI_Comm graph (const gsBoxTopology & topology,
+                    const std::vector<index_t> & patchRank,
+                    bool reorder = false) const;
+
+    /// @copydoc gsSerialComm::neighbors
+    int neighbors (std::vector<int> & sources, std::vector<int> & destinations) const
+    {
+        int indegree, outdegree, weighted;
+        MPI_Dist_graph_neighbors_count(m_comm, &indegree, &outdegree, &weighted);
+        sources.resize(indegree);
+        destinations.resize(outdegree);
+        int dummy = 0;
+        return MPI_Dist_graph_neighbors(m_comm,
+            indegree, indegree ? sources.data() : &dummy, MPI_UNWEIGHTED,
+            outdegree, outdegree ? destinations.data() : &dummy, MPI_UNWEIGHTED);
+    }
+
+    /// @copydoc gsSerialComm::free
+    int free ()
+    {
+        const int ret = MPI_Comm_free(&m_comm);
+        rank_ = -1;
+        size_ = 0;
+        return ret;
+    }
+
     operator MPI_Comm () const { return m_comm; }
 
 private:
@@ -1313,6 +1580,61 @@ public:
                          source,tag,m_comm,req);
     }
 
+    /// @copydoc gsSerialComm::sendInit()
+    template<typename T>
+    int sendInit (T* in, int len, int dest, MPI_Request* req, int tag = 0) const
+    {
+        return MPI_Send_init(in,len,MPITraits<T>::getType(),
+                             dest,tag,m_comm,req);
+    }
+
+    /// @copydoc gsSerialComm::recvInit()
+    template<typename T>
+    int recvInit (T* out, int len, int source, MPI_Request* req, int tag = 0) const
+    {
+        return MPI_Recv_init(out,len,MPITraits<T>::getType(),
+                             source,tag,m_comm,req);
+    }
+
+    /// @copydoc gsSerialComm::neighborAlltoall()
+    template<typename T>
+    int neighborAlltoall (T* send, T* recv, int count) const
+    {
+        return MPI_Neighbor_alltoall(send,count,MPITraits<T>::getType(),
+                                     recv,count,MPITraits<T>::getType(),
+                                     m_comm);
+    }
+
+    /// @copydoc gsSerialComm::neighborAlltoallv()
+    template<typename T>
+    int neighborAlltoallv (T* send, const int* sendcount, const int* senddispl,
+                           T* recv, const int* recvcount, const int* recvdispl) const
+    {
+        return MPI_Neighbor_alltoallv(send,sendcount,senddispl,MPITraits<T>::getType(),
+                                      recv,recvcount,recvdispl,MPITraits<T>::getType(),
+                                      m_comm);
+    }
+
+    /// @copydoc gsSerialComm::ineighborAlltoallv()
+    template<typename T>
+    int ineighborAlltoallv (T* send, const int* sendcount, const int* senddispl,
+                            T* recv, const int* recvcount, const int* recvdispl,
+                            MPI_Request* req) const
+    {
+        return MPI_Ineighbor_alltoallv(send,sendcount,senddispl,MPITraits<T>::getType(),
+                                       recv,recvcount,recvdispl,MPITraits<T>::getType(),
+                                       m_comm,req);
+    }
+
+    /// @copydoc gsSerialComm::neighborAllgather()
+    template<typename T>
+    int neighborAllgather (T* in, int count, T* out) const
+    {
+        return MPI_Neighbor_allgather(in,count,MPITraits<T>::getType(),
+                                      out,count,MPITraits<T>::getType(),
+                                      m_comm);
+    }
+
     /// @copydoc gsSerialComm::broadcast
     template<typename T>
     int broadcast (T* inout, int len, int root) const
@@ -1358,8 +1680,7 @@ public:
                             root,m_comm);
     }
 
-    /// @copydoc gsSerialComm::scatter()
-    /// @note out must have space for P*len elements
+    /// @copydoc gsSerialComm::alltoall()
     template<typename T>
     int alltoall (T* send, T* recv, int sendcount, int recvcount) const
     {
@@ -1368,7 +1689,7 @@ public:
                             m_comm);
     }
 
-    /// @copydoc gsSerialComm::scatterv()
+    /// @copydoc gsSerialComm::alltoallv()
     template<typename T>
     int alltoallv (T* send, int* sendcount, int* senddispl, T* recv, int* recvcount, int* recvdispl) const
     {
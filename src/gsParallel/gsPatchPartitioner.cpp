@@ -0,0 +1,513 @@
+/** @file gsPatchPartitioner.cpp
+
+    @brief Weighted partitioning of the patches of a multi-patch domain
+    for load-balanced parallel runs
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#include <gsParallel/gsPatchPartitioner.h>
+#include <gsCore/gsBoxTopology.h>
+#include <numeric>
+#include <tuple>
+
+#ifdef GISMO_WITH_METIS
+// METIS defines its own real_t, which G+Smo defines as a macro
+#pragma push_macro("real_t")
+#undef real_t
+#include <metis.h>
+typedef real_t metis_real_t;
+#pragma pop_macro("real_t")
+#endif
+
+namespace gismo
+{
+
+namespace
+{
+
+// Weighted graph in compressed form
+struct wGraph
+{
+    std::vector<real_t>  w;          // vertex weights
+    std::vector<index_t> xadj, adj;  // neighbors of v: adj[xadj[v]], ..., adj[xadj[v+1]-1]
+    std::vector<real_t>  ew;         // edge weights, like adj
+
+    index_t size() const { return static_cast<index_t>(w.size()); }
+};
+
+real_t total(const std::vector<real_t> & w)
+{ return std::accumulate(w.begin(), w.end(), real_t(0)); }
+
+// Connectivity of v to the parts of its (assigned) neighbors
+void connectivity(const wGraph & g, const std::vector<index_t> & part,
+                  index_t v, std::vector<real_t> & conn)
+{
+    std::fill(conn.begin(), conn.end(), real_t(0));
+    for (index_t e = g.xadj[v]; e < g.xadj[v+1]; ++e)
+        if (part[g.adj[e]] >= 0)
+            conn[part[g.adj[e]]] += g.ew[e];
+}
+
+// Largest weight first, to the least loaded part
+void greedyPartition(const wGraph & g, index_t nParts, std::vector<index_t> & part)
+{
+    const index_t n = g.size();
+    std::vector<index_t> order(n);
+    for (index_t v = 0; v < n; ++v)
+        order[v] = v;
+    std::stable_sort(order.begin(), order.end(),
+                     [&g](index_t a, index_t b) { return g.w[a] > g.w[b]; });
+
+    part.assign(n, -1);
+    std::vector<real_t> load(nParts, 0), conn(nParts);
+    for (index_t i = 0; i < n; ++i)
+    {
+        const index_t v = order[i];
+        connectivity(g, part, v, conn);
+        index_t best = 0;
+        for (index_t q = 1; q < nParts; ++q)
+            if (load[q] < load[best] || (load[q] == load[best] && conn[q] > conn[best]))
+                best = q;
+        part[v] = best;
+        load[best] += g.w[v];
+    }
+}
+
+// Grows the parts one after the other from the remaining vertices,
+// adding the vertices adjacent to the part until its target is met.
+// The first part starts from \a seed. One vertex is left for each of the
+// following parts, such that no part is empty (there are at least
+// nParts vertices).
+void growPartition(const wGraph & g, index_t nParts, index_t seed,
+                   std::vector<index_t> & part)
+{
+    const index_t n = g.size();
+    part.assign(n, -1);
+    real_t remaining = total(g.w);
+    index_t nAssigned = 0;
+    std::vector<bool> frontier(n);
+    std::vector<index_t> dist(n), queue;
+
+    for (index_t q = 0; q < nParts - 1 && nAssigned < n; ++q)
+    {
+        const real_t target = remaining / static_cast<real_t>(nParts - q);
+        real_t load = 0;
+        bool seeded = false;
+        std::fill(frontier.begin(), frontier.end(), false);
+        while (nAssigned < n - (nParts - 1 - q))
+        {
+            // Candidates by priority: the vertices of the frontier which
+            // fit into the part, or fit up to half of their weight, then
+            // the same for the other vertices (e.g., the seed). Among
+            // them, the one with the most edges to the part, then the one
+            // with the least edges to the remaining vertices, then the
+            // closest one to the seed (for compact parts), then the
+            // heaviest one. The seed is the heaviest candidate, such that
+            // the heavy vertices are not left over for the last parts.
+            typedef std::tuple<index_t,real_t,real_t,real_t,index_t,real_t> Key;
+            index_t best = -1;
+            Key bestKey;
+            for (index_t v = 0; v < n; ++v)
+            {
+                if (part[v] >= 0 || (0 == q && !seeded && v != seed)) continue;
+                index_t cl;
+                if (load + g.w[v] <= target)         cl = 0;
+                else if (load + g.w[v] / 2 < target) cl = 1;
+                else continue;
+                if (!frontier[v]) cl += 2;
+
+                real_t in = 0, out = 0;
+                for (index_t e = g.xadj[v]; e < g.xadj[v+1]; ++e)
+                    if (part[g.adj[e]] == q)
+                        in += g.ew[e];
+                    else if (part[g.adj[e]] < 0)
+                        out += g.ew[e];
+
+                const Key key(cl, seeded ? real_t(0) : -g.w[v], -in, out, dist[v], -g.w[v]);
+                if (best < 0 || key < bestKey)
+                {
+                    best    = v;
+                    bestKey = key;
+                }
+            }
+            if (best < 0)
+                break;
+
+            // Distances to the seed
+            if (!seeded)
+            {
+                seeded = true;
+                std::fill(dist.begin(), dist.end(), n);
+                dist[best] = 0;
+                queue.assign(1, best);
+                for (size_t i = 0; i != queue.size(); ++i)
+                    for (index_t e = g.xadj[queue[i]]; e < g.xadj[queue[i]+1]; ++e)
+                        if (dist[g.adj[e]] == n)
+                        {
+                            dist[g.adj[e]] = dist[queue[i]] + 1;
+                            queue.push_back(g.adj[e]);
+                        }
+            }
+
+            part[best] = q;
+            load += g.w[best];
+            ++nAssigned;
+            for (index_t e = g.xadj[best]; e < g.xadj[best+1]; ++e)
+                frontier[g.adj[e]] = true;
+        }
+        remaining -= load;
+    }
+
+    for (index_t v = 0; v < n; ++v)
+        if (part[v] < 0)
+            part[v] = nParts - 1;
+}
+
+// Moves boundary vertices to neighboring parts, to reduce the weight of
+// the cut edges without exceeding maxLoad, or to reduce the load of
+// the parts exceeding maxLoad. The last vertex of a part is not moved,
+// such that no part becomes empty.
+void refinePartition(const wGraph & g, index_t nParts, real_t maxLoad,
+                     std::vector<index_t> & part)
+{
+    const index_t n = g.size();
+    std::vector<real_t> load(nParts, 0), conn(nParts);
+    std::vector<index_t> count(nParts, 0);
+    for (index_t v = 0; v < n; ++v)
+    {
+        load[part[v]] += g.w[v];
+        ++count[part[v]];
+    }
+
+    for (index_t pass = 0; pass < 10; ++pass)
+    {
+        bool moved = false;
+        for (index_t v = 0; v < n; ++v)
+        {
+            const index_t p = part[v];
+            if (1 == count[p]) continue;
+            connectivity(g, part, v, conn);
+            index_t best = -1;
+            real_t bestGain = 0;
+            for (index_t e = g.xadj[v]; e < g.xadj[v+1]; ++e)
+            {
+                const index_t q = part[g.adj[e]];
+                if (q == p) continue;
+                const real_t gn = conn[q] - conn[p];
+                const real_t lq = load[q] + g.w[v];
+                const bool ok = (lq <= maxLoad && gn > 0)              // better cut
+                    || (load[p] > maxLoad && lq < load[p]);            // better balance
+                if (ok && (best < 0 || gn > bestGain
+                           || (gn == bestGain && load[q] < load[best])))
+                {
+                    best = q;
+                    bestGain = gn;
+                }
+            }
+            if (best >= 0)
+            {
+                part[v] = best;
+                load[p]    -= g.w[v];
+                load[best] += g.w[v];
+                --count[p];
+                ++count[best];
+                moved = true;
+            }
+        }
+        if (!moved) break;
+    }
+}
+
+// Heavy-edge matching; the merged vertices do not exceed maxWeight.
+// Returns false if the graph could not be coarsened significantly.
+bool coarsen(const wGraph & g, real_t maxWeight, wGraph & c, std::vector<index_t> & cmap)
+{
+    const index_t n = g.size();
+    cmap.assign(n, -1);
+    index_t nc = 0;
+
+    // Visit the light vertices first
+    std::vector<index_t> order(n);
+    for (index_t v = 0; v < n; ++v)
+        order[v] = v;
+    std::stable_sort(order.begin(), order.end(),
+                     [&g](index_t a, index_t b) { return g.w[a] < g.w[b]; });
+
+    for (index_t i = 0; i < n; ++i)
+    {
+        const index_t v = order[i];
+        if (cmap[v] >= 0) continue;
+        index_t mate = -1;
+        for (index_t e = g.xadj[v]; e < g.xadj[v+1]; ++e)
+        {
+            const index_t u = g.adj[e];
+            if (cmap[u] < 0 && g.w[v] + g.w[u] <= maxWeight
+                && (mate < 0 || g.ew[e] > g.ew[mate]))
+                mate = e;
+        }
+        cmap[v] = nc;
+        if (mate >= 0)
+            cmap[g.adj[mate]] = nc;
+        ++nc;
+    }
+    if (nc > 0.9 * n)
+        return false;
+
+    // Coarse vertices and merged edges
+    c.w.assign(nc, 0);
+    std::vector<std::vector<index_t> > members(nc);
+    for (index_t v = 0; v < n; ++v)
+    {
+        c.w[cmap[v]] += g.w[v];
+        members[cmap[v]].push_back(v);
+    }
+
+    c.xadj.assign(1, 0);
+    c.adj.clear();
+    c.ew.clear();
+    std::vector<index_t> pos(nc, -1);
+    for (index_t cv = 0; cv < nc; ++cv)
+    {
+        const index_t start = c.xadj.back();
+        for (size_t m = 0; m != members[cv].size(); ++m)
+        {
+            const index_t v = members[cv][m];
+            for (index_t e = g.xadj[v]; e < g.xadj[v+1]; ++e)
+            {
+                const index_t cu = cmap[g.adj[e]];
+                if (cu == cv) continue;
+                if (pos[cu] < start)
+                {
+                    pos[cu] = static_cast<index_t>(c.adj.size());
+                    c.adj.push_back(cu);
+                    c.ew.push_back(g.ew[e]);
+                }
+                else
+                    c.ew[pos[cu]] += g.ew[e];
+            }
+        }
+        c.xadj.push_back(static_cast<index_t>(c.adj.size()));
+    }
+    return true;
+}
+
+void multilevelPartition(const wGraph & g, index_t nParts, real_t tol,
+                         std::vector<index_t> & part)
+{
+    const real_t avg = total(g.w) / static_cast<real_t>(nParts);
+    const real_t maxLoad = (1 + tol) * avg;
+
+    // Coarsening
+    std::vector<wGraph> levels(1, g);
+    std::vector<std::vector<index_t> > cmaps;
+    while (levels.back().size() > 2 * nParts)
+    {
+        wGraph c;
+        std::vector<index_t> cmap;
+        if (!coarsen(levels.back(), avg / 4, c, cmap))
+            break;
+        levels.push_back(give(c));
+        cmaps.push_back(give(cmap));
+    }
+
+    // Initial partition of the coarsest graph, then projection and
+    // refinement on every level
+    // The best of several trials, with different seeds of the first part
+    const wGraph & cg = levels.back();
+    const index_t nc = cg.size(), nTrials = math::min(nc, static_cast<index_t>(16));
+    std::vector<index_t> trial;
+    real_t bestMax = 0, bestCut = 0;
+    for (index_t t = 0; t < nTrials; ++t)
+    {
+        growPartition(cg, nParts, (t * nc) / nTrials, trial);
+        refinePartition(cg, nParts, maxLoad, trial);
+
+        std::vector<real_t> load(nParts, 0);
+        real_t cut = 0;
+        for (index_t v = 0; v < nc; ++v)
+        {
+            load[trial[v]] += cg.w[v];
+            for (index_t e = cg.xadj[v]; e < cg.xadj[v+1]; ++e)
+                if (trial[cg.adj[e]] != trial[v])
+                    cut += cg.ew[e];
+        }
+        const real_t mx = *std::max_element(load.begin(), load.end());
+
+        // Balance first, then the cut
+        const bool better = 0 == t
+            || (mx <= maxLoad ? (bestMax > maxLoad || cut < bestCut
+                                 || (cut == bestCut && mx < bestMax))
+                              : mx < bestMax);
+        if (better)
+        {
+            part    = trial;
+            bestMax = mx;
+            bestCut = cut;
+        }
+    }
+    for (size_t l = cmaps.size(); l-- > 0; )
+    {
+        std::vector<index_t> fine(cmaps[l].size());
+        for (size_t v = 0; v != fine.size(); ++v)
+            fine[v] = part[cmaps[l][v]];
+        part.swap(fine);
+        refinePartition(levels[l], nParts, maxLoad, part);
+    }
+}
+
+#ifdef GISMO_WITH_METIS
+void metisPartition(const wGraph & g, index_t nParts, real_t tol,
+                    std::vector<index_t> & part)
+{
+    // METIS needs integer weights
+    const real_t wmax = *std::max_element(g.w.begin(), g.w.end());
+    const real_t emax = g.ew.empty() ? 1 : *std::max_element(g.ew.begin(), g.ew.end());
+    std::vector<idx_t> xadj(g.xadj.begin(), g.xadj.end()), adj(g.adj.begin(), g.adj.end());
+    std::vector<idx_t> vwgt(g.size()), adjwgt(g.ew.size()), mpart(g.size());
+    for (index_t v = 0; v < g.size(); ++v)
+        vwgt[v] = math::max(static_cast<idx_t>(1e6 * g.w[v] / wmax), static_cast<idx_t>(1));
+    for (size_t e = 0; e != g.ew.size(); ++e)
+        adjwgt[e] = math::max(static_cast<idx_t>(1e3 * g.ew[e] / emax), static_cast<idx_t>(1));
+
+    idx_t nv = static_cast<idx_t>(g.size()), ncon = 1, np = static_cast<idx_t>(nParts), cut;
+    metis_real_t ubvec = static_cast<metis_real_t>(1 + tol);
+    idx_t options[METIS_NOPTIONS];
+    METIS_SetDefaultOptions(options);
+    options[METIS_OPTION_NUMBERING] = 0;
+
+    const int status = METIS_PartGraphKway(&nv, &ncon, xadj.data(), adj.empty() ? NULL : adj.data(),
+                                           vwgt.data(), NULL, adj.empty() ? NULL : adjwgt.data(),
+                                           &np, NULL, &ubvec, options, &cut, mpart.data());
+    GISMO_ENSURE(METIS_OK == status, "METIS_PartGraphKway failed with status "<<status);
+    part.assign(mpart.begin(), mpart.end());
+}
+#endif
+
+} // anonymous namespace
+
+void gsPatchPartitioner::init(const gsBoxTopology & topology,
+                              const std::vector<real_t> & patchCost,
+                              const std::vector<real_t> & interfaceWeight)
+{
+    const index_t n = topology.nBoxes();
+    const std::vector<boundaryInterface> & ifaces = topology.interfaces();
+    GISMO_ASSERT(static_cast<index_t>(patchCost.size()) == n,
+                 "The number of costs does not match the number of patches: "
+                 << patchCost.size() << "!=" << n);
+    GISMO_ASSERT(interfaceWeight.empty() || interfaceWeight.size() == ifaces.size(),
+                 "The number of weights does not match the number of interfaces: "
+                 << interfaceWeight.size() << "!=" << ifaces.size());
+
+    m_cost = patchCost;
+
+    // Both directions of every edge; several interfaces between two
+    // patches (e.g. periodic ones) are merged
+    std::vector<std::vector<std::pair<index_t,real_t> > > nb(n);
+    for (size_t i = 0; i != ifaces.size(); ++i)
+    {
+        const index_t p1 = ifaces[i].first().patch, p2 = ifaces[i].second().patch;
+        if (p1 == p2) continue;
+        const real_t w = interfaceWeight.empty() ? real_t(1) : interfaceWeight[i];
+        nb[p1].push_back(std::make_pair(p2, w));
+        nb[p2].push_back(std::make_pair(p1, w));
+    }
+
+    m_xadj.assign(1, 0);
+    m_adj.clear();
+    m_adjWeight.clear();
+    for (index_t k = 0; k < n; ++k)
+    {
+        std::sort(nb[k].begin(), nb[k].end());
+        for (size_t j = 0; j != nb[k].size(); ++j)
+        {
+            if (j > 0 && nb[k][j].first == nb[k][j-1].first)
+                m_adjWeight.back() += nb[k][j].second;
+            else
+            {
+                m_adj.push_back(nb[k][j].first);
+                m_adjWeight.push_back(nb[k][j].second);
+            }
+        }
+        m_xadj.push_back(static_cast<index_t>(m_adj.size()));
+    }
+}
+
+std::vector<index_t> gsPatchPartitioner::partition(index_t nParts, method m) const
+{
+    GISMO_ENSURE(nParts > 0, "The number of parts must be positive.");
+    const index_t n = nPatches();
+    std::vector<index_t> part(n, 0);
+    if (1 == nParts || 0 == n)
+        return part;
+
+    // One patch per part
+    if (n <= nParts)
+    {
+        for (index_t k = 0; k < n; ++k)
+            part[k] = k;
+        return part;
+    }
+
+    wGraph g;
+    g.w    = m_cost;
+    g.xadj = m_xadj;
+    g.adj  = m_adj;
+    g.ew   = m_adjWeight;
+
+    switch (m)
+    {
+    case greedy:
+        greedyPartition(g, nParts, part);
+        break;
+    case metis:
+#ifdef GISMO_WITH_METIS
+        metisPartition(g, nParts, m_tolerance, part);
+        break;
+#else
+        gsWarn << "gsPatchPartitioner: G+Smo is compiled without METIS, "
+               << "the multilevel method is used instead.\n";
+        multilevelPartition(g, nParts, m_tolerance, part);
+        break;
+#endif
+    default:
+        multilevelPartition(g, nParts, m_tolerance, part);
+    }
+    return part;
+}
+
+std::vector<real_t> gsPatchPartitioner::loads(const std::vector<index_t> & part,
+                                              index_t nParts) const
+{
+    GISMO_ASSERT(static_cast<index_t>(part.size()) == nPatches(), "Invalid partition.");
+    std::vector<real_t> result(nParts, 0);
+    for (index_t k = 0; k < nPatches(); ++k)
+        result[part[k]] += m_cost[k];
+    return result;
+}
+
+real_t gsPatchPartitioner::imbalance(const std::vector<index_t> & part, index_t nParts) const
+{
+    const std::vector<real_t> l = loads(part, nParts);
+    const real_t avg = total(l) / static_cast<real_t>(nParts);
+    return avg > 0 ? *std::max_element(l.begin(), l.end()) / avg : real_t(1);
+}
+
+real_t gsPatchPartitioner::edgeCut(const std::vector<index_t> & part) const
+{
+    GISMO_ASSERT(static_cast<index_t>(part.size()) == nPatches(), "Invalid partition.");
+    real_t cut = 0;
+    for (index_t k = 0; k < nPatches(); ++k)
+        for (index_t e = m_xadj[k]; e < m_xadj[k+1]; ++e)
+            if (m_adj[e] > k && part[m_adj[e]] != part[k])
+                cut += m_adjWeight[e];
+    return cut;
+}
+
+} // namespace gismo
@@ -0,0 +1,195 @@
+/** @file gsPatchPartitioner.h
+
+    @brief Weighted partitioning of the patches of a multi-patch domain
+    for load-balanced parallel runs
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsCore/gsMultiBasis.h>
+
+namespace gismo
+{
+
+/**
+   @brief Assigns the patches of a multi-patch domain to a number of
+   parts (processes or threads), such that the parts have about the same
+   cost and share few interface dofs
+
+   The patches are the vertices of a weighted graph. The weight of a
+   patch is an estimate of its cost, and every interface between two
+   patches is an edge, weighted with the number of basis functions on
+   the interface (the communication volume if the two patches end up in
+   different parts).
+
+   Given a gsMultiBasis, the cost of a patch is estimated by the
+   assembly cost, i.e., its number of elements (which reflects the
+   refinement level, also of hierarchical bases) times the number of
+   quadrature nodes per element times the squared number of active basis
+   functions per element, see patchCost(). Other estimates (e.g.,
+   measured timings) can be given directly.
+
+   The partition is a vector with the part of every patch, which can be
+   used as the assignment of the patches to the processes in
+   gsDistributedDofMapper, gsMpiComm::graph, or to select the patches of
+   a process for gsIetiMapper and the assemblers, see patchesOf().
+
+   Three methods are available:
+   - greedy: the patches are assigned in the order of decreasing cost,
+     each to the part with the smallest load (ties are broken by the
+     connectivity to the part);
+   - multilevel: the graph is coarsened by heavy-edge matching, the
+     coarsest graph is partitioned greedily, and the partition is
+     refined by moving boundary patches on every level while projecting
+     back to the patches;
+   - metis: the k-way partitioner of METIS, if G+Smo is compiled with
+     GISMO_WITH_METIS, otherwise the multilevel method is used.
+
+   @ingroup Mpi
+*/
+class GISMO_EXPORT gsPatchPartitioner
+{
+public:
+
+    /// The partitioning methods
+    enum method
+    {
+        greedy     = 0, ///< largest cost first, to the least loaded part
+        multilevel = 1, ///< coarsening, greedy partitioning and refinement
+        metis      = 2  ///< METIS (if available, otherwise multilevel)
+    };
+
+    /// Empty partitioner, no patches
+    gsPatchPartitioner() : m_tolerance(0.05) { }
+
+    /// @brief Sets up the graph of the patches of \a mb, with the cost
+    /// estimates of patchCost()
+    template<class T>
+    explicit gsPatchPartitioner(const gsMultiBasis<T> & mb)
+    : m_tolerance(0.05)
+    { init(mb); }
+
+    /// @brief Sets up the graph of the patches of \a topology with
+    /// given costs
+    ///
+    /// @param topology        the topology of the patches
+    /// @param patchCost       the cost of every patch
+    /// @param interfaceWeight the weight of every interface, in the order
+    ///                        of topology.interfaces(); all 1 if empty
+    gsPatchPartitioner(const gsBoxTopology & topology,
+                       const std::vector<real_t> & patchCost,
+                       const std::vector<real_t> & interfaceWeight = std::vector<real_t>())
+    : m_tolerance(0.05)
+    { init(topology, patchCost, interfaceWeight); }
+
+    /// @copydoc gsPatchPartitioner(const gsMultiBasis<T>&)
+    template<class T>
+    void init(const gsMultiBasis<T> & mb)
+    {
+        const gsBoxTopology & topology = mb.topology();
+        std::vector<real_t> cost(mb.nBases());
+        for (size_t k = 0; k != mb.nBases(); ++k)
+            cost[k] = patchCost(mb.basis(k));
+
+        const std::vector<boundaryInterface> & ifaces = topology.interfaces();
+        std::vector<real_t> weight(ifaces.size());
+        for (size_t i = 0; i != ifaces.size(); ++i)
+            weight[i] = static_cast<real_t>(
+                mb.basis(ifaces[i].first().patch).boundary(ifaces[i].first()).size() );
+
+        init(topology, cost, weight);
+    }
+
+    /// @copydoc gsPatchPartitioner(const gsBoxTopology&,const std::vector<real_t>&,const std::vector<real_t>&)
+    void init(const gsBoxTopology & topology,
+              const std::vector<real_t> & patchCost,
+              const std::vector<real_t> & interfaceWeight = std::vector<real_t>());
+
+    /// @brief The estimated cost of the assembly on the patch with basis \a b
+    ///
+    /// The number of elements times \f$ \prod_i (p_i+1)^3 \f$, with the
+    /// degrees \f$ p_i \f$: \f$ \prod_i (p_i+1) \f$ quadrature nodes per
+    /// direction and element, and as many active basis functions.
+    template<class T>
+    static real_t patchCost(const gsBasis<T> & b)
+    {
+        real_t perElement = 1;
+        for (short_t i = 0; i < b.dim(); ++i)
+        {
+            const real_t q = static_cast<real_t>(b.degree(i) + 1);
+            perElement *= q * q * q;
+        }
+        return static_cast<real_t>(b.numElements()) * perElement;
+    }
+
+    /// @brief Partitions the patches into \a nParts parts
+    ///
+    /// Returns the part of every patch, a number between 0 and nParts-1.
+    /// If there are at most as many patches as parts, every patch is a
+    /// part of its own and the remaining parts are empty. Otherwise, the
+    /// multilevel and the greedy methods leave no part empty.
+    std::vector<index_t> partition(index_t nParts, method m = multilevel) const;
+
+    /// @brief The allowed relative imbalance of the multilevel method
+    ///
+    /// A part is considered overloaded if its cost exceeds the average
+    /// by more than this fraction (default 0.05).
+    void setTolerance(real_t tol) { m_tolerance = tol; }
+
+    /// The number of patches
+    index_t nPatches() const { return static_cast<index_t>(m_cost.size()); }
+
+    /// The cost of every patch
+    const std::vector<real_t> & costs() const { return m_cost; }
+
+    /// The costs of the parts of \a part
+    std::vector<real_t> loads(const std::vector<index_t> & part, index_t nParts) const;
+
+    /// @brief The maximal cost of the parts divided by the average
+    /// (1 for a perfect balance)
+    real_t imbalance(const std::vector<index_t> & part, index_t nParts) const;
+
+    /// The sum of the weights of the interfaces between different parts
+    real_t edgeCut(const std::vector<index_t> & part) const;
+
+    /// The (sorted) patches of part \a p
+    static std::vector<index_t> patchesOf(const std::vector<index_t> & part, index_t p)
+    {
+        std::vector<index_t> result;
+        for (size_t k = 0; k != part.size(); ++k)
+            if (part[k] == p)
+                result.push_back(static_cast<index_t>(k));
+        return result;
+    }
+
+    /// Prints the object as a string
+    std::ostream & print(std::ostream & os) const
+    {
+        os << "gsPatchPartitioner: " << nPatches() << " patches, "
+           << m_adj.size() / 2 << " pairs of neighbors\n";
+        return os;
+    }
+
+private:
+    real_t m_tolerance;
+
+    // The graph in compressed form, with merged parallel edges
+    std::vector<real_t>  m_cost;
+    std::vector<index_t> m_xadj, m_adj;
+    std::vector<real_t>  m_adjWeight;
+};
+
+/// \brief Print (as string) operator for patch partitioners
+/// \relates gsPatchPartitioner
+inline std::ostream & operator<<(std::ostream & os, const gsPatchPartitioner & pp)
+{ return pp.print(os); }
+
+} // namespace gismo
@@ -41,7 +41,8 @@ public:
       m_numIterations(0),
       m_maxIterations(100),
       m_tolerance(1e-12),
-      m_converged(false)
+      m_converged(false),
+      m_analyzedNnz(-1)
     { 
 
     }
@@ -51,7 +52,8 @@ public:
       m_numIterations(0),
       m_maxIterations(100),
       m_tolerance(1e-12),
-      m_converged(false)
+      m_converged(false),
+      m_analyzedNnz(-1)
     { 
 
     }
@@ -101,6 +103,12 @@ protected:
     virtual void solveLinearProblem(const gsMultiPatch<T> & currentSol, gsMatrix<T> &updateVector);
 
     virtual T getResidue() {return m_assembler.rhs().norm();}
+
+    /// \brief Factorizes the current system matrix. If the assembler
+    /// keeps a fixed sparsity pattern, the symbolic analysis of the
+    /// first iteration is reused and only the numeric factorization
+    /// is repeated
+    void factorizeSystem();
 protected:
 
     /// \brief gsAssemblerBase object to generate the linear system
@@ -141,6 +149,9 @@ protected:
     /// \brief Norm of the current Newton update vector
 	T m_updnorm;
 
+    /// \brief Non-zeros of the matrix analyzed by the solver (-1: none)
+    index_t m_analyzedNnz;
+
 };
 
 
@@ -150,6 +161,19 @@ protected:
 namespace gismo
 {
 
+template <class T>
+void gsNewtonIterator<T>::factorizeSystem()
+{
+    const gsSparseMatrix<T> & mat = m_assembler.matrix();
+    if ( m_assembler.system().hasPattern() && mat.nonZeros() == m_analyzedNnz )
+        m_solver.factorize(mat);
+    else
+    {
+        m_solver.compute(mat);
+        m_analyzedNnz = ( m_assembler.system().hasPattern() ? mat.nonZeros() : -1 );
+    }
+}
+
 template <class T>
 void gsNewtonIterator<T>::solveLinearProblem(gsMatrix<T>& updateVector)
 {
@@ -160,7 +184,7 @@ void gsNewtonIterator<T>::solveLinearProblem(gsMatrix<T>& updateVector)
     // gsDebugVar( m_assembler.rhs().transpose() );
 
     // Compute the newton update
-    m_solver.compute( m_assembler.matrix() );
+    factorizeSystem();
     updateVector = m_solver.solve( m_assembler.rhs() );
     
     // gsDebugVar(updateVector);
@@ -176,7 +200,7 @@ void gsNewtonIterator<T>::solveLinearProblem(const gsMultiPatch<T> & currentSol,
     // gsDebugVar( m_assembler.rhs().transpose() );
     
     // Compute the newton update
-    m_solver.compute( m_assembler.matrix() );
+    factorizeSystem();
     updateVector = m_solver.solve( m_assembler.rhs() );
 
     // gsDebugVar(updateVector);
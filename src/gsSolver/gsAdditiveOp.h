@@ -44,6 +44,12 @@ namespace gismo
 ///
 /// but much faster.
 ///
+/// The subspace corrections are applied one after another, or in
+/// parallel by the OpenMP threads if enabled by setParallel (see
+/// gsKrylovKernels::sumTasks). In the latter case, an operator
+/// \f$ A_i \f$ that keeps workspaces must not be used for several
+/// subspaces.
+///
 /// @ingroup Solvers
 
 template<class T>
@@ -65,7 +71,7 @@ public:
     typedef memory::unique_ptr<gsAdditiveOp> uPtr;
 
     /// Default Constructor
-    gsAdditiveOp() : m_transfers(), m_ops() {}
+    gsAdditiveOp() : m_transfers(), m_ops(), m_parallel(false) {}
 
     /// @brief Constructor
     ///
@@ -74,7 +80,7 @@ public:
     /// @param transfers  transfer matrices \f$ T_i \f$
     /// @param ops        local operators \f$ A_i \f$
     gsAdditiveOp(TransferContainer transfers, OpContainer ops)
-    : m_transfers(), m_ops(give(ops))
+    : m_transfers(), m_ops(give(ops)), m_parallel(false)
     {
         const size_t sz = transfers.size();
         m_transfers.reserve(sz);
@@ -99,7 +105,7 @@ public:
     /// @param transfers  transfer matrices \f$ T_i \f$
     /// @param ops        local operators \f$ A_i \f$
     gsAdditiveOp(TransferPtrContainer transfers, OpContainer ops)
-    : m_transfers(give(transfers)), m_ops(give(ops))
+    : m_transfers(give(transfers)), m_ops(give(ops)), m_parallel(false)
     {
 #ifndef NDEBUG
         GISMO_ASSERT( m_transfers.size() == m_ops.size(), "Sizes do not agree" );
@@ -167,6 +173,12 @@ public:
                        "Dimensions of the operators do not fit." );
     }
 
+    /// @brief Apply the subspace corrections in parallel by the OpenMP threads
+    ///
+    /// This is disabled by default. The local operators must not share
+    /// workspaces then.
+    void setParallel(bool parallel = true) { m_parallel = parallel; }
+
     void apply(const gsMatrix<T>& input, gsMatrix<T>& x) const;
 
     index_t rows() const
@@ -184,6 +196,7 @@ public:
 protected:
     TransferPtrContainer m_transfers;   ///< Transfer matrices
     OpContainer m_ops;                  ///< Operators to be applied in the subspaces
+    bool m_parallel;                    ///< Apply the subspace corrections in parallel
 
 };
 
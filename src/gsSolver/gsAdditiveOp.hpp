@@ -11,6 +11,8 @@
     Author(s): S. Takacs
 */
 
+#include <gsSolver/gsKrylovKernels.h>
+
 namespace gismo
 {
 
@@ -19,17 +21,15 @@ void gsAdditiveOp<T>::apply(const gsMatrix<T>& input, gsMatrix<T>& x) const
 {
     GISMO_ASSERT( this->rows() == input.rows(), "The dimensions do not fit." );
 
-    x.setZero( input.rows(), input.cols() );
-
-    const index_t n = m_ops.size();
-    gsMatrix<T> res_local, corr_local;
-
-    for (index_t i=0; i<n; ++i)
-    {
-        res_local.noalias() = m_transfers[i]->transpose()*input;
-        m_ops[i]->apply(res_local, corr_local);
-        x.noalias() += *(m_transfers[i])*corr_local;
-    }
+    // The subspace corrections are independent, they can be computed in parallel
+    gsKrylovKernels<T>::sumTasks(m_ops.size(), input.rows(), input.cols(),
+        [&](index_t i, gsMatrix<T> & y)
+        {
+            gsMatrix<T> res_local, corr_local;
+            res_local.noalias() = m_transfers[i]->transpose()*input;
+            m_ops[i]->apply(res_local, corr_local);
+            y.noalias() += *(m_transfers[i])*corr_local;
+        }, x, m_parallel);
 }
 
 } // namespace gismo
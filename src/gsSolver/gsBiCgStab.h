@@ -31,6 +31,8 @@ public:
 
     typedef typename Base::LinOpPtr LinOpPtr;
 
+    typedef gsKrylovKernels<T> Kernels;
+
     typedef memory::shared_ptr<gsBiCgStab> Ptr;
     typedef memory::unique_ptr<gsBiCgStab> uPtr;
 
@@ -84,6 +86,7 @@ private:
     using Base::m_num_iter;
     using Base::m_rhs_norm;
     using Base::m_error;
+    using Base::sumProcs;
 
     VectorType m_res;
     VectorType m_r0;
@@ -34,7 +34,7 @@ bool gsBiCgStab<T>::initIteration( const typename gsBiCgStab<T>::VectorType& rhs
     m_rho = 1;
     m_w = 1;
 
-    m_error = m_res.norm() / m_rhs_norm;
+    m_error = math::sqrt(sumProcs(m_res.squaredNorm())) / m_rhs_norm;
 
     return m_error < m_tol;
 
@@ -44,41 +44,46 @@ template<class T>
 bool gsBiCgStab<T>::step( typename gsBiCgStab<T>::VectorType& x )
 {
     T rho_old = m_rho;
-    m_rho = m_r0.col(0).dot(m_res.col(0));
+    T red[2];
+    Kernels::dot2(m_r0, m_res, m_r0, red[0], red[1]);
+    sumProcs(red, 2);
+    m_rho = red[0];
 
-    if (math::abs(m_rho) < m_restartThereshold * m_r0.col(0).dot(m_r0.col(0)) )
+    if (math::abs(m_rho) < m_restartThereshold * red[1] )
     {
         gsInfo << "Residual almost orthogonal, restart with new r0 \n";
         m_r0 = m_res;
-        m_rho = m_r0.col(0).dot(m_r0.col(0)); //= r0_sqnorm
+        m_rho = sumProcs(Kernels::dot(m_r0, m_r0)); //= r0_sqnorm
     }
 
     T beta = (m_rho/rho_old)*(m_alpha/m_w);
-    m_p = m_res + beta*(m_p - m_w * m_v);
+    Kernels::axpbypcz(1, m_res, -beta * m_w, m_v, beta, m_p); // m_p = m_res + beta*(m_p - m_w * m_v)
 
     // Apply preconditioning by solving Ahat m_y = m_p
     m_precond->apply(m_p, m_y);
     // m_v = A * m_y;
     m_mat->apply(m_y, m_v);
-    m_alpha = m_rho/(m_r0.col(0).dot(m_v.col(0)));
+    m_alpha = m_rho/sumProcs(Kernels::dot(m_r0, m_v));
 
-    m_s.noalias() = m_res - m_alpha * m_v;
+    Kernels::axpbypcz(1, m_res, -m_alpha, m_v, 0, m_s);
     // Apply preconditioning by solving Ahat m_z = m_s
     m_precond->apply(m_s, m_z);
 
     // m_t = A * m_z;
     m_mat->apply(m_z, m_t);
 
-    if (m_t.col(0).dot(m_t.col(0)) > 0)
-        m_w = m_t.col(0).dot(m_s.col(0))/m_t.col(0).dot(m_t.col(0));
+    Kernels::dot2(m_t, m_t, m_s, red[0], red[1]);
+    sumProcs(red, 2);
+    if (red[0] > 0)
+        m_w = red[1]/red[0];
     else
         m_w = 0;
 
     // Update iterate and residual
-    x.noalias() += m_alpha * m_y + m_w * m_z;
-    m_res.noalias() -= m_alpha * m_v + m_w * m_t;
+    Kernels::axpbypcz(m_alpha, m_y, m_w, m_z, 1, x);
+    const T res2 = sumProcs(Kernels::axpbypcz(-m_alpha, m_v, -m_w, m_t, 1, m_res));
 
-    m_error = m_res.norm() / m_rhs_norm;
+    m_error = math::sqrt(res2) / m_rhs_norm;
     return m_error < m_tol;
 
 }
@@ -0,0 +1,122 @@
+/** @file gsBlockConjugateGradient.h
+
+    @brief Block conjugate gradient solver for several right-hand sides
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsSolver/gsIterativeSolver.h>
+
+namespace gismo
+{
+
+/// @brief The block conjugate gradient method.
+///
+/// Solves a system with several right-hand sides (the columns of the
+/// rhs) at once. All columns share one Krylov space, hence the operator
+/// and the preconditioner are applied to blocks of vectors (sparse
+/// matrix times multi-vector products), and usually less iterations
+/// than for the single columns are needed.
+///
+/// This is the breakdown-free variant of Ji and Li (Comput. Math. Appl.
+/// 73, 2017): the search directions are orthonormalized, and dependent
+/// directions are dropped. Columns whose relative residual is below the
+/// tolerance are deflated, i.e. removed from the iteration. Columns whose
+/// initial residual is (up to the tolerance) a linear combination of
+/// the other ones are not iterated; their solutions are combined from
+/// the solutions of the others at the end.
+///
+/// The error is the largest relative residual of the columns. The
+/// operator and the preconditioner must be symmetric positive definite
+/// and able to process multiple columns.
+///
+/// \ingroup Solver
+template<class T = real_t>
+class gsBlockConjugateGradient : public gsIterativeSolver<T>
+{
+public:
+    typedef gsIterativeSolver<T> Base;
+
+    typedef gsMatrix<T>  VectorType;
+
+    typedef typename Base::LinOpPtr LinOpPtr;
+
+    typedef gsKrylovKernels<T> Kernels;
+
+    typedef memory::shared_ptr<gsBlockConjugateGradient> Ptr;
+    typedef memory::unique_ptr<gsBlockConjugateGradient> uPtr;
+
+    /// @brief Constructor using a matrix (operator) and optionally a preconditionner
+    ///
+    /// @param mat     The operator to be solved for, see gsIterativeSolver for details
+    /// @param precond The preconditioner, defaulted to the identity
+    template< typename OperatorType >
+    explicit gsBlockConjugateGradient( const OperatorType& mat,
+                                       const LinOpPtr& precond = LinOpPtr() )
+    : Base(mat, precond) {}
+
+    /// @brief Make function using a matrix (operator) and optionally a preconditionner
+    ///
+    /// @param mat     The operator to be solved for, see gsIterativeSolver for details
+    /// @param precond The preconditioner, defaulted to the identity
+    template< typename OperatorType >
+    static uPtr make( const OperatorType& mat, const LinOpPtr& precond = LinOpPtr() )
+    { return uPtr( new gsBlockConjugateGradient(mat, precond) ); }
+
+    bool initIteration( const VectorType& rhs, VectorType& x );
+    bool step( VectorType& x );
+    void finalizeIteration( VectorType& x );
+
+    /// The number of columns which have not converged yet
+    index_t numActive() const                { return m_active.size(); }
+
+    /// Prints the object as a string.
+    std::ostream &print(std::ostream &os) const
+    {
+        os << "gsBlockConjugateGradient\n";
+        return os;
+    }
+
+private:
+    // Moves the converged columns to x and removes them from the
+    // iteration; returns true if all columns have converged
+    bool deflate( VectorType& x );
+
+    // Removes the columns whose initial residuals are combinations of
+    // the others from the iteration
+    void removeDependent();
+
+private:
+    using Base::m_mat;
+    using Base::m_precond;
+    using Base::m_max_iters;
+    using Base::m_tol;
+    using Base::m_num_iter;
+    using Base::m_rhs_norm;
+    using Base::m_error;
+    using Base::m_distributed;
+
+    std::vector<index_t> m_active;     // columns of x still iterated
+    gsMatrix<T> m_rhsNorms;            // norms of the active rhs columns
+    VectorType m_X, m_R, m_Z;          // active iterates, residuals, preconditioned residuals
+    VectorType m_P, m_AP;              // orthonormal search directions, A*P
+
+    VectorType m_X0;                   // initial guess
+    std::vector<index_t> m_indep;      // the independent columns
+    std::vector<index_t> m_dep;        // the dependent columns,
+    std::vector< gsMatrix<T> > m_depCoefs; // and their coefficients w.r.t. m_indep
+};
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsBlockConjugateGradient.hpp)
+#endif
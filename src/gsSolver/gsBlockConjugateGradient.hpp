@@ -0,0 +1,204 @@
+/** @file gsBlockConjugateGradient.hpp
+
+    @brief Block conjugate gradient solver for several right-hand sides
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+namespace gismo
+{
+
+template<class T>
+bool gsBlockConjugateGradient<T>::initIteration( const typename gsBlockConjugateGradient<T>::VectorType& rhs,
+                                                 typename gsBlockConjugateGradient<T>::VectorType& x )
+{
+    GISMO_ENSURE( !m_distributed, "gsBlockConjugateGradient: Distributed vectors (see setComm) are not supported." );
+    GISMO_ASSERT( rhs.rows() == m_mat->rows(),
+                  "The right-hand side does not match the matrix: "
+                  << rhs.rows() <<"!="<< m_mat->rows() );
+
+    m_num_iter = 0;
+
+    const index_t n = m_mat->cols(), k = rhs.cols();
+    if ( 0 == x.size() ) // if no initial solution, start with zeros
+        x.setZero(n, k);
+    GISMO_ASSERT( x.rows() == n && x.cols() == k,
+                  "The initial guess does not match the matrix and the right-hand side." );
+
+    Kernels::columnSquaredNorms(rhs, m_rhsNorms);
+    m_rhs_norm = math::sqrt(m_rhsNorms.sum());
+    m_rhsNorms = m_rhsNorms.cwiseSqrt();
+
+    // Columns with zero right-hand side are solved by zero
+    std::vector<bool> zero(k);
+    m_active.clear();
+    for (index_t j = 0; j != k; ++j)
+    {
+        zero[j] = (0 == m_rhsNorms(0,j));
+        if (zero[j])
+            x.col(j).setZero();
+        else
+            m_active.push_back(j);
+    }
+
+    m_X = x;
+    m_mat->apply(m_X,m_AP);
+    m_R = rhs - m_AP;                                                   // initial residuals
+    Kernels::removeColumns(m_X, zero);
+    Kernels::removeColumns(m_R, zero);
+    Kernels::removeColumns(m_rhsNorms, zero);
+
+    if (deflate(x))
+        return true;
+
+    m_X0 = x;
+    removeDependent();
+
+    m_precond->apply(m_R,m_Z);
+    gsMatrix<T> tmp;
+    Kernels::orthonormalize(m_Z, m_P, tmp);                             // initial search directions
+    return false;
+}
+
+template<class T>
+void gsBlockConjugateGradient<T>::removeDependent()
+{
+    // Gram-Schmidt (twice) on the residuals, R = Q U for the
+    // independent columns
+    const index_t n = m_R.rows(), k = m_R.cols();
+    gsMatrix<T> Q(n, k), U = gsMatrix<T>::Zero(k, k), v, h, h2;
+    std::vector<bool> dep(k);
+    std::vector<index_t> indep;
+    m_dep.clear();
+    m_depCoefs.clear();
+    index_t r = 0;
+    for (index_t j = 0; j != k; ++j)
+    {
+        v = m_R.col(j);
+        h.setZero(r, 1);
+        for (index_t pass = 0; pass != 2 && r != 0; ++pass)
+        {
+            Kernels::gram(Q.leftCols(r), v, h2);
+            Kernels::addProduct(Q.leftCols(r), -h2, v);
+            h += h2;
+        }
+        const T nv = math::sqrt(Kernels::dot(v, v));
+
+        // The residual of column j is a combination of the previous
+        // ones, up to a remainder that is below the tolerance
+        dep[j] = (nv < m_tol * m_rhsNorms(0,j) / 2);
+        if (dep[j])
+        {
+            m_dep.push_back(m_active[j]);
+            m_depCoefs.push_back(U.topLeftCorner(r, r).template triangularView<gsEigen::Upper>().solve(h));
+        }
+        else
+        {
+            Q.col(r) = v / nv;
+            U.col(r).head(r) = h;
+            U(r, r) = nv;
+            indep.push_back(m_active[j]);
+            ++r;
+        }
+    }
+    m_indep.swap(indep);
+
+    if (!m_dep.empty())
+    {
+        Kernels::removeColumns(m_X, dep);
+        Kernels::removeColumns(m_R, dep);
+        Kernels::removeColumns(m_rhsNorms, dep);
+        m_active = m_indep;
+    }
+}
+
+template<class T>
+bool gsBlockConjugateGradient<T>::step( typename gsBlockConjugateGradient<T>::VectorType& x )
+{
+    if (0 == m_P.cols()) // no search direction left
+        return true;
+
+    m_mat->apply(m_P,m_AP);                                             // apply system matrix
+
+    gsMatrix<T> W, PtR;
+    Kernels::gram(m_P, m_AP, W);
+    Kernels::gram(m_P, m_R, PtR);
+    W = (W + W.transpose()) / 2;
+    const gsEigen::LLT<typename gsMatrix<T>::Base> llt(W);
+
+    const gsMatrix<T> alpha = llt.solve(PtR);                           // the amount we travel on P
+    Kernels::addProduct(m_P,  alpha, m_X);                              // update solutions
+    Kernels::addProduct(m_AP,-alpha, m_R);                              // update residuals
+
+    if (deflate(x))
+        return true;
+
+    m_precond->apply(m_R,m_Z);
+
+    // New search directions: orthonormalize Z + P beta,
+    // with beta = -(P^T A P)^{-1} (A P)^T Z
+    gsMatrix<T> QtZ, tmp;
+    Kernels::gram(m_AP, m_Z, QtZ);
+    Kernels::addProduct(m_P, -llt.solve(QtZ), m_Z);
+    Kernels::orthonormalize(m_Z, m_P, tmp);
+    return false;
+}
+
+template<class T>
+bool gsBlockConjugateGradient<T>::deflate( typename gsBlockConjugateGradient<T>::VectorType& x )
+{
+    gsMatrix<T> res;
+    Kernels::columnSquaredNorms(m_R, res);
+
+    const index_t k = m_active.size();
+    std::vector<bool> done(k);
+    std::vector<index_t> active;
+    m_error = 0;
+    for (index_t j = 0; j != k; ++j)
+    {
+        const T err = math::sqrt(res(0,j)) / m_rhsNorms(0,j);
+        m_error = math::max(m_error, err);
+        done[j] = (err < m_tol);
+        if (done[j])
+            x.col(m_active[j]) = m_X.col(j);
+        else
+            active.push_back(m_active[j]);
+    }
+
+    if (active.size() != m_active.size())
+    {
+        Kernels::removeColumns(m_X, done);
+        Kernels::removeColumns(m_R, done);
+        Kernels::removeColumns(m_rhsNorms, done);
+        m_active.swap(active);
+    }
+    return m_active.empty();
+}
+
+template<class T>
+void gsBlockConjugateGradient<T>::finalizeIteration( typename gsBlockConjugateGradient<T>::VectorType& x )
+{
+    // the columns which have not converged
+    for (size_t j = 0; j != m_active.size(); ++j)
+        x.col(m_active[j]) = m_X.col(j);
+
+    // the columns which depend on the others
+    for (size_t j = 0; j != m_dep.size(); ++j)
+        for (index_t i = 0; i != m_depCoefs[j].rows(); ++i)
+            x.col(m_dep[j]) += m_depCoefs[j](i,0) * (x.col(m_indep[i]) - m_X0.col(m_indep[i]));
+
+    // cleanup temporaries
+    m_active.clear(); m_indep.clear();
+    m_dep.clear(); m_depCoefs.clear();
+    m_rhsNorms.clear();
+    m_X0.clear(); m_X.clear(); m_R.clear(); m_Z.clear();
+    m_P.clear(); m_AP.clear();
+}
+
+} // namespace gismo
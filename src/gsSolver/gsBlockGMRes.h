@@ -0,0 +1,147 @@
+/** @file gsBlockGMRes.h
+
+    @brief Block GMRes solver for several right-hand sides
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsSolver/gsIterativeSolver.h>
+
+namespace gismo
+{
+
+/// @brief The restarted block GMRes method.
+///
+/// Solves a system with several right-hand sides (the columns of the
+/// rhs) at once, in a Krylov space shared by all columns. Every
+/// iteration applies the operator and the preconditioner to a block of
+/// vectors (sparse matrix times multi-vector products). Like gsGMRes,
+/// the preconditioner is applied from the left, and the error is the
+/// relative norm of the preconditioned residual, here the largest one
+/// of the columns.
+///
+/// The block basis is orthogonalized by block Gram-Schmidt with
+/// reorthogonalization, and dependent directions are dropped. The
+/// block Hessenberg matrix is factorized incrementally by Householder
+/// transformations, which give the residual norms of the columns in
+/// every iteration.
+///
+/// The method is restarted every "Restart" iterations; the basis needs
+/// "Restart"+1 times as many vectors as there are right-hand sides.
+/// At a restart, the columns which have converged are deflated, i.e.
+/// removed from the iteration.
+///
+/// \ingroup Solver
+template<class T = real_t>
+class gsBlockGMRes : public gsIterativeSolver<T>
+{
+public:
+    typedef gsIterativeSolver<T> Base;
+
+    typedef gsMatrix<T>  VectorType;
+
+    typedef typename Base::LinOpPtr LinOpPtr;
+
+    typedef gsKrylovKernels<T> Kernels;
+
+    typedef memory::shared_ptr<gsBlockGMRes> Ptr;
+    typedef memory::unique_ptr<gsBlockGMRes> uPtr;
+
+    /// @brief Constructor using a matrix (operator) and optionally a preconditionner
+    ///
+    /// @param mat     The operator to be solved for, see gsIterativeSolver for details
+    /// @param precond The preconditioner, defaulted to the identity
+    template< typename OperatorType >
+    explicit gsBlockGMRes( const OperatorType& mat,
+                           const LinOpPtr& precond = LinOpPtr() )
+    : Base(mat, precond), m_restart(30) {}
+
+    /// @brief Make function using a matrix (operator) and optionally a preconditionner
+    ///
+    /// @param mat     The operator to be solved for, see gsIterativeSolver for details
+    /// @param precond The preconditioner, defaulted to the identity
+    template< typename OperatorType >
+    static uPtr make( const OperatorType& mat, const LinOpPtr& precond = LinOpPtr() )
+    { return uPtr( new gsBlockGMRes(mat, precond) ); }
+
+    /// @brief Returns a list of default options
+    static gsOptionList defaultOptions()
+    {
+        gsOptionList opt = Base::defaultOptions();
+        opt.addInt("Restart", "Number of iterations after which the method is restarted", 30 );
+        return opt;
+    }
+
+    /// @brief Set the options based on a gsOptionList
+    gsBlockGMRes& setOptions(const gsOptionList& opt)
+    {
+        Base::setOptions(opt);
+        m_restart = opt.askInt("Restart", m_restart);
+        GISMO_ENSURE(m_restart > 0, "gsBlockGMRes: the restart length must be positive.");
+        return *this;
+    }
+
+    /// @brief Set the number of iterations after which the method is restarted (default: 30)
+    void setRestart( index_t restart )       { GISMO_ENSURE(restart > 0, "Invalid restart length."); m_restart = restart; }
+
+    bool initIteration( const VectorType& rhs, VectorType& x );
+    bool step( VectorType& x );
+    void finalizeIteration( VectorType& x );
+
+    /// The number of columns which have not converged yet
+    index_t numActive() const                { return m_active.size(); }
+
+    /// Prints the object as a string.
+    std::ostream &print(std::ostream &os) const
+    {
+        os << "gsBlockGMRes\n";
+        return os;
+    }
+
+private:
+    // Computes the residuals, deflates the converged columns and sets
+    // up the first basis block; returns true if all columns have
+    // converged
+    bool startCycle( VectorType& x );
+
+    // Adds the correction of the current cycle to the iterates
+    void updateSolution();
+
+private:
+    using Base::m_mat;
+    using Base::m_precond;
+    using Base::m_max_iters;
+    using Base::m_tol;
+    using Base::m_num_iter;
+    using Base::m_rhs_norm;
+    using Base::m_error;
+    using Base::m_distributed;
+
+    index_t m_restart;
+
+    std::vector<index_t> m_active;     // columns of x still iterated
+    gsMatrix<T> m_rhsNorms;            // norms of the active rhs columns
+    VectorType m_B, m_X;               // active right-hand sides and iterates
+
+    VectorType m_V;                    // orthonormal basis, in blocks
+    std::vector<index_t> m_off;        // first column of every basis block
+    gsMatrix<T> m_R;                   // triangular factor of the Hessenberg matrix
+    gsMatrix<T> m_G;                   // transformed right-hand side of the least squares problem
+    std::vector< gsEigen::HouseholderQR<typename gsMatrix<T>::Base> > m_qr; // transformations
+
+    VectorType m_tmp, m_W;
+};
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsBlockGMRes.hpp)
+#endif
@@ -0,0 +1,216 @@
+/** @file gsBlockGMRes.hpp
+
+    @brief Block GMRes solver for several right-hand sides
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+namespace gismo
+{
+
+template<class T>
+bool gsBlockGMRes<T>::initIteration( const typename gsBlockGMRes<T>::VectorType& rhs,
+                                     typename gsBlockGMRes<T>::VectorType& x )
+{
+    GISMO_ENSURE( !m_distributed, "gsBlockGMRes: Distributed vectors (see setComm) are not supported." );
+    GISMO_ASSERT( rhs.rows() == m_mat->rows(),
+                  "The right-hand side does not match the matrix: "
+                  << rhs.rows() <<"!="<< m_mat->rows() );
+
+    m_num_iter = 0;
+
+    const index_t n = m_mat->cols(), k = rhs.cols();
+    if ( 0 == x.size() ) // if no initial solution, start with zeros
+        x.setZero(n, k);
+    GISMO_ASSERT( x.rows() == n && x.cols() == k,
+                  "The initial guess does not match the matrix and the right-hand side." );
+
+    Kernels::columnSquaredNorms(rhs, m_rhsNorms);
+    m_rhs_norm = math::sqrt(m_rhsNorms.sum());
+    m_rhsNorms = m_rhsNorms.cwiseSqrt();
+
+    // Columns with zero right-hand side are solved by zero
+    std::vector<bool> zero(k);
+    m_active.clear();
+    for (index_t j = 0; j != k; ++j)
+    {
+        zero[j] = (0 == m_rhsNorms(0,j));
+        if (zero[j])
+            x.col(j).setZero();
+        else
+            m_active.push_back(j);
+    }
+
+    m_B = rhs;
+    m_X = x;
+    Kernels::removeColumns(m_B, zero);
+    Kernels::removeColumns(m_X, zero);
+    Kernels::removeColumns(m_rhsNorms, zero);
+
+    m_qr.clear();
+    return startCycle(x);
+}
+
+template<class T>
+bool gsBlockGMRes<T>::startCycle( typename gsBlockGMRes<T>::VectorType& x )
+{
+    // Preconditioned residuals of the active columns
+    m_mat->apply(m_X,m_tmp);
+    m_tmp = m_B - m_tmp;
+    m_precond->apply(m_tmp,m_W);
+
+    // Deflate the converged columns
+    gsMatrix<T> res;
+    Kernels::columnSquaredNorms(m_W, res);
+    const index_t k = m_active.size();
+    std::vector<bool> done(k);
+    std::vector<index_t> active;
+    m_error = 0;
+    for (index_t j = 0; j != k; ++j)
+    {
+        const T err = math::sqrt(res(0,j)) / m_rhsNorms(0,j);
+        m_error = math::max(m_error, err);
+        done[j] = (err < m_tol);
+        if (done[j])
+            x.col(m_active[j]) = m_X.col(j);
+        else
+            active.push_back(m_active[j]);
+    }
+    if (active.empty())
+    {
+        m_active.clear();
+        return true;
+    }
+    if (active.size() != m_active.size())
+    {
+        Kernels::removeColumns(m_B, done);
+        Kernels::removeColumns(m_X, done);
+        Kernels::removeColumns(m_W, done);
+        Kernels::removeColumns(m_rhsNorms, done);
+        m_active.swap(active);
+    }
+
+    // First basis block, W = V_0 G
+    const index_t ka = m_active.size();
+    gsMatrix<T> V0;
+    const index_t p = Kernels::orthonormalize(m_W, V0, m_G);
+    m_V.resize(m_mat->cols(), (m_restart + 1) * ka);
+    m_V.leftCols(p) = V0;
+    m_off.assign(1, 0);
+    m_off.push_back(p);
+    m_R.setZero(m_restart * ka, m_restart * ka);
+    m_qr.clear();
+    return false;
+}
+
+template<class T>
+bool gsBlockGMRes<T>::step( typename gsBlockGMRes<T>::VectorType& x )
+{
+    const index_t j  = m_qr.size();                 // the current block
+    const index_t c0 = m_off[j], p = m_off[j+1] - c0;
+    const index_t nb = m_off[j+1];                  // size of the basis
+
+    // W = M^{-1} A V_j
+    m_tmp = m_V.middleCols(c0, p);
+    m_mat->apply(m_tmp, m_W);
+    m_tmp.swap(m_W);
+    m_precond->apply(m_tmp, m_W);
+
+    // Block Gram-Schmidt, twice
+    gsMatrix<T> h, h2;
+    Kernels::gram(m_V.leftCols(nb), m_W, h);
+    Kernels::addProduct(m_V.leftCols(nb), -h, m_W);
+    Kernels::gram(m_V.leftCols(nb), m_W, h2);
+    Kernels::addProduct(m_V.leftCols(nb), -h2, m_W);
+    h += h2;
+
+    // The next basis block, W = V_{j+1} S
+    gsMatrix<T> Vn, S;
+    const index_t pn = Kernels::orthonormalize(m_W, Vn, S);
+    m_V.middleCols(nb, pn) = Vn;
+    m_off.push_back(nb + pn);
+
+    // The new block column of the Hessenberg matrix, transformed by
+    // the previous Householder transformations
+    gsMatrix<T> hc(nb + pn, p);
+    hc.topRows(nb)    = h;
+    hc.bottomRows(pn) = S;
+    for (index_t i = 0; i != j; ++i)
+    {
+        const index_t r0 = m_off[i], nr = m_off[i+2] - r0;
+        const gsMatrix<T> blk = m_qr[i].householderQ().adjoint() * hc.middleRows(r0, nr);
+        hc.middleRows(r0, nr) = blk;
+    }
+
+    // The new transformation eliminates S
+    m_qr.push_back(gsEigen::HouseholderQR<typename gsMatrix<T>::Base>(hc.bottomRows(p + pn)));
+    m_R.block(0, c0, c0, p) = hc.topRows(c0);
+    m_R.block(c0, c0, p, p) = m_qr.back().matrixQR().topRows(p).template triangularView<gsEigen::Upper>();
+
+    m_G.conservativeResize(nb + pn, gsEigen::NoChange);
+    m_G.bottomRows(pn).setZero();
+    const gsMatrix<T> g = m_qr.back().householderQ().adjoint() * m_G.bottomRows(p + pn);
+    m_G.bottomRows(p + pn) = g;
+
+    // The residual norms are the norms of the last rows of G
+    gsMatrix<T> res;
+    res.noalias() = m_G.bottomRows(pn).colwise().norm();
+    m_error = 0;
+    for (index_t c = 0; c != res.cols(); ++c)
+        m_error = math::max(m_error, res(0,c) / m_rhsNorms(0,c));
+
+    if (m_error < m_tol || 0 == pn)
+    {
+        updateSolution();
+        for (size_t c = 0; c != m_active.size(); ++c)
+            x.col(m_active[c]) = m_X.col(c);
+        m_active.clear();
+        return true;
+    }
+
+    if (j + 1 == m_restart)
+    {
+        updateSolution();
+        return startCycle(x);
+    }
+
+    return false;
+}
+
+template<class T>
+void gsBlockGMRes<T>::updateSolution()
+{
+    if (m_qr.empty()) return;
+
+    // Solve the least squares problem, R Y = G, and update X += V Y
+    const index_t nc = m_off[m_qr.size()];
+    const gsMatrix<T> Y = m_R.topLeftCorner(nc, nc).template triangularView<gsEigen::Upper>()
+        .solve(m_G.topRows(nc));
+    Kernels::addProduct(m_V.leftCols(nc), Y, m_X);
+    m_qr.clear();
+}
+
+template<class T>
+void gsBlockGMRes<T>::finalizeIteration( typename gsBlockGMRes<T>::VectorType& x )
+{
+    // the columns which have not converged
+    updateSolution();
+    for (size_t j = 0; j != m_active.size(); ++j)
+        x.col(m_active[j]) = m_X.col(j);
+
+    // cleanup temporaries
+    m_active.clear();
+    m_rhsNorms.clear();
+    m_B.clear(); m_X.clear();
+    m_V.clear(); m_off.clear();
+    m_R.clear(); m_G.clear();
+    m_tmp.clear(); m_W.clear();
+}
+
+} // namespace gismo
@@ -37,6 +37,11 @@ namespace gismo
  * The number of blocks (m and n) are specified in the constructor. The blocks \f$C_{ij}\f$ are
  * defined using addOperator(i,j,...). Unspecified blocks are considered to be 0.
  *
+ * The blocks are applied one after another, or in parallel by the OpenMP
+ * threads if enabled by setParallel (see gsKrylovKernels::sumTasks). In
+ * the latter case, an operator that keeps workspaces must not be used for
+ * several blocks.
+ *
  * \ingroup Solver
  */
 template<class T>
@@ -79,8 +84,17 @@ public:
         return m_blockPrec(row,col);
     }
 
+    /**
+     * @brief Apply the blocks in parallel by the OpenMP threads
+     *
+     * This is disabled by default. The blocks must not share workspaces then.
+     */
+    void setParallel(bool parallel = true) { m_parallel = parallel; }
+
     /**
      * @brief Apply the correct segment of the input vector on the preconditioners in the block structure and store the result.
+     *
+     * The blocks are applied in parallel if enabled by setParallel.
      * @param input  Input vector
      * @param result Result vector
      */
@@ -102,6 +116,8 @@ private:
     gsVector<index_t> m_blockTargetPositions;
     //Contains the size of the input vector for each block
     gsVector<index_t> m_blockInputPositions;
+    //Apply the blocks in parallel
+    bool m_parallel;
 
 };
 
@@ -11,11 +11,14 @@
     Author(s): J. Sogn
 */
 
+#include <gsSolver/gsKrylovKernels.h>
+
 namespace gismo
 {
 
 template<typename T>
 gsBlockOp<T>::gsBlockOp(index_t nRows, index_t nCols)
+    : m_parallel(false)
 {
     m_blockPrec.resize(nRows, nCols);
     m_blockTargetPositions.setZero(nRows);
@@ -45,28 +48,31 @@ void gsBlockOp<T>::addOperator(index_t row, index_t col, const BasePtr& op)
 template<typename T>
 void gsBlockOp<T>::apply(const gsMatrix<T> & input, gsMatrix<T> & result) const
 {
-    result.setZero(m_blockTargetPositions.sum(), input.cols());
-    gsVector<index_t> singleCol(1);
-    singleCol <<  input.cols();
-    typename gsMatrix<T>::BlockView resultBlocks = result.blockView(m_blockTargetPositions, singleCol);
+    const index_t nRows = m_blockPrec.rows(), nCols = m_blockPrec.cols();
 
-    for (index_t i = 0; i < m_blockPrec.rows() ; ++i)
-    {
-        index_t inputIndex = 0;
-        for (index_t j = 0; j < m_blockPrec.cols(); ++j)
-        {
-            if (!m_blockPrec(i,j))// if the block is a null pointer
-            {
-                inputIndex += m_blockInputPositions(j);
-                continue;
-            }
+    // First row (column) of the blocks in the result (input)
+    gsVector<index_t> rowStart(nRows), colStart(nCols);
+    for (index_t i = 0, s = 0; i < nRows; s += m_blockTargetPositions[i], ++i)
+        rowStart[i] = s;
+    for (index_t j = 0, s = 0; j < nCols; s += m_blockInputPositions[j], ++j)
+        colStart[j] = s;
+
+    // The blocks which are not null pointers
+    std::vector< std::pair<index_t,index_t> > blocks;
+    for (index_t i = 0; i < nRows; ++i)
+        for (index_t j = 0; j < nCols; ++j)
+            if (m_blockPrec(i,j))
+                blocks.push_back( std::make_pair(i,j) );
 
+    // The blocks are independent, they can be applied in parallel
+    gsKrylovKernels<T>::sumTasks(blocks.size(), m_blockTargetPositions.sum(), input.cols(),
+        [&](index_t k, gsMatrix<T> & y)
+        {
+            const index_t i = blocks[k].first, j = blocks[k].second;
             gsMatrix<T> tmp_result;
-            m_blockPrec(i,j)->apply(input.block(inputIndex,0,m_blockInputPositions(j),input.cols()),tmp_result);
-            resultBlocks(i) += tmp_result;
-            inputIndex += m_blockInputPositions(j);
-        }
-    }
+            m_blockPrec(i,j)->apply(input.middleRows(colStart[j], m_blockInputPositions[j]), tmp_result);
+            y.middleRows(rowStart[i], m_blockTargetPositions[i]) += tmp_result;
+        }, result, m_parallel);
 }
 
 }
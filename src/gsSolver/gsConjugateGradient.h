@@ -35,6 +35,8 @@ public:
 
     typedef typename Base::LinOpPtr LinOpPtr;
 
+    typedef gsKrylovKernels<T> Kernels;
+
     typedef memory::shared_ptr<gsConjugateGradient> Ptr;
     typedef memory::unique_ptr<gsConjugateGradient> uPtr;
 
@@ -100,6 +102,7 @@ private:
     using Base::m_num_iter;
     using Base::m_rhs_norm;
     using Base::m_error;
+    using Base::sumProcs;
 
 
     VectorType m_res;
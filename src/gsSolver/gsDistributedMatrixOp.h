@@ -0,0 +1,81 @@
+/** @file gsDistributedMatrixOp.h
+
+    @brief Adapter class to use a row-distributed sparse matrix as a
+    gsLinearOperator
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsSolver/gsLinearOperator.h>
+#include <gsParallel/gsDistributedSparseMatrix.h>
+
+namespace gismo
+{
+
+/// @brief Adapter class to use a gsDistributedSparseMatrix as a linear
+/// operator
+///
+/// The operator acts on the rows owned by this process, so rows() and
+/// cols() are the local sizes. Together with gsIterativeSolver::setComm
+/// and a local preconditioner (for example, built from the diagonal
+/// block), this gives distributed Krylov solvers.
+///
+/// @ingroup Solver
+template<class T = real_t>
+class gsDistributedMatrixOp GISMO_FINAL : public gsLinearOperator<T>
+{
+    typedef gsDistributedSparseMatrix<T> MatrixType;
+    typedef memory::shared_ptr<MatrixType> MatrixPtr;
+
+public:
+    /// Shared pointer for gsDistributedMatrixOp
+    typedef memory::shared_ptr<gsDistributedMatrixOp> Ptr;
+
+    /// Unique pointer for gsDistributedMatrixOp
+    typedef memory::unique_ptr<gsDistributedMatrixOp> uPtr;
+
+    /// @brief Constructor taking a reference
+    ///
+    /// @note This does not copy the matrix. Make sure that the matrix
+    /// is not deleted too early (alternatively use constructor by
+    /// shared pointer)
+    gsDistributedMatrixOp(const MatrixType & mat) : m_mat(), m_ref(mat) { }
+
+    /// Constructor taking a shared pointer
+    gsDistributedMatrixOp(MatrixPtr mat) : m_mat(give(mat)), m_ref(*m_mat) { }
+
+    /// @brief Make function returning a smart pointer
+    ///
+    /// @note This does not copy the matrix. Make sure that the matrix
+    /// is not deleted too early or provide a shared pointer.
+    static uPtr make(const MatrixType & mat)
+    { return uPtr( new gsDistributedMatrixOp(mat) ); }
+
+    /// Make function returning a smart pointer
+    static uPtr make(MatrixPtr mat)
+    { return uPtr( new gsDistributedMatrixOp(give(mat)) ); }
+
+    void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
+    { m_ref.multiply(input, x); }
+
+    index_t rows() const { return m_ref.rows(); }
+
+    index_t cols() const { return m_ref.rows(); }
+
+    /// Returns the matrix
+    const MatrixType & matrix() const { return m_ref; }
+
+private:
+    const MatrixPtr m_mat;
+    const MatrixType & m_ref;
+};
+
+} // namespace gismo
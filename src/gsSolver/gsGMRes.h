@@ -30,6 +30,8 @@ public:
 
     typedef typename Base::LinOpPtr LinOpPtr;
 
+    typedef gsKrylovKernels<T> Kernels;
+
     typedef memory::shared_ptr<gsGMRes> Ptr;
     typedef memory::unique_ptr<gsGMRes> uPtr;
 
@@ -77,6 +79,7 @@ private:
     using Base::m_num_iter;
     using Base::m_rhs_norm;
     using Base::m_error;
+    using Base::sumProcs;
 
 
     gsMatrix<T> tmp, g, g_tmp, h_tmp, y, w;
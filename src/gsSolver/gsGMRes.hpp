@@ -26,7 +26,7 @@ bool gsGMRes<T>::initIteration( const typename gsGMRes<T>::VectorType& rhs,
     m_mat->apply(x,tmp);
     tmp = rhs - tmp;
     m_precond->apply(tmp, residual);
-    beta = residual.norm(); // This is  ||r||
+    beta = math::sqrt(sumProcs(Kernels::dot(residual, residual))); // This is  ||r||
 
     m_error = beta/m_rhs_norm;
     if(m_error < m_tol)
@@ -53,14 +53,9 @@ void gsGMRes<T>::finalizeIteration( typename gsGMRes<T>::VectorType& x )
     //Solve H*y = g;
     solveUpperTriangular(H, g_tmp);
 
-    //Create the matrix from the column matrix in v.
-    gsMatrix<T> V(m_mat->rows(),m_num_iter);
+    //Update solution: x += V*y, with the columns of V in v
     for (index_t k = 0; k< m_num_iter; ++k)
-    {
-        V.col(k) = v[k];
-    }
-    //Update solution
-    x += V*y;
+        Kernels::axpy(y(k,0), v[k], x);
 
     // cleanup temporaries
     tmp.clear();
@@ -96,12 +91,14 @@ bool gsGMRes<T>::step( typename gsGMRes<T>::VectorType& )
     m_mat->apply(v[k],tmp);
     m_precond->apply(tmp, w);
 
+    // Modified Gram-Schmidt; every update of w is fused with the
+    // next inner product (or the norm after the last update)
+    h_tmp(0,0) = sumProcs(Kernels::dot(w, v[0]));
     for (index_t i = 0; i< k+1; ++i)
     {
-        h_tmp(i,0) = (w.transpose()*v[i]).value(); //Typo h_l,k
-        w = w - h_tmp(i,0)*v[i];
+        const T next = sumProcs(Kernels::axpyDot(-h_tmp(i,0), v[i], w, i < k ? v[i+1] : w));
+        h_tmp(i+1,0) = (i < k ? next : math::sqrt(next)); //Typo h_l,k
     }
-    h_tmp(k+1,0) = w.norm();
 
   //  if (math::abs(h_tmp(k+1,0)) < 1e-16) //If exact solution
   //      return true;
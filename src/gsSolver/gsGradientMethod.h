@@ -134,6 +134,7 @@ private:
     using Base::m_num_iter;
     using Base::m_rhs_norm;
     using Base::m_error;
+    using Base::sumProcs;
 
     VectorType m_res;
     VectorType m_tmp;
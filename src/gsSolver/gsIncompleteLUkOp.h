@@ -0,0 +1,212 @@
+/** @file gsIncompleteLUkOp.h
+
+    @brief Incomplete LU factorization with level of fill k, with
+    parallel factorization and triangular solves
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsSolver/gsPreconditioner.h>
+#include <gsSolver/gsMatrixOp.h>
+#include <gsSolver/gsKrylovKernels.h>
+
+namespace gismo
+{
+
+/// @brief Incomplete LU preconditioner with level of fill k, ILU(k)
+///
+/// The factors \f$ L \f$ (with unit diagonal) and \f$ U \f$ are kept
+/// on the sparsity pattern of the matrix, enlarged by the fill-in of
+/// level at most k (option "FillLevel", default 0). Unlike
+/// gsIncompleteLUOp, which wraps the sequential IncompleteLUT of Eigen,
+/// this operator is designed for the OpenMP threads:
+///
+/// - The rows are grouped into levels, such that the rows of a level
+///   only depend on rows of previous levels (level scheduling). The
+///   rows of one level are factorized in parallel, and the triangular
+///   solves process the rows of one level in parallel.
+/// - Alternatively (option "TriangularSweeps" > 0), the triangular
+///   systems are solved approximately by the given number of Jacobi
+///   sweeps, which are fully parallel (Chow and Patel, SIAM J. Sci.
+///   Comput. 37, 2015). This is useful if there are many small levels.
+///
+/// The symbolic factorization (analyzePattern) and the numeric one
+/// (factorize) are separated, such that the pattern and the levels
+/// are reused for matrices with the same sparsity pattern, e.g., in
+/// the iterations of a Newton method.
+///
+/// @note If a matrix is provided, only a reference is stored. Make
+/// sure that the matrix is not deleted too early or provide a shared
+/// pointer.
+///
+/// \ingroup Solver
+template <class T>
+class gsIncompleteLUkOp GISMO_FINAL : public gsPreconditionerOp<T>
+{
+public:
+    /// Matrix type
+    typedef gsSparseMatrix<T> MatrixType;
+
+    /// Shared pointer to matrix type
+    typedef memory::shared_ptr<MatrixType> MatrixPtr;
+
+    /// Shared pointer for gsIncompleteLUkOp
+    typedef memory::shared_ptr< gsIncompleteLUkOp > Ptr;
+
+    /// Unique pointer for gsIncompleteLUkOp
+    typedef memory::unique_ptr< gsIncompleteLUkOp > uPtr;
+
+    /// Base class
+    typedef gsPreconditionerOp<T> Base;
+
+    /// Constructor with given matrix
+    explicit gsIncompleteLUkOp(const MatrixType& mat, index_t fillLevel = 0)
+    : m_matPtr(), m_mat(&mat), m_fillLevel(fillLevel), m_sweeps(0)
+    { compute(mat); }
+
+    /// Constructor with shared pointer to matrix
+    explicit gsIncompleteLUkOp(const MatrixPtr& mat, index_t fillLevel = 0)
+    : m_matPtr(mat), m_mat(mat.get()), m_fillLevel(fillLevel), m_sweeps(0)
+    { compute(*mat); }
+
+    static uPtr make(const MatrixType& mat, index_t fillLevel = 0)
+    { return memory::make_unique( new gsIncompleteLUkOp(mat, fillLevel) ); }
+
+    static uPtr make(const MatrixPtr& mat, index_t fillLevel = 0)
+    { return memory::make_unique( new gsIncompleteLUkOp(mat, fillLevel) ); }
+
+    /// @brief Computes the sparsity pattern of the factors and the
+    /// levels of the rows
+    void analyzePattern(const MatrixType& mat);
+
+    /// @brief Computes the factors of \a mat, which must have the
+    /// sparsity pattern given to analyzePattern (or a subset of it)
+    ///
+    /// Afterwards, the operator refers to \a mat.
+    void factorize(const MatrixType& mat);
+
+    /// Computes the pattern and the factors of \a mat
+    void compute(const MatrixType& mat)
+    {
+        analyzePattern(mat);
+        factorize(mat);
+    }
+
+    /// @brief Solves \f$ LU x = f \f$ (approximately if
+    /// "TriangularSweeps" is positive)
+    void solve(const gsMatrix<T> & f, gsMatrix<T> & x) const;
+
+    void step(const gsMatrix<T> & rhs, gsMatrix<T> & x) const
+    {
+        GISMO_ASSERT( m_mat->rows() == rhs.rows() && x.rows() == rhs.rows() && x.cols() == rhs.cols(),
+                      "Dimensions do not match.");
+        gsMatrix<T> res, corr;
+        gsKrylovKernels<T>::product(*m_mat, x, res);
+        res = rhs - res;
+        solve(res, corr);
+        x += corr;
+    }
+
+    // We use our own apply implementation as we can save one multiplication.
+    void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
+    {
+        solve(input, x);
+        for (index_t k = 1; k < m_num_of_sweeps; ++k)
+            step(input, x);
+    }
+
+    index_t rows() const {return m_mat->rows();}
+    index_t cols() const {return m_mat->cols();}
+
+    /// Number of levels of the forward substitution
+    index_t numLevels() const { return m_lowerStart.size() - 1; }
+
+    /// Number of non-zeros of the factors
+    index_t nonZeros() const  { return m_col.size(); }
+
+    /// Get the default options as gsOptionList object
+    static gsOptionList defaultOptions()
+    {
+        gsOptionList opt = Base::defaultOptions();
+        opt.addInt( "FillLevel", "Level of fill k of ILU(k)", 0 );
+        opt.addInt( "TriangularSweeps", "Number of Jacobi sweeps for the triangular solves, 0 for exact level-scheduled solves", 0 );
+        return opt;
+    }
+
+    /// Set options based on a gsOptionList object
+    virtual void setOptions(const gsOptionList & opt)
+    {
+        Base::setOptions(opt);
+        m_sweeps = opt.askInt( "TriangularSweeps", m_sweeps );
+        const index_t fillLevel = opt.askInt( "FillLevel", m_fillLevel );
+        if (fillLevel != m_fillLevel)
+        {
+            m_fillLevel = fillLevel;
+            compute(*m_mat);
+        }
+    }
+
+    /// Returns the matrix
+    const MatrixType & matrix() const { return *m_mat; }
+
+    /// Returns a shared pinter to the matrix
+    MatrixPtr    matrixPtr() const {
+        GISMO_ENSURE( m_matPtr, "A shared pointer is only available if it was provided to gsIncompleteLUkOp." );
+        return m_matPtr;
+    }
+
+    typename gsLinearOperator<T>::Ptr underlyingOp() const { return makeMatrixOp(m_matPtr); }
+
+private:
+    // Groups the rows into levels for the substitution with the lower
+    // or the upper factor
+    void computeLevels(bool lower, std::vector<index_t> & order,
+                       std::vector<index_t> & start) const;
+
+    void lowerSolve(gsMatrix<T> & x) const;
+    void upperSolve(gsMatrix<T> & x) const;
+
+private:
+    MatrixPtr          m_matPtr;     ///< Shared pointer to matrix (if needed)
+    const MatrixType * m_mat;        ///< The matrix
+    index_t            m_fillLevel;  ///< Level of fill k
+    index_t            m_sweeps;     ///< Jacobi sweeps of the triangular solves, 0 for exact solves
+    using Base::m_num_of_sweeps;
+
+    // The factors in compressed row storage: row i has the columns
+    // m_col[m_rowStart[i]..m_rowStart[i+1]), sorted, with the diagonal
+    // at m_diag[i]; the entries left of it belong to L, the others to U
+    std::vector<index_t> m_rowStart, m_col, m_diag;
+    std::vector<T>       m_val;
+
+    // Rows sorted by levels for the lower and the upper triangular
+    // factor, and first entry of each level
+    std::vector<index_t> m_lowerOrder, m_lowerStart;
+    std::vector<index_t> m_upperOrder, m_upperStart;
+};
+
+/// @brief Returns a smart pointer to an ILU(k) operator referring on \a mat
+/// \relates gsIncompleteLUkOp
+template <class T>
+typename gsIncompleteLUkOp<T>::uPtr makeIncompleteLUkOp(const gsSparseMatrix<T>& mat, index_t fillLevel = 0)
+{ return gsIncompleteLUkOp<T>::make(mat, fillLevel); }
+
+/// @brief Returns a smart pointer to an ILU(k) operator referring on \a mat
+/// \relates gsIncompleteLUkOp
+template <class T>
+typename gsIncompleteLUkOp<T>::uPtr makeIncompleteLUkOp(const memory::shared_ptr< gsSparseMatrix<T> >& mat, index_t fillLevel = 0)
+{ return gsIncompleteLUkOp<T>::make(mat, fillLevel); }
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsIncompleteLUkOp.hpp)
+#endif
@@ -0,0 +1,296 @@
+/** @file gsIncompleteLUkOp.hpp
+
+    @brief Incomplete LU factorization with level of fill k, with
+    parallel factorization and triangular solves
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsParallel/gsOpenMP.h>
+
+namespace gismo
+{
+
+template <class T>
+void gsIncompleteLUkOp<T>::analyzePattern(const MatrixType& mat)
+{
+    GISMO_ASSERT( mat.rows() == mat.cols(), "gsIncompleteLUkOp needs quadratic matrices." );
+    GISMO_ENSURE( m_fillLevel >= 0, "gsIncompleteLUkOp: The level of fill must not be negative." );
+
+    const index_t n = mat.rows();
+
+    // The pattern of the rows of the matrix
+    const gsSparseMatrix<T,RowMajor> A = mat;
+
+    m_rowStart.resize(n+1);
+    m_diag.resize(n);
+    m_col.clear();
+    m_col.reserve(A.nonZeros() + n);
+    std::vector<index_t> level;    // levels of fill of the entries
+    level.reserve(A.nonZeros() + n);
+
+    // Row i is assembled in a sorted linked list (terminated by n),
+    // together with the levels of its entries (n if not present)
+    std::vector<index_t> next(n+1), lev(n, n);
+    m_rowStart[0] = 0;
+    for (index_t i = 0; i < n; ++i)
+    {
+        index_t last = n; // sentinel as head
+        for (typename gsSparseMatrix<T,RowMajor>::InnerIterator it(A,i); it; ++it)
+        {
+            next[last] = it.index();
+            last = it.index();
+            lev[last] = 0;
+        }
+        next[last] = n;
+        if (lev[i] != 0) // the diagonal is always present
+        {
+            index_t prev = n;
+            while (next[prev] < i) prev = next[prev];
+            next[i] = next[prev];
+            next[prev] = i;
+            lev[i] = 0;
+        }
+
+        // Fill-in from the previous rows k of the lower part
+        for (index_t k = next[n]; k < i; k = next[k])
+        {
+            if (lev[k] >= m_fillLevel)
+                continue;
+            index_t prev = k;
+            for (index_t p = m_diag[k] + 1; p < m_rowStart[k+1]; ++p)
+            {
+                const index_t j = m_col[p], l = lev[k] + level[p] + 1;
+                if (l > m_fillLevel)
+                    continue;
+                if (lev[j] == n) // new entry, after prev
+                {
+                    while (next[prev] < j) prev = next[prev];
+                    next[j] = next[prev];
+                    next[prev] = j;
+                    lev[j] = l;
+                }
+                else
+                    lev[j] = math::min(lev[j], l);
+                prev = j;
+            }
+        }
+
+        for (index_t j = next[n]; j < n; j = next[j])
+        {
+            if (j == i)
+                m_diag[i] = m_col.size();
+            m_col.push_back(j);
+            level.push_back(lev[j]);
+            lev[j] = n;
+        }
+        m_rowStart[i+1] = m_col.size();
+    }
+    m_val.resize(m_col.size());
+
+    computeLevels(true , m_lowerOrder, m_lowerStart);
+    computeLevels(false, m_upperOrder, m_upperStart);
+}
+
+template <class T>
+void gsIncompleteLUkOp<T>::computeLevels(bool lower, std::vector<index_t> & order,
+                                         std::vector<index_t> & start) const
+{
+    const index_t n = m_diag.size();
+    std::vector<index_t> level(n);
+    index_t numLevels = 0;
+    for (index_t r = 0; r < n; ++r)
+    {
+        const index_t i = lower ? r : n - 1 - r;
+        const index_t b = lower ? m_rowStart[i] : m_diag[i] + 1;
+        const index_t e = lower ? m_diag[i]     : m_rowStart[i+1];
+        index_t l = 0;
+        for (index_t p = b; p < e; ++p)
+            l = math::max(l, level[m_col[p]] + 1);
+        level[i] = l;
+        numLevels = math::max(numLevels, l + 1);
+    }
+
+    // Rows sorted by level, in their order of processing within a level
+    start.assign(numLevels + 1, 0);
+    for (index_t i = 0; i < n; ++i)
+        ++start[level[i] + 1];
+    for (index_t l = 0; l < numLevels; ++l)
+        start[l+1] += start[l];
+
+    std::vector<index_t> pos(start.begin(), start.end() - 1);
+    order.resize(n);
+    for (index_t r = 0; r < n; ++r)
+    {
+        const index_t i = lower ? r : n - 1 - r;
+        order[pos[level[i]]++] = i;
+    }
+}
+
+template <class T>
+void gsIncompleteLUkOp<T>::factorize(const MatrixType& mat)
+{
+    const index_t n = m_diag.size();
+    GISMO_ENSURE( mat.rows() == n && mat.cols() == n,
+                  "gsIncompleteLUkOp::factorize: The matrix does not fit to the pattern." );
+
+    m_mat = &mat;
+    if ( m_matPtr && m_matPtr.get() != &mat )
+        m_matPtr.reset();
+
+    // Copy the matrix to the pattern of the factors
+    std::fill(m_val.begin(), m_val.end(), T(0));
+    bool inPattern = true;
+#   pragma omp parallel for schedule(static) reduction(&&:inPattern)
+    for (index_t j = 0; j < n; ++j)
+        for (typename MatrixType::InnerIterator it(mat,j); it; ++it)
+        {
+            const index_t i = it.row(), c = it.col();
+            const index_t * b = m_col.data() + m_rowStart[i], * e = m_col.data() + m_rowStart[i+1];
+            const index_t * p = std::lower_bound(b, e, c);
+            if (p != e && *p == c)
+                m_val[p - m_col.data()] = it.value();
+            else
+                inPattern = false;
+        }
+    GISMO_ENSURE( inPattern, "gsIncompleteLUkOp::factorize: The matrix does not fit to the pattern." );
+
+    // Factorization (IKJ variant), the rows of one level in parallel
+    bool zeroPivot = false;
+    const index_t numLevels = m_lowerStart.size() - 1;
+    for (index_t l = 0; l < numLevels; ++l)
+    {
+        const index_t s = m_lowerStart[l], e = m_lowerStart[l+1];
+#       pragma omp parallel for schedule(dynamic,64) if (e - s > 256) reduction(||:zeroPivot)
+        for (index_t r = s; r < e; ++r)
+        {
+            const index_t i = m_lowerOrder[r], end = m_rowStart[i+1];
+            for (index_t p = m_rowStart[i]; p < m_diag[i]; ++p)
+            {
+                const index_t k = m_col[p];
+                const T lik = (m_val[p] /= m_val[m_diag[k]]);
+
+                // row i -= lik * (upper part of row k), on the pattern of row i
+                index_t q = p + 1;
+                for (index_t t = m_diag[k] + 1; t < m_rowStart[k+1] && q < end; ++t)
+                {
+                    while (q < end && m_col[q] < m_col[t]) ++q;
+                    if (q < end && m_col[q] == m_col[t])
+                        m_val[q] -= lik * m_val[t];
+                }
+            }
+            if (m_val[m_diag[i]] == T(0))
+                zeroPivot = true;
+        }
+    }
+    GISMO_ENSURE( !zeroPivot, "gsIncompleteLUkOp::factorize: Zero pivot." );
+}
+
+template <class T>
+void gsIncompleteLUkOp<T>::solve(const gsMatrix<T> & f, gsMatrix<T> & x) const
+{
+    GISMO_ASSERT( f.rows() == static_cast<index_t>(m_diag.size()), "Dimensions do not match.");
+    x = f;
+    lowerSolve(x);
+    upperSolve(x);
+}
+
+template <class T>
+void gsIncompleteLUkOp<T>::lowerSolve(gsMatrix<T> & x) const
+{
+    const index_t n = x.rows(), nc = x.cols();
+    if (0 == m_sweeps)
+    {
+        const index_t numLevels = m_lowerStart.size() - 1;
+        for (index_t l = 0; l < numLevels; ++l)
+        {
+            const index_t s = m_lowerStart[l], e = m_lowerStart[l+1];
+#           pragma omp parallel for schedule(static) if (e - s > 512)
+            for (index_t r = s; r < e; ++r)
+            {
+                const index_t i = m_lowerOrder[r];
+                for (index_t c = 0; c < nc; ++c)
+                {
+                    T sum = x(i,c);
+                    for (index_t p = m_rowStart[i]; p < m_diag[i]; ++p)
+                        sum -= m_val[p] * x(m_col[p],c);
+                    x(i,c) = sum;
+                }
+            }
+        }
+        return;
+    }
+
+    // Jacobi sweeps y <- f - (L-I) y, starting from y = f
+    const gsMatrix<T> f = x;
+    gsMatrix<T> y(n, nc);
+    for (index_t k = 0; k < m_sweeps; ++k)
+    {
+        y.swap(x);
+#       pragma omp parallel for schedule(static) if (n > 1024)
+        for (index_t i = 0; i < n; ++i)
+            for (index_t c = 0; c < nc; ++c)
+            {
+                T sum = f(i,c);
+                for (index_t p = m_rowStart[i]; p < m_diag[i]; ++p)
+                    sum -= m_val[p] * y(m_col[p],c);
+                x(i,c) = sum;
+            }
+    }
+}
+
+template <class T>
+void gsIncompleteLUkOp<T>::upperSolve(gsMatrix<T> & x) const
+{
+    const index_t n = x.rows(), nc = x.cols();
+    if (0 == m_sweeps)
+    {
+        const index_t numLevels = m_upperStart.size() - 1;
+        for (index_t l = 0; l < numLevels; ++l)
+        {
+            const index_t s = m_upperStart[l], e = m_upperStart[l+1];
+#           pragma omp parallel for schedule(static) if (e - s > 512)
+            for (index_t r = s; r < e; ++r)
+            {
+                const index_t i = m_upperOrder[r];
+                for (index_t c = 0; c < nc; ++c)
+                {
+                    T sum = x(i,c);
+                    for (index_t p = m_diag[i] + 1; p < m_rowStart[i+1]; ++p)
+                        sum -= m_val[p] * x(m_col[p],c);
+                    x(i,c) = sum / m_val[m_diag[i]];
+                }
+            }
+        }
+        return;
+    }
+
+    // Jacobi sweeps z <- D^{-1} (y - (U-D) z), starting from z = D^{-1} y
+    const gsMatrix<T> y = x;
+    gsMatrix<T> z(n, nc);
+    for (index_t i = 0; i < n; ++i)
+        x.row(i) /= m_val[m_diag[i]];
+    for (index_t k = 1; k < m_sweeps; ++k)
+    {
+        z.swap(x);
+#       pragma omp parallel for schedule(static) if (n > 1024)
+        for (index_t i = 0; i < n; ++i)
+            for (index_t c = 0; c < nc; ++c)
+            {
+                T sum = y(i,c);
+                for (index_t p = m_diag[i] + 1; p < m_rowStart[i+1]; ++p)
+                    sum -= m_val[p] * z(m_col[p],c);
+                x(i,c) = sum / m_val[m_diag[i]];
+            }
+    }
+}
+
+} // namespace gismo
@@ -0,0 +1,9 @@
+#include <gsSolver/gsIncompleteLUkOp.h>
+#include <gsSolver/gsIncompleteLUkOp.hpp>
+
+namespace gismo
+{
+
+CLASS_TEMPLATE_INST gsIncompleteLUkOp<real_t>;
+
+} // namespace gismo
@@ -16,11 +16,18 @@
 #include <gsCore/gsLinearAlgebra.h>
 #include <gsSolver/gsMatrixOp.h>
 #include <gsIO/gsOptionList.h>
+#include <gsParallel/gsMpi.h>
 
 namespace gismo
 {
 /// @brief Abstract class for iterative solvers.
 ///
+/// If a communicator is set (see setComm), every process holds a
+/// disjoint block of rows of the vectors, and the operator and the
+/// preconditioner act on these blocks (exchanging data as needed, see
+/// gsDistributedMatrixOp). The inner products are then summed over the
+/// processes.
+///
 /// \ingroup Solver
 template<class T=real_t>
 class gsIterativeSolver
@@ -46,7 +53,9 @@ public:
       m_tol(1e-10),
       m_num_iter(-1),
       m_rhs_norm(-1),
-      m_error(-1)
+      m_error(-1),
+      m_num_threads(0),
+      m_distributed(false)
     {
         GISMO_ASSERT(m_mat->rows()     == m_mat->cols(),     "The matrix is not square."                     );
 
@@ -76,7 +85,9 @@ public:
       m_tol(1e-10),
       m_num_iter(-1),
       m_rhs_norm(-1),
-      m_error(-1)
+      m_error(-1),
+      m_num_threads(0),
+      m_distributed(false)
     {
         GISMO_ASSERT(m_mat->rows()     == m_mat->cols(),     "The matrix is not square."                     );
 
@@ -95,6 +106,8 @@ public:
         opt.addInt   ("MaxIterations"    , "Maximum number of iterations", 1000       );
         opt.addReal  ("Tolerance"        , "Tolerance for the error criteria on the "
                                            "relative residual error",      1e-10      );
+        opt.addInt   ("NumThreads"       , "Number of OpenMP threads used by the solver "
+                                           "(0: OpenMP default)",          0          );
         return opt;
     }
 
@@ -103,6 +116,7 @@ public:
     {
         m_max_iters        = opt.askInt   ("MaxIterations"    , m_max_iters        );
         m_tol              = opt.askReal  ("Tolerance"        , m_tol              );
+        m_num_threads      = opt.askInt   ("NumThreads"       , m_num_threads      );
         return *this;
     }
 
@@ -113,6 +127,7 @@ public:
     /// @param[in,out] x        starting value; the solution is stored in here
     void solve( const VectorType& rhs, VectorType& x )
     {
+        threadScope scope(m_num_threads);
         if (initIteration(rhs, x)) return;
 
         while (m_num_iter < m_max_iters)
@@ -133,6 +148,7 @@ public:
     /// @param[out]    error_history    the error history is stored here
     void solveDetailed( const VectorType& rhs, VectorType& x, VectorType& error_history )
     {
+        threadScope scope(m_num_threads);
         if (initIteration(rhs, x))
         {
             error_history.resize(1,1); //VectorType is actually gsMatrix
@@ -179,7 +195,7 @@ public:
 
         m_num_iter = 0;
 
-        m_rhs_norm = rhs.norm();
+        m_rhs_norm = math::sqrt( sumProcs(rhs.squaredNorm()) );
 
         if (0 == m_rhs_norm) // special case of zero rhs
         {
@@ -222,6 +238,26 @@ public:
     /// Set the tolerance for the error criteria on the relative residual error (default: 1e-10)
     void setTolerance(T tol)                                   { m_tol = tol; }
 
+    /// @brief Set the number of OpenMP threads used during solve() (default: 0)
+    ///
+    /// The vector kernels, the sparse matrix-vector products and the
+    /// preconditioners run with this number of threads. Zero keeps the
+    /// current OpenMP setting.
+    void setNumThreads(index_t num_threads)                    { m_num_threads = num_threads; }
+
+    /// The number of OpenMP threads used during solve()
+    index_t numThreads() const                                 { return m_num_threads; }
+
+    /// @brief Sums the inner products over the processes of \a comm
+    ///
+    /// The right-hand side, the iterate and the operator then refer to
+    /// the rows owned by this process only. This is not supported by
+    /// gsMinResQLP, gsBlockConjugateGradient and gsBlockGMRes.
+    void setComm(const gsMpiComm & comm)                       { m_comm = comm; m_distributed = true; }
+
+    /// Returns true if the vectors are distributed over the processes
+    bool isDistributed() const                                 { return m_distributed; }
+
     /// The number of iterations needed to reach the error criteria
     index_t iterations() const                                 { return m_num_iter; }
 
@@ -256,6 +292,27 @@ protected:
     index_t            m_num_iter;        ///< The number of iterations performed
     T                  m_rhs_norm;        ///< The norm of the right-hand-side
     T                  m_error;           ///< The relative error as absolute_error/m_rhs_norm
+    index_t            m_num_threads;     ///< The number of OpenMP threads (0: OpenMP default)
+    gsMpiComm          m_comm;            ///< The communicator, if the vectors are distributed
+    bool               m_distributed;     ///< True if the inner products are summed over m_comm
+
+    /// Sums the local parts of \a len inner products over the processes
+    void sumProcs(T * red, int len) const
+    { if (m_distributed) m_comm.sum(red, len); }
+
+    /// Sums the local part of an inner product over the processes
+    T sumProcs(T red) const
+    { sumProcs(&red, 1); return red; }
+
+private:
+    // Sets the number of OpenMP threads for the life time of the object
+    struct threadScope
+    {
+        explicit threadScope(const index_t num_threads) : m_prev(omp_get_max_threads())
+        { if (num_threads > 0) omp_set_num_threads(num_threads); }
+        ~threadScope() { omp_set_num_threads(m_prev); }
+        const int m_prev;
+    };
 };
 
 /// \brief Print (as string) operator for iterative solvers
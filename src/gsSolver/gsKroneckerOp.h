@@ -23,6 +23,17 @@ namespace gismo
 ///
 /// where \f$ A \otimes B = ( a_{11} B \  a_{12} B \ ... ;  a_{21} B \  a_{22} B \ ... ; ... ) \f$.
 ///
+/// The operators are applied one after the other as mode products to the
+/// input, which is interpreted as a tensor. Factors of type
+/// gsMatrixOp< gsMatrix<T> > (or of its transpose) are multiplied
+/// directly on the tensor, which requires neither transposes nor
+/// temporaries. The other factors are applied to a reordered copy of
+/// the tensor. The slices of the tensor are processed in parallel by
+/// the OpenMP threads. The workspaces are kept between the calls of
+/// apply. For dense factors they only grow, such that repeated
+/// applications do not allocate memory; the input and output of other
+/// factors are reallocated if their size changes.
+///
 /// \ingroup Solver
 template <class T>
 class gsKroneckerOp GISMO_FINAL : public gsLinearOperator<T>
@@ -81,8 +92,25 @@ public:
     /// Apply provided linear operators without the need of creating an object
     static void apply(const std::vector<BasePtr> & ops, const gsMatrix<T> & input, gsMatrix<T> & x);
 
+private:
+    /// Applies the operators, using the given workspaces
+    static void apply(const std::vector<BasePtr> & ops, const gsMatrix<T> & input, gsMatrix<T> & x,
+                      gsMatrix<T> (&work)[4]);
+
+    /// Applies \a op as mode product to the tensor \a src of size
+    /// inner x op.cols() x outer and writes the result (of size inner
+    /// x op.rows() x outer) to \a dst
+    static void modeProduct(const gsLinearOperator<T> & op, const T * src, T * dst,
+                            index_t inner, index_t outer, gsMatrix<T> & in, gsMatrix<T> & out);
+
+    /// Calls op(o) for all slices o < outer, in parallel if the
+    /// amount of work is large enough
+    template <class Op>
+    static void forEachSlice(index_t outer, index_t work, Op op);
+
 private:
     std::vector<BasePtr> m_ops;
+    mutable gsMatrix<T>  m_work[4]; ///< Workspaces of apply
 };
 
 }
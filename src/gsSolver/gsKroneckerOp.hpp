@@ -11,14 +11,136 @@
     Author(s): C. Hofreither, S. Takacs
 */
 
+#include <gsSolver/gsMatrixOp.h>
+#include <gsParallel/gsOpenMP.h>
+
 namespace gismo
 {
 
 /// @cond
 template <typename T>
-void gsKroneckerOp<T>::apply(const std::vector<typename gsLinearOperator<T>::Ptr> & ops, const gsMatrix<T> & input, gsMatrix<T> & x)
+template <class Op>
+void gsKroneckerOp<T>::forEachSlice(const index_t outer, const index_t work, Op op)
+{
+    if (outer < 2 || work < 65536 || omp_get_max_threads() < 2)
+    {
+        for (index_t o = 0; o < outer; ++o)
+            op(o);
+        return;
+    }
+#   pragma omp parallel for schedule(static)
+    for (index_t o = 0; o < outer; ++o)
+        op(o);
+}
+
+template <typename T>
+void gsKroneckerOp<T>::modeProduct(const gsLinearOperator<T> & op, const T * src, T * dst,
+                                   index_t inner, index_t outer, gsMatrix<T> & in, gsMatrix<T> & out)
+{
+    typedef typename gsMatrix<T>::Base                 Dense;
+    typedef gsEigen::Map<const Dense>                  ConstMap;
+    typedef gsEigen::Map<Dense>                        Map;
+    typedef gsEigen::Transpose<Dense>                  DenseTr;
+    typedef gsEigen::Transpose<const Dense>            ConstDenseTr;
+
+    const index_t c = op.cols(), r = op.rows();
+
+    // Dense factors
+    const Dense * A = NULL;
+    bool transposed = false;
+    if (const gsMatrixOp< gsMatrix<T> > * op0 = dynamic_cast<const gsMatrixOp< gsMatrix<T> > *>(&op))
+        A = &op0->matrix();
+    else if (const gsMatrixOp<Dense> * op1 = dynamic_cast<const gsMatrixOp<Dense> *>(&op))
+        A = &op1->matrix();
+    else if (const gsMatrixOp<ConstDenseTr> * op2 = dynamic_cast<const gsMatrixOp<ConstDenseTr> *>(&op))
+    {
+        A = &op2->matrix().nestedExpression();
+        transposed = true;
+    }
+    else if (const gsMatrixOp<DenseTr> * op3 = dynamic_cast<const gsMatrixOp<DenseTr> *>(&op))
+    {
+        A = &op3->matrix().nestedExpression();
+        transposed = true;
+    }
+
+    // Dense factors are multiplied directly on the tensor, unless the
+    // slices are too small for an efficient matrix product
+    if (A && (inner == 1 || inner >= 32))
+    {
+        if (inner == 1)
+        {
+            Map D(dst, r, outer);
+            if (transposed)
+                D.noalias() = A->transpose() * ConstMap(src, c, outer);
+            else
+                D.noalias() = (*A) * ConstMap(src, c, outer);
+        }
+        else
+        {
+            // D_o = S_o * op^T for all slices o
+            forEachSlice(outer, inner * r * c * outer, [&](index_t o)
+            {
+                Map D(dst + o * inner * r, inner, r);
+                ConstMap S(src + o * inner * c, inner, c);
+                if (transposed)
+                    D.noalias() = S * (*A);
+                else
+                    D.noalias() = S * A->transpose();
+            });
+        }
+        return;
+    }
+
+    // Otherwise, the operator is applied to the columns of the
+    // reordered tensor. For dense factors, the workspaces are flat
+    // buffers which keep their capacity for smaller tensors; general
+    // operators get an input of the exact shape
+    if (!A)
+        in.resize(c, inner * outer);
+    else if (in.size() < c * inner * outer)
+        in.resize(c * inner * outer, 1);
+    Map IN(in.data(), c, inner * outer);
+    if (inner == 1)
+        IN = ConstMap(src, c, outer);
+    else
+    {
+        forEachSlice(outer, inner * c * outer, [&](index_t o)
+        { IN.middleCols(o * inner, inner).noalias() = ConstMap(src + o * inner * c, inner, c).transpose(); });
+    }
+
+    if (A)
+    {
+        if (out.size() < r * inner * outer)
+            out.resize(r * inner * outer, 1);
+        Map OUT(out.data(), r, inner * outer);
+        if (transposed)
+            OUT.noalias() = A->transpose() * IN;
+        else
+            OUT.noalias() = (*A) * IN;
+    }
+    else
+    {
+        // The result of a general operator is sized by its apply
+        op.apply(in, out);
+        GISMO_ASSERT (out.rows() == r && out.cols() == inner * outer, "The linear operator returned a matrix with unexpected size.");
+    }
+    ConstMap OUT(out.data(), r, inner * outer);
+
+    if (inner == 1)
+        Map(dst, r, outer) = OUT;
+    else
+    {
+        forEachSlice(outer, inner * r * outer, [&](index_t o)
+        { Map(dst + o * inner * r, inner, r).noalias() = OUT.middleCols(o * inner, inner).transpose(); });
+    }
+}
+
+template <typename T>
+void gsKroneckerOp<T>::apply(const std::vector<typename gsLinearOperator<T>::Ptr> & ops, const gsMatrix<T> & input, gsMatrix<T> & x,
+                             gsMatrix<T> (&work)[4])
 {
     GISMO_ASSERT( !ops.empty(), "Zero-term Kronecker product" );
+    GISMO_ASSERT( &input != &x, "gsKroneckerOp: The input and the output must not be the same object." );
     const index_t nrOps = ops.size();
 
     if (nrOps == 1)        // deal with single-operator case efficiently
@@ -27,65 +149,66 @@ void gsKroneckerOp<T>::apply(const std::vector<typename gsLinearOperator<T>::Ptr
         return;
     }
 
-    //index_t rows = 1; // we don't compute rows as we do not need it
-    index_t sz = 1;
-
+    // The input is a tensor of size cols_{nrOps-1} x ... x cols_0 x n
+    // (column-major); the operators are applied from the last one on.
+    // Before step i, the size is cols_i x ... x cols_0 x n, preceded by
+    // inner = rows_{nrOps-1} * ... * rows_{i+1}.
+    index_t sz = 1, maxSz;
     for (index_t i = 0; i < nrOps; ++i)
-    {
-        //rows *= ops[i]->rows();
         sz *= ops[i]->cols();
-    }
-
     GISMO_ASSERT (sz == input.rows(), "The input matrix has wrong size.");
     const index_t n = input.cols();
 
-    // Note: algorithm relies on col-major matrices
-    gsMatrix<T, Dynamic, Dynamic, ColMajor> q0, q1;
-    gsMatrix<T> temp;
-
-    // size: sz x n
-    q0 = input;
+    maxSz = sz;
+    index_t inner = 1, outer = sz / ops[nrOps-1]->cols();
+    for (index_t i = nrOps - 1; i > 0; --i)
+    {
+        inner *= ops[i]->rows();
+        outer /= ops[i-1]->cols();
+        maxSz = math::max(maxSz, inner * ops[i-1]->cols() * outer);
+    }
+    if (work[0].size() < maxSz * n) work[0].resize(maxSz * n, 1);
+    if (work[1].size() < maxSz * n) work[1].resize(maxSz * n, 1);
 
+    const T * src = input.data();
+    inner = 1;
+    outer = sz / ops[nrOps-1]->cols() * n;
     for (index_t i = nrOps - 1; i >= 0; --i)
     {
-
-        const index_t cols_i = ops[i]->cols();
-        const index_t rows_i = ops[i]->rows();
-        const index_t r_i  = sz / cols_i;
-
-        // Re-order right-hand sides
-        q0.resize(cols_i, n * r_i);
-
-        // Apply operator
-        ops[i]->apply(q0, temp);
-        GISMO_ASSERT (temp.rows() == rows_i && temp.cols() == n * r_i, "The linear operator returned a matrix with unexpected size.");
-
-        // Transpose solution component-wise
-        if (n == 1)
-            q1 = temp.transpose();
-        else
+        T * dst;
+        if (i == 0)
         {
-            q1.resize(r_i, n * rows_i);
-            for (index_t k = 0; k != n; ++k)
-                q1.middleCols(k*rows_i, rows_i) = temp.middleCols(k*r_i, r_i).transpose();
+            x.resize(inner * ops[0]->rows(), n);
+            dst = x.data();
         }
+        else
+            dst = work[i % 2].data();
 
-        q1.swap( q0 ); // move solution as next right-hand side
-        sz = ( sz / cols_i) * rows_i; // update now the dimensionality such that in the end sz = rows
-        //sz % cols_i == 0, since sz *= ops[i]->cols();
-    }
+        modeProduct(*ops[i], src, dst, inner, outer, work[2], work[3]);
 
-    //GISMO_ASSERT (sz == rows, "Internal error."); // see one above
+        src = dst;
+        inner *= ops[i]->rows();
+        if (i > 0)
+            outer /= ops[i-1]->cols();
+    }
+}
 
-    q0.resize(sz, n);
-    x.swap( q0 );
+template <typename T>
+void gsKroneckerOp<T>::apply(const std::vector<typename gsLinearOperator<T>::Ptr> & ops, const gsMatrix<T> & input, gsMatrix<T> & x)
+{
+    gsMatrix<T> work[4];
+    apply(ops, input, x, work);
 }
 /// @endcond
 
 template <typename T>
 void gsKroneckerOp<T>::apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
 {
-    apply(m_ops, input, x);
+    // The workspaces of the object are only used by one thread
+    if (omp_in_parallel())
+        apply(m_ops, input, x);
+    else
+        apply(m_ops, input, x, m_work);
 }
 
 template <typename T>
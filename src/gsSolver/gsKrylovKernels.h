@@ -0,0 +1,412 @@
+/** @file gsKrylovKernels.h
+
+    @brief Multithreaded vector and matrix-vector kernels of the
+    Krylov subspace methods
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsCore/gsLinearAlgebra.h>
+
+namespace gismo
+{
+
+/**
+   \brief Multithreaded kernels on (single column) vectors, used by
+   the iterative solvers
+
+   The vectors are split into contiguous chunks, one per OpenMP thread
+   (at most omp_get_max_threads()), each of which is processed by
+   vectorized Eigen code. Vectors with less than 2*minChunk() entries
+   are processed by the calling thread only. Reductions are summed in
+   a fixed order, therefore the results do not depend on the
+   scheduling of the threads, only on their number.
+
+   Several kernels fuse the update of a vector with a reduction on
+   the result, saving one pass over the memory per iteration of the
+   solvers.
+
+   \ingroup Solver
+*/
+template<class T>
+class gsKrylovKernels
+{
+public:
+    typedef gsMatrix<T> VectorType;
+
+    typedef typename gsMatrix<T>::Ref      BlockRef;
+    typedef typename gsMatrix<T>::constRef constBlockRef;
+
+    /// Minimum number of entries processed by one thread
+    static index_t minChunk() { return 4096; }
+
+    /// Returns \f$ a^T b \f$
+    static T dot(const VectorType & a, const VectorType & b)
+    {
+        GISMO_ASSERT(a.size()==b.size(), "Sizes do not match");
+        return reduce(a.size(), [&](index_t s, index_t l)
+            { return a.col(0).segment(s,l).dot(b.col(0).segment(s,l)); });
+    }
+
+    /// Returns \f$ a^T b \f$ in \a ab and \f$ a^T c \f$ in \a ac,
+    /// reading \a a only once
+    static void dot2(const VectorType & a, const VectorType & b, const VectorType & c,
+                     T & ab, T & ac)
+    {
+        GISMO_ASSERT(a.size()==b.size() && a.size()==c.size(), "Sizes do not match");
+        const index_t n = a.size(), nc = numChunks(n);
+        if (1 == nc)
+        {
+            ab = a.col(0).dot(b.col(0));
+            ac = a.col(0).dot(c.col(0));
+            return;
+        }
+        std::vector<T> part(2 * nc);
+#       pragma omp parallel for schedule(static,1) num_threads(nc)
+        for (index_t k = 0; k < nc; ++k)
+        {
+            const index_t s = chunkStart(n, nc, k), l = chunkStart(n, nc, k + 1) - s;
+            part[2*k  ] = a.col(0).segment(s,l).dot(b.col(0).segment(s,l));
+            part[2*k+1] = a.col(0).segment(s,l).dot(c.col(0).segment(s,l));
+        }
+        ab = ac = 0;
+        for (index_t k = 0; k != nc; ++k)
+        {
+            ab += part[2*k  ];
+            ac += part[2*k+1];
+        }
+    }
+
+    /// \f$ y \leftarrow y + a x \f$
+    static void axpy(const T a, const VectorType & x, VectorType & y)
+    {
+        GISMO_ASSERT(x.size()==y.size(), "Sizes do not match");
+        forEach(x.size(), [&](index_t s, index_t l)
+            { y.col(0).segment(s,l) += a * x.col(0).segment(s,l); });
+    }
+
+    /// \f$ y \leftarrow x + b y \f$
+    static void xpby(const VectorType & x, const T b, VectorType & y)
+    {
+        GISMO_ASSERT(x.size()==y.size(), "Sizes do not match");
+        forEach(x.size(), [&](index_t s, index_t l)
+            { y.col(0).segment(s,l) = x.col(0).segment(s,l) + b * y.col(0).segment(s,l); });
+    }
+
+    /// \f$ y \leftarrow x + b y \f$ followed by \f$ z \leftarrow z + a y \f$
+    static void xpbyAxpy(const VectorType & x, const T b, VectorType & y,
+                         const T a, VectorType & z)
+    {
+        GISMO_ASSERT(x.size()==y.size() && x.size()==z.size(), "Sizes do not match");
+        forEach(x.size(), [&](index_t s, index_t l)
+            {
+                y.col(0).segment(s,l) = x.col(0).segment(s,l) + b * y.col(0).segment(s,l);
+                z.col(0).segment(s,l) += a * y.col(0).segment(s,l);
+            });
+    }
+
+    /// \f$ y \leftarrow y + a x \f$, returns \f$ y^T z \f$ (\a z may
+    /// be \a y)
+    static T axpyDot(const T a, const VectorType & x, VectorType & y, const VectorType & z)
+    {
+        GISMO_ASSERT(x.size()==y.size() && x.size()==z.size(), "Sizes do not match");
+        return reduce(x.size(), [&](index_t s, index_t l)
+            {
+                y.col(0).segment(s,l) += a * x.col(0).segment(s,l);
+                return y.col(0).segment(s,l).dot(z.col(0).segment(s,l));
+            });
+    }
+
+    /// \f$ z \leftarrow a x + b y + c z \f$, returns \f$ z^T z \f$.
+    /// If \a c is zero, \a z is not read, and may be uninitialized.
+    static T axpbypcz(const T a, const VectorType & x, const T b, const VectorType & y,
+                      const T c, VectorType & z)
+    {
+        GISMO_ASSERT(x.size()==y.size(), "Sizes do not match");
+        if (0 == c)
+            z.resize(x.rows(), 1);
+        GISMO_ASSERT(x.size()==z.size(), "Sizes do not match");
+        return reduce(x.size(), [&](index_t s, index_t l)
+            {
+                if (0 == c)
+                    z.col(0).segment(s,l) = a * x.col(0).segment(s,l) + b * y.col(0).segment(s,l);
+                else
+                    z.col(0).segment(s,l) = a * x.col(0).segment(s,l) + b * y.col(0).segment(s,l)
+                                          + c * z.col(0).segment(s,l);
+                return z.col(0).segment(s,l).squaredNorm();
+            });
+    }
+
+    /// \f$ G \leftarrow A^T B \f$ for blocks of vectors \a A and \a B
+    /// (the Gram matrix of the columns), reading both only once
+    static void gram(constBlockRef A, constBlockRef B, gsMatrix<T> & G)
+    {
+        GISMO_ASSERT(A.rows()==B.rows(), "Sizes do not match");
+        reduceMatrix(A.rows(), [&](index_t s, index_t l, gsMatrix<T> & part)
+            { part.noalias() = A.middleRows(s,l).transpose() * B.middleRows(s,l); }, G);
+    }
+
+    /// Returns the squared norms of the columns of \a A in the row
+    /// vector \a nrm
+    static void columnSquaredNorms(constBlockRef A, gsMatrix<T> & nrm)
+    {
+        reduceMatrix(A.rows(), [&](index_t s, index_t l, gsMatrix<T> & part)
+            { part.noalias() = A.middleRows(s,l).colwise().squaredNorm(); }, nrm);
+    }
+
+    /**
+       \brief Orthonormalizes the columns of \a A
+
+       On return \a Q has orthonormal columns and \f$ A \approx Q R \f$.
+       The directions of \a A whose singular values are below \a tol
+       times the largest one are dropped, therefore \a Q might have
+       less columns than \a A (or none, if \a A is zero). The columns
+       are computed from the eigen-decomposition of the Gram matrix
+       (SVQB), which needs a single reduction.
+
+       Returns the number of columns of \a Q.
+     */
+    static index_t orthonormalize(constBlockRef A, gsMatrix<T> & Q, gsMatrix<T> & R,
+                                  const T tol = 1e-8)
+    {
+        gsMatrix<T> G;
+        gram(A, A, G);
+        typename gsMatrix<T>::SelfAdjEigenSolver eig(G);
+        const gsMatrix<T> & lambda = eig.eigenvalues(); // increasing
+        const index_t m = A.cols();
+        index_t first = 0;
+        while (first < m && !(lambda(first) > tol * tol * lambda(m-1)))
+            ++first;
+        const index_t p = m - first;
+
+        const gsMatrix<T> V = eig.eigenvectors().rightCols(p);
+        const gsMatrix<T> sq = lambda.bottomRows(p).cwiseSqrt();
+        R = sq.asDiagonal() * V.transpose();
+        Q.setZero(A.rows(), p);
+        addProduct(A, V * sq.cwiseInverse().asDiagonal(), Q);
+        return p;
+    }
+
+    /// Removes the columns of \a A whose entries in \a drop are true
+    static void removeColumns(gsMatrix<T> & A, const std::vector<bool> & drop)
+    {
+        GISMO_ASSERT(static_cast<index_t>(drop.size())==A.cols(), "Sizes do not match");
+        index_t k = 0;
+        for (index_t j = 0; j != A.cols(); ++j)
+            if (!drop[j])
+            {
+                if (k != j)
+                    A.col(k) = A.col(j);
+                ++k;
+            }
+        A.conservativeResize(gsEigen::NoChange, k);
+    }
+
+    /// \f$ Y \leftarrow Y + X C \f$ for blocks of vectors \a X and \a Y
+    /// and a small matrix \a C
+    static void addProduct(constBlockRef X, const gsMatrix<T> & C, BlockRef Y)
+    {
+        GISMO_ASSERT(X.rows()==Y.rows() && X.cols()==C.rows() && Y.cols()==C.cols(),
+                     "Sizes do not match");
+        forEach(X.rows(), [&](index_t s, index_t l)
+            { Y.middleRows(s,l).noalias() += X.middleRows(s,l) * C; });
+    }
+
+    /// \f$ y \leftarrow A x \f$ for any matrix or expression \a A (the
+    /// product is carried out by Eigen)
+    template<class MatrixType>
+    static void product(const MatrixType & A, const VectorType & x, VectorType & y)
+    { y.noalias() = A * x; }
+
+    /**
+       \brief \f$ y \leftarrow A x \f$ for a sparse matrix \a A
+
+       Eigen multiplies row-major matrices in parallel by itself. The
+       columns of column-major matrices are split into chunks with
+       about the same number of non-zeros, whose products are
+       accumulated in private vectors and summed in parallel.
+     */
+    template<int _Options, typename _Index>
+    static void product(const gsEigen::SparseMatrix<T,_Options,_Index> & A,
+                        const VectorType & x, VectorType & y)
+    {
+        const index_t n = A.cols(), m = A.rows();
+        const index_t nc = (_Options & RowMajor) ? 1 : numChunks(A.nonZeros() / 8);
+        if (1 == nc || !A.isCompressed())
+        {
+            y.noalias() = A * x;
+            return;
+        }
+
+        // Chunks of columns with equal number of non-zeros
+        std::vector<index_t> start(nc + 1);
+        const _Index * outer = A.outerIndexPtr();
+        start[0] = 0;
+        for (index_t k = 1; k != nc; ++k)
+            start[k] = std::upper_bound(outer, outer + n,
+                       static_cast<_Index>(chunkStart(A.nonZeros(), nc, k))) - outer - 1;
+        start[nc] = n;
+
+        gsMatrix<T> part(m, x.cols() * (nc - 1));
+        y.resize(m, x.cols());
+#       pragma omp parallel num_threads(nc)
+        {
+#           pragma omp for schedule(static,1)
+            for (index_t k = 0; k < nc; ++k)
+            {
+                const index_t s = start[k], l = start[k+1] - s;
+                if (0 == k)
+                    y.noalias() = A.middleCols(s,l) * x.middleRows(s,l);
+                else
+                    part.middleCols((k-1) * x.cols(), x.cols()).noalias() =
+                        A.middleCols(s,l) * x.middleRows(s,l);
+            }
+
+            // Sum the partial products, row chunk after row chunk
+#           pragma omp for schedule(static,1)
+            for (index_t k = 0; k < nc; ++k)
+            {
+                const index_t s = chunkStart(m, nc, k), l = chunkStart(m, nc, k + 1) - s;
+                for (index_t j = 1; j != nc; ++j)
+                    y.middleRows(s,l) += part.block(s, (j-1) * x.cols(), l, x.cols());
+            }
+        }
+    }
+
+    /// \f$ y \leftarrow A x \f$ for a gsSparseMatrix \a A (otherwise
+    /// the overload for general matrices would be the better match)
+    template<int _Options, typename _Index>
+    static void product(const gsSparseMatrix<T,_Options,_Index> & A,
+                        const VectorType & x, VectorType & y)
+    { product(static_cast<const gsEigen::SparseMatrix<T,_Options,_Index> &>(A), x, y); }
+
+    /**
+       \brief Sums the contributions of \a n independent tasks, like
+       the subspace corrections of gsAdditiveOp, into \a x
+
+       \a x is set to a zero matrix with \a rows rows and \a cols
+       columns, and task \a i adds its contribution to a buffer \a y
+       of the same size by op(i, y). If \a parallel is false, inside a
+       parallel region or if there is only one task or thread, the
+       tasks are run one after another on \a x. Otherwise, the tasks
+       are scheduled dynamically to the threads, each of which has its
+       own buffer; the buffers are summed in parallel by chunks of rows
+       at the end.
+
+       The tasks run concurrently, so op must not modify shared data,
+       like the workspaces of an operator which is used by several
+       tasks. The order of the summation depends on the scheduling,
+       therefore the result can vary by round-off from run to run.
+     */
+    template<class Op>
+    static void sumTasks(const index_t n, const index_t rows, const index_t cols,
+                         Op op, gsMatrix<T> & x, const bool parallel = true)
+    {
+        x.setZero(rows, cols);
+        const index_t nt = math::min(n, (index_t)omp_get_max_threads());
+        if (!parallel || nt < 2 || omp_in_parallel())
+        {
+            for (index_t i = 0; i < n; ++i)
+                op(i, x);
+            return;
+        }
+
+        std::vector< gsMatrix<T> > part(nt - 1);
+#       pragma omp parallel num_threads(nt)
+        {
+            const index_t t = omp_get_thread_num(), nth = omp_get_num_threads();
+            gsMatrix<T> & y = (0 == t ? x : part[t-1]);
+            if (0 != t)
+                y.setZero(rows, cols);
+
+#           pragma omp for schedule(dynamic,1)
+            for (index_t i = 0; i < n; ++i)
+                op(i, y);
+
+            // Sum the buffers, row chunk after row chunk
+#           pragma omp for schedule(static,1)
+            for (index_t k = 0; k < nth; ++k)
+            {
+                const index_t s = chunkStart(rows, nth, k), l = chunkStart(rows, nth, k + 1) - s;
+                for (index_t j = 1; j != nth; ++j)
+                    x.middleRows(s,l) += part[j-1].middleRows(s,l);
+            }
+        }
+    }
+
+private:
+
+    // Number of chunks of a vector of size n
+    static index_t numChunks(const index_t n)
+    {
+        const index_t nt = omp_get_max_threads();
+        return (nt < 2 || n < 2 * minChunk()) ? 1 : math::min(nt, n / minChunk());
+    }
+
+    // First entry of chunk k out of nc of a vector of size n
+    static index_t chunkStart(const index_t n, const index_t nc, const index_t k)
+    { return (n / nc) * k + math::min(k, n % nc); }
+
+    // Calls op(start,length) on every chunk of a vector of size n
+    template<class Op>
+    static void forEach(const index_t n, Op op)
+    {
+        const index_t nc = numChunks(n);
+        if (1 == nc) { op(0, n); return; }
+#       pragma omp parallel for schedule(static,1) num_threads(nc)
+        for (index_t k = 0; k < nc; ++k)
+        {
+            const index_t s = chunkStart(n, nc, k);
+            op(s, chunkStart(n, nc, k + 1) - s);
+        }
+    }
+
+    // Sums the matrices computed by op(start,length,part) over the
+    // chunks of n rows into res
+    template<class Op>
+    static void reduceMatrix(const index_t n, Op op, gsMatrix<T> & res)
+    {
+        const index_t nc = numChunks(n);
+        if (1 == nc) { op(0, n, res); return; }
+        std::vector< gsMatrix<T> > part(nc);
+#       pragma omp parallel for schedule(static,1) num_threads(nc)
+        for (index_t k = 0; k < nc; ++k)
+        {
+            const index_t s = chunkStart(n, nc, k);
+            op(s, chunkStart(n, nc, k + 1) - s, part[k]);
+        }
+        res.swap(part[0]);
+        for (index_t k = 1; k != nc; ++k)
+            res += part[k];
+    }
+
+    // Sums the values of op(start,length) over the chunks of a vector
+    // of size n
+    template<class Op>
+    static T reduce(const index_t n, Op op)
+    {
+        const index_t nc = numChunks(n);
+        if (1 == nc) return op(0, n);
+        std::vector<T> part(nc);
+#       pragma omp parallel for schedule(static,1) num_threads(nc)
+        for (index_t k = 0; k < nc; ++k)
+        {
+            const index_t s = chunkStart(n, nc, k);
+            part[k] = op(s, chunkStart(n, nc, k + 1) - s);
+        }
+        T res = 0;
+        for (index_t k = 0; k != nc; ++k)
+            res += part[k];
+        return res;
+    }
+};
+
+} // namespace gismo
@@ -14,6 +14,7 @@
 
 #include <gsCore/gsLinearAlgebra.h>
 #include <gsSolver/gsLinearOperator.h>
+#include <gsSolver/gsKrylovKernels.h>
 
 namespace gismo
 {
@@ -71,8 +72,10 @@ public:
     static uPtr make(MatrixPtr mat)
     { return uPtr( new gsMatrixOp(give(mat)) ); }
 
+    /// Applies the matrix; sparse matrices are multiplied in parallel
+    /// (see gsKrylovKernels::product)
     void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
-    { x.noalias() = m_expr * input; }
+    { gsKrylovKernels<T>::product(m_expr, input, x); }
 
     index_t rows() const
     { return m_expr.rows(); }
@@ -101,6 +101,7 @@ private:
     using Base::m_num_iter;
     using Base::m_rhs_norm;
     using Base::m_error;
+    using Base::m_distributed;
 
     gsMatrix<T> m_rhs, r1, r2, r3, resvec, Aresvec,
                 v, xl2, negResidual,
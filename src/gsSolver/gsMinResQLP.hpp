@@ -56,6 +56,7 @@ void MinResQLPSymOrtho(T const a, T const b, T &c, T &s, T &r)
 template<class T>
 bool gsMinResQLP<T>::initIteration( const typename gsMinResQLP<T>::VectorType& rhs, typename gsMinResQLP<T>::VectorType& x )
 {
+    GISMO_ENSURE( !m_distributed, "gsMinResQLP: Distributed vectors (see setComm) are not supported." );
     m_rhs = rhs;
     Base::initIteration(rhs,x);
     index_t n = m_mat->cols();
@@ -32,6 +32,8 @@ public:
 
     typedef typename Base::LinOpPtr LinOpPtr;
 
+    typedef gsKrylovKernels<T> Kernels;
+
     typedef memory::shared_ptr<gsMinimalResidual> Ptr;
     typedef memory::unique_ptr<gsMinimalResidual> uPtr;
 
@@ -93,6 +95,7 @@ private:
     using Base::m_num_iter;
     using Base::m_rhs_norm;
     using Base::m_error;
+    using Base::sumProcs;
 
     gsMatrix<T> negResidual,
                      vPrev, v, vNew,
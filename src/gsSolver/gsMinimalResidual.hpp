@@ -31,7 +31,7 @@ bool gsMinimalResidual<T>::initIteration( const typename gsMinimalResidual<T>::V
     m_mat->apply(x,negResidual);
     negResidual -= rhs;
 
-    m_error = negResidual.norm() / m_rhs_norm;
+    m_error = math::sqrt(sumProcs(negResidual.squaredNorm())) / m_rhs_norm;
     if (m_error < m_tol)
         return true;
 
@@ -39,7 +39,7 @@ bool gsMinimalResidual<T>::initIteration( const typename gsMinimalResidual<T>::V
     m_precond->apply(v, z);
 
     gammaPrev = 1;
-    T ip = z.col(0).dot(v.col(0));
+    T ip = sumProcs(Kernels::dot(z, v));
     GISMO_ASSERT(ip >= T(0), "gsMinimalResidual::initIteration(...), preconditioner not positive semi-definite");
     gamma = math::sqrt(ip);
     gammaNew = 1;
@@ -56,10 +56,13 @@ bool gsMinimalResidual<T>::step( typename gsMinimalResidual<T>::VectorType& x )
     z /= gamma;
     m_mat->apply(z,Az);
 
-    T delta = z.col(0).dot(Az.col(0));
-    vNew = Az - (delta/gamma)*v - (gamma/gammaPrev)*vPrev;
+    T delta = sumProcs(Kernels::dot(z, Az));
+    // vNew = Az - (delta/gamma)*v - (gamma/gammaPrev)*vPrev, computed
+    // in the storage of vPrev, which is not needed any more
+    Kernels::axpbypcz(1, Az, -delta/gamma, v, -gamma/gammaPrev, vPrev);
+    vNew.swap(vPrev);
     m_precond->apply(vNew, zNew);
-    T ip = zNew.col(0).dot(vNew.col(0));
+    T ip = sumProcs(Kernels::dot(zNew, vNew));
     GISMO_ASSERT(ip >= T(0), "gsMinimalResidual::step(...), preconditioner not positive semi-definite");
     gammaNew = math::sqrt(ip);
     const T a0 = c*delta - cPrev*s*gamma;
@@ -68,17 +71,20 @@ bool gsMinimalResidual<T>::step( typename gsMinimalResidual<T>::VectorType& x )
     const T a3 = sPrev*gamma;
     cNew = a0/a1;
     sNew = gammaNew/a1;
-    wNew = (z - a3*wPrev - a2*w)/a1;
+    // wNew = (z - a3*wPrev - a2*w)/a1, likewise for AwNew
+    Kernels::axpbypcz(1/a1, z, -a2/a1, w, -a3/a1, wPrev);
+    wNew.swap(wPrev);
     if (!m_inexact_residual)
-        AwNew = (Az - a3*AwPrev - a2*Aw)/a1;
-    x += cNew*eta*wNew;
-    if (!m_inexact_residual)
-        negResidual += cNew*eta*AwNew;
+    {
+        Kernels::axpbypcz(1/a1, Az, -a2/a1, Aw, -a3/a1, AwPrev);
+        AwNew.swap(AwPrev);
+    }
+    Kernels::axpy(cNew*eta, wNew, x);
 
     if (m_inexact_residual)
         m_error *= math::abs(sNew); // see https://eigen.tuxfamily.org/dox-devel/unsupported/MINRES_8h_source.html
     else
-        m_error = negResidual.norm() / m_rhs_norm;
+        m_error = math::sqrt(sumProcs(Kernels::axpyDot(cNew*eta, AwNew, negResidual, negResidual))) / m_rhs_norm;
 
     eta = -sNew*eta;
 
@@ -0,0 +1,71 @@
+/** @file gsMpiSumOp.h
+
+    @brief Sums the results of an operator over the processes of a communicator
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsSolver/gsLinearOperator.h>
+#include <gsParallel/gsMpi.h>
+
+namespace gismo
+{
+
+/// @brief Sums the results of an operator over the processes of a
+/// communicator
+///
+/// Every process holds the full input and the full result, and the
+/// operator \f$ A_p \f$ of process \f$ p \f$ only represents its local
+/// contribution. The operator represents \f$ \sum_p A_p \f$, where the
+/// sum is realized by one allreduce per application. This is the case
+/// for the IETI Schur complement and the scaled Dirichlet preconditioner
+/// if the subdomains are distributed over the processes.
+///
+/// @ingroup Solver
+template<class T>
+class gsMpiSumOp GISMO_FINAL : public gsLinearOperator<T>
+{
+public:
+    /// Shared pointer for gsMpiSumOp
+    typedef memory::shared_ptr<gsMpiSumOp> Ptr;
+
+    /// Unique pointer for gsMpiSumOp
+    typedef memory::unique_ptr<gsMpiSumOp> uPtr;
+
+    /// Shared pointer for gsLinearOperator
+    typedef typename gsLinearOperator<T>::Ptr BasePtr;
+
+    /// Constructor taking the local operator and the communicator
+    gsMpiSumOp(BasePtr op, const gsMpiComm & comm) : m_op(give(op)), m_comm(comm) {}
+
+    /// Make function returning a smart pointer
+    static uPtr make(BasePtr op, const gsMpiComm & comm)
+    { return uPtr( new gsMpiSumOp(give(op), comm) ); }
+
+    void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
+    {
+        m_op->apply(input, x);
+        m_comm.sum(x.data(), static_cast<int>(x.size()));
+    }
+
+    index_t rows() const { return m_op->rows(); }
+
+    index_t cols() const { return m_op->cols(); }
+
+    /// Returns the local operator
+    const BasePtr & localOp() const { return m_op; }
+
+private:
+    const BasePtr m_op;
+    gsMpiComm m_comm;
+};
+
+} // namespace gismo
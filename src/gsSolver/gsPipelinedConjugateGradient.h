@@ -0,0 +1,107 @@
+/** @file gsPipelinedConjugateGradient.h
+
+    @brief Pipelined conjugate gradient solver
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsSolver/gsIterativeSolver.h>
+#include <gsParallel/gsMpi.h>
+
+namespace gismo
+{
+
+/// @brief The pipelined preconditioned conjugate gradient method.
+///
+/// This is the variant of Ghysels and Vanroose (Parallel Computing 40,
+/// 2014) of the preconditioned conjugate gradient method. The two
+/// reductions of the standard method are merged into one, which is
+/// carried out while the preconditioner and the operator are applied.
+/// Each iteration costs one application of the operator and of the
+/// preconditioner, like gsConjugateGradient, but updates four more
+/// vectors. The recurrences are less stable than those of the standard
+/// method, so the attainable accuracy might be lower.
+///
+/// The residual is checked before the update of the iterate, hence the
+/// error of the last iteration is the one of the returned solution.
+///
+/// If a communicator is set (see setComm), every process holds a
+/// disjoint block of rows of the vectors, and the operator and the
+/// preconditioner act on these blocks (exchanging data as needed). The
+/// reductions are then summed over the processes by a non-blocking
+/// gsMpiComm::isum.
+///
+/// \ingroup Solver
+template<class T = real_t>
+class gsPipelinedConjugateGradient : public gsIterativeSolver<T>
+{
+public:
+    typedef gsIterativeSolver<T> Base;
+
+    typedef gsMatrix<T>  VectorType;
+
+    typedef typename Base::LinOpPtr LinOpPtr;
+
+    typedef gsKrylovKernels<T> Kernels;
+
+    typedef memory::shared_ptr<gsPipelinedConjugateGradient> Ptr;
+    typedef memory::unique_ptr<gsPipelinedConjugateGradient> uPtr;
+
+    /// @brief Constructor using a matrix (operator) and optionally a preconditionner
+    ///
+    /// @param mat     The operator to be solved for, see gsIterativeSolver for details
+    /// @param precond The preconditioner, defaulted to the identity
+    template< typename OperatorType >
+    explicit gsPipelinedConjugateGradient( const OperatorType& mat,
+                                           const LinOpPtr& precond = LinOpPtr() )
+    : Base(mat, precond) {}
+
+    /// @brief Make function using a matrix (operator) and optionally a preconditionner
+    ///
+    /// @param mat     The operator to be solved for, see gsIterativeSolver for details
+    /// @param precond The preconditioner, defaulted to the identity
+    template< typename OperatorType >
+    static uPtr make( const OperatorType& mat, const LinOpPtr& precond = LinOpPtr() )
+    { return uPtr( new gsPipelinedConjugateGradient(mat, precond) ); }
+
+    bool initIteration( const VectorType& rhs, VectorType& x );
+    bool step( VectorType& x );
+    void finalizeIteration( VectorType& x );
+
+    /// Prints the object as a string.
+    std::ostream &print(std::ostream &os) const
+    {
+        os << "gsPipelinedConjugateGradient\n";
+        return os;
+    }
+
+private:
+    using Base::m_mat;
+    using Base::m_precond;
+    using Base::m_max_iters;
+    using Base::m_tol;
+    using Base::m_num_iter;
+    using Base::m_rhs_norm;
+    using Base::m_error;
+    using Base::m_comm;
+    using Base::m_distributed;
+
+    VectorType m_r, m_u, m_w;          // residual, preconditioned residual, A*u
+    VectorType m_m, m_n;               // M^{-1}*w, A*m
+    VectorType m_p, m_s, m_q, m_z;     // search direction, A*p, M^{-1}*s, A*q
+    T m_gamma, m_alpha;
+};
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsPipelinedConjugateGradient.hpp)
+#endif
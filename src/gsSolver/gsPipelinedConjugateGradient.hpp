@@ -0,0 +1,122 @@
+/** @file gsPipelinedConjugateGradient.hpp
+
+    @brief Pipelined conjugate gradient solver
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+namespace gismo
+{
+
+template<class T>
+bool gsPipelinedConjugateGradient<T>::initIteration( const typename gsPipelinedConjugateGradient<T>::VectorType& rhs,
+                                                     typename gsPipelinedConjugateGradient<T>::VectorType& x )
+{
+    // Same as Base::initIteration, but the norms are summed over the processes
+    GISMO_ASSERT( rhs.cols() == 1,
+                  "Iterative solvers only work for single column right-hand side." );
+    GISMO_ASSERT( rhs.rows() == m_mat->rows(),
+                  "The right-hand side does not match the matrix: "
+                  << rhs.rows() <<"!="<< m_mat->rows() );
+
+    m_num_iter = 0;
+
+    if ( 0 == x.size() ) // if no initial solution, start with zeros
+        x.setZero(rhs.rows(), rhs.cols());
+    GISMO_ASSERT( x.cols() == 1 && x.rows() == m_mat->cols(),
+                  "The initial guess does not match the matrix." );
+
+    m_mat->apply(x,m_s);
+    m_r = rhs - m_s;                                                    // initial residual
+
+    T norms[2] = { Kernels::dot(rhs,rhs), Kernels::dot(m_r,m_r) };
+    if (m_distributed)
+        m_comm.sum(norms, 2);
+
+    m_rhs_norm = math::sqrt(norms[0]);
+    if (0 == m_rhs_norm) // special case of zero rhs
+    {
+        x.setZero(rhs.rows(),rhs.cols()); // for sure zero is a solution
+        m_error = 0.;
+        return true; // iteration is finished
+    }
+
+    m_error = math::sqrt(norms[1]) / m_rhs_norm;
+    if (m_error < m_tol)
+        return true;
+
+    m_precond->apply(m_r,m_u);
+    m_mat->apply(m_u,m_w);
+
+    const index_t n = m_mat->cols();
+    m_p.setZero(n,1);
+    m_s.setZero(n,1);
+    m_q.setZero(n,1);
+    m_z.setZero(n,1);
+    m_gamma = m_alpha = 0;
+
+    return false;
+}
+
+template<class T>
+bool gsPipelinedConjugateGradient<T>::step( typename gsPipelinedConjugateGradient<T>::VectorType& x )
+{
+    // The single reduction of the iteration: gamma = (u,r), delta = (u,w)
+    // and the squared norm of the residual
+    T red[3];
+    Kernels::dot2(m_u, m_r, m_w, red[0], red[1]);
+    red[2] = Kernels::dot(m_r, m_r);
+
+    gsMpiRequest req;
+    if (m_distributed)
+        m_comm.isum(red, 3, &req);
+
+    // Overlapped with the reduction
+    m_precond->apply(m_w,m_m);
+    m_mat->apply(m_m,m_n);
+
+    if (m_distributed)
+        req.wait();
+
+    m_error = math::sqrt(red[2]) / m_rhs_norm;
+    if (m_error < m_tol)
+        return true;
+
+    const T gamma_old = m_gamma;
+    m_gamma = red[0];
+    T beta;
+    if (1 == m_num_iter)
+    {
+        beta    = 0;
+        m_alpha = m_gamma / red[1];
+    }
+    else
+    {
+        beta    = m_gamma / gamma_old;
+        m_alpha = m_gamma / (red[1] - beta * m_gamma / m_alpha);
+    }
+
+    Kernels::xpbyAxpy(m_u, beta, m_p,  m_alpha, x  );                 // p = u + beta p, x += alpha p
+    Kernels::xpbyAxpy(m_w, beta, m_s, -m_alpha, m_r);                 // s = w + beta s, r -= alpha s
+    Kernels::xpbyAxpy(m_m, beta, m_q, -m_alpha, m_u);                 // q = m + beta q, u -= alpha q
+    Kernels::xpbyAxpy(m_n, beta, m_z, -m_alpha, m_w);                 // z = n + beta z, w -= alpha z
+
+    return false;
+}
+
+template<class T>
+void gsPipelinedConjugateGradient<T>::finalizeIteration( typename gsPipelinedConjugateGradient<T>::VectorType& )
+{
+    // cleanup temporaries
+    m_r.clear(); m_u.clear(); m_w.clear();
+    m_m.clear(); m_n.clear();
+    m_p.clear(); m_s.clear(); m_q.clear(); m_z.clear();
+}
+
+} // namespace gismo
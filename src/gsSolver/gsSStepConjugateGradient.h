@@ -0,0 +1,135 @@
+/** @file gsSStepConjugateGradient.h
+
+    @brief s-step conjugate gradient solver
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#pragma once
+
+#include <gsSolver/gsIterativeSolver.h>
+#include <gsParallel/gsMpi.h>
+
+namespace gismo
+{
+
+/// @brief The s-step preconditioned conjugate gradient method.
+///
+/// The variant of Chronopoulos and Gear (J. Comput. Appl. Math. 25,
+/// 1989): every step builds the basis
+/// \f$ V = [z, Kz, \dots, K^{s-1}z] \f$, with \f$ K = M^{-1}A \f$
+/// and \f$ z = M^{-1}r \f$, of the next s Krylov directions, makes it
+/// A-conjugate to the previous block of directions and minimizes the
+/// energy norm of the error over it. This is equivalent to s iterations
+/// of gsConjugateGradient in exact arithmetic, but all inner products
+/// of a step are computed as one Gram matrix, i.e. with one reduction
+/// instead of 2s.
+///
+/// The basis is the monomial one, which gets ill-conditioned quickly.
+/// Small values of s (the default is 4) are advisable.
+///
+/// The number of iterations counts the steps, each of which applies
+/// the operator and the preconditioner s times. The residual is checked
+/// at the beginning of a step, from the Gram matrix.
+///
+/// If a communicator is set (see setComm), every process holds a
+/// disjoint block of rows of the vectors, and the Gram matrix is summed
+/// over the processes.
+///
+/// \ingroup Solver
+template<class T = real_t>
+class gsSStepConjugateGradient : public gsIterativeSolver<T>
+{
+public:
+    typedef gsIterativeSolver<T> Base;
+
+    typedef gsMatrix<T>  VectorType;
+
+    typedef typename Base::LinOpPtr LinOpPtr;
+
+    typedef gsKrylovKernels<T> Kernels;
+
+    typedef memory::shared_ptr<gsSStepConjugateGradient> Ptr;
+    typedef memory::unique_ptr<gsSStepConjugateGradient> uPtr;
+
+    /// @brief Constructor using a matrix (operator) and optionally a preconditionner
+    ///
+    /// @param mat     The operator to be solved for, see gsIterativeSolver for details
+    /// @param precond The preconditioner, defaulted to the identity
+    template< typename OperatorType >
+    explicit gsSStepConjugateGradient( const OperatorType& mat,
+                                       const LinOpPtr& precond = LinOpPtr() )
+    : Base(mat, precond), m_s(4) {}
+
+    /// @brief Make function using a matrix (operator) and optionally a preconditionner
+    ///
+    /// @param mat     The operator to be solved for, see gsIterativeSolver for details
+    /// @param precond The preconditioner, defaulted to the identity
+    template< typename OperatorType >
+    static uPtr make( const OperatorType& mat, const LinOpPtr& precond = LinOpPtr() )
+    { return uPtr( new gsSStepConjugateGradient(mat, precond) ); }
+
+    /// @brief Returns a list of default options
+    static gsOptionList defaultOptions()
+    {
+        gsOptionList opt = Base::defaultOptions();
+        opt.addInt("Steps", "Number of directions s computed per step", 4 );
+        return opt;
+    }
+
+    /// @brief Set the options based on a gsOptionList
+    gsSStepConjugateGradient& setOptions(const gsOptionList& opt)
+    {
+        Base::setOptions(opt);
+        m_s = opt.askInt("Steps", m_s);
+        GISMO_ENSURE(m_s > 0, "gsSStepConjugateGradient: the number of steps must be positive.");
+        return *this;
+    }
+
+    /// @brief Set the number of directions s computed per step (default: 4)
+    void setSteps( index_t s )               { GISMO_ENSURE(s > 0, "Invalid number of steps."); m_s = s; }
+
+    bool initIteration( const VectorType& rhs, VectorType& x );
+    bool step( VectorType& x );
+    void finalizeIteration( VectorType& x );
+
+    /// Prints the object as a string.
+    std::ostream &print(std::ostream &os) const
+    {
+        os << "gsSStepConjugateGradient, s=" << m_s << "\n";
+        return os;
+    }
+
+private:
+    using Base::m_mat;
+    using Base::m_precond;
+    using Base::m_max_iters;
+    using Base::m_tol;
+    using Base::m_num_iter;
+    using Base::m_rhs_norm;
+    using Base::m_error;
+    using Base::m_comm;
+    using Base::m_distributed;
+
+    index_t m_s;
+
+    VectorType m_L;            // [V, P, r]: new basis, previous directions, residual
+    VectorType m_R;            // [A*V, r]
+    VectorType m_AP;           // A*P
+    VectorType m_r;            // residual
+    VectorType m_tmp, m_Av;
+    gsMatrix<T> m_W;           // P^T*A*P
+    bool m_first;
+};
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsSStepConjugateGradient.hpp)
+#endif
@@ -0,0 +1,131 @@
+/** @file gsSStepConjugateGradient.hpp
+
+    @brief s-step conjugate gradient solver
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+namespace gismo
+{
+
+template<class T>
+bool gsSStepConjugateGradient<T>::initIteration( const typename gsSStepConjugateGradient<T>::VectorType& rhs,
+                                                 typename gsSStepConjugateGradient<T>::VectorType& x )
+{
+    // Same as Base::initIteration, but the norms are summed over the processes
+    GISMO_ASSERT( rhs.cols() == 1,
+                  "Iterative solvers only work for single column right-hand side." );
+    GISMO_ASSERT( rhs.rows() == m_mat->rows(),
+                  "The right-hand side does not match the matrix: "
+                  << rhs.rows() <<"!="<< m_mat->rows() );
+
+    m_num_iter = 0;
+
+    if ( 0 == x.size() ) // if no initial solution, start with zeros
+        x.setZero(rhs.rows(), rhs.cols());
+    GISMO_ASSERT( x.cols() == 1 && x.rows() == m_mat->cols(),
+                  "The initial guess does not match the matrix." );
+
+    const index_t n = m_mat->cols(), s = m_s;
+    m_L.setZero(n, 2*s+1);
+    m_R.resize(n, s+1);
+    m_AP.resize(n, s);
+    m_first = true;
+
+    m_mat->apply(x,m_tmp);
+    m_r = rhs - m_tmp;                                                  // initial residual
+
+    T norms[2] = { Kernels::dot(rhs,rhs), Kernels::dot(m_r,m_r) };
+    if (m_distributed)
+        m_comm.sum(norms, 2);
+
+    m_rhs_norm = math::sqrt(norms[0]);
+    if (0 == m_rhs_norm) // special case of zero rhs
+    {
+        x.setZero(rhs.rows(),rhs.cols()); // for sure zero is a solution
+        m_error = 0.;
+        return true; // iteration is finished
+    }
+
+    m_error = math::sqrt(norms[1]) / m_rhs_norm;
+    return m_error < m_tol;
+}
+
+template<class T>
+bool gsSStepConjugateGradient<T>::step( typename gsSStepConjugateGradient<T>::VectorType& x )
+{
+    const index_t s = m_s;
+
+    // The basis V = [z, Kz, ..., K^{s-1}z] in the first s columns of
+    // m_L, and A*V in the first s columns of m_R
+    m_L.col(2*s) = m_r;
+    m_R.col(s)   = m_r;
+    m_precond->apply(m_r, m_tmp);
+    for (index_t k = 0; k != s; ++k)
+    {
+        m_L.col(k) = m_tmp;
+        m_mat->apply(m_tmp, m_Av);
+        m_R.col(k) = m_Av;
+        if (k + 1 != s)
+            m_precond->apply(m_Av, m_tmp);
+    }
+
+    // The single reduction of the step:
+    //     [ V^T A V  V^T r ]
+    // G = [ P^T A V  P^T r ]
+    //     [    *     r^T r ]
+    gsMatrix<T> G;
+    Kernels::gram(m_L, m_R, G);
+    if (m_distributed)
+        m_comm.sum(G.data(), static_cast<int>(G.size()));
+
+    m_error = math::sqrt(G(2*s,s)) / m_rhs_norm;
+    if (m_error < m_tol)
+        return true;
+
+    gsMatrix<T> W = G.topLeftCorner(s,s), a = G.block(0,s,s,1);
+    if (m_first)
+    {
+        // P = V, A*P = A*V
+        m_L.middleCols(s,s) = m_L.leftCols(s);
+        m_AP = m_R.leftCols(s);
+        m_first = false;
+    }
+    else
+    {
+        // Make the basis A-conjugate to the previous directions:
+        // P = V - P_prev B, with B = (P_prev^T A P_prev)^{-1} P_prev^T A V
+        const gsMatrix<T> B = m_W.ldlt().solve(G.block(s,0,s,s));
+        W.noalias() -= G.block(s,0,s,s).transpose() * B;
+        a.noalias() -= B.transpose() * G.block(s,s,s,1);
+
+        Kernels::addProduct(m_L.middleCols(s,s), -B, m_L.leftCols(s));
+        Kernels::addProduct(m_AP, -B, m_R.leftCols(s));
+        m_L.middleCols(s,s) = m_L.leftCols(s);
+        m_AP = m_R.leftCols(s);
+    }
+
+    // Minimize over the new directions
+    m_W = (W + W.transpose()) / 2;
+    a = m_W.ldlt().solve(a);
+
+    Kernels::addProduct(m_L.middleCols(s,s), a, x);                    // x += P a
+    Kernels::addProduct(m_AP, -a, m_r);                                // r -= A P a
+    return false;
+}
+
+template<class T>
+void gsSStepConjugateGradient<T>::finalizeIteration( typename gsSStepConjugateGradient<T>::VectorType& )
+{
+    // cleanup temporaries
+    m_L.clear(); m_R.clear(); m_AP.clear(); m_r.clear();
+    m_tmp.clear(); m_Av.clear();
+}
+
+} // namespace gismo
@@ -14,6 +14,7 @@
 
 #include <gsCore/gsLinearAlgebra.h>
 #include <gsSolver/gsPreconditioner.h>
+#include <gsSolver/gsKrylovKernels.h>
 
 namespace gismo
 {
@@ -21,9 +22,17 @@ namespace gismo
 namespace internal
 {
 template<typename T>
-void gaussSeidelSweep(const gsSparseMatrix<T> & A, gsMatrix<T>& x, const gsMatrix<T>& f);
+void gaussSeidelSweep(const typename gsSparseMatrix<T>::Base & A, gsMatrix<T>& x, const gsMatrix<T>& f);
 template<typename T>
-void reverseGaussSeidelSweep(const gsSparseMatrix<T> & A, gsMatrix<T>& x, const gsMatrix<T>& f);
+void reverseGaussSeidelSweep(const typename gsSparseMatrix<T>::Base & A, gsMatrix<T>& x, const gsMatrix<T>& f);
+template<typename T>
+void multiColoring(const typename gsSparseMatrix<T>::Base & A, std::vector<index_t>& order, std::vector<index_t>& colorStart);
+template<typename T>
+void multiColorSweep(const typename gsSparseMatrix<T>::Base & A, gsMatrix<T>& x, const gsMatrix<T>& f,
+                     const std::vector<index_t>& order, const std::vector<index_t>& colorStart,
+                     T omega, bool reverse);
+template<typename T>
+T jacobiSpectralRadius(const typename gsSparseMatrix<T>::Base & A, index_t steps);
 } // namespace internal
 
 /// @brief Richardson preconditioner
@@ -180,9 +189,9 @@ public:
         GISMO_ASSERT( m_expr.rows() == rhs.rows() && m_expr.cols() == m_expr.rows(),
                       "Dimensions do not match.");
 
-        GISMO_ASSERT( rhs.cols() == 1, "This operator is only implemented for a single right-hand side." );
-
-        x.array() += m_tau * ( rhs - m_expr * x ).array() / m_expr.diagonal().array();
+        const gsMatrix<T> res = rhs - m_expr * x;
+        for (index_t c = 0; c < x.cols(); ++c)
+            x.col(c).array() += m_tau * res.col(c).array() / m_expr.diagonal().array();
     }
 
     // We use our own apply implementation as we can save one multiplication. This is important if the number
@@ -192,13 +201,13 @@ public:
         GISMO_ASSERT( m_expr.rows() == input.rows() && m_expr.cols() == m_expr.rows(),
                       "Dimensions do not match.");
 
-        GISMO_ASSERT( input.cols() == 1, "This operator is only implemented for a single right-hand side." );
-
         // For the first sweep, we do not need to multiply with the matrix
-        x.array() = m_tau * input.array() / m_expr.diagonal().array();
+        x.resize(input.rows(), input.cols());
+        for (index_t c = 0; c < x.cols(); ++c)
+            x.col(c).array() = m_tau * input.col(c).array() / m_expr.diagonal().array();
 
         for (index_t k = 1; k < m_num_of_sweeps; ++k)
-            x.array() += m_tau * ( input - m_expr * x ).array() / m_expr.diagonal().array();
+            step(input, x);
     }
 
     index_t rows() const {return m_expr.rows();}
@@ -388,6 +397,295 @@ template <class Derived>
 typename gsGaussSeidelOp<Derived,gsGaussSeidel::symmetric>::uPtr makeSymmetricGaussSeidelOp(const memory::shared_ptr<Derived>& mat)
 { return gsGaussSeidelOp<Derived,gsGaussSeidel::symmetric>::make(mat); }
 
+/// @brief Multicolor Gauss-Seidel and SOR preconditioner
+///
+/// The unknowns are colored such that unknowns of the same color are
+/// not coupled by the matrix (greedy coloring of the graph of the
+/// matrix), and are relaxed color by color. The unknowns of one color
+/// do not depend on each other, therefore they are processed in
+/// parallel by the OpenMP threads. The result differs from the one of
+/// \a gsGaussSeidelOp, since the unknowns are relaxed in another order.
+///
+/// The relaxation parameter (option "Relaxation", default 1) turns
+/// the Gauss-Seidel sweeps into SOR sweeps. If "Symmetric" is set, a
+/// step consists of a forward and a backward sweep over the colors
+/// (SSOR), otherwise \a stepT sweeps the colors in reverse order. As for
+/// \a gsGaussSeidelOp, the matrix is supposed to be symmetric.
+///
+/// \ingroup Solver
+template <typename MatrixType>
+class gsMultiColorGaussSeidelOp GISMO_FINAL : public gsPreconditionerOp<typename MatrixType::Scalar>
+{
+    typedef memory::shared_ptr<MatrixType>          MatrixPtr;
+    typedef typename MatrixType::Nested             NestedMatrix;
+
+public:
+    /// Scalar type
+    typedef typename MatrixType::Scalar T;
+
+    /// Shared pointer for gsMultiColorGaussSeidelOp
+    typedef memory::shared_ptr< gsMultiColorGaussSeidelOp > Ptr;
+
+    /// Unique pointer for gsMultiColorGaussSeidelOp
+    typedef memory::unique_ptr< gsMultiColorGaussSeidelOp > uPtr;
+
+    /// Base class
+    typedef gsPreconditionerOp<T> Base;
+
+    /// Constructor with given matrix
+    explicit gsMultiColorGaussSeidelOp(const MatrixType& mat, T omega = 1, bool symmetric = false)
+    : m_mat(), m_expr(mat.derived()), m_omega(omega), m_symmetric(symmetric)
+    { internal::multiColoring<T>(m_expr, m_order, m_colorStart); }
+
+    /// Constructor with shared pointer to matrix
+    explicit gsMultiColorGaussSeidelOp(const MatrixPtr& mat, T omega = 1, bool symmetric = false)
+    : m_mat(mat), m_expr(m_mat->derived()), m_omega(omega), m_symmetric(symmetric)
+    { internal::multiColoring<T>(m_expr, m_order, m_colorStart); }
+
+    static uPtr make(const MatrixType& mat, T omega = 1, bool symmetric = false)
+    { return memory::make_unique( new gsMultiColorGaussSeidelOp(mat, omega, symmetric) ); }
+
+    static uPtr make(const MatrixPtr& mat, T omega = 1, bool symmetric = false)
+    { return memory::make_unique( new gsMultiColorGaussSeidelOp(mat, omega, symmetric) ); }
+
+    void step(const gsMatrix<T> & rhs, gsMatrix<T> & x) const
+    {
+        internal::multiColorSweep<T>(m_expr, x, rhs, m_order, m_colorStart, m_omega, false);
+        if ( m_symmetric )
+            internal::multiColorSweep<T>(m_expr, x, rhs, m_order, m_colorStart, m_omega, true);
+    }
+
+    void stepT(const gsMatrix<T> & rhs, gsMatrix<T> & x) const
+    {
+        if ( m_symmetric )
+            internal::multiColorSweep<T>(m_expr, x, rhs, m_order, m_colorStart, m_omega, false);
+        internal::multiColorSweep<T>(m_expr, x, rhs, m_order, m_colorStart, m_omega, true);
+    }
+
+    index_t rows() const {return m_expr.rows();}
+    index_t cols() const {return m_expr.cols();}
+
+    /// Number of colors
+    index_t numColors() const { return m_colorStart.size() - 1; }
+
+    /// Set relaxation parameter
+    void setRelaxation(const T omega) { m_omega = omega; }
+
+    /// Get relaxation parameter
+    T relaxation() const              { return m_omega;  }
+
+    /// Get the default options as gsOptionList object
+    static gsOptionList defaultOptions()
+    {
+        gsOptionList opt = Base::defaultOptions();
+        opt.addReal  ( "Relaxation", "Relaxation parameter (1 for Gauss-Seidel, otherwise SOR)", 1 );
+        opt.addSwitch( "Symmetric", "Iff true, a step is a forward and a backward sweep (SSOR)", false );
+        return opt;
+    }
+
+    /// Set options based on a gsOptionList object
+    virtual void setOptions(const gsOptionList & opt)
+    {
+        Base::setOptions(opt);
+        m_omega     = opt.askReal  ( "Relaxation", m_omega     );
+        m_symmetric = opt.askSwitch( "Symmetric",  m_symmetric );
+    }
+
+    /// Returns the matrix
+    NestedMatrix matrix() const { return m_expr; }
+
+    /// Returns a shared pinter to the matrix
+    MatrixPtr    matrixPtr() const {
+        GISMO_ENSURE( m_mat, "A shared pointer is only available if it was provided to gsMultiColorGaussSeidelOp." );
+        return m_mat;
+    }
+
+    typename gsLinearOperator<T>::Ptr underlyingOp() const { return makeMatrixOp(m_mat); }
+
+private:
+    const MatrixPtr      m_mat;        ///< Shared pointer to matrix (if needed)
+    NestedMatrix         m_expr;       ///< Nested Eigen expression
+    T                    m_omega;      ///< Relaxation parameter
+    bool                 m_symmetric;  ///< Forward and backward sweeps
+    std::vector<index_t> m_order;      ///< Unknowns, sorted by color
+    std::vector<index_t> m_colorStart; ///< First entry of each color in m_order
+};
+
+/// @brief Returns a smart pointer to a multicolor Gauss-Seidel operator referring on \a mat
+/// \relates gsMultiColorGaussSeidelOp
+template <class Derived>
+typename gsMultiColorGaussSeidelOp<Derived>::uPtr makeMultiColorGaussSeidelOp(const gsEigen::EigenBase<Derived>& mat, typename Derived::Scalar omega = 1)
+{ return gsMultiColorGaussSeidelOp<Derived>::make(mat.derived(), omega); }
+
+/// @brief Returns a smart pointer to a multicolor Gauss-Seidel operator referring on \a mat
+/// \relates gsMultiColorGaussSeidelOp
+template <class Derived>
+typename gsMultiColorGaussSeidelOp<Derived>::uPtr makeMultiColorGaussSeidelOp(const memory::shared_ptr<Derived>& mat, typename Derived::Scalar omega = 1)
+{ return gsMultiColorGaussSeidelOp<Derived>::make(mat, omega); }
+
+/// @brief Returns a smart pointer to a multicolor SSOR operator referring on \a mat
+/// \relates gsMultiColorGaussSeidelOp
+template <class Derived>
+typename gsMultiColorGaussSeidelOp<Derived>::uPtr makeMultiColorSSOROp(const gsEigen::EigenBase<Derived>& mat, typename Derived::Scalar omega = 1)
+{ return gsMultiColorGaussSeidelOp<Derived>::make(mat.derived(), omega, true); }
+
+/// @brief Returns a smart pointer to a multicolor SSOR operator referring on \a mat
+/// \relates gsMultiColorGaussSeidelOp
+template <class Derived>
+typename gsMultiColorGaussSeidelOp<Derived>::uPtr makeMultiColorSSOROp(const memory::shared_ptr<Derived>& mat, typename Derived::Scalar omega = 1)
+{ return gsMultiColorGaussSeidelOp<Derived>::make(mat, omega, true); }
+
+/// @brief Chebyshev accelerated Jacobi preconditioner
+///
+/// One step applies the Chebyshev iteration of the given degree
+/// (option "Degree", default 3) to the Jacobi preconditioned system
+/// \f$ D^{-1}A \f$, which damps the part of the spectrum in
+/// \f$ [\lambda_{max}/r, \lambda_{max}] \f$, where \f$ r \f$ is the
+/// option "EigenvalueRatio". The largest eigenvalue is estimated by
+/// power iterations in the constructor (and enlarged by 10 percent),
+/// unless it is set by \a setEigenvalueBounds. This is a smoother for
+/// symmetric positive definite matrices which only needs matrix-vector
+/// products, which are multithreaded (see gsKrylovKernels), and no
+/// sequential sweeps. The polynomial is symmetric, so stepT is step.
+///
+/// \ingroup Solver
+template <typename MatrixType>
+class gsChebyshevOp GISMO_FINAL : public gsPreconditionerOp<typename MatrixType::Scalar>
+{
+    typedef memory::shared_ptr<MatrixType>          MatrixPtr;
+    typedef typename MatrixType::Nested             NestedMatrix;
+
+public:
+    /// Scalar type
+    typedef typename MatrixType::Scalar T;
+
+    /// Shared pointer for gsChebyshevOp
+    typedef memory::shared_ptr< gsChebyshevOp > Ptr;
+
+    /// Unique pointer for gsChebyshevOp
+    typedef memory::unique_ptr< gsChebyshevOp > uPtr;
+
+    /// Base class
+    typedef gsPreconditionerOp<T> Base;
+
+    /// Constructor with given matrix
+    explicit gsChebyshevOp(const MatrixType& mat, index_t degree = 3)
+    : m_mat(), m_expr(mat.derived()), m_degree(degree), m_ratio(30)
+    { init(); }
+
+    /// Constructor with shared pointer to matrix
+    explicit gsChebyshevOp(const MatrixPtr& mat, index_t degree = 3)
+    : m_mat(mat), m_expr(m_mat->derived()), m_degree(degree), m_ratio(30)
+    { init(); }
+
+    static uPtr make(const MatrixType& mat, index_t degree = 3)
+    { return memory::make_unique( new gsChebyshevOp(mat, degree) ); }
+
+    static uPtr make(const MatrixPtr& mat, index_t degree = 3)
+    { return memory::make_unique( new gsChebyshevOp(mat, degree) ); }
+
+    void step(const gsMatrix<T> & rhs, gsMatrix<T> & x) const
+    {
+        GISMO_ASSERT( m_expr.rows() == rhs.rows() && m_expr.cols() == m_expr.rows(),
+                      "Dimensions do not match.");
+
+        const T lmin = m_lmax / m_ratio;
+        const T theta = (m_lmax + lmin) / 2, delta = (m_lmax - lmin) / 2;
+        const T sigma = theta / delta;
+        T rho = 1 / sigma, rhoOld;
+
+        gsMatrix<T> r, d;
+        residual(rhs, x, r);
+        d = r / theta;
+        x += d;
+        for (index_t k = 1; k < m_degree; ++k)
+        {
+            rhoOld = rho;
+            rho = 1 / (2 * sigma - rhoOld);
+            residual(rhs, x, r);
+            d = (rho * rhoOld) * d + (2 * rho / delta) * r;
+            x += d;
+        }
+    }
+
+    void stepT(const gsMatrix<T> & rhs, gsMatrix<T> & x) const
+    { step(rhs, x); }
+
+    index_t rows() const {return m_expr.rows();}
+    index_t cols() const {return m_expr.cols();}
+
+    /// @brief Set the upper bound of the spectrum of \f$ D^{-1}A \f$
+    /// and the ratio to the lower end of the damped part
+    void setEigenvalueBounds(const T lmax, const T ratio = 30)
+    { m_lmax = lmax; m_ratio = ratio; }
+
+    /// Get the upper bound of the spectrum of \f$ D^{-1}A \f$
+    T largestEigenvalue() const { return m_lmax; }
+
+    /// Get the default options as gsOptionList object
+    static gsOptionList defaultOptions()
+    {
+        gsOptionList opt = Base::defaultOptions();
+        opt.addInt ( "Degree", "Degree of the Chebyshev polynomial", 3 );
+        opt.addReal( "EigenvalueRatio", "Ratio of the largest eigenvalue and the lower end of the damped interval", 30 );
+        return opt;
+    }
+
+    /// Set options based on a gsOptionList object
+    virtual void setOptions(const gsOptionList & opt)
+    {
+        Base::setOptions(opt);
+        m_degree = opt.askInt ( "Degree", m_degree );
+        m_ratio  = opt.askReal( "EigenvalueRatio", m_ratio );
+    }
+
+    /// Returns the matrix
+    NestedMatrix matrix() const { return m_expr; }
+
+    /// Returns a shared pinter to the matrix
+    MatrixPtr    matrixPtr() const {
+        GISMO_ENSURE( m_mat, "A shared pointer is only available if it was provided to gsChebyshevOp." );
+        return m_mat;
+    }
+
+    typename gsLinearOperator<T>::Ptr underlyingOp() const { return makeMatrixOp(m_mat); }
+
+private:
+    void init()
+    {
+        m_invDiag = m_expr.diagonal().cwiseInverse();
+        m_lmax = (T)(1.1) * internal::jacobiSpectralRadius<T>(m_expr, 20);
+    }
+
+    // r = D^{-1} (f - A x)
+    void residual(const gsMatrix<T> & f, const gsMatrix<T> & x, gsMatrix<T> & r) const
+    {
+        gsKrylovKernels<T>::product(m_expr, x, r);
+        for (index_t c = 0; c < x.cols(); ++c)
+            r.col(c).array() = (f.col(c) - r.col(c)).array() * m_invDiag.array();
+    }
+
+private:
+    const MatrixPtr m_mat;     ///< Shared pointer to matrix (if needed)
+    NestedMatrix    m_expr;    ///< Nested Eigen expression
+    gsVector<T>     m_invDiag; ///< Inverse of the diagonal
+    index_t         m_degree;  ///< Degree of the polynomial
+    T               m_lmax;    ///< Upper bound of the spectrum
+    T               m_ratio;   ///< Ratio of the bounds of the damped interval
+};
+
+/// @brief Returns a smart pointer to a Chebyshev smoother referring on \a mat
+/// \relates gsChebyshevOp
+template <class Derived>
+typename gsChebyshevOp<Derived>::uPtr makeChebyshevOp(const gsEigen::EigenBase<Derived>& mat, index_t degree = 3)
+{ return gsChebyshevOp<Derived>::make(mat.derived(), degree); }
+
+/// @brief Returns a smart pointer to a Chebyshev smoother referring on \a mat
+/// \relates gsChebyshevOp
+template <class Derived>
+typename gsChebyshevOp<Derived>::uPtr makeChebyshevOp(const memory::shared_ptr<Derived>& mat, index_t degree = 3)
+{ return gsChebyshevOp<Derived>::make(mat, degree); }
+
 /// @brief  Incomplete LU with thresholding preconditioner
 ///
 /// \ingroup Solvers
@@ -11,6 +11,8 @@
     Author(s): C. Hofreither
 */
 
+#pragma once
+
 namespace gismo
 {
 
@@ -18,7 +20,7 @@ namespace internal
 {
 
 template<typename T>
-void gaussSeidelSweep(const gsSparseMatrix<T> & A, gsMatrix<T>& x, const gsMatrix<T>& f)
+void gaussSeidelSweep(const typename gsSparseMatrix<T>::Base & A, gsMatrix<T>& x, const gsMatrix<T>& f)
 {
     GISMO_ASSERT( A.rows() == x.rows() && x.rows() == f.rows() && A.cols() == A.rows() && x.cols() == f.cols(),
         "Dimensions do not match.");
@@ -31,7 +33,7 @@ void gaussSeidelSweep(const gsSparseMatrix<T> & A, gsMatrix<T>& x, const gsMatri
         T diag = 0;
         T sum  = 0;
 
-        for (typename gsSparseMatrix<T>::InnerIterator it(A,i); it; ++it)
+        for (typename gsSparseMatrix<T>::Base::InnerIterator it(A,i); it; ++it)
         {
             sum += it.value() * x( it.index() );        // compute A.x
             if (it.index() == i)
@@ -43,7 +45,7 @@ void gaussSeidelSweep(const gsSparseMatrix<T> & A, gsMatrix<T>& x, const gsMatri
 }
 
 template<typename T>
-void reverseGaussSeidelSweep(const gsSparseMatrix<T> & A, gsMatrix<T>& x, const gsMatrix<T>& f)
+void reverseGaussSeidelSweep(const typename gsSparseMatrix<T>::Base & A, gsMatrix<T>& x, const gsMatrix<T>& f)
 {
     GISMO_ASSERT( A.rows() == x.rows() && x.rows() == f.rows() && A.cols() == A.rows() && x.cols() == f.cols(),
         "Dimensions do not match.");
@@ -56,7 +58,7 @@ void reverseGaussSeidelSweep(const gsSparseMatrix<T> & A, gsMatrix<T>& x, const
         T diag = 0;
         T sum = 0;
 
-        for (typename gsSparseMatrix<T>::InnerIterator it(A,i); it; ++it)
+        for (typename gsSparseMatrix<T>::Base::InnerIterator it(A,i); it; ++it)
         {
             sum += it.value() * x( it.index() );        // compute A.x
             if (it.index() == i)
@@ -67,6 +69,108 @@ void reverseGaussSeidelSweep(const gsSparseMatrix<T> & A, gsMatrix<T>& x, const
     }
 }
 
+template<typename T>
+void multiColoring(const typename gsSparseMatrix<T>::Base & A, std::vector<index_t>& order, std::vector<index_t>& colorStart)
+{
+    GISMO_ASSERT( A.cols() == A.rows(), "The matrix must be square." );
+
+    // Greedy coloring: the smallest color of no neighbour
+    // A is supposed to be symmetric, so it doesn't matter if it's stored in row- or column-major order
+    const index_t n = A.outerSize();
+    std::vector<index_t> color(n, -1), mark;
+    index_t numColors = 0;
+    for (index_t i = 0; i < n; ++i)
+    {
+        for (typename gsSparseMatrix<T>::Base::InnerIterator it(A,i); it; ++it)
+            if ( color[it.index()] != -1 )
+                mark[color[it.index()]] = i;
+
+        index_t c = 0;
+        while ( c < numColors && mark[c] == i )
+            ++c;
+        if ( c == numColors )
+        {
+            mark.push_back(-1);
+            ++numColors;
+        }
+        color[i] = c;
+    }
+
+    // Unknowns sorted by color, in increasing order within each color
+    colorStart.assign(numColors + 1, 0);
+    for (index_t i = 0; i < n; ++i)
+        ++colorStart[color[i] + 1];
+    for (index_t c = 0; c < numColors; ++c)
+        colorStart[c + 1] += colorStart[c];
+
+    std::vector<index_t> pos(colorStart.begin(), colorStart.end() - 1);
+    order.resize(n);
+    for (index_t i = 0; i < n; ++i)
+        order[pos[color[i]]++] = i;
+}
+
+template<typename T>
+void multiColorSweep(const typename gsSparseMatrix<T>::Base & A, gsMatrix<T>& x, const gsMatrix<T>& f,
+                     const std::vector<index_t>& order, const std::vector<index_t>& colorStart,
+                     T omega, bool reverse)
+{
+    GISMO_ASSERT( A.rows() == x.rows() && x.rows() == f.rows() && A.cols() == A.rows() && x.cols() == f.cols(),
+        "Dimensions do not match.");
+
+    const index_t numColors = colorStart.size() - 1;
+    for (index_t k = 0; k < numColors; ++k)
+    {
+        const index_t c = reverse ? numColors - 1 - k : k;
+        const index_t s = colorStart[c], e = colorStart[c+1];
+
+        // The unknowns of one color are not coupled
+#       pragma omp parallel for schedule(static) if (e - s > 1024)
+        for (index_t l = s; l < e; ++l)
+        {
+            const index_t i = order[l];
+            T diag = 0;
+            for (typename gsSparseMatrix<T>::Base::InnerIterator it(A,i); it; ++it)
+                if (it.index() == i)
+                {
+                    diag = it.value();
+                    break;
+                }
+
+            for (index_t j = 0; j < x.cols(); ++j)
+            {
+                T sum = 0;
+                for (typename gsSparseMatrix<T>::Base::InnerIterator it(A,i); it; ++it)
+                    sum += it.value() * x( it.index(), j );     // compute A.x
+                x(i,j) += omega * (f(i,j) - sum) / diag;
+            }
+        }
+    }
+}
+
+template<typename T>
+T jacobiSpectralRadius(const typename gsSparseMatrix<T>::Base & A, index_t steps)
+{
+    // Power iterations for D^{-1}A
+    const gsVector<T> invDiag = A.diagonal().cwiseInverse();
+    // Deterministic start vector: the alternating pattern is rich in
+    // the oscillatory modes of the largest eigenvalues
+    gsMatrix<T> x(A.rows(), 1), y;
+    for (index_t i = 0; i < x.rows(); ++i)
+        x(i,0) = (i % 2 ? (T)(-1) : (T)(1));
+    x /= x.norm();
+    T rho = 0;
+    for (index_t k = 0; k < steps; ++k)
+    {
+        gsKrylovKernels<T>::product(A, x, y);
+        y.array() *= invDiag.array();
+        rho = y.norm();
+        if ( rho == (T)(0) )
+            break;
+        x = y / rho;
+    }
+    return rho;
+}
+
 } // namespace internal
 
 } // namespace gismo
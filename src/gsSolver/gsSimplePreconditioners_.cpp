@@ -7,8 +7,13 @@ namespace gismo
 namespace internal
 {
 
-TEMPLATE_INST void gaussSeidelSweep(const gsSparseMatrix<real_t> & A, gsMatrix<real_t>& x, const gsMatrix<real_t>& f);
-TEMPLATE_INST void reverseGaussSeidelSweep(const gsSparseMatrix<real_t> & A, gsMatrix<real_t>& x, const gsMatrix<real_t>& f);
+TEMPLATE_INST void gaussSeidelSweep<real_t>(const gsSparseMatrix<real_t>::Base & A, gsMatrix<real_t>& x, const gsMatrix<real_t>& f);
+TEMPLATE_INST void reverseGaussSeidelSweep<real_t>(const gsSparseMatrix<real_t>::Base & A, gsMatrix<real_t>& x, const gsMatrix<real_t>& f);
+TEMPLATE_INST void multiColoring<real_t>(const gsSparseMatrix<real_t>::Base & A, std::vector<index_t>& order, std::vector<index_t>& colorStart);
+TEMPLATE_INST void multiColorSweep<real_t>(const gsSparseMatrix<real_t>::Base & A, gsMatrix<real_t>& x, const gsMatrix<real_t>& f,
+                                           const std::vector<index_t>& order, const std::vector<index_t>& colorStart,
+                                           real_t omega, bool reverse);
+TEMPLATE_INST real_t jacobiSpectralRadius<real_t>(const gsSparseMatrix<real_t>::Base & A, index_t steps);
 
 } // namespace internal
 
@@ -13,12 +13,18 @@
 #pragma once
 
 #include <gsSolver/gsLinearOperator.h>
+#include <gsSolver/gsKrylovKernels.h>
 
 namespace gismo
 {
 
 /// @brief Class for representing the sum of objects of type \a gsLinearOperator as \a gsLinearOperator
 ///
+/// The operators are applied one after another, or in parallel by the
+/// OpenMP threads if enabled by setParallel (see
+/// gsKrylovKernels::sumTasks). In the latter case, an operator that
+/// keeps workspaces must not be added several times.
+///
 /// @ingroup Solver
 template<typename T>
 class gsSumOp GISMO_FINAL : public gsLinearOperator<T>
@@ -33,11 +39,11 @@ public:
     typedef memory::unique_ptr<gsSumOp> uPtr;
 
     /// Empty constructor. To be filled with addOperator()
-    gsSumOp() : m_ops(0) {}
+    gsSumOp() : m_ops(0), m_parallel(false) {}
 
     /// Constructor taking a vector of Linear Operators
     gsSumOp(std::vector<BasePtr> ops)
-        : m_ops(give(ops))
+        : m_ops(give(ops)), m_parallel(false)
     {
 #ifndef NDEBUG
         const size_t sz = m_ops.size();
@@ -51,7 +57,7 @@ public:
 
     /// Constructor taking two Linear Operators
     gsSumOp(BasePtr op0, BasePtr op1)
-        : m_ops(2)
+        : m_ops(2), m_parallel(false)
     {
         GISMO_ASSERT ( op0->rows() == op1->rows() && op0->cols() == op1->cols(), "Dimensions of the operators do not fit." );
         m_ops[0] = give(op0); m_ops[1] = give(op1);
@@ -59,7 +65,7 @@ public:
 
     /// Constructor taking three Linear Operators
     gsSumOp(BasePtr op0, BasePtr op1, BasePtr op2 )
-        : m_ops(3)
+        : m_ops(3), m_parallel(false)
     {
         GISMO_ASSERT ( op0->rows() == op1->rows() && op0->cols() == op1->cols()
                         && op0->rows() == op2->rows() && op0->cols() == op2->cols(), "Dimensions of the operators do not fit." );
@@ -90,20 +96,23 @@ public:
         m_ops.push_back(give(op));
     }
 
+    /// @brief Apply the operators in parallel by the OpenMP threads
+    ///
+    /// This is disabled by default. The operators must not share
+    /// workspaces then.
+    void setParallel(bool parallel = true) { m_parallel = parallel; }
+
     void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
     {
         GISMO_ASSERT ( !m_ops.empty(), "gsSumOp::apply does not work for 0 operators." );
 
-        // Here, we could make a permanently allocated vector
-        gsMatrix<T> tmp;
-        const size_t sz = m_ops.size();
-
-        m_ops[0]->apply(input,x);
-        for (size_t i=1; i<sz; ++i)
-        {
-            m_ops[i]->apply(input,tmp);
-            x += tmp;
-        }
+        gsKrylovKernels<T>::sumTasks(m_ops.size(), rows(), input.cols(),
+            [&](index_t i, gsMatrix<T> & y)
+            {
+                gsMatrix<T> tmp;
+                m_ops[i]->apply(input,tmp);
+                y += tmp;
+            }, x, m_parallel);
     }
 
     index_t rows() const
@@ -123,6 +132,7 @@ public:
 
 private:
     std::vector<BasePtr> m_ops;
+    bool m_parallel;
 
 };
 
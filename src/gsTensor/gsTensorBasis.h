@@ -280,6 +280,29 @@ private:
                    const gsVector<unsigned, d> & size,
                    gsMatrix<T>& result);
 
+    // Internal function
+    //
+    // Writes the first derivatives (gradients) of the tensor product
+    // basis functions into result, which must be already sized.
+    // values: as in deriv2_tp, with at least first derivatives
+    static void deriv_tp(const std::vector< gsMatrix<T> > values[],
+                         gsMatrix<T>& result);
+
+    // Internal function
+    //
+    // tab[i], i = 0,...,d-1, are univariate tables (one row per
+    // function, one column per point). Writes the products
+    // tab[0](i_0,c)*...*tab[d-1](i_{d-1},c), for all points c and
+    // all tensor indices (i_0 running fastest), into the rows offset,
+    // offset+stride, offset+2*stride, ... of the (already sized)
+    // matrix result. Partial products of the first directions are
+    // shared between the functions, and the points are treated one
+    // after the other, with contiguous memory access for stride 1.
+    static void tensorProduct_into(const gsMatrix<T> * const tab[],
+                                   gsMatrix<T> & result,
+                                   const index_t stride,
+                                   const index_t offset);
+
 public:
     // see gsBasis for doxygen documentation
     // Evaluate the i-th basis function derivative at all columns of
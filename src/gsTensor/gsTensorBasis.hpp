@@ -498,6 +498,64 @@ void gsTensorBasis<d,T>::deriv2Single_into(index_t i,
     }
 }
 
+template<short_t d, class T>
+void gsTensorBasis<d,T>::tensorProduct_into(const gsMatrix<T> * const tab[],
+                                            gsMatrix<T> & result,
+                                            const index_t stride,
+                                            const index_t offset)
+{
+    const index_t np = tab[0]->cols();
+    index_t nw = 1;
+    for (short_t i = 0; i < d-1; ++i)
+        nw *= tab[i]->rows();
+    STACK_ARRAY(T, work, nw);
+
+    for (index_t c = 0; c != np; ++c) // for all points
+    {
+        T * out = result.data() + c * result.rows() + offset;
+
+        // Products of the first d-1 directions, first direction
+        // running fastest; the block of function j of direction k
+        // is written after the current products, last block first,
+        // so that the expansion happens in place
+        index_t m = tab[0]->rows();
+        std::copy(tab[0]->data() + c * m, tab[0]->data() + (c+1) * m, work);
+        for (short_t k = 1; k < d-1; ++k)
+        {
+            const index_t n = tab[k]->rows();
+            const T * tk = tab[k]->data() + c * n;
+            for (index_t j = n-1; j >= 0; --j)
+            {
+                const T s = tk[j];
+                T * w = work + j * m;
+                for (index_t i = 0; i != m; ++i)
+                    w[i] = work[i] * s;
+            }
+            m *= n;
+        }
+
+        // Last direction, written to the result
+        const index_t n = tab[d-1]->rows();
+        const T * tk = tab[d-1]->data() + c * n;
+        if (1==stride)
+            for (index_t j = 0; j != n; ++j)
+            {
+                const T s = tk[j];
+                T * o = out + j * m;
+                for (index_t i = 0; i != m; ++i)
+                    o[i] = work[i] * s;
+            }
+        else
+            for (index_t j = 0; j != n; ++j)
+            {
+                const T s = tk[j];
+                T * o = out + j * m * stride;
+                for (index_t i = 0; i != m; ++i)
+                    o[i*stride] = work[i] * s;
+            }
+    }
+}
+
 template<short_t d, class T>
 void gsTensorBasis<d,T>::eval_into(const gsMatrix<T> & u,
                                          gsMatrix<T>& result) const
@@ -505,35 +563,23 @@ void gsTensorBasis<d,T>::eval_into(const gsMatrix<T> & u,
     GISMO_ASSERT( u.rows() == d, 
                   "Attempted to evaluate the tensor-basis on points with the wrong dimension" );
 
-    /// \todo more efficient ?
-
     gsMatrix<T> ev[d];
-    gsVector<unsigned, d> v, size;
+    const gsMatrix<T> * tab[d];
 
     // Evaluate univariate basis functions
-    unsigned nb = 1;
+    index_t nb = 1;
     for (short_t i = 0; i < d; ++i)
     {
         m_bases[i]->eval_into( u.row(i), ev[i] );
         nb *= ev[i].rows();
-        size[i] = ev[i].rows();
+        tab[i] = ev + i;
     }
-  
-    // initialize result
-    result.resize( nb, u.cols() );
 
-    // iterate over all tensor product basis functions
-    v.setZero();
-    unsigned r = 0;
-    do {
-        // Multiply BSplines to get the value of basis function v
-        result.row( r )=  ev[0].row( v(0) );
-        for ( short_t i=1; i<d; ++i)
-            result.row( r )= result.row( r ).cwiseProduct( ev[i].row( v(i) ) ) ;
-      
-        ++r ;
-    } while (nextLexicographic(v, size));
-};
+    // Multiply univariate values to get the values of the tensor
+    // product basis functions
+    result.resize( nb, u.cols() );
+    tensorProduct_into(tab, result, 1, 0);
+}
 
 template<short_t d, class T>
 void gsTensorBasis<d,T>::eval_into(const gsMatrix<T> & u,
@@ -596,8 +642,6 @@ void gsTensorBasis<d,T>::deriv_into(const gsMatrix<T> & u,
 {
     std::vector<gsMatrix<T> > values[d];
 
-    gsVector<unsigned, d> v, size;
-
     index_t nb = 1;
     for (short_t i = 0; i < d; ++i)
     {
@@ -605,28 +649,11 @@ void gsTensorBasis<d,T>::deriv_into(const gsMatrix<T> & u,
         m_bases[i]->evalAllDers_into( u.row(i), 1, values[i]); 
 
         // number of basis functions
-        const index_t num_i = values[i].front().rows();
-        nb *= num_i;
-        size[i] = num_i;
+        nb *= values[i].front().rows();
     }
 
     result.resize( d*nb, u.cols() );
-
-    v.setZero();
-    unsigned r = 0;
-    do {
-        for ( short_t k=0; k<d; ++k)
-        {
-            // derivative w.r.t. k-th variable
-            const index_t rownum = r*d + k;
-            result.row(rownum)  =  values[k][1].row( v(k) );
-            for ( short_t i=0; i<k; ++i)
-                result.row(rownum).array() *= values[i][0].row( v(i) ).array();
-            for ( short_t i=k+1; i<d; ++i)
-                result.row(rownum).array() *= values[i][0].row( v(i) ).array();
-        }
-        ++r ;
-    } while (nextLexicographic(v, size));
+    deriv_tp(values, result);
 }
 
 
@@ -642,7 +669,7 @@ void gsTensorBasis<d,T>::evalAllDers_into(const gsMatrix<T> & u, int n,
     }
 
     std::vector< gsMatrix<T> >values[d];
-    gsVector<unsigned, d> v, nb_cwise;
+    gsVector<unsigned, d> nb_cwise;
     result.resize(n+1);
 
     unsigned nb = 1;
@@ -657,42 +684,18 @@ void gsTensorBasis<d,T>::evalAllDers_into(const gsMatrix<T> & u, int n,
         nb         *= num_i;
     }
     
-    // iterate over all tensor product basis functions
-    v.setZero();
-    gsMatrix<T> & vals = result[0];
-    vals.resize(nb, u.cols());
-    unsigned r = 0;
-    do // for all basis functions
-    {
-        // Multiply basis functions to get the value of basis function v
-        vals.row( r )=  values[0].front().row( v[0] );
-        for ( short_t i=1; i!=d; ++i) // for all variables
-            vals.row(r).array() *= values[i].front().row( v[i] ).array();
-    
-        ++r;
-    } while (nextLexicographic(v, nb_cwise));
+    // Multiply basis functions to get the values
+    const gsMatrix<T> * tab[d];
+    for ( short_t i=0; i!=d; ++i)
+        tab[i] = &values[i].front();
+    result[0].resize(nb, u.cols());
+    tensorProduct_into(tab, result[0], 1, 0);
   
-    // iterate again and write derivatives
+    // and the derivatives
     if ( n>=1)
     {
-        gsMatrix<T> & der = result[1];
-        der.resize(d*nb, u.cols());;
-        v.setZero();
-        r = 0;
-        do // for all basis functions
-        {
-            for ( short_t k=0; k<d; ++k) // for partial derivatives
-            {
-                // derivative w.r.t. k-th variable // TODO Check this!
-                der.row(r) = values[k][1].row( v(k) );
-                for ( short_t i=0; i<k; ++i)
-                    der.row(r).array() *= values[i][0].row( v(i) ).array();
-                for ( short_t i=k+1; i<d; ++i)
-                    der.row(r).array() *= values[i][0].row( v(i) ).array();
-            ++r;
-            }
-
-        } while (nextLexicographic(v, nb_cwise));
+        result[1].resize(d*nb, u.cols());
+        deriv_tp(values, result[1]);
     }
 
     if (n>1)
@@ -703,25 +706,20 @@ void gsTensorBasis<d,T>::evalAllDers_into(const gsMatrix<T> & u, int n,
         for (int i = 3; i <=n; ++i) // for all orders of derivation
         {
             gsMatrix<T> & der = result[i];
-            der.resize( nb*numCompositions(i,d), u.cols());
-            v.setZero();
-            
-            r = 0;
-            do // for all basis functions
+            const index_t stride = numCompositions(i,d);
+            der.resize( nb*stride, u.cols());
+
+            index_t r = 0;
+            firstComposition(i, d, cc);
+            do // for all partial derivatives of order \a i
             {
-                firstComposition(i, d, cc);
-                do // for all partial derivatives of order \a i
-                {
-                    // cc[k]: order of derivation w.r.t. variable \a k
-                    der.row(r) = values[0][cc[0]].row(v[0]);
-                    for (short_t k = 1; k!=d; ++k) // for all variables
-                        der.row(r).array() *= values[k][cc[k]].row(v[k]).array();
+                // cc[k]: order of derivation w.r.t. variable \a k
+                for (short_t k = 0; k!=d; ++k) // for all variables
+                    tab[k] = &values[k][cc[k]];
+                tensorProduct_into(tab, der, stride, r);
                 ++r;
-                } while (nextComposition(cc));
-            } while (nextLexicographic(v, nb_cwise));
+            } while (nextComposition(cc));
         }
-
-        // n==2: bubble up // <- not needed due to call of deriv2_tp
     }
 
 }
@@ -731,7 +729,7 @@ void gsTensorBasis<d,T>::deriv2_into(const gsMatrix<T> & u,
                                            gsMatrix<T> & result ) const
 {
     std::vector< gsMatrix<T> >values[d];
-    gsVector<unsigned, d> v, nb_cwise;
+    gsVector<unsigned, d> nb_cwise;
 
     for (short_t i = 0; i < d; ++i)
     {
@@ -744,6 +742,19 @@ void gsTensorBasis<d,T>::deriv2_into(const gsMatrix<T> & u,
 }
 
 
+template<short_t d, class T>
+void gsTensorBasis<d,T>::deriv_tp(const std::vector< gsMatrix<T> > values[],
+                                  gsMatrix<T>& result)
+{
+    const gsMatrix<T> * tab[d];
+    for ( short_t k=0; k<d; ++k) // derivative w.r.t. k-th variable
+    {
+        for ( short_t i=0; i<d; ++i)
+            tab[i] = &values[i][i==k ? 1 : 0];
+        tensorProduct_into(tab, result, d, k);
+    }
+}
+
 
 template<short_t d, class T>
 void gsTensorBasis<d,T>::deriv2_tp(const std::vector< gsMatrix<T> > values[],
@@ -755,38 +766,22 @@ void gsTensorBasis<d,T>::deriv2_tp(const std::vector< gsMatrix<T> > values[],
 
     result.resize( stride*nb, values[0][0].cols() );
 
-    gsVector<unsigned, d> v;
-    v.setZero();
-    unsigned r = 0; // r is a local index of a basis function times the stride
-    do
+    const gsMatrix<T> * tab[d];
+    unsigned m = d;
+    for ( short_t k=0; k<d; ++k)// First compute the pure second derivatives
     {
-        unsigned m = d;
-        for ( short_t k=0; k<d; ++k)// First compute the pure second derivatives
+        for ( short_t i=0; i<d; ++i)
+            tab[i] = &values[i][i==k ? 2 : 0];
+        tensorProduct_into(tab, result, stride, k);
+
+        for ( short_t l=k+1; l<d; ++l) // Then all mixed derivatives follow in lex order
         {
-            index_t cur = r + k;
-            result.row(cur) = values[k][2].row( v.at(k) ) ;// pure 2nd derivate w.r.t. k-th var
-            for ( short_t i=0; i<k; ++i)
-                result.row(cur).array() *= values[i][0].row( v.at(i) ).array();
-            for ( short_t i=k+1; i<d; ++i)
-                result.row(cur).array() *= values[i][0].row( v.at(i) ).array();
-
-            for ( short_t l=k+1; l<d; ++l) // Then all mixed derivatives follow in lex order
-            {
-                cur = r + m;
-                result.row(cur).noalias() =
-                    values[k][1].row( v.at(k) ).cwiseProduct( values[l][1].row( v.at(l) ) );
-                for ( short_t i=0; i<k; ++i)
-                    result.row(cur).array() *= values[i][0].row( v.at(i) ).array() ;
-                for ( short_t i=k+1; i<l; ++i)
-                    result.row(cur).array() *= values[i][0].row( v.at(i) ).array();
-                for ( short_t i=l+1; i<d; ++i)
-                    result.row(cur).array() *= values[i][0].row( v.at(i) ).array() ;
-                ++m;
-            }
+            for ( short_t i=0; i<d; ++i)
+                tab[i] = &values[i][i==k || i==l ? 1 : 0];
+            tensorProduct_into(tab, result, stride, m);
+            ++m;
         }
-
-        r+= stride;
-    } while (nextLexicographic(v, nb_cwise));
+    }
 }
 
 
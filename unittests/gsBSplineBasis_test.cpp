@@ -0,0 +1,77 @@
+/** @file gsBSplineBasis_test.cpp
+
+    @brief Tests for the evaluation of B-spline bases
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): agent
+*/
+
+#include "gismo_unittest.h"
+
+SUITE(gsBSplineBasis_test)
+{
+    TEST(evalAllDers_batched)
+    {
+        // Cubic, with a double knot at 0.4 and a triple knot at 0.6
+        const real_t knots[] = {0, 0, 0, 0, 0.2, 0.4, 0.4, 0.6, 0.6, 0.6, 0.8, 1, 1, 1, 1};
+        gsKnotVector<> kv(3, knots, knots + 15);
+        gsBSplineBasis<> basis(kv);
+        const index_t n = 4; // derivatives up to order 4 > degree
+
+        // Runs of points in the same knot span, points on every knot
+        // (also the repeated ones and the end points), and points
+        // jumping between spans
+        gsMatrix<> u(1, 23);
+        u << 0.05, 0.1, 0.15, 0.0, 0.2, 0.4, 0.45, 0.5, 0.55, 0.6,
+             0.3, 1.0, 0.7, 0.6, 0.65, 0.8, 0.9, 0.4, 0.4, 0.1,
+             0.99, 0.25, 0.75;
+
+        std::vector<gsMatrix<> > ders, single;
+        basis.evalAllDers_into(u, n, ders);
+        CHECK_EQUAL( n + 1, static_cast<index_t>(ders.size()) );
+
+        gsMatrix<index_t> act;
+        gsMatrix<> ev;
+        bool eq = true;
+        for (index_t k = 0; k != u.cols(); ++k)
+        {
+            // Point by point
+            basis.evalAllDers_into(u.col(k), n, single);
+            for (index_t i = 0; i <= n; ++i)
+                eq = eq && (ders[i].col(k) - single[i]).norm()
+                    < 1e-12 * (1 + single[i].norm());
+
+            // Function by function, up to the degree (not at the last
+            // knot, where evalDerSingle_into uses the empty span)
+            if ( u(0,k) == kv.last() )
+                continue;
+            basis.active_into(u.col(k), act);
+            for (index_t j = 0; j != act.rows(); ++j)
+                for (index_t i = 0; i <= basis.degree(); ++i)
+                {
+                    basis.evalDerSingle_into(act(j,0), u.col(k), i, ev);
+                    eq = eq && math::abs(ders[i](j,k) - ev(0,0))
+                        < 1e-10 * (1 + math::abs(ev(0,0)));
+                }
+        }
+        CHECK( eq );
+
+        // Values and first two derivatives match eval_into,
+        // deriv_into and deriv2_into
+        basis.eval_into(u, ev);
+        CHECK( (ders[0] - ev).norm() < 1e-12 * ev.norm() );
+        basis.deriv_into(u, ev);
+        CHECK( (ders[1] - ev).norm() < 1e-12 * ev.norm() );
+        basis.deriv2_into(u, ev);
+        CHECK( (ders[2] - ev).norm() < 1e-12 * ev.norm() );
+
+        // Partition of unity, and derivatives above the degree vanish
+        CHECK( (ders[0].colwise().sum().array() - 1).abs().maxCoeff() < 1e-12 );
+        CHECK( ders[4].norm() < 1e-12 );
+    }
+}
@@ -0,0 +1,254 @@
+/** @file gsDistributedSparseMatrix_test.cpp
+
+    @brief Tests for the row-distributed sparse matrices and the
+    distributed Krylov solvers.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#include "gismo_unittest.h"
+
+namespace {
+
+// Mass plus stiffness matrix on a 2x2 patch grid, and the glued mapper
+void multiPatchSystem(gsSparseMatrix<> & mat, gsMatrix<> & rhs, gsDofMapper & mapper)
+{
+    gsMultiPatch<> mp = gsNurbsCreator<>::BSplineSquareGrid(2, 2, 1.0);
+    gsMultiBasis<> mb(mp);
+    mb.uniformRefine();
+    mb.uniformRefine();
+
+    gsExprAssembler<> A(1,1);
+    A.setIntegrationElements(mb);
+    gsExprAssembler<>::geometryMap G = A.getMap(mp);
+    gsExprAssembler<>::space u = A.getSpace(mb);
+    gsBoundaryConditions<> bc;
+    u.setup(bc, dirichlet::homogeneous, 0);
+    A.initSystem();
+    A.assemble( (igrad(u,G)*igrad(u,G).tr() + u*u.tr()) * meas(G), u * meas(G) );
+
+    mat    = A.matrix();
+    rhs    = A.rhs();
+    mapper = u.mapper();
+}
+
+}
+
+SUITE(gsDistributedSparseMatrix_test)
+{
+    TEST(DofMapper_test)
+    {
+        gsMpiComm comm = gsMpi::init().worldComm();
+        gsSparseMatrix<> mat;
+        gsMatrix<> rhs;
+        gsDofMapper mapper;
+        multiPatchSystem(mat, rhs, mapper);
+
+        std::vector<index_t> patchRank(4);
+        for (index_t k = 0; k < 4; ++k)
+            patchRank[k] = (k * comm.size()) / 4;
+        gsDistributedDofMapper dm(mapper, patchRank, comm);
+
+        index_t owned = dm.ownedSize();
+        CHECK_EQUAL( mapper.freeSize(), comm.sum(owned) );
+        for (index_t gl = 0; gl < dm.globalSize(); ++gl)
+            CHECK_EQUAL( gl, dm.fromSerial(dm.toSerial(gl)) );
+
+        gsMatrix<> x, y;
+        dm.restrict(rhs, x);
+        dm.gather(x, y);
+        CHECK( (y - rhs).norm() == 0 );
+    }
+
+    TEST(Multiply_test)
+    {
+        gsMpiComm comm = gsMpi::init().worldComm();
+        const index_t np = comm.size(), me = comm.rank();
+        gsSparseMatrix<> mat;
+        gsMatrix<> rhs;
+        gsDofMapper mapper;
+        multiPatchSystem(mat, rhs, mapper);
+
+        std::vector<index_t> patchRank(4);
+        for (index_t k = 0; k < 4; ++k)
+            patchRank[k] = k % np;
+        gsDistributedDofMapper dm(mapper, patchRank, comm);
+
+        // Every process contributes some of the entries, in any row
+        const index_t n = dm.globalSize();
+        gsSparseEntries<> se;
+        for (index_t j = 0; j < mat.outerSize(); ++j)
+            for (gsSparseMatrix<>::InnerIterator it(mat, j); it; ++it)
+                if ((it.row() + it.col()) % np == me)
+                    se.add(dm.fromSerial(it.row()), dm.fromSerial(it.col()), it.value());
+        gsSparseMatrix<> contributions(n, n);
+        contributions.setFrom(se);
+        gsDistributedSparseMatrix<> A(contributions, dm.offsets(), comm);
+        CHECK_EQUAL( dm.ownedSize(), A.rows() );
+
+        gsMatrix<> x = gsMatrix<>::Random(n, 2);
+        comm.broadcast(x.data(), static_cast<int>(x.size()), 0);
+        gsMatrix<> xo, yo, y;
+        dm.restrict(x, xo);
+        A.multiply(xo, yo);
+        dm.gather(yo, y);
+        CHECK( (y - mat * x).norm() < 1e-12 * x.norm() );
+    }
+
+    TEST(HaloModes_test)
+    {
+        gsMpiComm comm = gsMpi::init().worldComm();
+        const index_t np = comm.size();
+        gsSparseMatrix<> mat;
+        gsMatrix<> rhs;
+        gsDofMapper mapper;
+        multiPatchSystem(mat, rhs, mapper);
+
+        std::vector<index_t> patchRank(4);
+        for (index_t k = 0; k < 4; ++k)
+            patchRank[k] = k % np;
+        gsDistributedDofMapper dm(mapper, patchRank, comm);
+
+        const index_t n = dm.globalSize();
+        gsSparseEntries<> se;
+        if (0 == comm.rank())
+            for (index_t j = 0; j < mat.outerSize(); ++j)
+                for (gsSparseMatrix<>::InnerIterator it(mat, j); it; ++it)
+                    se.add(dm.fromSerial(it.row()), dm.fromSerial(it.col()), it.value());
+        gsSparseMatrix<> contributions(n, n);
+        contributions.setFrom(se);
+        gsDistributedSparseMatrix<> A(contributions, dm.offsets(), comm);
+        CHECK_EQUAL( gsHaloExchange::persistent, A.halo().getMode() );
+
+        gsMatrix<> x = gsMatrix<>::Random(n, 3);
+        comm.broadcast(x.data(), static_cast<int>(x.size()), 0);
+        gsMatrix<> xo, yo, y, y0 = mat * x;
+        dm.restrict(x, xo);
+
+        const gsHaloExchange::mode modes[] =
+            { gsHaloExchange::pointToPoint, gsHaloExchange::persistent, gsHaloExchange::neighborhood };
+        for (index_t m = 0; m < 3; ++m)
+        {
+            A.setHaloMode(modes[m]);
+            for (index_t r = 0; r < 2; ++r) // repeated, for the persistent requests
+            {
+                A.multiply(xo, yo);
+                dm.gather(yo, y);
+                CHECK( (y - y0).norm() < 1e-12 * x.norm() );
+            }
+        }
+
+        // Copies use their own requests
+        gsDistributedSparseMatrix<> B(A);
+        B.setHaloMode(gsHaloExchange::persistent);
+        B.multiply(xo, yo);
+        dm.gather(yo, y);
+        CHECK( (y - y0).norm() < 1e-12 * x.norm() );
+    }
+
+    TEST(GraphComm_test)
+    {
+        gsMpiComm comm = gsMpi::init().worldComm();
+        const index_t np = comm.size(), me = comm.rank();
+        gsMultiPatch<> mp = gsNurbsCreator<>::BSplineSquareGrid(2, 2, 1.0);
+
+        std::vector<index_t> patchRank(4);
+        for (index_t k = 0; k < 4; ++k)
+            patchRank[k] = k % np;
+
+        // The neighbors from the interfaces of the patches
+        std::vector<int> expected;
+        const std::vector<boundaryInterface> & ifaces = mp.topology().interfaces();
+        for (size_t i = 0; i != ifaces.size(); ++i)
+        {
+            const index_t p1 = patchRank[ifaces[i].first().patch];
+            const index_t p2 = patchRank[ifaces[i].second().patch];
+            if (p1 == me && p2 != me) expected.push_back(static_cast<int>(p2));
+            if (p2 == me && p1 != me) expected.push_back(static_cast<int>(p1));
+        }
+        std::sort(expected.begin(), expected.end());
+        expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+
+        gsMpiComm graph = comm.graph(mp.topology(), patchRank);
+        std::vector<int> sources, destinations;
+        graph.neighbors(sources, destinations);
+        CHECK( sources == expected );
+        CHECK( destinations == expected );
+
+        // Every process receives the ranks of its neighbors
+        int mine = static_cast<int>(me);
+        std::vector<int> send(sources.size(), mine), recv(sources.size(), -1), ranks(sources.size(), -1);
+        graph.neighborAllgather(&mine, 1, recv.data());
+        graph.neighborAlltoall(send.data(), ranks.data(), 1);
+        CHECK( recv == expected );
+        CHECK( ranks == expected );
+        graph.free();
+    }
+
+    TEST(DistributedSolvers_test)
+    {
+        gsMpiComm comm = gsMpi::init().worldComm();
+        const index_t np = comm.size(), me = comm.rank();
+        gsSparseMatrix<> mat;
+        gsMatrix<> rhs;
+        gsDofMapper mapper;
+        multiPatchSystem(mat, rhs, mapper);
+
+        std::vector<index_t> patchRank(4);
+        for (index_t k = 0; k < 4; ++k)
+            patchRank[k] = (k * np) / 4;
+        gsDistributedDofMapper dm(mapper, patchRank, comm);
+
+        // Process 0 contributes the whole matrix, the others nothing
+        const index_t n = dm.globalSize();
+        gsSparseEntries<> se;
+        gsMatrix<> f = gsMatrix<>::Zero(n, 1);
+        if (0 == me)
+        {
+            for (index_t j = 0; j < mat.outerSize(); ++j)
+                for (gsSparseMatrix<>::InnerIterator it(mat, j); it; ++it)
+                    se.add(dm.fromSerial(it.row()), dm.fromSerial(it.col()), it.value());
+            for (index_t i = 0; i < n; ++i)
+                f(dm.fromSerial(i), 0) = rhs(i, 0);
+        }
+        gsSparseMatrix<> contributions(n, n);
+        contributions.setFrom(se);
+        gsDistributedSparseMatrix<> A(contributions, dm.offsets(), comm);
+        gsMatrix<> b;
+        dm.accumulate(f, b);
+
+        gsDistributedMatrixOp<>::Ptr op = gsDistributedMatrixOp<>::make(A);
+        gsLinearOperator<>::Ptr prec = makeJacobiOp(A.diagonalBlock());
+        const real_t tol = 1e-10;
+
+        gsConjugateGradient<> cg(op, prec);
+        gsGMRes<> gmres(op, prec);
+        gsBiCgStab<> bicgstab(op, prec);
+        gsMinimalResidual<> minres(op, prec);
+        gsGradientMethod<> gradient(op, prec);
+        gradient.setMaxIterations(10000);
+        gsIterativeSolver<> * solvers[] = { &cg, &gmres, &bicgstab, &minres, &gradient };
+        for (index_t s = 0; s < 5; ++s)
+        {
+            solvers[s]->setComm(comm);
+            solvers[s]->setTolerance(tol);
+            gsMatrix<> x, xs;
+            x.setZero(b.rows(), 1);
+            solvers[s]->solve(b, x);
+            dm.gather(x, xs);
+            CHECK( (mat * xs - rhs).norm() <= 10 * tol * rhs.norm() );
+        }
+
+        // Solvers which do not sum their inner products refuse to run
+        gsMinResQLP<> qlp(op, prec);
+        qlp.setComm(comm);
+        gsMatrix<> x;
+        CHECK_THROW( qlp.solve(b, x), std::runtime_error );
+    }
+}
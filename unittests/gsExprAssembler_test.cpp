@@ -96,4 +96,271 @@ SUITE(gsExprAssembler_test)
         //
         CHECK(math::abs(ev.integral(el.area(G))-2*EIGEN_PI/32) < 1e-10);
     }
+
+    TEST(ThreadLocalAccumulation)
+    {
+        gsMultiPatch<> mp = gsNurbsCreator<>::BSplineSquareGrid(2,2,0.5);
+        gsMultiBasis<> mb(mp);
+        mb.setDegree(2);
+        mb.uniformRefine();
+
+        gsFunctionExpr<> ff("x*y", 2);
+        gsBoundaryConditions<> bc;
+        for (gsMultiPatch<>::const_biterator bit = mp.bBegin(); bit != mp.bEnd(); ++bit)
+            bc.addCondition(*bit, condition_type::dirichlet, &ff);
+        bc.setGeoMap(mp);
+
+        gsExprAssembler<> A(1,1);
+        A.setIntegrationElements(mb);
+        gsExprAssembler<>::geometryMap G = A.getMap(mp);
+        gsExprAssembler<>::space u = A.getSpace(mb);
+        auto f = A.getCoeff(ff, G);
+        u.setup(bc, dirichlet::interpolation, 0);
+
+        A.options().setInt("accumulation", accumulation::critical);
+        A.initSystem();
+        A.assemble( igrad(u, G) * igrad(u, G).tr() * meas(G), u * f * meas(G) );
+        gsSparseMatrix<> K = A.matrix();
+        gsMatrix<> rhs = A.rhs();
+
+        A.options().setInt("accumulation", accumulation::threadLocal);
+        A.initSystem();
+        A.assemble( igrad(u, G) * igrad(u, G).tr() * meas(G), u * f * meas(G) );
+
+        CHECK( (K - A.matrix()).norm() < 1e-12 * K.norm() );
+        CHECK( (rhs - A.rhs()).norm() < 1e-12 * rhs.norm() );
+    }
+
+    TEST(ExactSparsityPattern)
+    {
+        gsMultiPatch<> mp = gsNurbsCreator<>::BSplineSquareGrid(2,2,0.5);
+        gsMultiBasis<> mb(mp);
+        mb.setDegree(2);
+        mb.uniformRefine();
+
+        gsFunctionExpr<> ff("x*y", 2);
+        gsBoundaryConditions<> bc;
+        for (gsMultiPatch<>::const_biterator bit = mp.bBegin(); bit != mp.bEnd(); ++bit)
+            bc.addCondition(*bit, condition_type::dirichlet, &ff);
+        bc.setGeoMap(mp);
+
+        gsExprAssembler<> A(1,1);
+        A.setIntegrationElements(mb);
+        gsExprAssembler<>::geometryMap G = A.getMap(mp);
+        gsExprAssembler<>::space u = A.getSpace(mb);
+        auto f = A.getCoeff(ff, G);
+        u.setup(bc, dirichlet::interpolation, 0);
+
+        A.initSystem();
+        A.assemble( igrad(u, G) * igrad(u, G).tr() * meas(G), u * f * meas(G) );
+        gsSparseMatrix<> K = A.matrix();
+        gsMatrix<> rhs = A.rhs();
+
+        A.options().setSwitch("exactPattern", true);
+        A.initSystem();
+        CHECK( A.hasPattern() );
+        const index_t nz = A.matrix().nonZeros();
+        CHECK( K.nonZeros() <= nz );
+
+        // Repeated assembly reuses the pattern
+        for (index_t k = 0; k != 2; ++k)
+        {
+            A.clearMatrix();
+            A.clearRhs();
+            A.assemble( igrad(u, G) * igrad(u, G).tr() * meas(G), u * f * meas(G) );
+            CHECK_EQUAL( nz, A.matrix().nonZeros() );
+            CHECK( (K - A.matrix()).norm() < 1e-12 * K.norm() );
+            CHECK( (rhs - A.rhs()).norm() < 1e-12 * rhs.norm() );
+        }
+    }
+
+    TEST(ColoredAssembly)
+    {
+        gsMultiPatch<> mp = gsNurbsCreator<>::BSplineSquareGrid(2,2,0.5);
+        gsMultiBasis<> mb(mp);
+        mb.setDegree(2);
+        mb.uniformRefine();
+        mb.uniformRefine();
+
+        gsFunctionExpr<> ff("x*y", 2);
+        gsBoundaryConditions<> bc;
+        for (gsMultiPatch<>::const_biterator bit = mp.bBegin(); bit != mp.bEnd(); ++bit)
+            bc.addCondition(*bit, condition_type::dirichlet, &ff);
+        bc.setGeoMap(mp);
+
+        gsExprAssembler<> A(1,1);
+        A.setIntegrationElements(mb);
+        gsExprAssembler<>::geometryMap G = A.getMap(mp);
+        gsExprAssembler<>::space u = A.getSpace(mb);
+        auto f = A.getCoeff(ff, G);
+        u.setup(bc, dirichlet::interpolation, 0);
+
+        A.initSystem();
+        A.assemble( igrad(u, G) * igrad(u, G).tr() * meas(G), u * f * meas(G) );
+        gsSparseMatrix<> K = A.matrix();
+        gsMatrix<> rhs = A.rhs();
+
+        A.options().setInt("accumulation", accumulation::colored);
+        A.initSystem();
+        A.assemble( igrad(u, G) * igrad(u, G).tr() * meas(G), u * f * meas(G) );
+        CHECK( A.hasPattern() );
+        CHECK( (K - A.matrix()).norm() < 1e-12 * K.norm() );
+        CHECK( (rhs - A.rhs()).norm() < 1e-12 * rhs.norm() );
+    }
+
+    TEST(MatrixFreeOperator)
+    {
+        gsMultiPatch<> mp = gsNurbsCreator<>::BSplineSquareGrid(2,2,0.5);
+        for (size_t p = 0; p != mp.nPatches(); ++p) // not affine
+            mp.patch(p).coefs().col(1).array() += 0.2 * mp.patch(p).coefs().col(0).array().square();
+        gsMultiBasis<> mb(mp);
+        mb.setDegree(2);
+        mb.uniformRefine();
+
+        gsFunctionExpr<> ff("x*y", 2);
+        gsBoundaryConditions<> bc;
+        for (gsMultiPatch<>::const_biterator bit = mp.bBegin(); bit != mp.bEnd(); ++bit)
+            bc.addCondition(*bit, condition_type::dirichlet, &ff);
+        bc.setGeoMap(mp);
+
+        gsExprAssembler<> A(1,1);
+        A.setIntegrationElements(mb);
+        gsExprAssembler<>::geometryMap G = A.getMap(mp);
+        gsExprAssembler<>::space u = A.getSpace(mb);
+        u.setup(bc, dirichlet::interpolation, 0);
+
+        A.initSystem();
+        A.assemble( igrad(u, G) * igrad(u, G).tr() * meas(G) + u * u.tr() * meas(G) );
+        const gsSparseMatrix<> K = A.matrix();
+
+        gsMatrix<> x(A.numDofs(), 2), y;
+        for (index_t i = 0; i != x.rows(); ++i)
+        {
+            x(i,0) = math::sin( (real_t)(i) );
+            x(i,1) = (real_t)(i % 7) - 3;
+        }
+        const gsMatrix<> yRef = K * x;
+
+        gsLinearOperator<>::Ptr op =
+            A.getMatrixFreeOp( igrad(u, G) * igrad(u, G).tr() * meas(G) + u * u.tr() * meas(G) );
+        CHECK_EQUAL( K.rows(), op->rows() );
+        CHECK_EQUAL( K.cols(), op->cols() );
+        op->apply(x, y);
+        CHECK( (y - yRef).norm() < 1e-12 * yRef.norm() );
+
+        // With cached geometry data: the first application fills the cache
+        gsLinearOperator<>::Ptr opCached =
+            A.getMatrixFreeOp( igrad(u, G) * igrad(u, G).tr() * meas(G) + u * u.tr() * meas(G), true );
+        for (index_t k = 0; k != 2; ++k)
+        {
+            opCached->apply(x, y);
+            CHECK( (y - yRef).norm() < 1e-12 * yRef.norm() );
+        }
+
+        gsMatrix<> diag;
+        A.getMatrixFreeOp( igrad(u, G) * igrad(u, G).tr() * meas(G) + u * u.tr() * meas(G) )
+            ->diagonal_into(diag);
+        CHECK( (diag - K.diagonal()).norm() < 1e-12 * diag.norm() );
+    }
+
+    TEST(BasisTableCache)
+    {
+        gsMultiPatch<> mp = gsNurbsCreator<>::BSplineSquareGrid(2,1,0.5);
+        gsMultiBasis<> mb(mp);
+        mb.setDegree(3);
+        mb.uniformRefine();
+        mb.uniformRefine();
+        mp.patch(1).coefs().col(1).array() *= 1.5; // not a translate
+
+        gsFunctionExpr<> ff("x*y", 2);
+        gsBoundaryConditions<> bc;
+        for (gsMultiPatch<>::const_biterator bit = mp.bBegin(); bit != mp.bEnd(); ++bit)
+            bc.addCondition(*bit, condition_type::neumann, &ff);
+        bc.setGeoMap(mp);
+
+        gsExprAssembler<> A(1,1);
+        A.setIntegrationElements(mb);
+        gsExprAssembler<>::geometryMap G = A.getMap(mp);
+        gsExprAssembler<>::space u = A.getSpace(mb);
+        auto f = A.getCoeff(ff, G);
+        u.setup(0);
+
+        A.initSystem();
+        A.assemble( igrad(u, G) * igrad(u, G).tr() * meas(G) + u * u.tr() * meas(G),
+                    u * f * meas(G) );
+        A.assembleBdr( bc.get("Neumann"), u * f * nv(G).norm() );
+        gsSparseMatrix<> K = A.matrix();
+        gsMatrix<> rhs = A.rhs();
+
+        A.options().setSwitch("cacheBasisTables", true);
+        A.initSystem();
+        A.assemble( igrad(u, G) * igrad(u, G).tr() * meas(G) + u * u.tr() * meas(G),
+                    u * f * meas(G) );
+        A.assembleBdr( bc.get("Neumann"), u * f * nv(G).norm() );
+        CHECK( (K - A.matrix()).norm() < 1e-12 * K.norm() );
+        CHECK( (rhs - A.rhs()).norm() < 1e-12 * rhs.norm() );
+
+        // Interior elements of a uniform knot vector share their tables
+        gsKnotVector<> kv(0, 1, 7, 3);
+        gsTensorBSplineBasis<2> basis(kv, kv);
+        gsGaussRule<> rule(basis, 1.0, 1);
+        gsMatrix<> nodes;
+        gsVector<> weights;
+        gsFuncData<> fd(NEED_DERIV | NEED_ACTIVE | SAME_ELEMENT), ref(fd.flags);
+        gsBasisTableCache<real_t> cache;
+        bool eq = true;
+        for (gsBasis<>::domainIter it = basis.makeDomainIterator(); it->good(); it->next())
+        {
+            rule.mapTo(it->lowerCorner(), it->upperCorner(), nodes, weights);
+            CHECK( cache.compute(basis, nodes, fd) );
+            basis.compute(nodes, ref);
+            eq = eq && (fd.values[0] - ref.values[0]).norm() < 1e-12
+                && (fd.values[1] - ref.values[1]).norm() < 1e-10
+                && fd.actives == ref.actives;
+        }
+        CHECK( eq );
+        CHECK_EQUAL( 64u, cache.hits() + cache.misses() );
+        CHECK_EQUAL( 25u, cache.misses() ); // 5 element classes per direction
+    }
+
+    TEST(ElementColoring)
+    {
+        // 1D mesh with 4 elements and quadratic basis: element e
+        // touches the DoFs e, e+1, e+2
+        gsElementColoring<real_t> ec;
+        std::vector<index_t> dofs(3);
+        for (index_t e = 0; e != 4; ++e)
+        {
+            for (index_t i = 0; i != 3; ++i)
+                dofs[i] = e + i;
+            ec.add(0, dofs);
+        }
+        ec.finalize();
+        CHECK_EQUAL(3, ec.numColors());
+        CHECK_EQUAL(2, ec.numElements(0));
+        CHECK_EQUAL(0, ec.element(ec.chunks(0).front().begin));
+        CHECK_EQUAL(3, ec.element(ec.chunks(0).back().end - 1));
+    }
+
+    TEST(ElementScheduler)
+    {
+        // Many small patches and one large patch
+        gsElementScheduler<real_t> sched;
+        for (index_t p = 0; p != 10; ++p)
+            sched.addDomain(4, 1.0);
+        sched.addDomain(400, 2.0);
+        sched.finalize(4);
+
+        // Every element is covered exactly once
+        std::vector<index_t> count(sched.offset(sched.numDomains()), 0);
+        for (index_t k = 0; k != sched.size(); ++k)
+            for (index_t e = sched[k].begin; e != sched[k].end; ++e)
+                ++count[sched.offset(sched[k].domain) + e];
+        CHECK( std::count(count.begin(), count.end(), 1) ==
+               static_cast<std::ptrdiff_t>(count.size()) );
+
+        // The large patch is split, and its items come first
+        CHECK( sched.size() > 11 );
+        CHECK_EQUAL(10, sched[0].domain);
+    }
 }
@@ -126,6 +126,58 @@ SUITE(gsIterativeSolvers_test)
         CHECK( (mat*x-rhs).norm()/rhs.norm() <= tol );
     }
 
+    TEST(PipelinedCG_Jacobi_test)
+    {
+        index_t          N = 100;
+        real_t           tol = std::pow(10.0, - REAL_DIG * 0.5);
+
+        gsSparseMatrix<> mat;
+        gsMatrix<>       rhs;
+        gsMatrix<>       x;
+
+        poissonDiscretization(mat, rhs, N);
+
+        gsOptionList opt = gsPipelinedConjugateGradient<>::defaultOptions();
+        opt.setInt ("MaxIterations", 2*N);
+        opt.setReal("Tolerance"    , tol);
+
+        gsLinearOperator<>::Ptr precon = makeJacobiOp(mat);
+        gsPipelinedConjugateGradient<> solver(mat,precon);
+        solver.setOptions(opt);
+
+        x.setZero(N,1);
+        solver.solve(rhs, x);
+
+        CHECK( (mat*x-rhs).norm()/rhs.norm() <= 10*tol );
+    }
+
+    TEST(SStepCG_Jacobi_test)
+    {
+        index_t          N = 100;
+        real_t           tol = std::pow(10.0, - REAL_DIG * 0.5);
+
+        gsSparseMatrix<> mat;
+        gsMatrix<>       rhs;
+        gsMatrix<>       x;
+
+        poissonDiscretization(mat, rhs, N);
+
+        gsOptionList opt = gsSStepConjugateGradient<>::defaultOptions();
+        opt.setInt ("MaxIterations", N  );
+        opt.setReal("Tolerance"    , tol);
+        opt.setInt ("Steps"        , 3  );
+
+        gsLinearOperator<>::Ptr precon = makeJacobiOp(mat);
+        gsSStepConjugateGradient<> solver(mat,precon);
+        solver.setOptions(opt);
+
+        x.setZero(N,1);
+        solver.solve(rhs, x);
+
+        CHECK( (mat*x-rhs).norm()/rhs.norm() <= tol );
+        CHECK( solver.iterations() < N/2 );
+    }
+
     TEST(MinRes_test)
     {
         index_t          N = 100;
@@ -352,4 +404,151 @@ SUITE(gsIterativeSolvers_test)
         CHECK( (mat*x-rhs).norm()/rhs.norm() <= tol );
     }
 
+
+    TEST(BlockCG_Jacobi_test)
+    {
+        index_t          N = 100;
+        real_t           tol = std::pow(10.0, - REAL_DIG * 0.5);
+
+        gsSparseMatrix<> mat;
+        gsMatrix<>       rhs;
+        gsMatrix<>       x;
+
+        poissonDiscretization(mat, rhs, N);
+
+        // Several right-hand sides, among them a zero and a dependent one
+        gsMatrix<> B(N,5);
+        B.col(0) = rhs;
+        B.col(1).setRandom();
+        B.col(2).setZero();
+        B.col(3) = 2 * B.col(1);
+        B.col(4).setRandom();
+
+        gsOptionList opt = gsBlockConjugateGradient<>::defaultOptions();
+        opt.setInt ("MaxIterations", N  );
+        opt.setReal("Tolerance"    , tol);
+
+        gsLinearOperator<>::Ptr precon = makeJacobiOp(mat);
+        gsBlockConjugateGradient<> solver(mat,precon);
+        solver.setOptions(opt);
+
+        solver.solve(B, x);
+
+        CHECK( x.col(2).isZero() );
+        for (index_t j = 0; j != 5; ++j)
+            CHECK( (mat*x.col(j)-B.col(j)).norm() <= tol * B.col(j).norm() );
+    }
+
+    TEST(BlockGMRes_test)
+    {
+        index_t          N = 100;
+        real_t           tol = std::pow(10.0, - REAL_DIG * 0.5);
+
+        // A non-symmetric, diagonally dominant matrix
+        gsSparseMatrix<> mat(N,N);
+        gsMatrix<>       x;
+        mat.reservePerColumn( 3 );
+        for (index_t k = 0; k < N; ++k)
+        {
+            mat(k,k) = 3;
+            if (k > 0)   mat(k,k-1) = -1.2;
+            if (k < N-1) mat(k,k+1) = -0.8;
+        }
+        mat.makeCompressed();
+
+        // Several right-hand sides, among them a dependent one
+        gsMatrix<> B(N,4);
+        B.setRandom();
+        B.col(2) = B.col(0) + B.col(1);
+
+        gsOptionList opt = gsBlockGMRes<>::defaultOptions();
+        opt.setInt ("MaxIterations", N  );
+        opt.setReal("Tolerance"    , tol);
+        opt.setInt ("Restart"      , 10 );
+
+        gsBlockGMRes<> solver(mat);
+        solver.setOptions(opt);
+
+        solver.solve(B, x);
+
+        for (index_t j = 0; j != 4; ++j)
+            CHECK( (mat*x.col(j)-B.col(j)).norm() <= tol * B.col(j).norm() );
+    }
+
+    TEST(Krylov_threads_test)
+    {
+        // Large enough to split the vectors into several chunks
+        index_t          N = 4 * gsKrylovKernels<real_t>::minChunk();
+        real_t           tol = std::pow(10.0, - REAL_DIG * 0.5);
+
+        gsSparseMatrix<> mat;
+        gsMatrix<>       rhs;
+        gsMatrix<>       x, y;
+
+        poissonDiscretization(mat, rhs, N);
+
+        x.setRandom(N,1);
+        makeMatrixOp(mat)->apply(x, y);
+        CHECK( (mat*x-y).norm() <= tol * y.norm() );
+
+        gsOptionList opt = gsMinimalResidual<>::defaultOptions();
+        opt.setInt ("MaxIterations", 100);
+        opt.setReal("Tolerance"    , tol);
+        opt.setInt ("NumThreads"   , 2  );
+
+        gsLinearOperator<>::Ptr precon = makeJacobiOp(mat);
+        gsIterativeSolver<>::Ptr solvers[4] = {
+            gsIterativeSolver<>::Ptr(new gsConjugateGradient<>(mat, precon)),
+            gsIterativeSolver<>::Ptr(new gsGMRes<>(mat, precon)),
+            gsIterativeSolver<>::Ptr(new gsBiCgStab<>(mat, precon)),
+            gsIterativeSolver<>::Ptr(new gsMinimalResidual<>(mat, precon)) };
+
+        // Compare the threaded runs with the serial ones
+        for (index_t s = 0; s != 4; ++s)
+        {
+            opt.setInt("NumThreads", 1);
+            solvers[s]->setOptions(opt);
+            x.setZero(N,1);
+            solvers[s]->solve(rhs, x);
+            const index_t it = solvers[s]->iterations();
+
+            opt.setInt("NumThreads", 2);
+            solvers[s]->setOptions(opt);
+            y.setZero(N,1);
+            solvers[s]->solve(rhs, y);
+
+            CHECK( math::abs(solvers[s]->iterations() - it) <= 1 );
+            CHECK( (x-y).norm() <= 1e-6 * (x.norm() + 1) );
+        }
+    }
+
+    TEST(MixedPrecision_test)
+    {
+        gsSparseMatrix<> mat;
+        gsMatrix<>       rhs, x;
+
+        // For N = 10000, the condition number is too large for plain
+        // refinement with a single precision factorization, and the
+        // solver switches to GMRES
+        for (index_t N = 1000; N <= 10000; N *= 10)
+        {
+            poissonDiscretization(mat, rhs, N);
+            rhs.conservativeResize(N,2);
+            rhs.col(1).setOnes();
+
+            gsSparseSolver<>::MixedPrecisionLU lu(mat);
+            x = lu.solve(rhs);
+            CHECK( lu.succeed() );
+            CHECK( lu.error() <= lu.tolerance() );
+
+            gsSparseSolver<>::MixedPrecisionLDLT ldlt(mat);
+            x = ldlt.solve(rhs);
+            CHECK( ldlt.succeed() );
+
+            // The residual is comparable to the one of a direct solver
+            const real_t bwd = (rhs-mat*x).cwiseAbs().maxCoeff() / ( 4 * x.cwiseAbs().maxCoeff() + rhs.cwiseAbs().maxCoeff() );
+            CHECK( bwd <= ldlt.tolerance() );
+        }
+    }
+
 }
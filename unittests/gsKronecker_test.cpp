@@ -61,6 +61,36 @@ SUITE(gsKronecker_test)
         CHECK_EQUAL ( y, KP * x );
     }
 
+    TEST(gsKroneckerOp_mixed)
+    {
+        // Rectangular factors of all kinds: dense, transposed dense,
+        // sparse and general operators
+        gsMatrix<> D(2,4), E(4,2);
+        D.setRandom();
+        E.setRandom();
+        gsSparseMatrix<> sB = B.sparseView();
+
+        std::vector< gsLinearOperator<>::Ptr > ops;
+        ops.push_back( makeMatrixOp(D) );
+        ops.push_back( gsScaledOp<>::make(makeMatrixOp(A), 2) );
+        ops.push_back( makeMatrixOp(E.transpose()) );
+        ops.push_back( makeMatrixOp(sB) );
+        gsKroneckerOp<> kron(ops);
+        const gsMatrix<> K = D.kron(2*A).kron(E.transpose()).kron(B);
+        CHECK_EQUAL ( K.rows(), kron.rows() );
+        CHECK_EQUAL ( K.cols(), kron.cols() );
+
+        gsMatrix<> x, y;
+        x.setRandom(K.cols(), 3);
+        kron.apply(x, y);
+        CHECK ( (y - K * x).norm() < 1e-10 * y.norm() );
+
+        // A second application reuses the workspaces
+        x.setRandom(K.cols(), 1);
+        kron.apply(x, y);
+        CHECK ( (y - K * x).norm() < 1e-10 * y.norm() );
+    }
+
     TEST(DenseKronecker)
     {        
         gsMatrix<> C = A.kron(B);
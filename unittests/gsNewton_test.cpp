@@ -14,10 +14,87 @@
 //#define TEST_INFO
 
 #include "gismo_unittest.h"
+#include <gsPde/gsNewtonIterator.h>
+
+namespace {
+
+// A linear Poisson problem posed as a nonlinear one: the residual at
+// u is f - K u. The first system is scaled by two, so that the second
+// iteration has to refactorize the matrix to find the solution
+class gsScaledPoissonAssembler : public gsPoissonAssembler<real_t>
+{
+public:
+    gsScaledPoissonAssembler(const gsMultiPatch<> & patches,
+                             const gsMultiBasis<> & bases,
+                             const gsBoundaryConditions<> & bc,
+                             const gsFunction<> & f)
+    : gsPoissonAssembler<real_t>(patches, bases, bc, f)
+    { }
+
+    void assemble()
+    {
+        gsPoissonAssembler<real_t>::assemble();
+        m_system.matrix() *= 2;
+    }
+
+    void assemble(const gsMultiPatch<real_t> & curSolution)
+    {
+        gsPoissonAssembler<real_t>::assemble();
+
+        const gsDofMapper & mapper = m_system.colMapper(0);
+        gsMatrix<> x(m_system.matrix().cols(), 1);
+        index_t idx;
+        for (size_t p = 0; p < curSolution.nPatches(); ++p)
+            for (index_t i = 0; i < curSolution.patch(p).coefsSize(); ++i)
+                if ( mapper.is_free(i, p) )
+                {
+                    m_system.mapToGlobalColIndex(i, p, idx, 0);
+                    x(idx, 0) = curSolution.patch(p).coef(i, 0);
+                }
+        m_system.rhs() -= m_system.matrix() * x;
+    }
+};
+
+}
 
 SUITE(gsNewton_test)
 {
 
+    TEST(Refactorization_test)
+    {
+        gsMultiPatch<> patches = gsNurbsCreator<>::BSplineSquareGrid(2, 1, 0.5);
+        gsMultiBasis<> bases(patches);
+        bases.setDegree(2);
+        bases.uniformRefine();
+
+        gsFunctionExpr<> f("2*pi^2*sin(pi*x)*sin(pi*y)", 2);
+        gsFunctionExpr<> g("0", 2);
+        gsBoundaryConditions<> bc;
+        for (gsMultiPatch<>::const_biterator bit = patches.bBegin(); bit != patches.bEnd(); ++bit)
+            bc.addCondition(*bit, condition_type::dirichlet, &g);
+
+        // Reference solution by a direct solve
+        gsPoissonAssembler<real_t> reference(patches, bases, bc, f);
+        reference.assemble();
+        gsSparseSolver<>::LU solver;
+        const gsMatrix<> x = solver.compute( reference.matrix() ).solve( reference.rhs() );
+        gsMultiPatch<> exact;
+        reference.constructSolution(x, exact);
+
+        gsScaledPoissonAssembler A(patches, bases, bc, f);
+        A.options().setSwitch("exactPattern", true);
+        gsNewtonIterator<real_t> newton(A);
+        newton.setTolerance(1e-10);
+        newton.solve();
+
+        CHECK( A.system().hasPattern() );
+        CHECK( newton.converged() );
+        CHECK( newton.numIterations() <= 3 );
+        for (size_t p = 0; p < exact.nPatches(); ++p)
+            CHECK( (exact.patch(p).coefs() - newton.solution().patch(p).coefs()).norm()
+                   < 1e-10 * x.norm() );
+    }
+
     TEST(test) // Declares test
     {
         UNITTEST_TIME_CONSTRAINT(1000);// this will produce failure if test takes more than 1 sec
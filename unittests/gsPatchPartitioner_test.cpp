@@ -0,0 +1,128 @@
+/** @file gsPatchPartitioner_test.cpp
+
+    @brief Tests for the weighted partitioning of the patches of a
+    multi-patch domain.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+*/
+
+#include "gismo_unittest.h"
+
+namespace {
+
+// A 4x4 patch grid, where the patches of the first column are refined
+gsMultiBasis<> refinedGrid()
+{
+    gsMultiPatch<> mp = gsNurbsCreator<>::BSplineSquareGrid(4, 4, 1.0);
+    gsMultiBasis<> mb(mp);
+    mb.uniformRefine();
+    for (index_t k = 0; k < 4; ++k)
+        mb.basis(k).uniformRefine();
+    return mb;
+}
+
+// Every part has at least one patch
+bool allPartsUsed(const std::vector<index_t> & part, index_t nParts)
+{
+    for (index_t p = 0; p < nParts; ++p)
+        if (gsPatchPartitioner::patchesOf(part, p).empty())
+            return false;
+    return true;
+}
+
+}
+
+SUITE(gsPatchPartitioner_test)
+{
+    TEST(PatchCost_test)
+    {
+        gsTensorBSplineBasis<2> b(gsKnotVector<>(0, 1, 3, 3), gsKnotVector<>(0, 1, 1, 2));
+        // 4x2 elements, (3*2)^3 per element
+        CHECK_EQUAL( 8 * 216, gsPatchPartitioner::patchCost(b) );
+    }
+
+    TEST(UniformGrid_test)
+    {
+        gsMultiPatch<> mp = gsNurbsCreator<>::BSplineSquareGrid(4, 4, 1.0);
+        gsMultiBasis<> mb(mp);
+        gsPatchPartitioner pp(mb);
+        CHECK_EQUAL( 16, pp.nPatches() );
+
+        for (index_t nParts = 1; nParts <= 16; nParts *= 2)
+        {
+            const std::vector<index_t> ml = pp.partition(nParts);
+            CHECK( allPartsUsed(ml, nParts) );
+            CHECK_CLOSE( 1, pp.imbalance(ml, nParts), 1e-12 );
+
+            const std::vector<index_t> gr = pp.partition(nParts, gsPatchPartitioner::greedy);
+            CHECK( allPartsUsed(gr, nParts) );
+            CHECK_CLOSE( 1, pp.imbalance(gr, nParts), 1e-12 );
+
+            // The multilevel method keeps neighboring patches together
+            CHECK( pp.edgeCut(ml) <= pp.edgeCut(gr) );
+        }
+
+        // Four blocks of 2x2 patches
+        const std::vector<index_t> part = pp.partition(4);
+        CHECK_EQUAL( 8 * 2, pp.edgeCut(part) );
+    }
+
+    TEST(RefinedGrid_test)
+    {
+        gsMultiBasis<> mb = refinedGrid();
+        gsPatchPartitioner pp(mb);
+        const std::vector<real_t> & cost = pp.costs();
+        CHECK_CLOSE( 4 * cost[15], cost[0], 1e-12 );
+
+        // Contiguous ranges of patches are not balanced
+        std::vector<index_t> ranges(16);
+        for (index_t k = 0; k < 16; ++k)
+            ranges[k] = k / 4;
+        CHECK( pp.imbalance(ranges, 4) > 2 );
+
+        const std::vector<index_t> gr = pp.partition(4, gsPatchPartitioner::greedy);
+        CHECK_CLOSE( 1, pp.imbalance(gr, 4), 1e-12 );
+
+        pp.setTolerance(0.1);
+        const std::vector<index_t> ml = pp.partition(4);
+        CHECK( allPartsUsed(ml, 4) );
+        CHECK( pp.imbalance(ml, 4) <= 1.1 + 1e-12 );
+        CHECK( pp.edgeCut(ml) <= pp.edgeCut(gr) );
+
+        // Same result on every call (and every process)
+        CHECK( ml == pp.partition(4) );
+    }
+
+    TEST(GivenCosts_test)
+    {
+        gsMultiPatch<> mp = gsNurbsCreator<>::BSplineSquareGrid(1, 5, 1.0);
+        std::vector<real_t> cost(5, 1);
+        cost[2] = 3;
+        gsPatchPartitioner pp(mp.topology(), cost);
+
+        // A chain of patches with costs 1,1,3,1,1: the best partition
+        // has the heaviest patch alone
+        const std::vector<index_t> part = pp.partition(3);
+        CHECK( allPartsUsed(part, 3) );
+        CHECK_EQUAL( 1, gsPatchPartitioner::patchesOf(part, part[2]).size() );
+        CHECK_CLOSE( 9.0 / 7.0, pp.imbalance(part, 3), 1e-12 );
+        CHECK_EQUAL( 2, pp.edgeCut(part) );
+
+        // No part is left empty, although the heaviest patch alone
+        // exceeds the average load
+        const std::vector<index_t> four = pp.partition(4);
+        CHECK( allPartsUsed(four, 4) );
+        CHECK( allPartsUsed(pp.partition(4, gsPatchPartitioner::greedy), 4) );
+
+        // More parts than patches
+        const std::vector<index_t> one = pp.partition(7);
+        for (index_t k = 0; k < 5; ++k)
+            CHECK_EQUAL( k, one[k] );
+    }
+}
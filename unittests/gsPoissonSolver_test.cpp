@@ -150,6 +150,78 @@ void runPoissonSolverTest( dirichlet::strategy Dstrategy, iFace::strategy Istrat
 SUITE(gsPoissonSolver_test)
 {
 
+    TEST(ExactPattern_test)
+    {
+        gsMultiPatch<> patches = gsNurbsCreator<>::BSplineSquareGrid(2, 2, 0.5);
+        gsMultiBasis<> bases(patches);
+        bases.setDegree(2);
+        bases.uniformRefine();
+
+        gsFunctionExpr<> f("((pi*1)^2 + (pi*2)^2)*sin(pi*x*1)*sin(pi*y*2)",2);
+        gsFunctionExpr<> g("sin(pi*x*1)*sin(pi*y*2)+pi/10",2);
+        gsBoundaryConditions<> bcInfo;
+        for (gsMultiPatch<>::const_biterator bit = patches.bBegin(); bit != patches.bEnd(); ++bit)
+            bcInfo.addCondition(*bit, condition_type::dirichlet, &g);
+
+        gsPoissonAssembler<real_t> reference(patches,bases,bcInfo,f);
+        reference.assemble();
+        const gsSparseMatrix<> K = reference.matrix();
+        const gsMatrix<> rhs = reference.rhs();
+        CHECK( !reference.system().hasPattern() );
+
+        gsPoissonAssembler<real_t> poisson(patches,bases,bcInfo,f);
+        poisson.options().setSwitch("exactPattern", true);
+        poisson.assemble();
+        CHECK( poisson.system().hasPattern() );
+        const index_t nz = poisson.matrix().nonZeros();
+        CHECK( K.nonZeros() <= nz );
+
+        // Reassembly with an unchanged pattern and refactorization
+        gsSparseSolver<>::LU solver;
+        solver.compute( K );
+        const gsMatrix<> x = solver.solve( rhs );
+        solver.analyzePattern( poisson.matrix() );
+        for (index_t k = 0; k != 2; ++k)
+        {
+            poisson.assemble();
+            CHECK( poisson.system().hasPattern() );
+            CHECK_EQUAL( nz, poisson.matrix().nonZeros() );
+            CHECK( (K - poisson.matrix()).norm() < 1e-12 * K.norm() );
+            CHECK( (rhs - poisson.rhs()).norm() < 1e-12 * rhs.norm() );
+
+            solver.factorize( poisson.matrix() );
+            CHECK( (x - solver.solve( poisson.rhs() )).norm() < 1e-10 * x.norm() );
+        }
+    }
+
+    TEST(ColoredAccumulation_test)
+    {
+        gsMultiPatch<> patches = gsNurbsCreator<>::BSplineSquareGrid(2, 2, 0.5);
+        gsMultiBasis<> bases(patches);
+        bases.setDegree(2);
+        bases.uniformRefine();
+        bases.uniformRefine();
+
+        gsFunctionExpr<> f("((pi*1)^2 + (pi*2)^2)*sin(pi*x*1)*sin(pi*y*2)",2);
+        gsFunctionExpr<> g("sin(pi*x*1)*sin(pi*y*2)+pi/10",2);
+        gsBoundaryConditions<> bcInfo;
+        for (gsMultiPatch<>::const_biterator bit = patches.bBegin(); bit != patches.bEnd(); ++bit)
+            bcInfo.addCondition(*bit, condition_type::dirichlet, &g);
+
+        gsPoissonAssembler<real_t> serial(patches,bases,bcInfo,f);
+        serial.assemble();
+
+        gsPoissonAssembler<real_t> colored(patches,bases,bcInfo,f);
+        colored.options().setInt("accumulation", accumulation::colored);
+        colored.assemble();
+        CHECK( colored.system().hasPattern() );
+        CHECK( colored.system().coloring().numColors() > 1 );
+
+        const gsSparseMatrix<> & K = serial.matrix();
+        CHECK( (K - colored.matrix()).norm() < 1e-12 * K.norm() );
+        CHECK( (serial.rhs() - colored.rhs()).norm() < 1e-12 * serial.rhs().norm() );
+    }
+
     TEST(Galerkin_test)
     {
         runPoissonSolverTest(dirichlet::elimination, iFace::glue, 0);
@@ -87,6 +87,97 @@ void runPreconditionerTest( index_t testcase )
         solver.solve(rhs,sol);
         CHECK ( solver.error() <= solver.tolerance() );
     }
+    else if (testcase==4)
+    {
+        gsOptionList amgOpt = gsAlgebraicMultiGrid<>::defaultOptions();
+        amgOpt.setInt( "CoarseSize", 20 );
+        gsAlgebraicMultiGrid<> amg = gsAlgebraicMultiGrid<>::build(mat, amgOpt);
+        CHECK ( amg.numLevels() > 1 );
+        gsConjugateGradient<> solver(mat, amg.makeMultiGridOp());
+        solver.setTolerance( 1.e-8 );
+        solver.setMaxIterations( 25 );
+        solver.solve(rhs,sol);
+        CHECK ( solver.error() <= solver.tolerance() );
+    }
+    else if (testcase==5)
+    {
+        gsConjugateGradient<> solver(mat, makeMultiColorSSOROp(mat));
+        solver.setTolerance( 1.e-8 );
+        solver.setMaxIterations( 50 );
+        solver.solve(rhs,sol);
+        CHECK ( solver.error() <= solver.tolerance() );
+    }
+    else if (testcase==6)
+    {
+        gsOptionList amgOpt = gsAlgebraicMultiGrid<>::defaultOptions();
+        amgOpt.setInt( "CoarseSize", 20 );
+        gsMultiGridOp<>::Ptr mg = gsAlgebraicMultiGrid<>::build(mat, amgOpt).makeMultiGridOp();
+        gsOptionList mgOpt = gsMultiGridOp<>::defaultOptions();
+        mgOpt.setString( "Smoother", "Chebyshev" );
+        mg->setOptions(mgOpt);
+        gsConjugateGradient<> solver(mat, mg);
+        solver.setTolerance( 1.e-8 );
+        solver.setMaxIterations( 25 );
+        solver.solve(rhs,sol);
+        CHECK ( solver.error() <= solver.tolerance() );
+    }
+    else if (testcase==7)
+    {
+        gsIncompleteLUkOp<>::Ptr ilu = makeIncompleteLUkOp(mat, 1);
+        CHECK ( ilu->nonZeros() > mat.nonZeros() );
+        gsGMRes<> solver(mat, ilu);
+        solver.setTolerance( 1.e-8 );
+        solver.setMaxIterations( 40 );
+        solver.solve(rhs,sol);
+        CHECK ( solver.error() <= solver.tolerance() );
+    }
+    else if (testcase==8)
+    {
+        gsIncompleteLUkOp<>::Ptr ilu = makeIncompleteLUkOp(mat);
+        gsOptionList iluOpt = gsIncompleteLUkOp<>::defaultOptions();
+        iluOpt.setInt( "TriangularSweeps", 10 );
+        ilu->setOptions(iluOpt);
+        gsGMRes<> solver(mat, ilu);
+        solver.setTolerance( 1.e-8 );
+        solver.setMaxIterations( 120 );
+        solver.solve(rhs,sol);
+        CHECK ( solver.error() <= solver.tolerance() );
+    }
+    else if (testcase==9)
+    {
+        // The levels are set up by refinement, since NURBS bases can not be coarsened
+        gsMultiBasis<> coarse(mp);
+        for (int i = 0; i < numRefine - 2; ++i)
+            coarse.uniformRefine();
+        std::vector< gsSparseMatrix<real_t,RowMajor> > transferMatrices;
+        gsGridHierarchy<>::buildByRefinement(coarse, bc, gsGridHierarchy<>::defaultOptions())
+            .moveTransferMatricesTo(transferMatrices);
+        gsMultiGridOp<>::Ptr mg = gsMultiGridOp<>::make(mat, transferMatrices);
+        gsOptionList mgOpt = gsMultiGridOp<>::defaultOptions();
+        mgOpt.setString( "Smoother", "SymmetricGaussSeidel" );
+        mgOpt.setInt( "SinglePrecisionLevels", mg->numLevels() );
+        mg->setOptions(mgOpt);
+        gsConjugateGradient<> solver(mat, mg);
+        solver.setTolerance( 1.e-8 );
+        solver.setMaxIterations( 20 );
+        solver.solve(rhs,sol);
+        CHECK ( solver.error() <= solver.tolerance() );
+    }
+    else if (testcase==10)
+    {
+        gsOptionList amgOpt = gsAlgebraicMultiGrid<>::defaultOptions();
+        amgOpt.setInt( "CoarseSize", 20 );
+        gsMultiGridOp<>::Ptr mg = gsAlgebraicMultiGrid<>::build(mat, amgOpt).makeMultiGridOp();
+        gsOptionList mgOpt = gsMultiGridOp<>::defaultOptions();
+        mgOpt.setInt( "SinglePrecisionLevels", 2 );
+        mgOpt.setString( "Smoother", "Chebyshev" );
+        mg->setOptions(mgOpt);
+        gsConjugateGradient<> solver(mat, mg);
+        solver.setTolerance( 1.e-8 );
+        solver.setMaxIterations( 25 );
+        solver.solve(rhs,sol);
+        CHECK ( solver.error() <= solver.tolerance() );
+    }
 }
 
 
@@ -110,6 +201,176 @@ SUITE(gsPreconditioner_test)
         runPreconditionerTest(3);
     }
 
+    TEST(gsAlgebraicMultiGridPreconditioner_test)
+    {
+        runPreconditionerTest(4);
+    }
+
+    TEST(gsMultiColorSSORPreconditioner_test)
+    {
+        runPreconditionerTest(5);
+    }
+
+    TEST(gsChebyshevSmoother_test)
+    {
+        runPreconditionerTest(6);
+    }
+
+    TEST(gsIncompleteLUkPreconditioner_test)
+    {
+        runPreconditionerTest(7);
+    }
+
+    TEST(gsIncompleteLUkJacobiSweeps_test)
+    {
+        runPreconditionerTest(8);
+    }
+
+    TEST(gsMultiGridSinglePrecisionPreconditioner_test)
+    {
+        runPreconditionerTest(9);
+    }
+
+    TEST(gsAlgebraicMultiGridSinglePrecision_test)
+    {
+        runPreconditionerTest(10);
+    }
+
+    TEST(gsMultiGridSinglePrecision_test)
+    {
+        gsMultiPatch<> mp( *gsNurbsCreator<>::BSplineSquareDeg(2) );
+        gsMultiBasis<> mb(mp);
+        for (index_t i = 0; i < 4; ++i)
+            mb.uniformRefine();
+        gsBoundaryConditions<> bc;
+        std::vector< gsSparseMatrix<real_t,RowMajor> > transferMatrices;
+        gsGridHierarchy<>::buildByCoarsening(mb, bc, gsGridHierarchy<>::defaultOptions())
+            .moveTransferMatricesTo(transferMatrices);
+
+        // A diagonally dominant matrix on the finest grid
+        const index_t n = transferMatrices.back().rows();
+        gsSparseMatrix<> mat(n,n);
+        for (index_t i = 0; i < n; ++i)
+        {
+            mat(i,i) = 4;
+            if (i > 0)   mat(i,i-1) = -1;
+            if (i < n-1) mat(i,i+1) = -1;
+        }
+        mat.makeCompressed();
+
+        gsMultiGridOp<> mgDouble(mat, transferMatrices);
+        gsMultiGridOp<> mgSingle(mat, transferMatrices);
+        mgDouble.setSmoothers("GaussSeidel");
+        mgSingle.setSmoothers("GaussSeidel");
+        const size_t bytes = mgDouble.memoryUsage();
+        mgSingle.setSinglePrecisionLevels(2);
+        CHECK_EQUAL ( 2, mgSingle.singlePrecisionLevels() );
+        CHECK ( !mgSingle.smoother(1) && mgSingle.smoother(2) );
+        CHECK ( mgSingle.memoryUsage() < bytes );
+        mgSingle.setSinglePrecisionLevels(mgSingle.numLevels());
+        CHECK ( mgSingle.memoryUsage() < bytes );
+        CHECK ( mgSingle.nDofs(0) == mgDouble.nDofs(0) );
+        CHECK ( mgSingle.matrixSingle(1).nonZeros() == mgDouble.matrix(1).nonZeros() );
+
+        gsMatrix<> rhs, x, y;
+        rhs.setRandom(n, 1);
+        mgDouble.apply(rhs, x);
+        mgSingle.apply(rhs, y);
+        CHECK ( (x - y).norm() <= 1e-4 * x.norm() );
+
+        // Full multigrid uses the transfers between the float levels in T
+        std::vector< gsMatrix<> > rhsLevels(mgDouble.numLevels()), fixed(mgDouble.numLevels());
+        rhsLevels.back() = rhs;
+        for (index_t lvl = mgDouble.numLevels()-1; lvl > 0; --lvl)
+            mgDouble.restrictVector(lvl, rhsLevels[lvl], rhsLevels[lvl-1]);
+        for (index_t lvl = 0; lvl < mgDouble.numLevels(); ++lvl)
+            fixed[lvl].setZero(mgDouble.nDofs(lvl), 1);
+        mgDouble.fullMultiGrid(rhsLevels, fixed, x);
+        mgSingle.fullMultiGrid(rhsLevels, fixed, y);
+        CHECK ( (x - y).norm() <= 1e-4 * x.norm() );
+    }
+
+    TEST(gsIncompleteLUk_test)
+    {
+        // Nonsymmetric tridiagonal matrix, where ILU(0) is the exact LU
+        const index_t n = 50;
+        gsSparseMatrix<> mat(n,n);
+        for (index_t i=0; i<n; ++i)
+        {
+            mat(i,i) = 3;
+            if (i>0)   mat(i,i-1) = -1.2;
+            if (i<n-1) mat(i,i+1) = -0.8;
+        }
+        mat.makeCompressed();
+
+        gsIncompleteLUkOp<> ilu(mat);
+        CHECK_EQUAL ( mat.nonZeros(), ilu.nonZeros() );
+        CHECK_EQUAL ( n, ilu.numLevels() );
+
+        gsMatrix<> rhs, x;
+        rhs.setRandom(n,2);
+        ilu.apply(rhs,x);
+        CHECK ( (rhs - mat*x).norm() < 1/(real_t)(10000) );
+
+        // New values on the same pattern
+        gsSparseMatrix<> mat2 = 2 * mat;
+        ilu.factorize(mat2);
+        ilu.apply(rhs,x);
+        CHECK ( (rhs - mat2*x).norm() < 1/(real_t)(10000) );
+    }
+
+    TEST(gsMultiColorGaussSeidel_test)
+    {
+        // 2D five-point stencil, which needs two colors
+        const index_t m = 10, n = m*m;
+        gsSparseMatrix<> mat(n,n);
+        for (index_t i=0; i<m; ++i)
+            for (index_t j=0; j<m; ++j)
+            {
+                const index_t k = i*m+j;
+                mat(k,k) = 4;
+                if (i>0)   mat(k,k-m) = -1;
+                if (i<m-1) mat(k,k+m) = -1;
+                if (j>0)   mat(k,k-1) = -1;
+                if (j<m-1) mat(k,k+1) = -1;
+            }
+        mat.makeCompressed();
+
+        gsMultiColorGaussSeidelOp< gsSparseMatrix<> > gs(mat);
+        CHECK_EQUAL ( 2, gs.numColors() );
+
+        // The residual vanishes on the color relaxed last
+        gsMatrix<> rhs, x;
+        rhs.setRandom(n,2);
+        x.setZero(n,2);
+        gs.step(rhs,x);
+        const gsMatrix<> res = rhs - mat*x;
+        for (index_t k=0; k<n; ++k)
+            if ( (k/m + k%m) % 2 == 1 )
+                CHECK ( res.row(k).norm() < 1/(real_t)(10000) );
+    }
+
+    TEST(gsAlgebraicMultiGrid_multiply_test)
+    {
+        gsSparseMatrix<> A(50,40), B(40,30), C;
+        for (index_t i=0; i<50; ++i)
+        {
+            A(i,(7*i)%40) = i+1;
+            A(i,(3*i+1)%40) = -1;
+        }
+        for (index_t j=0; j<30; ++j)
+        {
+            B(j,j) = 2;
+            B((5*j+3)%40,j) = j;
+        }
+        A.makeCompressed();
+        B.makeCompressed();
+        gsAlgebraicMultiGrid<>::multiply(A,B,C);
+        const gsSparseMatrix<> D = A*B;
+        CHECK ( C.nonZeros() <= D.nonZeros() );
+        CHECK ( (C-D).norm() < 1/(real_t)(10000) );
+    }
+
     TEST(gsPatchPreconditioner_stiff_test)
     {
         // Define Geometry
@@ -266,5 +527,55 @@ SUITE(gsPreconditioner_test)
         }
     }
 
+    TEST(gsAdditiveOp_parallel_test)
+    {
+        // Many overlapping subspaces, such that the subspace corrections
+        // are distributed over the threads
+        const index_t n = 50, numSub = 20, sz = 6;
+        std::vector< gsSparseMatrix<real_t,RowMajor> > t(numSub);
+        std::vector< gsLinearOperator<>::Ptr > o(numSub);
+        gsSumOp<> s;
+        gsBlockOp<> b(numSub, 2);
+        gsMatrix<> full(n, n), blocks(numSub*sz, sz+n);
+        full.setZero();
+        blocks.setZero();
+        for (index_t i = 0; i < numSub; ++i)
+        {
+            t[i].resize(n, sz);
+            for (index_t j = 0; j < sz; ++j)
+                t[i].insert( (2*i+j) % n, j ) = 1;
+            gsMatrix<> oi(sz, sz), ti = t[i].toDense();
+            oi.setRandom();
+            full += ti * oi * ti.transpose();
+            if (i%2)
+                blocks.block(i*sz, sz, sz, n) = ti.transpose();
+            else
+                blocks.block(i*sz, 0, sz, sz) = oi;
+            o[i] = makeMatrixOp(oi.moveToPtr());
+            s.addOperator( gsProductOp<>::make( makeMatrixOp(t[i].transpose()), o[i], makeMatrixOp(t[i]) ) );
+            b.addOperator( i, i%2, i%2 ? makeMatrixOp(t[i].transpose()) : o[i] );
+        }
+
+        gsMatrix<> in, res;
+        gsAdditiveOp<> a(t, o);
+        // Serial by default, then in parallel
+        for (index_t k = 0; k < 2; ++k)
+        {
+            in.setRandom(n, 2);
+            a.apply( in, res );
+            CHECK ( (res - full*in).norm() < 1e-10 * res.norm() );
+            s.apply( in, res );
+            CHECK ( (res - full*in).norm() < 1e-10 * res.norm() );
+
+            in.setRandom(sz+n, 2);
+            b.apply( in, res );
+            CHECK ( (res - blocks*in).norm() < 1e-10 * res.norm() );
+
+            a.setParallel();
+            s.setParallel();
+            b.setParallel();
+        }
+    }
+
 
 }
@@ -0,0 +1,145 @@
+/** @file gsSumFactorization_test.cpp
+
+    @brief Tests for the sum-factorized element matrices of
+    tensor-product bases
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): agent
+*/
+
+#include "gismo_unittest.h"
+
+namespace {
+
+// Compares all kernels of gsSumFactorization with a quadrature loop
+// over the values of the full basis, on an interior element of basis
+void checkKernels(const gsBasis<> & basis, index_t quRule)
+{
+    gsOptionList opt = gsAssembler<>::defaultOptions();
+    opt.addInt("quRule", "", quRule);
+    const gsVector<index_t> numNodes = gsQuadrature::numNodes(basis, 1.0, 1);
+    gsQuadRule<real_t> rule = gsQuadrature::get(basis, opt);
+
+    gsBasis<>::domainIter it = basis.makeDomainIterator();
+    it->next();
+    gsMatrix<> nodes;
+    gsVector<> weights;
+    rule.mapTo(it->lowerCorner(), it->upperCorner(), nodes, weights);
+
+    gsSumFactorization<real_t> sf;
+    sf.compute(basis, nodes, numNodes);
+
+    std::vector<gsMatrix<> > ders;
+    basis.evalAllDers_into(nodes, 1, ders);
+    const index_t d = basis.dim(), N = ders[0].rows(), nq = nodes.cols();
+    CHECK_EQUAL( N, sf.numActive() );
+    CHECK_EQUAL( nq, sf.numNodes() );
+
+    // Arbitrary (non-symmetric) coefficients
+    gsMatrix<> massCoefs(1, nq), stiffCoefs(d * d, nq), convCoefs(d, nq), loadCoefs(2, nq);
+    for (index_t q = 0; q != nq; ++q)
+    {
+        massCoefs(0, q) = weights[q] * (1 + q % 3);
+        for (index_t k = 0; k != d * d; ++k)
+            stiffCoefs(k, q) = weights[q] * ((k + q) % 4 + 1 - k);
+        for (index_t k = 0; k != d; ++k)
+            convCoefs(k, q) = weights[q] * (k + 1) * (q % 2 ? -1 : 1);
+        loadCoefs(0, q) = weights[q];
+        loadCoefs(1, q) = weights[q] * nodes.col(q).sum();
+    }
+
+    gsMatrix<> mass = gsMatrix<>::Zero(N, N), stiff = mass, conv = mass;
+    gsMatrix<> load = gsMatrix<>::Zero(N, 2);
+    for (index_t q = 0; q != nq; ++q)
+    {
+        const gsAsConstMatrix<> grads(ders[1].col(q).data(), d, N);
+        const gsAsConstMatrix<> C(stiffCoefs.col(q).data(), d, d);
+        mass.noalias()  += massCoefs(0, q) * ders[0].col(q) * ders[0].col(q).transpose();
+        stiff.noalias() += grads.transpose() * C * grads;
+        conv.noalias()  += ders[0].col(q) * (convCoefs.col(q).transpose() * grads);
+        load.noalias()  += ders[0].col(q) * loadCoefs.col(q).transpose();
+    }
+
+    gsMatrix<> result;
+    sf.mass_into(massCoefs, result);
+    CHECK( (result - mass).norm() < 1e-12 * mass.norm() );
+    sf.stiffness_into(stiffCoefs, result);
+    CHECK( (result - stiff).norm() < 1e-12 * stiff.norm() );
+    sf.convection_into(convCoefs, result);
+    CHECK( (result - conv).norm() < 1e-12 * conv.norm() );
+    sf.moments_into(loadCoefs, result);
+    CHECK( (result - load).norm() < 1e-12 * load.norm() );
+}
+
+}
+
+SUITE(gsSumFactorization_test)
+{
+    TEST(Kernels_test)
+    {
+        gsKnotVector<> kv2(0, 1, 3, 3), kv3(0, 1, 2, 4);
+        gsTensorBSplineBasis<2> b2(kv2, kv3);
+        checkKernels(b2, gsQuadrature::GaussLegendre);
+        checkKernels(b2, gsQuadrature::GaussLobatto);
+
+        gsTensorBSplineBasis<3> b3(kv3, kv2, kv3);
+        checkKernels(b3, gsQuadrature::GaussLegendre);
+    }
+
+    TEST(Applies_test)
+    {
+        gsTensorBSplineBasis<2> b(gsKnotVector<>(0, 1, 3, 3), gsKnotVector<>(0, 1, 3, 3));
+        gsOptionList opt = gsAssembler<>::defaultOptions();
+        CHECK( gsSumFactorization<real_t>::applies(b, opt) );
+
+        opt.addInt("quRule", "", gsQuadrature::GaussLobatto);
+        CHECK( gsSumFactorization<real_t>::applies(b, opt) );
+
+        // The nodes of a patch rule do not form a tensor grid per element
+        opt.setInt("quRule", gsQuadrature::PatchRule);
+        CHECK( !gsSumFactorization<real_t>::applies(b, opt) );
+
+        opt.setInt("quRule", gsQuadrature::GaussLegendre);
+        opt.addSwitch("overInt", "", true);
+        CHECK( !gsSumFactorization<real_t>::applies(b, opt) );
+
+        gsTHBSplineBasis<2> thb(b);
+        opt.setSwitch("overInt", false);
+        CHECK( !gsSumFactorization<real_t>::applies(thb, opt) );
+    }
+
+    TEST(PoissonVisitor_test)
+    {
+        // A curved domain, the metric differs at every node
+        gsMultiPatch<> mp( *gsNurbsCreator<>::BSplineFatQuarterAnnulus() );
+        gsMultiBasis<> mb(mp);
+        mb.setDegree(3);
+        mb.uniformRefine();
+
+        gsFunctionExpr<> f("x*y", 2);
+        gsBoundaryConditions<> bc;
+        for (gsMultiPatch<>::const_biterator bit = mp.bBegin(); bit != mp.bEnd(); ++bit)
+            bc.addCondition(*bit, condition_type::dirichlet, &f);
+
+        for (index_t qu = gsQuadrature::GaussLegendre; qu <= gsQuadrature::GaussLobatto; ++qu)
+        {
+            gsPoissonAssembler<real_t> standard(mp, mb, bc, f);
+            standard.options().addInt("quRule", "", qu);
+            standard.assemble();
+
+            gsPoissonAssembler<real_t> sumFact(mp, mb, bc, f);
+            sumFact.options().addInt("quRule", "", qu);
+            sumFact.options().setSwitch("sumFactorization", true);
+            sumFact.assemble();
+
+            const gsSparseMatrix<> & K = standard.matrix();
+            CHECK( (K - sumFact.matrix()).norm() < 1e-12 * K.norm() );
+            CHECK( (standard.rhs() - sumFact.rhs()).norm() < 1e-12 * standard.rhs().norm() );
+        }
+    }
+}
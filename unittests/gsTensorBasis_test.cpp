@@ -0,0 +1,115 @@
+/** @file gsTensorBasis_test.cpp
+
+    @brief Tests for the evaluation of tensor-product bases
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): agent
+*/
+
+#include "gismo_unittest.h"
+
+namespace {
+
+// Compares the evaluation of all active functions of basis at the
+// points u with the evaluation of every function on its own
+template<short_t d>
+void checkTensorEvaluation(const gsTensorBSplineBasis<d> & basis, const gsMatrix<> & u)
+{
+    const index_t n = 3;
+    const index_t s2 = d * (d + 1) / 2, s3 = numCompositions(n, d);
+    const real_t tol = 1e-10;
+
+    gsMatrix<> ev, der, der2, single;
+    std::vector<gsMatrix<> > all;
+    gsMatrix<index_t> act;
+    basis.active_into(u, act);
+    basis.eval_into(u, ev);
+    basis.deriv_into(u, der);
+    basis.deriv2_into(u, der2);
+    basis.evalAllDers_into(u, n, all);
+
+    CHECK_EQUAL( n + 1, static_cast<index_t>(all.size()) );
+    CHECK( act.rows() == ev.rows() && u.cols() == ev.cols() );
+    CHECK( d * act.rows() == der.rows() && s2 * act.rows() == der2.rows() );
+    CHECK( s3 * act.rows() == all[3].rows() );
+    CHECK( (all[0] - ev).norm() < tol * ev.norm() );
+    CHECK( (all[1] - der).norm() < tol * der.norm() );
+    CHECK( (all[2] - der2).norm() < tol * der2.norm() );
+
+    bool eq = true;
+    gsVector<index_t, d> ti;
+    gsVector<index_t, d> cc;
+    gsMatrix<> uni;
+    for (index_t k = 0; k != u.cols(); ++k)
+        for (index_t j = 0; j != act.rows(); ++j)
+        {
+            const index_t i = act(j, k);
+            basis.evalSingle_into(i, u.col(k), single);
+            eq = eq && math::abs(ev(j, k) - single(0,0)) < tol;
+
+            basis.derivSingle_into(i, u.col(k), single);
+            eq = eq && (der.block(j * d, k, d, 1) - single).norm() < tol * (1 + single.norm());
+
+            basis.deriv2Single_into(i, u.col(k), single);
+            eq = eq && (der2.block(j * s2, k, s2, 1) - single).norm() < tol * (1 + single.norm());
+
+            // Third derivatives, products of univariate derivatives
+            ti = basis.tensorIndex(i);
+            index_t r = 0;
+            firstComposition(n, d, cc);
+            do
+            {
+                real_t val = 1;
+                for (short_t c = 0; c != d; ++c)
+                {
+                    if ( cc[c] > basis.degree(c) )
+                    {
+                        val = 0;
+                        break;
+                    }
+                    basis.component(c).evalDerSingle_into(ti[c], u.block(c, k, 1, 1), cc[c], uni);
+                    val *= uni(0,0);
+                }
+                eq = eq && math::abs(all[3](j * s3 + r, k) - val) < tol * (1 + math::abs(val));
+                ++r;
+            } while (nextComposition(cc));
+        }
+    CHECK( eq );
+}
+
+}
+
+SUITE(gsTensorBasis_test)
+{
+    TEST(evaluation2D)
+    {
+        gsKnotVector<> kv1(0, 1, 3, 4, 2); // cubic, double interior knots
+        gsKnotVector<> kv2(0, 1, 2, 3);    // quadratic
+        gsTensorBSplineBasis<2> basis(kv1, kv2);
+
+        // Interior points, on knots and in between
+        gsMatrix<> u(2, 6);
+        u << 0.0, 0.25, 0.3, 0.5, 0.9, 0.75,
+             0.1, 1./3, 0.5, 0.0, 0.8, 2./3;
+        checkTensorEvaluation<2>(basis, u);
+    }
+
+    TEST(evaluation3D)
+    {
+        gsKnotVector<> kv1(0, 1, 1, 4);    // cubic
+        gsKnotVector<> kv2(0, 1, 2, 3, 2); // quadratic, C0
+        gsKnotVector<> kv3(0, 1, 3, 3);    // quadratic
+        gsTensorBSplineBasis<3> basis(kv1, kv2, kv3);
+
+        gsMatrix<> u(3, 5);
+        u << 0.0, 0.5, 0.2, 0.7, 0.95,
+             0.1, 1./3, 0.5, 2./3, 0.9,
+             0.3, 0.25, 0.0, 0.6, 0.75;
+        checkTensorEvaluation<3>(basis, u);
+    }
+}
@@ -0,0 +1,144 @@
+/** @file gsVtkDataArray_test.cpp
+
+    @brief test gsIO/gsVtkDataArray
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Mantzaflaris
+ **/
+
+#include "gismo_unittest.h"
+
+namespace
+{
+
+std::string base64Decode(const std::string & in)
+{
+    const std::string table =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    uint32_t buf = 0;
+    int bits = 0;
+    for (size_t i = 0; i != in.size() && '=' != in[i]; ++i)
+    {
+        buf = (buf << 6) | static_cast<uint32_t>(table.find(in[i]));
+        bits += 6;
+        if (bits >= 8)
+        {
+            bits -= 8;
+            out.push_back(static_cast<char>((buf >> bits) & 0xFF));
+        }
+    }
+    return out;
+}
+
+// Text between the first ">\n" after \a tag and the next "\n</DataArray>"
+std::string arrayBody(const std::string & xml, const std::string & tag)
+{
+    const size_t b = xml.find(">\n", xml.find(tag)) + 2;
+    return xml.substr(b, xml.find("\n</DataArray>", b) - b);
+}
+
+}
+
+SUITE(gsVtkDataArray_test)
+{
+
+TEST(base64)
+{
+    gsMatrix<real_t> pts(2,3);
+    pts << 0, 1, 2,
+           3, 4, 5;
+
+    gsVtkDataArray vtk(vtkEncoding::base64);
+    std::stringstream ss;
+    vtk.writeFloat32(ss, pts, "Name=\"pts\" ", 3);
+    const std::string xml = ss.str();
+    CHECK(xml.find("format=\"binary\"") != std::string::npos);
+    CHECK(xml.find("NumberOfComponents=\"3\"") != std::string::npos);
+
+    // UInt32 size header, followed by the padded columns
+    const std::string raw = base64Decode(arrayBody(xml, "<DataArray"));
+    uint32_t size;
+    std::memcpy(&size, raw.data(), sizeof(uint32_t));
+    CHECK_EQUAL(9 * sizeof(float), size);
+    CHECK_EQUAL(sizeof(uint32_t) + size, raw.size());
+    float val[9];
+    std::memcpy(val, raw.data() + sizeof(uint32_t), size);
+    for (index_t j = 0; j != 3; ++j)
+    {
+        CHECK_EQUAL((float)pts(0,j), val[3*j  ]);
+        CHECK_EQUAL((float)pts(1,j), val[3*j+1]);
+        CHECK_EQUAL(0.0f           , val[3*j+2]);
+    }
+}
+
+TEST(appended)
+{
+    gsMatrix<real_t> pts(1,4);
+    pts << 1, 2, 3, 4;
+    std::vector<index_t> conn(5);
+    for (size_t i = 0; i != conn.size(); ++i)
+        conn[i] = 2 * i;
+
+    gsVtkDataArray vtk(vtkEncoding::appended);
+    std::stringstream ss;
+    vtk.writeFloat32(ss, pts, "");
+    vtk.writeInt(ss, conn, "Name=\"connectivity\" ");
+    vtk.appendedData(ss);
+    const std::string xml = ss.str();
+    CHECK(xml.find("format=\"appended\" offset=\"0\"") != std::string::npos);
+    const size_t second = sizeof(uint32_t) + 4 * sizeof(float);
+    CHECK(xml.find("offset=\"" + util::to_string(second) + "\"") != std::string::npos);
+
+    const size_t start = xml.find("<AppendedData encoding=\"raw\">\n_");
+    CHECK(start != std::string::npos);
+    const char * raw = xml.data() + start + 31;
+    uint32_t size;
+    std::memcpy(&size, raw + second, sizeof(uint32_t));
+    CHECK_EQUAL(5 * sizeof(int32_t), size);
+    int32_t val[5];
+    std::memcpy(val, raw + second + sizeof(uint32_t), size);
+    for (size_t i = 0; i != conn.size(); ++i)
+        CHECK_EQUAL(conn[i], val[i]);
+}
+
+TEST(zlibHeader)
+{
+    // Several compression blocks of 32768 bytes
+    gsMatrix<real_t> pts(3, 10000);
+    pts.setOnes();
+
+    gsVtkDataArray vtk(vtkEncoding::zlib);
+    CHECK(vtk.fileAttributes().find("vtkZLibDataCompressor") != std::string::npos);
+    std::stringstream ss;
+    vtk.writeFloat32(ss, pts, "");
+
+    // The header is encoded separately: 3 + nblocks UInt32 values
+    const std::string body = arrayBody(ss.str(), "<DataArray");
+    const uint32_t nbytes = 30000 * sizeof(float), nblocks = 4;
+    const size_t hlen = 4 * (((3 + nblocks) * sizeof(uint32_t) + 2) / 3);
+    const std::string header = base64Decode(body.substr(0, hlen));
+    uint32_t h[3];
+    std::memcpy(h, header.data(), sizeof(h));
+    CHECK_EQUAL(nblocks, h[0]);
+    CHECK_EQUAL(32768u , h[1]);
+    CHECK_EQUAL(nbytes % 32768u, h[2]);
+    CHECK(body.size() - hlen < 4 * nbytes / 3); // compressed
+}
+
+TEST(defaultEncoding)
+{
+    const vtkEncoding::type enc = gsVtkDataArray::defaultEncoding();
+    gsVtkDataArray::setDefaultEncoding(vtkEncoding::base64);
+    CHECK_EQUAL(vtkEncoding::base64, gsVtkDataArray().encoding());
+    CHECK_EQUAL(vtkEncoding::appended, gsVtkDataArray(vtkEncoding::appended).encoding());
+    gsVtkDataArray::setDefaultEncoding(enc);
+    CHECK_EQUAL(enc, gsVtkDataArray(-1).encoding());
+}
+
+}